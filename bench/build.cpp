@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Management request build benchmarks
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "msg.h"
+
+using namespace ptpmgmt;
+
+// Set action and build the request, as a poller does per request
+static void BuildRequest(benchmark::State &state)
+{
+    mng_vals_e id = (mng_vals_e)state.range(0);
+    Message m;
+    Buf buf(m.getMsgPlanedLen() + 100);
+    uint16_t seq = 0;
+    for(auto _ : state) {
+        m.setAction(GET, id);
+        benchmark::DoNotOptimize(m.build(buf, seq++));
+    }
+    state.SetLabel(Message::mng2str_c(id));
+}
+BENCHMARK(BuildRequest)->Arg(TIME_STATUS_NP)->Arg(PORT_DATA_SET)
+->Arg(CURRENT_DATA_SET);
+
+// Patch the sequence of a prepared request
+static void PreparedRequestSeq(benchmark::State &state)
+{
+    mng_vals_e id = (mng_vals_e)state.range(0);
+    Message m;
+    m.setAction(GET, id);
+    PreparedRequest r(m);
+    if(!r.isReady()) {
+        state.SkipWithError("prepare fails");
+        return;
+    }
+    uint16_t seq = 0;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(r.setSequence(seq++));
+    state.SetLabel(Message::mng2str_c(id));
+}
+BENCHMARK(PreparedRequestSeq)->Arg(TIME_STATUS_NP)->Arg(PORT_DATA_SET)
+->Arg(CURRENT_DATA_SET);
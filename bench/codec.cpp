@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Management TLVs codecs benchmarks
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "mngCodecs.h"
+
+using namespace ptpmgmt;
+
+// Process the dataField using the MsgProc functions, per field
+template <typename T> static void procGeneric(benchmark::State &state,
+    bool build, bool (MsgProc::*f)(T &))
+{
+    uint8_t buf[100] = { 0 };
+    T d;
+    MsgProc p;
+    p.m_build = build;
+    for(auto _ : state) {
+        p.m_cur = buf;
+        p.m_left = sizeof buf;
+        benchmark::DoNotOptimize((p.*f)(d));
+        benchmark::ClobberMemory();
+    }
+}
+// Process the dataField using the generated codec
+template <typename T> static void procCodec(benchmark::State &state,
+    bool build)
+{
+    uint8_t buf[100] = { 0 };
+    T d;
+    ssize_t left;
+    for(auto _ : state) {
+        left = sizeof buf;
+        benchmark::DoNotOptimize(left);
+        benchmark::DoNotOptimize(buf);
+        if(left >= (ssize_t)MngCodec<T>::size) {
+            if(build)
+                MngCodec<T>::enc(buf, d);
+            else
+                MngCodec<T>::dec(buf, d);
+        }
+        benchmark::DoNotOptimize(d);
+        benchmark::ClobberMemory();
+    }
+}
+#define bench(n)\
+    static void Parse_##n##_Generic(benchmark::State &state)\
+    { procGeneric<n##_t>(state, false, &MsgProc::n##_f); }\
+    BENCHMARK(Parse_##n##_Generic);\
+    static void Parse_##n##_Codec(benchmark::State &state)\
+    { procCodec<n##_t>(state, false); }\
+    BENCHMARK(Parse_##n##_Codec);\
+    static void Build_##n##_Generic(benchmark::State &state)\
+    { procGeneric<n##_t>(state, true, &MsgProc::n##_f); }\
+    BENCHMARK(Build_##n##_Generic);\
+    static void Build_##n##_Codec(benchmark::State &state)\
+    { procCodec<n##_t>(state, true); }\
+    BENCHMARK(Build_##n##_Codec);
+
+bench(DEFAULT_DATA_SET)
+bench(CURRENT_DATA_SET)
+bench(PORT_DATA_SET)
+bench(TIME_STATUS_NP)
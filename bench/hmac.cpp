@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief HMAC libraries benchmarks
+ *
+ * Use the shared library, to load each HMAC library in turn.
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "comp.h"
+
+__PTPMGMT_NAMESPACE_USE;
+
+// Digest of a management message with authentication TLV
+static void Digest(benchmark::State &state, const char *lib, HMAC_t type,
+    size_t keySize)
+{
+    hmac_freeLib();
+    // Without a library, use the built-in HMAC
+    if(lib != nullptr && !hmac_selectLib(lib)) {
+        state.SkipWithError("library is not available");
+        return;
+    }
+    uint8_t bkey[32], data[100];
+    for(size_t i = 0; i < sizeof bkey; i++)
+        bkey[i] = i * 7 + 1;
+    for(size_t i = 0; i < sizeof data; i++)
+        data[i] = i * 13 + 5;
+    Binary key(bkey, keySize), mac(16);
+    std::unique_ptr<HMAC_Key> hmac(hmac_allocHMAC(type, key));
+    if(hmac == nullptr) {
+        state.SkipWithError("key allocation fails");
+        return;
+    }
+    for(auto _ : state)
+        benchmark::DoNotOptimize(hmac->digest(data, sizeof data, mac));
+    state.SetBytesProcessed(state.iterations() * sizeof data);
+    hmac.reset();
+    hmac_freeLib();
+}
+#define bench(n, l)\
+    BENCHMARK_CAPTURE(Digest, n##_SHA256, l, HMAC_SHA256, 32);\
+    BENCHMARK_CAPTURE(Digest, n##_AES128, l, HMAC_AES128, 16);\
+    BENCHMARK_CAPTURE(Digest, n##_AES256, l, HMAC_AES256, 32)
+
+bench(openssl, "openssl");
+bench(gcrypt, "gcrypt");
+bench(gnutls, "gnutls");
+bench(nettle, "nettle");
+bench(native, nullptr);
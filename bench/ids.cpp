@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Management IDs lookup benchmarks
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "msg.h"
+
+using namespace ptpmgmt;
+
+// Parse a reply without dataField, mostly the managementId lookup
+static void ParseMngId(benchmark::State &state)
+{
+    mng_vals_e id = (mng_vals_e)state.range(0);
+    Message m;
+    uint8_t buf[70];
+    if(!m.setAction(GET, id) || m.build(buf, sizeof buf, 1) !=
+        MNG_PARSE_ERROR_OK) {
+        state.SkipWithError("build fails");
+        return;
+    }
+    // actionField location IEEE "PTP management message"
+    buf[46] = RESPONSE;
+    ssize_t size = m.getMsgLen();
+    for(auto _ : state)
+        benchmark::DoNotOptimize(m.parse(buf, size));
+    state.SetLabel(Message::mng2str_c(id));
+}
+BENCHMARK(ParseMngId)->Arg(CLOCK_DESCRIPTION)->Arg(PRIORITY1)
+->Arg(ALTERNATE_TIME_OFFSET_ENABLE)->Arg(PORT_HWCLOCK_NP);
+
+static void Mng2str(benchmark::State &state)
+{
+    for(auto _ : state)
+        for(int i = FIRST_MNG_ID; i < LAST_MNG_ID; i++)
+            benchmark::DoNotOptimize(Message::mng2str_c((mng_vals_e)i));
+    state.SetItemsProcessed(state.iterations() * (LAST_MNG_ID - FIRST_MNG_ID));
+}
+BENCHMARK(Mng2str);
+
+static void FindMngID(benchmark::State &state, const char *str, bool exact)
+{
+    const std::string s(str);
+    mng_vals_e id;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(Message::findMngID(s, id, exact));
+}
+BENCHMARK_CAPTURE(FindMngID, exact, "PORT_HWCLOCK_NP", true);
+BENCHMARK_CAPTURE(FindMngID, word, "port_hwclock_np", false);
+BENCHMARK_CAPTURE(FindMngID, partial, "hwclock", false);
+BENCHMARK_CAPTURE(FindMngID, ambiguous, "_data_set", false);
+BENCHMARK_CAPTURE(FindMngID, unknown, "NO_SUCH_ID", false);
@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief JSON conversion benchmarks
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <fstream>
+#include <sstream>
+#include "json.h"
+#include "jsonParser.h"
+
+using namespace ptpmgmt;
+
+// Parse a reply of the management ID into the message
+static bool parseReply(Message &m, mng_vals_e id)
+{
+    uint8_t buf[400];
+    if(!m.setAction(GET, id) || m.build(buf, sizeof buf, 1) !=
+        MNG_PARSE_ERROR_OK)
+        return false;
+    // actionField location IEEE "PTP management message"
+    buf[46] = RESPONSE;
+    return m.parse(buf, m.getMsgLen()) == MNG_PARSE_ERROR_OK;
+}
+
+static void Msg2json(benchmark::State &state)
+{
+    mng_vals_e id = (mng_vals_e)state.range(0);
+    Message m;
+    if(!parseReply(m, id)) {
+        state.SkipWithError("parse fails");
+        return;
+    }
+    for(auto _ : state)
+        benchmark::DoNotOptimize(msg2json(m));
+    state.SetLabel(Message::mng2str_c(id));
+}
+BENCHMARK(Msg2json)->Arg(PRIORITY1)->Arg(DEFAULT_DATA_SET)
+->Arg(PORT_DATA_SET)->Arg(TIME_STATUS_NP);
+
+// Compact JSON into a reused buffer
+static void Msg2jsonCompact(benchmark::State &state)
+{
+    mng_vals_e id = (mng_vals_e)state.range(0);
+    Message m;
+    if(!parseReply(m, id)) {
+        state.SkipWithError("parse fails");
+        return;
+    }
+    char buf[2000];
+    JsonBufSink sink(buf, sizeof buf);
+    for(auto _ : state) {
+        sink.clear();
+        benchmark::DoNotOptimize(msg2json(m, sink, true));
+    }
+    state.SetLabel(Message::mng2str_c(id));
+}
+BENCHMARK(Msg2jsonCompact)->Arg(PRIORITY1)->Arg(DEFAULT_DATA_SET)
+->Arg(PORT_DATA_SET)->Arg(TIME_STATUS_NP);
+
+static void FromJson(benchmark::State &state)
+{
+    mng_vals_e id = (mng_vals_e)state.range(0);
+    Message m;
+    if(!parseReply(m, id)) {
+        state.SkipWithError("parse fails");
+        return;
+    }
+    const std::string json = msg2json(m);
+    Json2msg j;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(j.fromJson(json));
+    state.SetBytesProcessed(state.iterations() * json.size());
+    state.SetLabel(Message::mng2str_c(id));
+}
+BENCHMARK(FromJson)->Arg(PRIORITY1)->Arg(DEFAULT_DATA_SET)
+->Arg(PORT_DATA_SET)->Arg(TIME_STATUS_NP);
+
+// Parse the unit test JSON file, with and without the arena
+static void JsonParse(benchmark::State &state)
+{
+    bool useArena = state.range(0) != 0;
+    std::ifstream f("utest/test.json");
+    std::stringstream ss;
+    ss << f.rdbuf();
+    const std::string json = ss.str();
+    jsonMain j;
+    if(!j.parseBuffer(json, true, useArena)) {
+        state.SkipWithError("parse fails");
+        return;
+    }
+    for(auto _ : state)
+        benchmark::DoNotOptimize(j.parseBuffer(json, true, useArena));
+    state.SetBytesProcessed(state.iterations() * json.size());
+    state.SetLabel(useArena ? "arena" : "heap");
+}
+BENCHMARK(JsonParse)->Arg(0)->Arg(1);
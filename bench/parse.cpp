@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Management reply parse benchmarks
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "msg.h"
+
+using namespace ptpmgmt;
+
+// Parse a reply with a dataField, filled with zeros
+static void ParseReply(benchmark::State &state)
+{
+    mng_vals_e id = (mng_vals_e)state.range(0);
+    Message m;
+    uint8_t buf[400];
+    // A get request carries a dataField in the reply size
+    if(!m.setAction(GET, id) || m.build(buf, sizeof buf, 1) !=
+        MNG_PARSE_ERROR_OK) {
+        state.SkipWithError("build fails");
+        return;
+    }
+    // actionField location IEEE "PTP management message"
+    buf[46] = RESPONSE;
+    ssize_t size = m.getMsgLen();
+    for(auto _ : state)
+        benchmark::DoNotOptimize(m.parse(buf, size));
+    state.SetBytesProcessed(state.iterations() * size);
+    state.SetLabel(Message::mng2str_c(id));
+}
+BENCHMARK(ParseReply)->Arg(PRIORITY1)->Arg(DEFAULT_DATA_SET)
+->Arg(CURRENT_DATA_SET)->Arg(PORT_DATA_SET)->Arg(TIME_STATUS_NP)
+->Arg(CLOCK_DESCRIPTION)->Arg(PORT_PROPERTIES_NP);
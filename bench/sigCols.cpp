@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Signalling records decoding benchmarks
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "sigCols.h"
+
+using namespace ptpmgmt;
+
+// Signalling message with a SLAVE_RX_SYNC_TIMING_DATA TLV
+static ssize_t sigMsg(Message &m, uint8_t *buf, size_t recs)
+{
+    MsgParams prms = m.getParams();
+    prms.rcvSignaling = true;
+    prms.filterSignaling = false;
+    m.updateParams(prms);
+    m.build(buf, 1500, 1);
+    buf[0] = (buf[0] & 0xf0) | Signaling; // messageType
+    buf[32] = 5; // controlField
+    // signaling = 36 header + 10 targetPortIdentity = 44
+    size_t len = 10 + recs * 34;
+    buf[44] = SLAVE_RX_SYNC_TIMING_DATA >> 8;
+    buf[45] = SLAVE_RX_SYNC_TIMING_DATA & 0xff;
+    buf[46] = len >> 8;
+    buf[47] = len & 0xff;
+    for(size_t i = 0; i < len; i++)
+        buf[48 + i] = (i * 37 + 11) & 0xff;
+    size_t size = 48 + len;
+    buf[2] = size >> 8; // header.messageLength
+    buf[3] = size & 0xff;
+    return size;
+}
+
+// Decode the records into a vector of records
+static void ParseRecords(benchmark::State &state)
+{
+    size_t recs = state.range(0);
+    Message m;
+    uint8_t buf[1500];
+    ssize_t size = sigMsg(m, buf, recs);
+    for(auto _ : state)
+        benchmark::DoNotOptimize(m.parse(buf, size));
+    state.SetItemsProcessed(state.iterations() * recs);
+}
+BENCHMARK(ParseRecords)->Arg(4)->Arg(40);
+
+// Decode the records into columns
+static void ParseColumns(benchmark::State &state)
+{
+    size_t recs = state.range(0);
+    Message m;
+    SigColumns cols;
+    uint8_t buf[1500];
+    ssize_t size = sigMsg(m, buf, recs);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(m.parseColumns(buf, size, cols));
+        if(cols.size(SLAVE_RX_SYNC_TIMING_DATA) > 10000)
+            cols.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * recs);
+}
+BENCHMARK(ParseColumns)->Arg(4)->Arg(40);
@@ -0,0 +1,59 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Unix socket benchmarks
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <unistd.h>
+#include "sock.h"
+#include "msg.h"
+
+using namespace ptpmgmt;
+
+// Bind a socket to an address of the process, and set its peer
+static bool initSock(SockUnix &s, const char *self, const char *peer)
+{
+    std::string base = "/tmp/ptpmgmt_bench." + std::to_string(getpid());
+    return s.setSelfAddress(base + self) && s.setPeerAddress(base + peer) &&
+        s.init();
+}
+
+// Send a request and reply on the same process, as with ptp4l
+static void UnixRoundTrip(benchmark::State &state)
+{
+    SockUnix client, server;
+    if(!initSock(client, ".client", ".server") ||
+        !initSock(server, ".server", ".client")) {
+        state.SkipWithError("socket fails");
+        client.close();
+        return;
+    }
+    Message m;
+    Buf buf(m.getMsgPlanedLen() + 100);
+    if(!m.setAction(GET, PORT_DATA_SET) || m.build(buf, 1) !=
+        MNG_PARSE_ERROR_OK) {
+        state.SkipWithError("build fails");
+        client.close();
+        server.close();
+        return;
+    }
+    size_t size = m.getMsgLen();
+    Buf rcv(buf.size());
+    for(auto _ : state) {
+        if(!client.send(buf, size) || server.rcv(rcv) <= 0 ||
+            !server.send(rcv, size) || client.rcv(rcv) <= 0) {
+            state.SkipWithError("round trip fails");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * size * 2);
+    // Remove the sockets files
+    client.close();
+    server.close();
+}
+BENCHMARK(UnixRoundTrip);
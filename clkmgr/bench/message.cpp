@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+   SPDX-FileCopyrightText: Copyright © 2025 Intel Corporation. */
+
+/** @file
+ * @brief benchmark notification message build and parse
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2025 Intel Corporation.
+ *
+ */
+
+#include "client/notification_msg.hpp"
+#include "client/timebase_state.hpp"
+#include "proxy/notification_msg.hpp"
+#include "proxy/client.hpp"
+
+using namespace clkmgr;
+
+// Used on ClientNotificationMessage::parseBufferTail()
+void TimeBaseStates::setTimeBaseStatePtp(size_t timeBaseIndex,
+    const ptp_event &newEvent)
+{
+    benchmark::DoNotOptimize(newEvent);
+}
+void TimeBaseStates::setTimeBaseStateSys(size_t timeBaseIndex,
+    const chrony_event &newchronyEvent)
+{
+    benchmark::DoNotOptimize(newchronyEvent);
+}
+
+// Used on ProxyNotificationMessage::makeBufferTail()
+void Client::getPTPEvent(size_t timeBaseIndex, ptp_event &event)
+{
+    event.asCapable = true;
+    event.gmClockUUID = 123;
+    event.clockOffset = 12;
+    event.syncInterval = 10000;
+    event.syncedWithGm = false;
+}
+void Client::getChronyEvent(size_t timeBaseIndex, chrony_event &chronyEvent)
+{
+    chronyEvent.clockOffset = 123;
+    chronyEvent.gmClockUUID = 456;
+    chronyEvent.syncInterval = 500000;
+}
+
+// For linking
+Transmitter *Transmitter::getTransmitterInstance(sessionId_t sessionId)
+{
+    static Transmitter me;
+    return &me;
+}
+
+// The proxy sends a notification per time base
+static void MakeBuffer(benchmark::State &state)
+{
+    Buffer &buf = Listener::getSingleListenerInstance().getBuff();
+    ProxyNotificationMessage msg;
+    msg.setClockType((ClockType)state.range(0));
+    for(auto _ : state)
+        benchmark::DoNotOptimize(msg.makeBuffer(buf));
+}
+BENCHMARK(MakeBuffer)->Arg(PTPClock)->Arg(SysClock);
+
+// The client parses each notification
+static void ParseBuffer(benchmark::State &state)
+{
+    Buffer &buf = Listener::getSingleListenerInstance().getBuff();
+    ProxyNotificationMessage pmsg;
+    pmsg.setClockType((ClockType)state.range(0));
+    if(!pmsg.makeBuffer(buf)) {
+        state.SkipWithError("make buffer fails");
+        return;
+    }
+    size_t size = buf.getOffset();
+    reg_message_type<ClientNotificationMessage>();
+    for(auto _ : state) {
+        // Perpare buffer for parsing
+        buf.setLen(size);
+        delete Message::parseBuffer(buf);
+    }
+}
+BENCHMARK(ParseBuffer)->Arg(PTPClock)->Arg(SysClock);
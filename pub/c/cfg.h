@@ -173,6 +173,30 @@ struct ptpmgmt_cfg_t {
      */
     const void *(*p2p_dst_mac)(const_ptpmgmt_cfg cfg, size_t *len,
         const char *section);
+    /**
+     * Get the busy_poll value
+     * @param[in] cfg configuration object
+     * @param[in] section (optional)
+     * @return time in microseconds the kernel busy polls on receive
+     * @note calling with null section will fetch value from @"global@" section
+     */
+    uint32_t (*busy_poll)(const_ptpmgmt_cfg cfg, const char *section);
+    /**
+     * Get the prefer_busy_poll value
+     * @param[in] cfg configuration object
+     * @param[in] section (optional)
+     * @return value
+     * @note calling with null section will fetch value from @"global@" section
+     */
+    uint8_t (*prefer_busy_poll)(const_ptpmgmt_cfg cfg, const char *section);
+    /**
+     * Get the busy_poll_spin value
+     * @param[in] cfg configuration object
+     * @param[in] section (optional)
+     * @return time in microseconds to spin on receive before waiting
+     * @note calling with null section will fetch value from @"global@" section
+     */
+    uint32_t (*busy_poll_spin)(const_ptpmgmt_cfg cfg, const char *section);
 };
 
 /**
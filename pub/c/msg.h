@@ -600,6 +600,48 @@ struct ptpmgmt_msg_t {
      * @note You @b should not try to free this TLV object
      */
     const void *(*getSigMngTlv)(ptpmgmt_msg msg, size_t position);
+    /**
+     * Parse a received raw socket and visit the signalling TLVs while parsing
+     * @param[in, out] msg object
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[in] cookie pointer to a user cookie
+     * @param[in] callback function to call with each signalling TLV
+     * @return parse error state
+     * @note The signalling TLVs are not stored
+     * @note The TLV is valid during the call-back only
+     * @note stop parsing once a call-back return true
+     */
+    enum ptpmgmt_MNG_PARSE_ERROR_e(*parseVisit)(ptpmgmt_msg msg,
+        const void *buf, ssize_t msgSize, void *cookie,
+        ptpmgmt_msg_sig_callback callback);
+    /**
+     * Replace the SA and the send key used in the AUTHENTICATION TLVs
+     * @param[in, out] msg object
+     * @param[in] sa reference to SA file object
+     * @param[in] spp ID to use to send
+     * @param[in] key ID to use to send
+     * @return true if replace success
+     * @note All keys of the new SA are initialized before the replacement,
+     *  keys with the same type and value are kept.
+     *  On failure, the message continues to use the previous SA.
+     */
+    bool (*rotateAuth)(ptpmgmt_msg msg, const_ptpmgmt_safile sa, uint8_t spp,
+        uint32_t key);
+    /**
+     * Initialize all keys of the SA for verifying received messages
+     * @param[in, out] msg object
+     * @return true if all keys are initialized
+     * @note the keys cache grows to hold all the SA keys
+     */
+    bool (*preloadAuth)(ptpmgmt_msg msg);
+    /**
+     * Set the number of keys kept initialized for verifying received messages
+     * @param[in, out] msg object
+     * @param[in] size number of keys
+     * @return true if size is updated
+     */
+    bool (*setAuthCacheSize)(ptpmgmt_msg msg, size_t size);
 };
 
 /**
@@ -797,6 +839,158 @@ ptpmgmt_msg ptpmgmt_msg_alloc();
  */
 ptpmgmt_msg ptpmgmt_msg_alloc_prms(ptpmgmt_cpMsgParams prms);
 
+/** pointer to ptpmgmt message batch structure */
+typedef struct ptpmgmt_msg_batch_t *ptpmgmt_msg_batch;
+
+/** pointer to constant ptpmgmt message batch structure */
+typedef const struct ptpmgmt_msg_batch_t *const_ptpmgmt_msg_batch;
+
+/**
+ * The ptpmgmt message batch structure parse many received messages
+ *  and keep a result per message
+ * @note All messages in the batch are parsed using the same message object
+ * @note The pointers returned by getPeer() and getData() belong to
+ *  the batch object and are overwritten by the next call
+ */
+struct ptpmgmt_msg_batch_t {
+    /**< @cond internal */
+    void *_this; /**< pointer to actual C++ initialization object */
+    struct ptpmgmt_PortIdentity_t _peer;
+    ptpmgmt_msg _msg; /**< message object wrapper */
+    void *data; /**< Received management TLV converted to C */
+    void *dataTbl; /**< Received management TLV table converted to C */
+    /**< @endcond */
+
+    /**
+     * Free this batch object
+     * @param[in, out] batch object
+     */
+    void (*free)(ptpmgmt_msg_batch batch);
+    /**
+     * Get the message object used for parsing
+     * @param[in, out] batch object
+     * @return message object
+     * @note use to update parameters and authentication
+     * @note the message object is released with the batch object
+     */
+    ptpmgmt_msg(*getMsg)(ptpmgmt_msg_batch batch);
+    /**
+     * Remove all results from the batch
+     * @param[in] batch object
+     */
+    void (*clear)(const_ptpmgmt_msg_batch batch);
+    /**
+     * Parse a received message and add the result to the batch
+     * @param[in] batch object
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @return parse error state
+     */
+    enum ptpmgmt_MNG_PARSE_ERROR_e(*append)(const_ptpmgmt_msg_batch batch,
+        const void *buf, ssize_t msgSize);
+    /**
+     * Parse received messages into the batch
+     * @param[in] batch object
+     * @param[in] bufs table of memory buffers containing raw PTP Messages
+     * @param[in] sizes table of received sizes of the PTP Messages
+     * @param[in] count number of messages
+     * @return number of messages parsed successfully
+     * @note the batch is cleared before parsing
+     */
+    size_t (*parse)(const_ptpmgmt_msg_batch batch, const void *const *bufs,
+        const ssize_t *sizes, size_t count);
+    /**
+     * Get number of results in the batch
+     * @param[in] batch object
+     * @return number of results
+     */
+    size_t (*size)(const_ptpmgmt_msg_batch batch);
+    /**
+     * Get parse error state of a message
+     * @param[in] batch object
+     * @param[in] position of message in the batch
+     * @return parse error state
+     */
+    enum ptpmgmt_MNG_PARSE_ERROR_e(*getErr)(const_ptpmgmt_msg_batch batch,
+        size_t position);
+    /**
+     * Get type of a message
+     * @param[in] batch object
+     * @param[in] position of message in the batch
+     * @return message type
+     */
+    enum ptpmgmt_msgType_e(*getType)(const_ptpmgmt_msg_batch batch,
+        size_t position);
+    /**
+     * Get peer port ID of a message
+     * @param[in, out] batch object
+     * @param[in] position of message in the batch
+     * @return message peer port ID
+     * @note the port ID is valid until the next getPeer() call
+     *  on this batch object, copy it to keep it
+     */
+    const struct ptpmgmt_PortIdentity_t *(*getPeer)(ptpmgmt_msg_batch batch,
+        size_t position);
+    /**
+     * Get sequence number of a message
+     * @param[in] batch object
+     * @param[in] position of message in the batch
+     * @return message sequence number
+     */
+    uint16_t (*getSequence)(const_ptpmgmt_msg_batch batch, size_t position);
+    /**
+     * Get reply management action of a message
+     * @param[in] batch object
+     * @param[in] position of message in the batch
+     * @return reply management action
+     */
+    enum ptpmgmt_actionField_e(*getReplyAction)(const_ptpmgmt_msg_batch batch,
+        size_t position);
+    /**
+     * Get management TLV ID of a message
+     * @param[in] batch object
+     * @param[in] position of message in the batch
+     * @return management TLV ID
+     */
+    enum ptpmgmt_mng_vals_e(*getTlvId)(const_ptpmgmt_msg_batch batch,
+        size_t position);
+    /**
+     * Get management error ID of a message
+     * @param[in] batch object
+     * @param[in] position of message in the batch
+     * @return management error ID
+     * @note Relevant only when message parse return
+     *  PTPMGMT_MNG_PARSE_ERROR_MSG
+     */
+    enum ptpmgmt_managementErrorId_e(*getErrId)(const_ptpmgmt_msg_batch batch,
+        size_t position);
+    /**
+     * Get management TLV of a message
+     * @param[in, out] batch object
+     * @param[in] position of message in the batch
+     * @return pointer to management TLV or null
+     * @note You need to cast to proper structure depends on
+     *  the management TLV ID.
+     * @note the TLV is valid until the next getData() call
+     *  on this batch object, or until the batch parses again,
+     *  is cleared or is freed
+     */
+    const void *(*getData)(ptpmgmt_msg_batch batch, size_t position);
+};
+
+/**
+ * Alocate new message batch structure
+ * @return new message batch structure or null in case of error
+ */
+ptpmgmt_msg_batch ptpmgmt_msg_batch_alloc();
+
+/**
+ * Alocate new message batch structure with parameters
+ * @param[in] prms ptpmgmt_MsgParams
+ * @return new message batch structure or null in case of error
+ */
+ptpmgmt_msg_batch ptpmgmt_msg_batch_alloc_prms(ptpmgmt_cpMsgParams prms);
+
 /** pointer to ptpmgmt TLV allocator structure */
 typedef struct ptpmgmt_tlv_mem_t *ptpmgmt_tlv_mem;
 /** pointer to constant ptpmgmt message structure */
@@ -21,6 +21,7 @@ typedef long ssize_t;
 #endif /* __PTPMGMT_HAVE_SYS_TYPES_H */
 #include "c/cfg.h"
 #include "c/ptp.h"
+#include "c/types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,6 +33,28 @@ typedef struct ptpmgmt_sk_t *ptpmgmt_sk;
 /** pointer to constant ptpmgmt socket structure */
 typedef const struct ptpmgmt_sk_t *const_ptpmgmt_sk;
 
+/**
+ * Datagram entry used for batch send and receive
+ * @note The caller provides the memory buffers
+ */
+struct ptpmgmt_sk_msg_t {
+    void *buf; /**< message memory buffer */
+    size_t bufSize; /**< memory buffer size */
+    size_t len; /**< message length */
+    /**
+     * source address of a received message
+     *  IP address for UDP sockets or source MAC for raw socket
+     */
+    uint8_t from[16];
+    size_t fromLen; /**< source address length */
+};
+
+/** pointer to ptpmgmt datagram entry */
+typedef struct ptpmgmt_sk_msg_t *ptpmgmt_sk_msg;
+
+/** pointer to constant ptpmgmt datagram entry */
+typedef const struct ptpmgmt_sk_msg_t *const_ptpmgmt_sk_msg;
+
 /**
  * The ptpmgmt socket structure hold the socket object
  *  and call backs to call C++ methods
@@ -447,6 +470,205 @@ struct ptpmgmt_sk_t {
      */
     bool (*setSocketPriorityCfg)(ptpmgmt_sk sk, const_ptpmgmt_cfg cfg,
         const char *section);
+    /**
+     * Send a batch of messages using the socket
+     * @param[in] sk socket
+     * @param[in] msgs array of messages, use buf and len
+     * @param[in] count number of messages in array
+     * @return number of messages sent or negative on failure
+     * @note UDP and raw sockets use a single system call
+     *  for up to 64 messages
+     */
+    ssize_t (*sendBatch)(const_ptpmgmt_sk sk, const_ptpmgmt_sk_msg msgs,
+        size_t count);
+    /**
+     * Receive a batch of messages using the socket
+     * @param[in] sk socket
+     * @param[in, out] msgs array of messages, use buf and bufSize,
+     *  set len, from and fromLen
+     * @param[in] count number of messages in array
+     * @param[in] block true, wait till the first packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of messages received or negative on failure
+     * @note Unix socket does not set the source address,
+     *  as it only receives from the peer
+     */
+    ssize_t (*rcvBatch)(const_ptpmgmt_sk sk, ptpmgmt_sk_msg msgs, size_t count,
+        bool block);
+    /**
+     * Filter the received messages in the kernel
+     * @param[in, out] sk socket
+     * @param[in] prms message parameters to filter with
+     * @param[in] useSelfId filter with the target port identity
+     * @return true if filter is set
+     * @note The kernel passes Management messages,
+     *  and signalling messages if the parameters receive them,
+     *  with the parameters domain number and transport specific.
+     * @note With useSelfId, the kernel passes messages with a target port
+     *  identity of the parameters self port identity or the wild card.
+     * @note The filter can be set before or after initializing.
+     */
+    bool (*setFilter)(ptpmgmt_sk sk, ptpmgmt_cpMsgParams prms, bool useSelfId);
+    /**
+     * Remove the received messages filter
+     * @param[in, out] sk socket
+     * @return true if filter is removed
+     */
+    bool (*removeFilter)(ptpmgmt_sk sk);
+    /**
+     * Use kernel timestamps
+     * @param[in, out] sk socket
+     * @param[in] enable true to use kernel timestamps
+     * @param[in] hardware true for the network interface hardware timestamps,
+     *                     false for the kernel software timestamps
+     * @return true if timestamps setting is updated
+     * @note Timestamps setting can not be changed after initializing.
+     *  User can close the socket, change this value, and
+     *  initialize a new socket.
+     * @note Unix socket uses software receive timestamps only.
+     */
+    bool (*setTimestamping)(ptpmgmt_sk sk, bool enable, bool hardware);
+    /**
+     * Query if socket uses kernel timestamps
+     * @param[in] sk socket
+     * @return true if socket uses kernel timestamps
+     */
+    bool (*isTimestamping)(const_ptpmgmt_sk sk);
+    /**
+     * Receive a message with its kernel receive timestamp
+     * @param[in] sk socket
+     * @param[in, out] buf pointer to a memory buffer
+     * @param[in] bufSize memory buffer size
+     * @param[out] ts receive timestamp, zero if the kernel did not stamp
+     * @param[in] block true, wait till a packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of bytes received or negative on failure
+     */
+    ssize_t (*rcvTs)(const_ptpmgmt_sk sk, void *buf, size_t bufSize,
+        struct ptpmgmt_Timestamp_t *ts, bool block);
+    /**
+     * Get ID of the next sent message transmit timestamp
+     * @param[in] sk socket
+     * @return timestamp ID
+     */
+    uint32_t (*getTxId)(const_ptpmgmt_sk sk);
+    /**
+     * Get a sent message kernel transmit timestamp
+     * @param[in] sk socket
+     * @param[out] ts transmit timestamp
+     * @param[out] id sent message timestamp ID
+     * @param[in] block true, wait till a timestamp arrives.
+     *                  false, do not wait, return error
+     *                  if no timestamp available
+     * @return true if a timestamp is received
+     * @note Unix socket does not support transmit timestamps.
+     */
+    bool (*getTxTs)(const_ptpmgmt_sk sk, struct ptpmgmt_Timestamp_t *ts,
+        uint32_t *id, bool block);
+    /**
+     * Set busy poll
+     * @param[in, out] sk socket
+     * @param[in] busy_poll time in microseconds the kernel polls
+     *  the network device for received messages, use 0 to disable
+     * @param[in] prefer_busy_poll prefer busy polling over
+     *  the network device interrupts,
+     *  fails if the system headers do not support it
+     * @param[in] busy_poll_spin time in microseconds poll() spins on
+     *  non blocking receive before it waits, use 0 to disable
+     * @return true if busy poll parameters are updated
+     * @note busy poll can not be changed after initializing.
+     *  User can close the socket, change this value, and
+     *  initialize a new socket.
+     * @note Unix socket does not support busy poll.
+     */
+    bool (*setBusyPoll)(ptpmgmt_sk sk, uint32_t busy_poll,
+        bool prefer_busy_poll, uint32_t busy_poll_spin);
+    /**
+     * Set busy poll using configuration file
+     * @param[in, out] sk socket
+     * @param[in] cfg pointer to configuration file object
+     * @param[in] section in configuration file
+     * @return true if busy poll parameters are updated
+     * @note busy poll can not be changed after initializing.
+     *  User can close the socket, change this value, and
+     *  initialize a new socket.
+     * @note calling with null section will fetch value
+     *  from @"global@" section
+     * @note Unix socket does not support busy poll.
+     */
+    bool (*setBusyPollCfg)(ptpmgmt_sk sk, const_ptpmgmt_cfg cfg,
+        const char *section);
+    /**
+     * Add a network interface using its name
+     * @param[in, out] sk socket
+     * @param[in] ifName interface name
+     * @return true if network interface exists and added.
+     * @note The socket joins the multicast group on the interface
+     *  set with setIf() and on all added interfaces.
+     *  Set the interface with setIf() first.
+     * @note network interfaces can not be changed after initializing.
+     * @note Used by IP sockets only.
+     */
+    bool (*addIfUsingName)(ptpmgmt_sk sk, const char *ifName);
+    /**
+     * Add a network interface using its index
+     * @param[in, out] sk socket
+     * @param[in] ifIndex interface index
+     * @return true if network interface exists and added.
+     * @note network interfaces can not be changed after initializing.
+     * @note Used by IP sockets only.
+     */
+    bool (*addIfUsingIndex)(ptpmgmt_sk sk, int ifIndex);
+    /**
+     * Add a network interface using a network interface object
+     * @param[in, out] sk socket
+     * @param[in] ifObj pointer to initialized network interface object
+     * @return true if network interface exists and added.
+     * @note network interfaces can not be changed after initializing.
+     * @note Used by IP sockets only.
+     */
+    bool (*addIf)(ptpmgmt_sk sk, const_ptpmgmt_ifInfo ifObj);
+    /**
+     * Remove all added network interfaces
+     * @param[in, out] sk socket
+     * @return true if interfaces are removed
+     * @note Used by IP sockets only.
+     */
+    bool (*clearIfs)(ptpmgmt_sk sk);
+    /**
+     * Get the number of network interfaces the socket uses
+     * @param[in] sk socket
+     * @return number of network interfaces
+     * @note Used by IP sockets only.
+     */
+    size_t (*ifsCount)(const_ptpmgmt_sk sk);
+    /**
+     * Send a message through a network interface
+     * @param[in] sk socket
+     * @param[in] msg pointer to message memory buffer
+     * @param[in] len message length
+     * @param[in] ifIndex interface index of the socket interfaces
+     * @return true if message is sent
+     * @note Used by IP sockets only.
+     */
+    bool (*sendIf)(const_ptpmgmt_sk sk, const void *msg, size_t len,
+        int ifIndex);
+    /**
+     * Receive a message and the network interface it arrived on
+     * @param[in] sk socket
+     * @param[in, out] buf pointer to a memory buffer
+     * @param[in] bufSize memory buffer size
+     * @param[out] ifIndex index of the interface the message arrived on
+     * @param[in] block true, wait till a packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of bytes received or negative on failure
+     * @note Used by IP sockets only.
+     */
+    ssize_t (*rcvIf)(const_ptpmgmt_sk sk, void *buf, size_t bufSize,
+        int *ifIndex, bool block);
 };
 
 /**
@@ -45,6 +45,9 @@ class ConfigFile
             udp6_scope_val,
             udp_ttl_val,
             socket_priority_val,
+            busy_poll_val,
+            prefer_busy_poll_val,
+            busy_poll_spin_val,
             network_transport_val,
             active_key_id_val,
             spp_val,
@@ -133,6 +136,27 @@ class ConfigFile
      * @note calling without section will fetch value from @"global@" section
      */
     uint8_t socket_priority(const std::string &section = "") const;
+    /**
+     * Get the busy_poll value
+     * @param[in] section (optional)
+     * @return time in microseconds the kernel busy polls on receive
+     * @note calling without section will fetch value from @"global@" section
+     */
+    uint32_t busy_poll(const std::string &section = "") const;
+    /**
+     * Get the prefer_busy_poll value
+     * @param[in] section (optional)
+     * @return value
+     * @note calling without section will fetch value from @"global@" section
+     */
+    uint8_t prefer_busy_poll(const std::string &section = "") const;
+    /**
+     * Get the busy_poll_spin value
+     * @param[in] section (optional)
+     * @return time in microseconds to spin on receive before waiting
+     * @note calling without section will fetch value from @"global@" section
+     */
+    uint32_t busy_poll_spin(const std::string &section = "") const;
     /**
      * Get the network_transport value
      * @param[in] section (optional)
@@ -242,6 +266,7 @@ class Spp
     bool set_val(char *line);
     void set(long id) { m_own_id = (uint8_t)id; m_keys.clear(); }
     friend class SaFile;
+    friend class HMAC_Cache;
     /**< @endcond */
     #endif
   public:
@@ -308,6 +333,9 @@ class SaFile
 {
   private:
     std::map<uint8_t, Spp> m_spps;
+    #ifndef SWIG
+    friend class HMAC_Cache;
+    #endif
   public:
     /**
      * Read a SA file and parse it
@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Query many local PTP daemons with a single Unix socket
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * @details
+ *  Send the same management request to many Unix socket peers,
+ *  and gather their replies.
+ * @note The gather is available in C++ only.
+ */
+
+#ifndef __PTPMGMT_GATHER_H
+#define __PTPMGMT_GATHER_H
+
+#ifdef __cplusplus
+#include <vector>
+#include "session.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+/** Result of a gathered management request of a single peer */
+struct GatherReply {
+    std::string peer; /**< peer address */
+    bool useAbstract = false; /**< peer uses an abstract socket address */
+    /**
+     * Peer request result
+     * @note The state is SESSION_REPLY, SESSION_TIMEOUT or SESSION_SEND_FAIL
+     */
+    SessionReply reply;
+};
+
+/**
+ * @brief Send a management request to many Unix socket peers
+ * @details
+ *  Use a single bound Unix socket to send the same request to
+ *  all the peers, like a ptp4l instance per network interface or domain.
+ *  Replies are matched to the peers by the reply source address
+ *  and the request sequence ID.
+ *  The first reply of each peer completes the peer request.
+ *
+ *  The query waits till all peers reply or pass their timeout,
+ *  so collecting the state of all peers takes a single round trip.
+ * @note The object is not thread safe.
+ * @note Use getMessage() to set authentication and the message parameters,
+ *  before sending requests.
+ */
+class ManagementGather
+{
+  private:
+    struct Peer {
+        std::string addr;
+        bool useAbstract;
+        uint64_t timeout_ms;
+        UnixPeer peer; /* resolved address */
+    };
+    const SockUnix &m_sock;
+    Message m_msg;
+    PreparedRequest m_req;
+    std::vector<Peer> m_peers;
+    uint16_t m_seq = 0;
+    std::vector<GatherReply> replies(MNG_PARSE_ERROR_e err) const;
+    bool handle(const void *buf, ssize_t msgSize, uint16_t sequence,
+        SessionReply &reply);
+
+  public:
+    /**
+     * Construct a gather
+     * @param[in] sock initialized Unix socket to send and receive with
+     * @note the socket must live longer than the gather
+     * @note the gather receives all messages arriving to the socket
+     *  during a query
+     */
+    ManagementGather(const SockUnix &sock);
+    /**
+     * Construct a gather with message parameters
+     * @param[in] sock initialized Unix socket to send and receive with
+     * @param[in] prms message parameters
+     * @note the socket must live longer than the gather
+     */
+    ManagementGather(const SockUnix &sock, const MsgParams &prms);
+    /**
+     * Get the Message object used for sending and parsing
+     * @return reference to the Message object
+     */
+    Message &getMessage();
+    /**
+     * Add a peer
+     * @param[in] addr peer address
+     * @param[in] timeout_ms peer timeout in milliseconds,
+     *  use 0 for the query timeout
+     * @param[in] useAbstract use Abstract socket address
+     * @return true if peer is added
+     */
+    bool addPeer(const std::string &addr, uint64_t timeout_ms = 0,
+        bool useAbstract = false);
+    /**
+     * Remove a peer
+     * @param[in] addr peer address
+     * @param[in] useAbstract use Abstract socket address
+     * @return true if peer was added
+     */
+    bool removePeer(const std::string &addr, bool useAbstract = false);
+    /**
+     * Remove all peers
+     */
+    void clearPeers();
+    /**
+     * Get number of peers
+     * @return number of peers
+     */
+    size_t peers() const;
+    /**
+     * Send a request to all peers and gather their replies
+     * @param[in] action management action
+     * @param[in] tlv_id management TLV ID
+     * @param[in] timeout_ms timeout in milliseconds of peers without timeout
+     * @param[in] data TLV to send with SET and COMMAND actions
+     * @return result per peer, in the peers order
+     * @note On build failure, all peers result with SESSION_SEND_FAIL.
+     */
+    std::vector<GatherReply> query(actionField_e action, mng_vals_e tlv_id,
+        uint64_t timeout_ms, const BaseMngTlv *data = nullptr);
+    /**
+     * Send a prepared request to all peers and gather their replies
+     * @param[in] req prepared request
+     * @param[in] timeout_ms timeout in milliseconds of peers without timeout
+     * @return result per peer, in the peers order
+     * @note The query sets the request sequence ID.
+     */
+    std::vector<GatherReply> query(PreparedRequest &req, uint64_t timeout_ms);
+};
+
+__PTPMGMT_NAMESPACE_END
+#endif /* __cplusplus */
+
+#endif /* __PTPMGMT_GATHER_H */
@@ -35,6 +35,99 @@ std::string msg2json(const Message &message, int indent = 0);
 std::string tlv2json(mng_vals_e managementId, const BaseMngTlv *tlv,
     int indent = 0);
 
+#ifndef SWIG
+/**
+ * @brief Output of the JSON writer
+ * @details
+ *  The writer collects the JSON in an internal buffer,
+ *  and passes it to the sink in chunks.
+ * @note The sink is available in C++ only.
+ */
+class JsonSink
+{
+  public:
+    virtual ~JsonSink() = default;
+    /**
+     * Write a chunk of JSON
+     * @param[in] str JSON chunk
+     * @param[in] len chunk length
+     * @return true on success
+     * @note On failure, the writer stops calling the sink.
+     */
+    virtual bool write(const char *str, size_t len) = 0;
+};
+
+/** Append the JSON to a string */
+class JsonStrSink : public JsonSink
+{
+  private:
+    std::string &m_str;
+  public:
+    /**
+     * Construct a string sink
+     * @param[in, out] str string to append to
+     */
+    JsonStrSink(std::string &str) : m_str(str) {}
+    bool write(const char *str, size_t len) override;
+};
+
+/** Write the JSON to a caller buffer */
+class JsonBufSink : public JsonSink
+{
+  private:
+    char *m_buf;
+    size_t m_size;
+    size_t m_len = 0;
+  public:
+    /**
+     * Construct a buffer sink
+     * @param[in] buf memory buffer
+     * @param[in] size buffer size
+     * @note The JSON in the buffer is null terminated.
+     */
+    JsonBufSink(char *buf, size_t size);
+    /**
+     * Write a chunk of JSON
+     * @param[in] str JSON chunk
+     * @param[in] len chunk length
+     * @return true on success, false if the buffer is too small
+     */
+    bool write(const char *str, size_t len) override;
+    /**
+     * Get JSON length
+     * @return JSON length, without the null termination
+     */
+    size_t len() const;
+    /**
+     * Empty the buffer, for reuse
+     */
+    void clear();
+};
+
+/**
+ * Convert Message to JSON
+ * @param[in] message received from PTP entity
+ * @param[in, out] sink output of the JSON
+ * @param[in] compact use JSON without white spaces
+ * @param[in] indent base indent for the JSON, ignored in compact
+ * @return true on success, false if the sink fails
+ */
+bool msg2json(const Message &message, JsonSink &sink, bool compact = false,
+    int indent = 0);
+
+/**
+ * Convert PTP management TLV to JSON
+ * @param[in] managementId PTP management TLV id
+ * @param[in] tlv PTP management TLV
+ * @param[in, out] sink output of the JSON
+ * @param[in] compact use JSON without white spaces
+ * @param[in] indent base indent for the JSON, ignored in compact
+ * @return true on success, false if the sink fails
+ */
+bool tlv2json(mng_vals_e managementId, const BaseMngTlv *tlv, JsonSink &sink,
+    bool compact = false, int indent = 0);
+#endif /* SWIG */
+
 /**
  * Parse JSON to PTP management message
  * Class provide converting function and
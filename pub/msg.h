@@ -24,9 +24,17 @@
 __PTPMGMT_NAMESPACE_BEGIN
 
 struct MsgProc;
+struct MngTlvsPool;
 class Message;
 class MessageSigTlvs;
+class MessageBatch;
+class PreparedRequest;
+class ManagementSession;
+class ManagementGather;
+class SigColumns;
+class SockBase;
 struct HMAC_Key;
+class HMAC_Cache;
 
 /**
  * Abstract class used for callback for Signalling TLVs traverse
@@ -97,12 +105,17 @@ class MessageSigTlvs
     Message &m_msg;
     /* hold signalling TLVs */
     std::vector<MessageSigTlv> m_tlvs;
+    /* hold signalling TLVs of previous parse for reuse */
+    std::vector<MessageSigTlv> m_spare;
   protected:
     /** @cond internal */
     friend class Message;
     bool m_lastSig = false; /* indicate last parse was signaling */
     MessageSigTlvs(Message &m) : m_msg(m) {};
-    void clearToUse() { m_tlvs.clear(); m_lastSig = true; }
+    void clearToUse(bool reuse);
+    void clearToVisit();
+    BaseSigTlv *reuse(tlvType_e tlvType);
+    void keep(tlvType_e tlvType, BaseSigTlv *tlv);
     const MANAGEMENT_t *getMng(size_t position) const;
     void push(tlvType_e tlvType, BaseSigTlv *tlv);
 
@@ -214,6 +227,10 @@ class MessageSigTlvs
 class Message
 {
   private:
+    friend class MessageBatch;
+    friend class PreparedRequest;
+    friend class ManagementSession;
+    friend class SessionParse;
 
     /* build parameters */
     actionField_e     m_sendAction = GET;
@@ -237,9 +254,19 @@ class Message
     MessageSigTlvs m_sigTlvs;
     /* parsed management TLV */
     std::unique_ptr<BaseMngTlv> m_dataGet;
+    /* parsed management TLVs kept for reuse */
+    std::unique_ptr<MngTlvsPool> m_pool;
+    /* parsed management TLV dataField, for views */
+    const void       *m_viewData = nullptr;
+    size_t            m_viewSize = 0;
 
     /* Generic */
     MsgParams         m_prms;
+    /* Signalling filter of m_prms, bitmap of the first 64 TLV types
+     *  in each TLV types range, used instead of searching the map */
+    uint64_t          m_allowSigBits[4] = {0, 0, 0, 0};
+    /* Number of allowed TLV types, which are not in the bitmap */
+    size_t            m_allowSigOthers = 0;
 
     /* Authentication TLV */
     uint32_t          m_keyID = 0; /**< Key id used for sending */
@@ -247,6 +274,9 @@ class Message
     SaFile            m_sa; /**< authentication security association pool */
     bool              m_haveAuth = false;  /**< Have Authentication */
     std::unique_ptr<HMAC_Key> m_hmac; /**< sending key HMAC library instance */
+    /* received messages keys HMAC library instances */
+    std::unique_ptr<HMAC_Cache> m_hmacCache;
+    size_t            m_hmacCacheSize = 16;
 
     /* parsing parameters */
     PortIdentity_t    m_peer; /* parsed message peer port id */
@@ -256,15 +286,35 @@ class Message
     managementErrorId_e m_errorId = (managementErrorId_e)0;
     PTPText_t m_errorDisplay;
 
+    /* Parse state shared by the messages of a batch */
+    struct BatchCache;
+
     bool allowedAction(mng_vals_e id, actionField_e action);
+    /* Build the signalling filter bitmap from the parameters */
+    void setSigFilter();
+    bool isSigTlv(tlvType_e type) const;
     /* val in network order */
     static bool findTlvId(uint16_t val, mng_vals_e &rid, implementSpecific_e spec);
+    /* Find reply management ID, use the batch last ID */
+    bool findReplyId(uint16_t val, BatchCache *cache);
     bool checkReplyAction(uint8_t actionField);
-    /* parse signalling message */
-    MNG_PARSE_ERROR_e parseSig(const void *buf, MsgProc *);
+    /* Signalling TLVs visitor */
+    typedef std::function<bool (const Message &msg, tlvType_e tlvType,
+            const BaseSigTlv *tlv)> sigVisit_f;
+    /* parse message, optionally into user TLV or for view only */
+    MNG_PARSE_ERROR_e parseMsg(const void *buf, ssize_t msgSize,
+        BaseMngTlv *into, bool view, const sigVisit_f *visit = nullptr,
+        SigColumns *cols = nullptr, BatchCache *cache = nullptr);
+    /* parse signalling message, optionally visit TLVs while parsing
+     * or decode records into columns */
+    MNG_PARSE_ERROR_e parseSig(const void *buf, MsgProc *,
+        const sigVisit_f *visit, SigColumns *cols);
+    /* verify signalling authentication before visiting TLVs */
+    MNG_PARSE_ERROR_e parseSigAuth(const void *buf, const uint8_t *cur,
+        ssize_t left);
     /* parse authentication message */
     MNG_PARSE_ERROR_e parseAuth(const void *buf, const void *auth, ssize_t left,
-        bool check = false);
+        bool check = false, BatchCache *cache = nullptr);
     /*
      * dataFieldSize() for sending SET/COMMAND
      * Get dataField of current build management ID
@@ -331,6 +381,38 @@ class Message
      * @return true if change success
      */
     bool changeAuth(uint32_t key);
+    /**
+     * Replace the SA and the send key used in the AUTHENTICATION TLVs
+     * @param[in] sa reference to SA file object
+     * @param[in] spp ID to use to send
+     * @param[in] key ID to use to send
+     * @return true if replace success
+     * @note All keys of the new SA are initialized before the replacement,
+     *  keys with the same type and value are kept.
+     *  On failure, the message continues to use the previous SA.
+     */
+    bool rotateAuth(const SaFile &sa, uint8_t spp, uint32_t key);
+    /**
+     * Replace the SA and keep the spp and send key
+     * @param[in] sa reference to SA file object
+     * @return true if replace success
+     * @note The new SA must have the send key.
+     */
+    bool rotateAuth(const SaFile &sa);
+    /**
+     * Initialize all keys of the SA for verifying received messages
+     * @return true if all keys are initialized
+     * @note the keys cache grows to hold all the SA keys
+     */
+    bool preloadAuth();
+    /**
+     * Set the number of keys kept initialized for verifying received messages
+     * @param[in] size number of keys
+     * @return true if size is updated
+     * @note Received messages keys, other than the send key,
+     *  are kept in a least recently used cache.
+     */
+    bool setAuthCacheSize(size_t size);
     /**
      * Disable the use of AUTHENTICATION TLV
      * @return true if disabled
@@ -650,6 +732,137 @@ class Message
      * @return parse error state
      */
     MNG_PARSE_ERROR_e parse(const Buf &buf, ssize_t msgSize);
+    /**
+     * Parse a received raw socket into a user management TLV object
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[out] tlv user management TLV object to fill
+     * @return parse error state
+     * @note the TLV object type must match the management TLV ID
+     *  of the message, otherwise return MNG_PARSE_ERROR_MISMATCH_TLV
+     * @note use getTlvId() to fetch the parsed management TLV ID
+     * @note the function does not allocate a TLV object,
+     *  getData() return null after a successful parse
+     * @note signalling messages are parsed as usual
+     */
+    MNG_PARSE_ERROR_e parse(const void *buf, ssize_t msgSize, BaseMngTlv &tlv);
+    /**
+     * Parse a received raw socket into a user management TLV object
+     * @param[in] buf object with memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[out] tlv user management TLV object to fill
+     * @return parse error state
+     * @note the TLV object type must match the management TLV ID
+     *  of the message, otherwise return MNG_PARSE_ERROR_MISMATCH_TLV
+     * @note use getTlvId() to fetch the parsed management TLV ID
+     * @note the function does not allocate a TLV object,
+     *  getData() return null after a successful parse
+     * @note signalling messages are parsed as usual
+     */
+    MNG_PARSE_ERROR_e parse(const Buf &buf, ssize_t msgSize, BaseMngTlv &tlv);
+    /**
+     * Parse a received raw socket without decoding the management TLV
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @return parse error state
+     * @note use view() to access the management TLV dataField
+     * @note getData() return null after a successful parse
+     * @note signalling messages are parsed as usual
+     */
+    MNG_PARSE_ERROR_e parseView(const void *buf, ssize_t msgSize);
+    /**
+     * Parse a received raw socket without decoding the management TLV
+     * @param[in] buf object with memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @return parse error state
+     * @note use view() to access the management TLV dataField
+     * @note getData() return null after a successful parse
+     * @note signalling messages are parsed as usual
+     */
+    MNG_PARSE_ERROR_e parseView(const Buf &buf, ssize_t msgSize);
+    /**
+     * Parse a received raw socket and visit the signalling TLVs while parsing
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[in] callback function to call with each signalling TLV
+     * @return parse error state
+     * @note The signalling TLVs are not stored,
+     *  getSigTlvsCount() return zero after parsing.
+     * @note The TLV object is valid during the call-back only,
+     *  the object is reused for the next TLV of the same type.
+     * @note stop parsing if the call-back return true
+     * @note The authentication is verified before calling the call-back
+     * @note management messages are parsed as usual
+     */
+    MNG_PARSE_ERROR_e parseVisit(const void *buf, ssize_t msgSize,
+        const std::function<bool (const Message &msg, tlvType_e tlvType,
+            const BaseSigTlv *tlv)> &callback);
+    /**
+     * Parse a received raw socket and visit the signalling TLVs while parsing
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[in] callback object with callback to be called with each TLV
+     * @return parse error state
+     * @note The signalling TLVs are not stored,
+     *  getSigTlvsCount() return zero after parsing.
+     * @note The TLV object is valid during the call-back only,
+     *  the object is reused for the next TLV of the same type.
+     * @note stop parsing if the call-back return true
+     * @note The authentication is verified before calling the call-back
+     * @note management messages are parsed as usual
+     * @note Available for PHP, Perl, Python and Ruby use
+     */
+    MNG_PARSE_ERROR_e parseVisitCl(const void *buf, ssize_t msgSize,
+        MessageSigTlvCallback &callback);
+    /**
+     * Parse a received raw socket and visit the signalling TLVs while parsing
+     * @param[in] buf object with memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[in] callback object with callback to be called with each TLV
+     * @return parse error state
+     * @note The signalling TLVs are not stored,
+     *  getSigTlvsCount() return zero after parsing.
+     * @note The TLV object is valid during the call-back only,
+     *  the object is reused for the next TLV of the same type.
+     * @note stop parsing if the call-back return true
+     * @note The authentication is verified before calling the call-back
+     * @note management messages are parsed as usual
+     * @note Available for PHP, Perl, Python and Ruby use
+     */
+    MNG_PARSE_ERROR_e parseVisitCl(const Buf &buf, ssize_t msgSize,
+        MessageSigTlvCallback &callback);
+    #ifndef SWIG
+    /**
+     * Parse a received raw socket and decode signalling records into columns
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[in, out] cols columns to append the records to
+     * @return parse error state
+     * @note The columns class is defined in @"sigCols.h@" header.
+     * @note The records of TLVs with records arrays are appended to the columns,
+     *  these TLVs are not stored in the message.
+     *  Other signalling TLVs are stored as usual.
+     * @note The authentication is verified before appending any record
+     * @note management messages are parsed as usual
+     */
+    MNG_PARSE_ERROR_e parseColumns(const void *buf, ssize_t msgSize,
+        SigColumns &cols);
+    /**
+     * Parse a received raw socket and decode signalling records into columns
+     * @param[in] buf object with memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @param[in, out] cols columns to append the records to
+     * @return parse error state
+     * @note The columns class is defined in @"sigCols.h@" header.
+     * @note The records of TLVs with records arrays are appended to the columns,
+     *  these TLVs are not stored in the message.
+     *  Other signalling TLVs are stored as usual.
+     * @note The authentication is verified before appending any record
+     * @note management messages are parsed as usual
+     */
+    MNG_PARSE_ERROR_e parseColumns(const Buf &buf, ssize_t msgSize,
+        SigColumns &cols);
+    #endif /* SWIG */
     /**
      * Get last reply management action
      * @return reply management action
@@ -709,8 +922,24 @@ class Message
      * @note You need to cast to proper structure depends on
      *  the management TLV ID.
      * @note You @b should not try to free or change this TLV object
+     * @note With MsgParams reuseTlvs, the TLV object is valid
+     *  till the next parse call
      */
     const BaseMngTlv *getData() const;
+    #ifndef SWIG
+    /**
+     * Get a read only view of last parsed message dataField
+     * @return view of the management TLV dataField
+     * @note The view class is defined in @"mngViews.h@" header.
+     * @note The view is invalid if the management TLV ID does not match
+     *  the view, or if the dataField is too small.
+     * @attention The view points to the parsed message buffer,
+     *  the buffer must remain valid while using the view.
+     */
+    template <typename T> T view() const {
+        return T(m_replayTlv_id, m_viewData, m_viewSize);
+    }
+    #endif /* SWIG */
     /**
      * Get send message dataField
      * @return pointer to send message dataField or null
@@ -815,6 +1044,237 @@ class Message
     const MessageSigTlvs &getSigTlvs() const;
 };
 
+/**
+ * @brief Parse a batch of received PTP management messages
+ * @details
+ *  Parse many received messages, for example from a single recvmmsg call,
+ *  and keep a result per message.
+ *  All messages in the batch are parsed using the same Message object.
+ *  The parameters are checked once per batch.
+ *  The header fields, the management TLV ID and the authentication key
+ *  of the previous message are reused when the next message matches them.
+ *  The management TLV objects are kept per position and are reused
+ *  by the next batch.
+ * @note signalling TLVs are not kept in the batch,
+ *  use the Message object for signalling messages
+ */
+class MessageBatch
+{
+  private:
+    /* Parse result of a single message */
+    struct Rec {
+        MNG_PARSE_ERROR_e err = MNG_PARSE_ERROR_OK;
+        msgType_e type = Management;
+        PortIdentity_t peer;
+        uint16_t sequence = 0;
+        actionField_e replyAction = RESPONSE;
+        mng_vals_e tlvId = NULL_PTP_MANAGEMENT;
+        managementErrorId_e errId = (managementErrorId_e)0;
+        std::unique_ptr<BaseMngTlv> data;
+    };
+    Message m_msg;
+    std::vector<Rec> m_recs;
+    size_t m_count = 0;
+    MNG_PARSE_ERROR_e add(const void *buf, ssize_t msgSize,
+        Message::BatchCache &cache);
+    template <typename T> size_t parseAll(const T *bufs,
+        const ssize_t *sizes, size_t count);
+
+  public:
+    /**
+     * Construct a batch using default parameters
+     * @note the batch set MsgParams reuseTlvs
+     */
+    MessageBatch();
+    /**
+     * Construct a batch with parameters
+     * @param[in] prms message parameters
+     * @note the batch set MsgParams reuseTlvs
+     */
+    MessageBatch(const MsgParams &prms);
+    /**
+     * Get the Message object used for parsing
+     * @return reference to the Message object
+     * @note use to update parameters and authentication
+     */
+    Message &getMessage();
+    /**
+     * Remove all results from the batch
+     * @note management TLV objects are kept for reuse
+     */
+    void clear();
+    /**
+     * Parse a received message and add the result to the batch
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @return parse error state
+     */
+    MNG_PARSE_ERROR_e append(const void *buf, ssize_t msgSize);
+    /**
+     * Parse a received message and add the result to the batch
+     * @param[in] buf object with memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @return parse error state
+     */
+    MNG_PARSE_ERROR_e append(const Buf &buf, ssize_t msgSize);
+    #ifndef SWIG
+    /**
+     * Parse received messages into the batch
+     * @param[in] bufs table of memory buffers containing raw PTP Messages
+     * @param[in] sizes table of received sizes of the PTP Messages
+     * @param[in] count number of messages
+     * @return number of messages parsed successfully
+     * @note the batch is cleared before parsing
+     */
+    size_t parse(const void *const *bufs, const ssize_t *sizes, size_t count);
+    /**
+     * Parse received messages into the batch
+     * @param[in] bufs table of buffer objects containing raw PTP Messages
+     * @param[in] sizes table of received sizes of the PTP Messages
+     * @param[in] count number of messages
+     * @return number of messages parsed successfully
+     * @note the batch is cleared before parsing
+     */
+    size_t parse(const Buf *bufs, const ssize_t *sizes, size_t count);
+    #endif /* SWIG */
+    /**
+     * Get number of results in the batch
+     * @return number of results
+     */
+    size_t size() const;
+    /**
+     * Get parse error state of a message
+     * @param[in] position of message in the batch
+     * @return parse error state
+     * @note return MNG_PARSE_ERROR_UNSUPPORT if position is out of range
+     */
+    MNG_PARSE_ERROR_e getErr(size_t position) const;
+    /**
+     * Get type of a message
+     * @param[in] position of message in the batch
+     * @return message type
+     */
+    msgType_e getType(size_t position) const;
+    /**
+     * Get peer port ID of a message
+     * @param[in] position of message in the batch
+     * @return message peer port ID
+     */
+    const PortIdentity_t &getPeer(size_t position) const;
+    /**
+     * Get sequence number of a message
+     * @param[in] position of message in the batch
+     * @return message sequence number
+     */
+    uint16_t getSequence(size_t position) const;
+    /**
+     * Get reply management action of a message
+     * @param[in] position of message in the batch
+     * @return reply management action
+     */
+    actionField_e getReplyAction(size_t position) const;
+    /**
+     * Get management TLV ID of a message
+     * @param[in] position of message in the batch
+     * @return management TLV ID
+     */
+    mng_vals_e getTlvId(size_t position) const;
+    /**
+     * Get management error ID of a message
+     * @param[in] position of message in the batch
+     * @return management error ID
+     * @note Relevant only when message parse return MNG_PARSE_ERROR_MSG
+     */
+    managementErrorId_e getErrId(size_t position) const;
+    /**
+     * Get management TLV of a message
+     * @param[in] position of message in the batch
+     * @return pointer to management TLV or null
+     * @note You need to cast to proper structure depends on
+     *  the management TLV ID.
+     * @note You @b should not try to free or change this TLV object
+     * @note The TLV object is valid till the next batch parse
+     */
+    const BaseMngTlv *getData(size_t position) const;
+};
+
+/**
+ * @brief Pre-built PTP management request
+ * @details
+ *  Build a management message once and send it many times.
+ *  Only the sequence ID is patched before sending.
+ *  When the message uses authentication, the ICV is recalculated
+ *  over the patched message.
+ *  The request keeps a copy of the message frame and of the sending key,
+ *  it does not depend on the Message object after preparing.
+ * @note prepare again after changing the Message action, parameters
+ *  or authentication.
+ */
+class PreparedRequest
+{
+  private:
+    Buf m_buf;
+    size_t m_len = 0;
+    size_t m_macSize = 0;
+    Binary m_mac;
+    std::unique_ptr<HMAC_Key> m_hmac;
+
+  public:
+    /**
+     * Construct an empty request
+     */
+    PreparedRequest();
+    /**
+     * Construct a request from a message
+     * @param[in] msg message object with the management action to send
+     * @note check isReady() for success
+     */
+    PreparedRequest(Message &msg);
+    ~PreparedRequest();
+    /**
+     * Build the request frame from a message
+     * @param[in] msg message object with the management action to send
+     * @param[in] sequence message sequence
+     * @return parse error state
+     * @note the message object message length is updated
+     */
+    MNG_PARSE_ERROR_e prepare(Message &msg, uint16_t sequence = 0);
+    /**
+     * Query if request frame is ready to send
+     * @return true if request is ready
+     */
+    bool isReady() const;
+    /**
+     * Set the sequence ID of the request frame
+     * @param[in] sequence message sequence
+     * @return parse error state
+     * @note recalculate the ICV if the request uses authentication
+     */
+    MNG_PARSE_ERROR_e setSequence(uint16_t sequence);
+    /**
+     * Get the sequence ID of the request frame
+     * @return message sequence
+     */
+    uint16_t getSequence() const;
+    /**
+     * Get the request frame buffer
+     * @return buffer object with the request frame
+     */
+    const Buf &getBuf() const;
+    /**
+     * Get the request frame length
+     * @return request frame length
+     */
+    size_t getMsgLen() const;
+    /**
+     * Set the sequence ID and send the request frame
+     * @param[in] sock socket to send with
+     * @param[in] sequence message sequence
+     * @return true if request is sent
+     */
+    bool send(const SockBase &sock, uint16_t sequence);
+};
+
 __PTPMGMT_NAMESPACE_END
 #else /* __cplusplus */
 #include "c/msg.h"
@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Poll many sockets, clocks and timers in a single thread
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * @details
+ *  Call back the application when a socket or a clock is ready,
+ *  or when a timer expires.
+ * @note The poller is available in C++ only.
+ */
+
+#ifndef __PTPMGMT_POLLER_H
+#define __PTPMGMT_POLLER_H
+
+#ifdef __cplusplus
+#include <map>
+#include <vector>
+#include <functional>
+#include "sock.h"
+#include "ptp.h"
+#include "session.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+/**
+ * Callback for a ready file description
+ * @param[in] fd file description ready for reading
+ */
+typedef std::function<void(int fd)> PollerCallback;
+
+/**
+ * Callback for an expired timer
+ * @param[in] timerId timer ID
+ */
+typedef std::function<void(int timerId)> PollerTimerCallback;
+
+/**
+ * @brief Poll many file descriptions and timers
+ * @details
+ *  Register sockets, clocks or any other file description with a callback.
+ *  The poller calls the callback when the file description is ready
+ *  for reading.
+ *  Timers call their callback once, or periodically until cancelled.
+ *  Management sessions receive their replies and complete their
+ *  requests on timeout.
+ *
+ *  The application calls dispatch() or run() to wait and
+ *  call the callbacks.
+ * @note Linux only, the poller uses epoll and timerfd.
+ * @note The poller is not thread safe, use it from the polling thread.
+ *  Callbacks may add and remove file descriptions, timers and sessions.
+ */
+class SockPoller
+{
+  private:
+    struct Entry {
+        PollerCallback callback;
+        PollerTimerCallback timerCallback;
+        ManagementSession *session = nullptr;
+        bool isTimer = false;
+        bool periodic = false;
+    };
+    int m_fd = -1;
+    bool m_stop = false;
+    std::map<int, Entry> m_entries;
+    std::vector<ManagementSession *> m_sessions;
+    bool addEntry(int fd, const Entry &entry);
+    bool removeEntry(int fd);
+
+  public:
+    SockPoller();
+    ~SockPoller();
+    /**
+     * Get the poller file description
+     * @return file description or -1 if poller creation failed
+     * @note The file description is ready when any of the
+     *  registered file descriptions or timers is ready.
+     *  Can be used to merge the poller into another polling.
+     */
+    int getFd() const;
+    /**
+     * Register a file description
+     * @param[in] fd file description
+     * @param[in] callback function to call when fd is ready for reading
+     * @return true if file description is registered
+     */
+    bool add(int fd, const PollerCallback &callback);
+    /**
+     * Register a socket
+     * @param[in] sock initialized socket
+     * @param[in] callback function to call when socket is ready for reading
+     * @return true if socket is registered
+     * @note the socket must live longer than its registration
+     */
+    bool add(const SockBase &sock, const PollerCallback &callback);
+    /**
+     * Register a PTP clock
+     * @param[in] clock initialized PTP clock
+     * @param[in] callback function to call when clock is ready for reading
+     * @return true if clock is registered
+     * @note the clock must live longer than its registration
+     */
+    bool add(const PtpClock &clock, const PollerCallback &callback);
+    /**
+     * Register a management session
+     * @param[in] session management session
+     * @return true if session is registered
+     * @note The poller receives the replies from the session socket,
+     *  and waits for the session requests timeout.
+     *  The request callbacks are called from dispatch().
+     * @note the session must live longer than its registration
+     */
+    bool add(ManagementSession &session);
+    /**
+     * Remove a file description
+     * @param[in] fd file description
+     * @return true if file description was registered
+     */
+    bool remove(int fd);
+    /**
+     * Remove a socket
+     * @param[in] sock socket
+     * @return true if socket was registered
+     * @note remove the socket before closing it
+     */
+    bool remove(const SockBase &sock);
+    /**
+     * Remove a PTP clock
+     * @param[in] clock PTP clock
+     * @return true if clock was registered
+     */
+    bool remove(const PtpClock &clock);
+    /**
+     * Remove a management session
+     * @param[in] session management session
+     * @return true if session was registered
+     */
+    bool remove(ManagementSession &session);
+    /**
+     * Add a timer
+     * @param[in] timeout_ms timeout in milliseconds
+     * @param[in] callback function to call when timer expires
+     * @param[in] periodic true, call the callback every timeout
+     *                     false, call the callback once
+     * @return timer ID or negative on failure
+     */
+    int addTimer(uint64_t timeout_ms, const PollerTimerCallback &callback,
+        bool periodic = false);
+    /**
+     * Cancel a timer
+     * @param[in] timerId timer ID
+     * @return true if timer was pending
+     */
+    bool cancelTimer(int timerId);
+    /**
+     * Wait and call the callbacks of the ready file descriptions
+     *  and expired timers
+     * @param[in] timeout_ms timeout in milliseconds.
+     *  use 0 for blocking.
+     * @return number of callbacks called or negative on failure
+     * @note Session requests completion count as callbacks
+     */
+    ssize_t dispatch(uint64_t timeout_ms = 0);
+    /**
+     * Call dispatch() until stop() is called
+     * @return true if stopped, false on failure
+     */
+    bool run();
+    /**
+     * Stop run()
+     * @note call from a callback
+     */
+    void stop();
+};
+
+__PTPMGMT_NAMESPACE_END
+#endif /* __cplusplus */
+
+#endif /* __PTPMGMT_POLLER_H */
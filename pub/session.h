@@ -0,0 +1,261 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Management session with many requests in flight
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * @details
+ *  Send PTP management requests without waiting for the replies.
+ *  Replies are matched to requests by sequence ID and peer port ID.
+ * @note The session is available in C++ only.
+ */
+
+#ifndef __PTPMGMT_SESSION_H
+#define __PTPMGMT_SESSION_H
+
+#ifdef __cplusplus
+#include <map>
+#include <mutex>
+#include <future>
+#include "msg.h"
+#include "sock.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+/** Management session request state */
+enum SessionState_e {
+    SESSION_REPLY, /**< Reply received */
+    SESSION_TIMEOUT, /**< No reply received before the request timeout */
+    SESSION_SEND_FAIL, /**< Fail to build or send the request */
+    SESSION_CANCEL, /**< Request was cancelled */
+};
+
+/** Result of a management session request */
+struct SessionReply {
+    SessionState_e state = SESSION_CANCEL; /**< request state */
+    /** Parse error state of the reply, or build error state */
+    MNG_PARSE_ERROR_e err = MNG_PARSE_ERROR_OK;
+    uint16_t sequence = 0; /**< request sequence ID */
+    PortIdentity_t peer; /**< reply peer port ID */
+    mng_vals_e tlvId = NULL_PTP_MANAGEMENT; /**< reply management TLV ID */
+    actionField_e replyAction = RESPONSE; /**< reply management action */
+    /**
+     * Reply management error ID
+     * @note Relevant only when err is MNG_PARSE_ERROR_MSG
+     */
+    managementErrorId_e errId = (managementErrorId_e)0;
+    uint64_t rtt = 0; /**< round trip time in nanoseconds */
+    /**
+     * Round trip time between the kernel timestamps in nanoseconds
+     * @note Relevant only when the socket uses kernel timestamps
+     *  and the kernel stamps both the request and the reply.
+     *  Zero otherwise.
+     */
+    uint64_t wireRtt = 0;
+    /**
+     * Reply management TLV
+     * @note You need to cast to proper structure depends on tlvId.
+     */
+    std::shared_ptr<BaseMngTlv> data;
+};
+
+/** Round trip time statistics of a management session */
+struct SessionRttStats {
+    size_t count = 0; /**< number of measured replies */
+    uint64_t min = 0; /**< minimum round trip time in nanoseconds */
+    uint64_t max = 0; /**< maximum round trip time in nanoseconds */
+    uint64_t sum = 0; /**< sum of round trip times in nanoseconds */
+    /**
+     * Add a measured round trip time
+     * @param[in] ns round trip time in nanoseconds
+     */
+    void add(uint64_t ns);
+    /**
+     * Get mean round trip time
+     * @return mean round trip time in nanoseconds, zero without replies
+     */
+    uint64_t mean() const { return count > 0 ? sum / count : 0; }
+};
+
+/** Statistics of the replies a management session received */
+struct SessionStats {
+    SessionRttStats rtt; /**< round trip time of all replies */
+    /**
+     * Round trip time between the kernel timestamps
+     * @note Only replies with a wire round trip time are counted
+     */
+    SessionRttStats wireRtt;
+};
+
+/**
+ * Callback for a management session request
+ * @param[in] reply request result
+ */
+typedef std::function<void(const SessionReply &reply)> SessionCallback;
+
+/**
+ * @brief Send management requests and match their replies
+ * @details
+ *  Each request gets a unique sequence ID among the requests in flight.
+ *  A reply completes the request with the same sequence ID,
+ *  if the reply peer port ID match the request target port ID.
+ *  All clocks and all ports in the target match any peer.
+ *  The first matching reply completes the request,
+ *  further replies to the same request are ignored.
+ *  Requests without a reply complete with SESSION_TIMEOUT.
+ *
+ *  The application calls process() to receive the replies,
+ *  callbacks are called and futures are set from process().
+ *
+ *  The session is thread safe, many threads can send requests
+ *  and call process() with the same session.
+ * @note The callbacks are called without holding the session lock,
+ *  a callback may send new requests.
+ * @note Use getMessage() to set authentication and the message parameters,
+ *  before sending requests.
+ * @note When the socket uses kernel timestamps, the session
+ *  measures the round trip time with the request transmit timestamp
+ *  and the reply receive timestamp.
+ */
+class ManagementSession
+{
+  private:
+    /* Request in flight */
+    struct Req {
+        PortIdentity_t target;
+        uint64_t sent; /* nanoseconds */
+        uint64_t deadline; /* nanoseconds */
+        SessionCallback callback;
+        uint32_t txId; /* kernel transmit timestamp ID */
+        Timestamp_t txTs; /* kernel transmit timestamp */
+    };
+    const SockBase &m_sock;
+    Message m_msg;
+    Buf m_buf;
+    std::map<uint16_t, Req> m_reqs;
+    uint16_t m_seq = 0;
+    SessionStats m_stats;
+    mutable std::mutex m_lock;
+    bool send(const PortIdentity_t &target, actionField_e action,
+        mng_vals_e tlv_id, uint64_t timeout_ms, const SessionCallback &callback,
+        const BaseMngTlv *data, SessionReply &reply);
+    bool handle(const void *buf, ssize_t msgSize, const Timestamp_t &rxTs,
+        SessionReply &reply, SessionCallback &callback);
+    ssize_t rcv(void *buf, Timestamp_t &rxTs);
+
+  public:
+    /**
+     * Construct a session
+     * @param[in] sock socket to send and receive with
+     * @note the socket must live longer than the session
+     */
+    ManagementSession(const SockBase &sock);
+    /**
+     * Construct a session with message parameters
+     * @param[in] sock socket to send and receive with
+     * @param[in] prms message parameters
+     * @note the socket must live longer than the session
+     */
+    ManagementSession(const SockBase &sock, const MsgParams &prms);
+    /**
+     * Destruct the session
+     * @note requests in flight are cancelled
+     */
+    ~ManagementSession();
+    /**
+     * Get the Message object used for sending and parsing
+     * @return reference to the Message object
+     * @attention do not change the message while requests are sent
+     *  or replies are processed
+     */
+    Message &getMessage();
+    /**
+     * Send a request and get its result with a callback
+     * @param[in] target target port ID
+     * @param[in] action management action
+     * @param[in] tlv_id management TLV ID
+     * @param[in] timeout_ms request timeout in milliseconds
+     * @param[in] callback function to call with the request result
+     * @param[in] data TLV to send with SET and COMMAND actions
+     * @return true if request is sent
+     * @note on failure the callback is not called
+     */
+    bool request(const PortIdentity_t &target, actionField_e action,
+        mng_vals_e tlv_id, uint64_t timeout_ms, const SessionCallback &callback,
+        const BaseMngTlv *data = nullptr);
+    /**
+     * Send a request and get its result with a future
+     * @param[in] target target port ID
+     * @param[in] action management action
+     * @param[in] tlv_id management TLV ID
+     * @param[in] timeout_ms request timeout in milliseconds
+     * @param[in] data TLV to send with SET and COMMAND actions
+     * @return future of the request result
+     * @note on failure the future is ready with SESSION_SEND_FAIL
+     * @attention the future is set from process(),
+     *  do not wait for it in the only thread calling process()
+     */
+    std::future<SessionReply> requestFuture(const PortIdentity_t &target,
+        actionField_e action, mng_vals_e tlv_id, uint64_t timeout_ms,
+        const BaseMngTlv *data = nullptr);
+    /**
+     * Receive replies and complete requests
+     * @param[in] timeout_ms maximum time to wait for replies in milliseconds
+     * @return number of requests completed
+     * @note with zero timeout, process only the received replies
+     * @note return before the timeout, once there are no requests in flight
+     */
+    size_t process(uint64_t timeout_ms = 0);
+    /**
+     * Complete a request using a received message
+     * @param[in] buf memory buffer containing the raw PTP Message
+     * @param[in] msgSize received size of PTP Message
+     * @return true if the message completes a request
+     * @note use when the application receives from the socket
+     */
+    bool handle(const void *buf, ssize_t msgSize);
+    /**
+     * Complete the requests that passed their timeout
+     * @return number of requests completed
+     */
+    size_t expire();
+    /**
+     * Cancel all requests in flight
+     * @return number of requests cancelled
+     */
+    size_t cancel();
+    /**
+     * Get number of requests in flight
+     * @return number of requests
+     */
+    size_t pending() const;
+    /**
+     * Get time till the first request timeout
+     * @param[out] timeout_ms time in milliseconds, rounded up
+     * @return true if there are requests in flight
+     * @note use to wait for replies in an application polling loop
+     */
+    bool nextTimeout(uint64_t &timeout_ms) const;
+    /**
+     * Get round trip time statistics of the replies
+     * @return statistics since the session start or the last reset
+     */
+    SessionStats getStats() const;
+    /**
+     * Reset round trip time statistics
+     */
+    void resetStats();
+    /**
+     * Get the socket used by the session
+     * @return reference to the socket object
+     */
+    const SockBase &getSocket() const;
+};
+
+__PTPMGMT_NAMESPACE_END
+#endif /* __cplusplus */
+
+#endif /* __PTPMGMT_SESSION_H */
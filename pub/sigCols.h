@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Signalling TLV records in columns
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * @details
+ *  Decode the records of the signalling TLVs with records arrays
+ *  into contiguous arrays, an array per record field.
+ *  Records of successive messages are appended to the arrays.
+ * @note The columns are available in C++ only.
+ */
+
+#ifndef __PTPMGMT_SIG_COLS_H
+#define __PTPMGMT_SIG_COLS_H
+
+#ifdef __cplusplus
+#include <vector>
+#include "msg.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+/** Timestamps column */
+struct TimestampColumn {
+    std::vector<UInteger48_t> secondsField; /**< seconds */
+    std::vector<UInteger32_t> nanosecondsField; /**< nanoseconds */
+};
+
+/** SLAVE_RX_SYNC_TIMING_DATA TLV records in columns */
+struct SLAVE_RX_SYNC_TIMING_DATA_cols_t {
+    /** Port identity of the last received sync message. */
+    PortIdentity_t syncSourcePortIdentity;
+    std::vector<UInteger16_t> sequenceId; /**< Sequence of the sync message */
+    /** sync Event Egress Timestamp value */
+    TimestampColumn syncOriginTimestamp;
+    /** aggregate value of the correctionField in scaled nanoseconds */
+    std::vector<Integer64_t> totalCorrectionField;
+    /** scaled Cumulative Rate Offset value */
+    std::vector<Integer32_t> scaledCumulativeRateOffset;
+    /** sync Event Ingress Timestamp value */
+    TimestampColumn syncEventIngressTimestamp;
+};
+
+/** SLAVE_RX_SYNC_COMPUTED_DATA TLV records in columns */
+struct SLAVE_RX_SYNC_COMPUTED_DATA_cols_t {
+    /** Port identity of the last received sync message. */
+    PortIdentity_t sourcePortIdentity;
+    /** Bit fields computedFlags of the last TLV */
+    uint8_t computedFlags = 0;
+    std::vector<UInteger16_t> sequenceId; /**< Sequence of the sync message */
+    /** offsetFromMaster in scaled nanoseconds */
+    std::vector<Integer64_t> offsetFromMaster;
+    /** meanPathDelay in scaled nanoseconds */
+    std::vector<Integer64_t> meanPathDelay;
+    /** scaledNeighborRateRatio */
+    std::vector<Integer32_t> scaledNeighborRateRatio;
+};
+
+/** SLAVE_TX_EVENT_TIMESTAMPS TLV records in columns */
+struct SLAVE_TX_EVENT_TIMESTAMPS_cols_t {
+    /** Port identity of the last transmitted event message. */
+    PortIdentity_t sourcePortIdentity;
+    /** Event massage type of the last TLV */
+    msgType_e eventMessageType = Sync;
+    std::vector<UInteger16_t> sequenceId; /**< Sequence of the event message */
+    /** egress Timestamp acquired for the event message */
+    TimestampColumn eventEgressTimestamp;
+};
+
+/**
+ * SLAVE_DELAY_TIMING_DATA_NP TLV records in columns
+ * @note linuxptp implementation specific
+ */
+struct SLAVE_DELAY_TIMING_DATA_NP_cols_t {
+    /** Port identity of the last message. */
+    PortIdentity_t sourcePortIdentity;
+    std::vector<UInteger16_t> sequenceId; /**< Sequence of the message */
+    /** delay Origin Timestamp value */
+    TimestampColumn delayOriginTimestamp;
+    /** aggregate value of the correctionField in scaled nanoseconds */
+    std::vector<Integer64_t> totalCorrectionField;
+    /** delay Response Timestamp */
+    TimestampColumn delayResponseTimestamp;
+};
+
+/**
+ * @brief Signalling TLVs records in columns
+ * @details
+ *  Message::parseColumns() appends the records of
+ *  SLAVE_RX_SYNC_TIMING_DATA, SLAVE_RX_SYNC_COMPUTED_DATA,
+ *  SLAVE_TX_EVENT_TIMESTAMPS and SLAVE_DELAY_TIMING_DATA_NP TLVs
+ *  to the columns of the TLV type.
+ *  The columns of a TLV type have the same number of records.
+ * @note Use trim() to keep a window of the last records.
+ */
+class SigColumns
+{
+  private:
+    /**< @cond internal */
+    friend class Message;
+    /* Append the records of a TLV dataField */
+    MNG_PARSE_ERROR_e append(tlvType_e tlvType, const uint8_t *cur, size_t len);
+    /**< @endcond */
+
+  public:
+    /** SLAVE_RX_SYNC_TIMING_DATA records */
+    SLAVE_RX_SYNC_TIMING_DATA_cols_t rxSyncTiming;
+    /** SLAVE_RX_SYNC_COMPUTED_DATA records */
+    SLAVE_RX_SYNC_COMPUTED_DATA_cols_t rxSyncComputed;
+    /** SLAVE_TX_EVENT_TIMESTAMPS records */
+    SLAVE_TX_EVENT_TIMESTAMPS_cols_t txEventTimestamps;
+    /** SLAVE_DELAY_TIMING_DATA_NP records */
+    SLAVE_DELAY_TIMING_DATA_NP_cols_t delayTiming;
+    /**
+     * Is TLV type decoded into columns
+     * @param[in] tlvType signalling TLV type
+     * @param[in] spec implementation specific
+     * @return true if the TLV records are decoded into columns
+     */
+    static bool isColumnsTlv(tlvType_e tlvType, implementSpecific_e spec);
+    /**
+     * Get number of records of a TLV type
+     * @param[in] tlvType signalling TLV type
+     * @return number of records
+     */
+    size_t size(tlvType_e tlvType) const;
+    /**
+     * Keep only the last records of each TLV type
+     * @param[in] maxRecords maximum number of records to keep
+     */
+    void trim(size_t maxRecords);
+    /**
+     * Remove all records
+     */
+    void clear();
+};
+
+__PTPMGMT_NAMESPACE_END
+#endif /* __cplusplus */
+
+#endif /* __PTPMGMT_SIG_COLS_H */
@@ -20,6 +20,8 @@
 #define __PTPMGMT_SOCK_H
 
 #ifdef __cplusplus
+#include <vector>
+#include <functional>
 #include "buf.h"
 #ifdef __PTPMGMT_HAVE_SYS_UN_H
 #include <sys/un.h>
@@ -29,12 +31,131 @@
 #endif
 #ifdef __linux__
 #include <linux/if_packet.h>
+#include <linux/filter.h>
 #endif
 #include "cfg.h"
 #include "ptp.h"
+#include "types.h"
 
 __PTPMGMT_NAMESPACE_BEGIN
 
+class SockUring;
+
+#ifndef SWIG
+/**
+ * @brief Datagram entry used for batch send and receive
+ * @details
+ *  The caller provides the memory buffers.
+ *  The structure has the same layout as the C ptpmgmt_sk_msg_t structure.
+ */
+struct SockMsg {
+    void *buf; /**< message memory buffer */
+    size_t bufSize; /**< memory buffer size */
+    size_t len; /**< message length */
+    /**
+     * source address of a received message
+     *  IP address for UDP sockets or source MAC for raw socket
+     */
+    uint8_t from[16];
+    size_t fromLen; /**< source address length */
+};
+
+/**
+ * Callback for a message received without copy
+ * @param[in] msg received message
+ * @note the message buffer is valid during the callback only
+ */
+typedef std::function<void(const SockMsg &msg)> SockMsgCallback;
+
+/**
+ * @brief Resolved Unix socket address
+ * @details
+ *  Resolve a Unix socket address once, and use it to send messages
+ *  and to match the source address of received messages,
+ *  without string conversions.
+ * @note Abstract addresses are kept with the leading zero byte,
+ *  like getLastFrom().
+ */
+class UnixPeer
+{
+  private:
+    sockaddr_un m_addr;
+    size_t m_len = 0; /* address length without the padding zeros */
+    friend class SockUnix;
+    friend class SockUring;
+    void setLen(size_t addrLen);
+
+  public:
+    /** Hash functor for unordered containers */
+    struct Hash {
+        /**
+         * Get hash of address
+         * @param[in] peer address
+         * @return hash value
+         */
+        size_t operator()(const UnixPeer &peer) const { return peer.hash(); }
+    };
+    UnixPeer();
+    /**
+     * Construct a resolved address
+     * @param[in] addr Unix socket address (socket file)
+     * @param[in] useAbstract use Abstract socket address
+     * @note the object is empty if the address is invalid
+     */
+    UnixPeer(const std::string &addr, bool useAbstract = false);
+    /**
+     * Resolve an address
+     * @param[in] addr Unix socket address (socket file)
+     * @param[in] useAbstract use Abstract socket address
+     * @return true if address is valid
+     */
+    bool set(const std::string &addr, bool useAbstract = false);
+    /**
+     * Clear the address
+     */
+    void clear();
+    /**
+     * Query if address is empty
+     * @return true if address is empty
+     */
+    bool empty() const;
+    /**
+     * Query if address is abstract
+     * @return true if address is abstract
+     */
+    bool isAbstract() const;
+    /**
+     * Get address as string
+     * @return Unix socket address
+     * @note Abstract address starts with a zero byte.
+     */
+    std::string str() const;
+    /**
+     * Get hash of address
+     * @return hash value
+     */
+    size_t hash() const;
+    /**
+     * Compare addresses
+     * @param[in] other address to compare
+     * @return true if addresses are identical
+     */
+    bool operator==(const UnixPeer &other) const;
+    /**
+     * Compare addresses
+     * @param[in] other address to compare
+     * @return true if addresses are different
+     */
+    bool operator!=(const UnixPeer &other) const { return !(*this == other); }
+    /**
+     * Order addresses
+     * @param[in] other address to compare
+     * @return true if address is smaller than other
+     */
+    bool operator<(const UnixPeer &other) const;
+};
+#endif /* SWIG */
+
 /**
  * @brief Base class for all sockets
  * @details
@@ -50,9 +171,25 @@ class SockBase
     bool sendReply(ssize_t cnt, size_t len) const;
     virtual bool sendBase(const void *msg, size_t len) const = 0;
     virtual ssize_t rcvBase(void *buf, size_t bufSize, bool block) const = 0;
+    virtual ssize_t sendBatchBase(const SockMsg *msgs, size_t count) const;
+    virtual ssize_t rcvBatchBase(SockMsg *msgs, size_t count, bool block) const;
     virtual bool initBase() = 0;
     virtual void closeChild() {}
     void closeBase();
+    /* Kernel timestamps */
+    bool m_useTs = false;
+    bool m_hwTs = false;
+    bool m_txTs = false; /* socket receives transmit timestamps */
+    mutable uint32_t m_txId = 0; /* ID of next sent message timestamp */
+    virtual bool initTs();
+    virtual ssize_t rcvTsBase(void *buf, size_t bufSize, bool block,
+        Timestamp_t &ts) const;
+    /*
+     * Spin before poll, return true if a message is ready
+     * Subtract the spin time from the timeout, zero timeout blocks
+     */
+    virtual bool busyWait(uint64_t &timeout_ns) const;
+    friend class SockUring;
     /**< @endcond */
 
   public:
@@ -124,6 +261,106 @@ class SockBase
      * @note identical to rcv. Some scripts fail to match proper function
      */
     ssize_t rcvBuf(Buf &buf, bool block = false) const;
+    #ifndef SWIG
+    /**
+     * Send a batch of messages using the socket
+     * @param[in] msgs array of messages, use buf and len
+     * @param[in] count number of messages in array
+     * @return number of messages sent or negative on failure
+     * @note UDP and raw sockets use a single system call
+     *  for up to 64 messages
+     * @note Stop at the first message not sent in full
+     */
+    ssize_t sendBatch(const SockMsg *msgs, size_t count) const;
+    /**
+     * Receive a batch of messages using the socket
+     * @param[in, out] msgs array of messages, use buf and bufSize,
+     *  set len, from and fromLen
+     * @param[in] count number of messages in array
+     * @param[in] block true, wait till the first packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of messages received or negative on failure
+     * @note UDP and raw sockets use a single system call
+     *  for up to 64 messages
+     * @note Unix socket does not set the source address,
+     *  as it only receives from the peer
+     * @note Truncated messages and frames without a message are dropped,
+     *  the following messages take their place in the array
+     */
+    ssize_t rcvBatch(SockMsg *msgs, size_t count, bool block = false) const;
+    /**
+     * Use kernel timestamps
+     * @param[in] enable true to use kernel timestamps
+     * @param[in] hardware true for the network interface hardware timestamps,
+     *                     false for the kernel software timestamps
+     * @return true if timestamps setting is updated
+     * @note Timestamps setting can not be changed after initializing.
+     *  User can close the socket, change this value, and
+     *  initialize a new socket.
+     * @note Hardware timestamps use the interface PTP clock.
+     *  The interface should be configured to time stamp all packets,
+     *  like ptp4l does with 'hwts_filter full'.
+     * @note Unix socket uses software receive timestamps only.
+     *  The kernel stamps the message when the peer sends it.
+     * @note With transmit timestamps the socket polls with an error,
+     *  fetch the timestamps with getTxTs().
+     */
+    bool setTimestamping(bool enable, bool hardware = false);
+    /**
+     * Query if socket uses kernel timestamps
+     * @return true if socket uses kernel timestamps
+     */
+    bool isTimestamping() const;
+    /**
+     * Query if socket uses hardware timestamps
+     * @return true if socket uses hardware timestamps
+     */
+    bool isHwTimestamping() const;
+    /**
+     * Receive a message with its kernel receive timestamp
+     * @param[in, out] buf pointer to a memory buffer
+     * @param[in] bufSize memory buffer size
+     * @param[out] ts receive timestamp, zero if the kernel did not stamp
+     * @param[in] block true, wait till a packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of bytes received or negative on failure
+     * @note Software timestamps use the system clock.
+     */
+    ssize_t rcvTs(void *buf, size_t bufSize, Timestamp_t &ts,
+        bool block = false) const;
+    /**
+     * Receive a message with its kernel receive timestamp
+     * @param[in, out] buf object with message memory buffer
+     * @param[out] ts receive timestamp, zero if the kernel did not stamp
+     * @param[in] block true, wait till a packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of bytes received or negative on failure
+     */
+    ssize_t rcvTs(Buf &buf, Timestamp_t &ts, bool block = false) const;
+    /**
+     * Get ID of the next sent message transmit timestamp
+     * @return timestamp ID
+     * @note The kernel counts the messages sent since initializing.
+     *  Messages sent not using this object are counted as well.
+     */
+    uint32_t getTxId() const;
+    /**
+     * Get a sent message kernel transmit timestamp
+     * @param[out] ts transmit timestamp
+     * @param[out] id sent message timestamp ID
+     * @param[in] block true, wait till a timestamp arrives.
+     *                  false, do not wait, return error
+     *                  if no timestamp available
+     * @return true if a timestamp is received
+     * @note The kernel send the timestamps in the error queue,
+     *  not necessarily in the order the messages are sent.
+     * @note Unix socket does not support transmit timestamps.
+     */
+    bool getTxTs(Timestamp_t &ts, uint32_t &id, bool block = false) const;
+    #endif /* SWIG */
     /**
      * Get socket file description
      * @return socket file description
@@ -151,6 +388,7 @@ class SockBase
      * @note If user need multiple socket,
      *  then fetch the file description with fileno()
      *  And implement it, or merge it into an existing polling
+     * @note With busy poll spin, the function spins before it waits.
      * @note Python: when building with 'PY_USE_S_THRD'
      *  using Python 'Global Interpreter Lock'.
      *  Which use mutex on all library functions.
@@ -192,15 +430,19 @@ class SockUnix : public SockBase
   private:
     static std::string m_homeDir;
     std::string m_me, m_peer, m_lastFrom;
-    sockaddr_un m_peerAddr;
+    UnixPeer m_peerAddr;
     bool setPeerInternal(const std::string &str, bool useAbstract);
     bool sendAny(const void *msg, size_t len, const sockaddr_un &addr) const;
     static void setUnixAddr(sockaddr_un &addr, const std::string &str);
+    friend class SockUring;
 
     bool sendBase(const void *msg, size_t len) const override final;
     ssize_t rcvBase(void *buf, size_t bufSize, bool block) const override final;
     bool initBase() override final;
     void closeChild() override final;
+    bool initTs() override final;
+    ssize_t rcvTsBase(void *buf, size_t bufSize, bool block,
+        Timestamp_t &ts) const override final;
 
   public:
     SockUnix();
@@ -312,6 +554,31 @@ class SockUnix : public SockBase
      */
     bool sendTo(const Buf &buf, size_t len, const std::string &addrStr,
         bool useAbstract = false) const;
+    #ifndef SWIG
+    /**
+     * Send the message using the socket to a resolved address
+     * @param[in] msg pointer to message memory buffer
+     * @param[in] len message length
+     * @param[in] peer resolved Unix socket address
+     * @return true if message is sent
+     * @note true does @b NOT guarantee the frame was successfully
+     *  arrives its target. Only the network layer sends it.
+     */
+    bool sendTo(const void *msg, size_t len, const UnixPeer &peer) const;
+    /**
+     * Receive a message using the socket from any address
+     * @param[in, out] buf pointer to a memory buffer
+     * @param[in] bufSize memory buffer size
+     * @param[out] from resolved origin address
+     * @param[in] block true, wait till a packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of bytes received or negative on failure
+     * @note The function does not allocate memory.
+     */
+    ssize_t rcvFrom(void *buf, size_t bufSize, UnixPeer &from,
+        bool block = false) const;
+    #endif /* SWIG */
     /**
      * Receive a message using the socket from any address
      * @param[in, out] buf pointer to a memory buffer
@@ -413,6 +680,19 @@ class SockBaseIf : public SockBase
     bool setInt(const IfInfo &ifObj);
     SockBaseIf() = default;
     virtual bool setAllBase(const ConfigFile &cfg, const std::string &section) = 0;
+    /* Kernel filter of received messages */
+    MsgParams m_filterPrms;
+    bool m_useFilter = false;
+    bool m_filterSelfId = false;
+    void ptpFilter(std::vector<sock_filter> &code, size_t offset) const;
+    virtual bool attachFilter() const = 0;
+    /* Busy poll */
+    int m_busyPoll = 0; /* microseconds */
+    bool m_preferBusyPoll = false;
+    uint32_t m_busySpin = 0; /* microseconds */
+    bool initBusyPoll() const;
+    bool busyWait(uint64_t &timeout_ns) const override final;
+    virtual bool rcvReady() const;
     /**< @endcond */
 
   public:
@@ -471,6 +751,54 @@ class SockBaseIf : public SockBase
      */
     bool setAllInit(const IfInfo &ifObj, const ConfigFile &cfg,
         const std::string &section = "");
+    /**
+     * Filter the received messages in the kernel
+     * @param[in] prms message parameters to filter with
+     * @param[in] useSelfId filter with the target port identity
+     * @return true if filter is set
+     * @note The kernel passes Management messages,
+     *  and signalling messages if the parameters receive them,
+     *  with the parameters domain number and transport specific.
+     * @note With useSelfId, the kernel passes messages with a target port
+     *  identity of the parameters self port identity or the wild card.
+     * @note The filter can be set before or after initializing.
+     */
+    bool setFilter(const MsgParams &prms, bool useSelfId = false);
+    /**
+     * Remove the received messages filter
+     * @return true if filter is removed
+     */
+    bool removeFilter();
+    /**
+     * Set busy poll
+     * @param[in] busy_poll time in microseconds the kernel polls
+     *  the network device for received messages, use 0 to disable
+     * @param[in] prefer_busy_poll prefer busy polling over
+     *  the network device interrupts,
+     *  fails if the system headers do not support it
+     * @param[in] busy_poll_spin time in microseconds poll() spins on
+     *  non blocking receive before it waits, use 0 to disable
+     * @return true if busy poll parameters are updated
+     * @note busy poll can not be changed after initializing.
+     *  User can close the socket, change this value, and
+     *  initialize a new socket.
+     * @note Busy polling reduces the receive latency on the cost of CPU time.
+     *  Setting busy poll time above the net.core.busy_read kernel parameter
+     *  requires the CAP_NET_ADMIN capability.
+     */
+    bool setBusyPoll(uint32_t busy_poll, bool prefer_busy_poll = false,
+        uint32_t busy_poll_spin = 0);
+    /**
+     * Set busy poll using configuration file
+     * @param[in] cfg reference to configuration file object
+     * @param[in] section in configuration file
+     * @return true if busy poll parameters are updated
+     * @note busy poll can not be changed after initializing.
+     *  User can close the socket, change this value, and
+     *  initialize a new socket.
+     * @note calling without section will fetch value from @"global@" section
+     */
+    bool setBusyPoll(const ConfigFile &cfg, const std::string &section = "");
 };
 
 /**
@@ -489,11 +817,22 @@ class SockIp : public SockBaseIf
     size_t m_addr_len;
     const char *m_mcast_str; /* string form */
     Binary m_mcast;
+    std::vector<int> m_ifs; /* additional interfaces */
     SockIp(int domain, const char *mcast, sockaddr *addr, size_t len);
+    bool addInt(const IfInfo &ifObj);
+    bool hasIf(int ifIndex) const;
+    friend class SockUring;
     virtual bool initIp() = 0;
     bool sendBase(const void *msg, size_t len) const override final;
     ssize_t rcvBase(void *buf, size_t bufSize, bool block) const override final;
+    ssize_t sendBatchBase(const SockMsg *msgs,
+        size_t count) const override final;
+    ssize_t rcvBatchBase(SockMsg *msgs, size_t count,
+        bool block) const override final;
     bool initBase() override final;
+    bool attachFilter() const override final;
+    ssize_t rcvTsBase(void *buf, size_t bufSize, bool block,
+        Timestamp_t &ts) const override final;
     /**< @endcond */
 
   public:
@@ -519,6 +858,68 @@ class SockIp : public SockBaseIf
      * @note calling without section will fetch value from @"global@" section
      */
     bool setUdpTtl(const ConfigFile &cfg, const std::string &section = "");
+    /**
+     * Add a network interface using its name
+     * @param[in] ifName interface name
+     * @return true if network interface exists and added.
+     * @note The socket joins the multicast group on the interface
+     *  set with setIf() and on all added interfaces.
+     *  Set the interface with setIf() first.
+     * @note network interfaces can not be changed after initializing.
+     *  User can close the socket, change the interfaces, and
+     *  initialize a new socket.
+     */
+    bool addIfUsingName(const std::string &ifName);
+    /**
+     * Add a network interface using its index
+     * @param[in] ifIndex interface index
+     * @return true if network interface exists and added.
+     * @note network interfaces can not be changed after initializing.
+     */
+    bool addIfUsingIndex(int ifIndex);
+    /**
+     * Add a network interface using a network interface object
+     * @param[in] ifObj initialized network interface object
+     * @return true if network interface exists and added.
+     * @note network interfaces can not be changed after initializing.
+     */
+    bool addIf(const IfInfo &ifObj);
+    /**
+     * Remove all added network interfaces
+     * @return true if interfaces are removed
+     * @note network interfaces can not be changed after initializing.
+     */
+    bool clearIfs();
+    /**
+     * Get the number of network interfaces the socket uses
+     * @return number of network interfaces
+     */
+    size_t ifsCount() const;
+    /**
+     * Send a message through a network interface
+     * @param[in] msg pointer to message memory buffer
+     * @param[in] len message length
+     * @param[in] ifIndex interface index of the socket interfaces
+     * @return true if message is sent
+     * @note The kernel selects the source address of the interface.
+     */
+    bool sendIf(const void *msg, size_t len, int ifIndex) const;
+#ifndef SWIG
+    /**
+     * Receive a message and the network interface it arrived on
+     * @param[in, out] buf pointer to a memory buffer
+     * @param[in] bufSize memory buffer size
+     * @param[out] ifIndex index of the interface the message arrived on
+     * @param[in] block true, wait till a packet arrives.
+     *                  false, do not wait, return error
+     *                  if no packet available
+     * @return number of bytes received or negative on failure
+     * @note With added interfaces, the socket is not bound to a single
+     *  interface, and receives the multicast messages of all its interfaces.
+     */
+    ssize_t rcvIf(void *buf, size_t bufSize, int &ifIndex,
+        bool block = false) const;
+#endif /* SWIG */
 };
 
 /**
@@ -586,15 +987,44 @@ class SockRaw : public SockBaseIf
     int m_socket_priority = -1;
     sockaddr_ll m_addr = {0};
     ethhdr m_hdr;
+    friend class SockUring;
+    /* TPACKET_V3 receive ring */
+    size_t m_ringBlockSize = 0;
+    size_t m_ringBlocksNum = 0;
+    uint32_t m_ringTimeout = 0;
+    uint8_t *m_ring = nullptr;
+    mutable size_t m_ringBlock = 0; /* current block */
+    mutable size_t m_ringLeft = 0; /* frames left in current block */
+    mutable uint8_t *m_ringFrame = nullptr; /* next frame in current block */
+    mutable uint64_t m_rxPackets = 0;
+    mutable uint64_t m_rxDrops = 0;
 
     bool setAllBase(const ConfigFile &cfg,
         const std::string &section) override final;
     bool sendBase(const void *msg, size_t len) const override final;
     ssize_t rcvBase(void *buf, size_t bufSize, bool block) const override final;
+    ssize_t sendBatchBase(const SockMsg *msgs,
+        size_t count) const override final;
+    ssize_t rcvBatchBase(SockMsg *msgs, size_t count,
+        bool block) const override final;
     bool initBase() override final;
+    bool attachFilter() const override final;
+    void closeChild() override final;
+    bool initTs() override final;
+    ssize_t rcvTsBase(void *buf, size_t bufSize, bool block,
+        Timestamp_t &ts) const override final;
+    ssize_t rcvMsg(void *buf, size_t bufSize, bool block,
+        Timestamp_t *ts) const;
+    bool initRing();
+    void closeRing();
+    const uint8_t *ringNext(bool block) const;
+    bool ringMsg(const uint8_t *frame, SockMsg &msg) const;
+    void ringDone() const;
+    bool rcvReady() const override final;
 
   public:
     SockRaw();
+    ~SockRaw();
     /**
      * Set PTP multicast address using string from
      * @param[in] string address in a string object
@@ -658,6 +1088,51 @@ class SockRaw : public SockBaseIf
      * @note calling without section will fetch value from @"global@" section
      */
     bool setSocketPriority(const ConfigFile &cfg, const std::string &section = "");
+#ifndef SWIG
+    /**
+     * Set a TPACKET_V3 receive ring
+     * @param[in] blockSize block size in bytes,
+     *  a power of 2 and a multiple of the page size
+     * @param[in] blocksNum number of blocks, use 0 to receive without a ring
+     * @param[in] timeout_ms time to wait before the kernel returns
+     *  a partially filled block, use 0 for the kernel default
+     * @return true if receive ring parameters are updated
+     * @note receive ring can not be changed after initializing.
+     *  User can close the socket, change this value, and
+     *  initialize a new socket.
+     * @note The kernel receives the frames directly into the ring
+     *  mapped memory. rcv() and rcvBatch() copy the frames from the ring,
+     *  rcvRing() uses the frames in place.
+     */
+    bool setRxRing(size_t blockSize, size_t blocksNum, uint32_t timeout_ms = 0);
+    /**
+     * Query if socket uses a receive ring
+     * @return true if socket is initialized with a receive ring
+     */
+    bool isRxRing() const;
+    /**
+     * Receive messages from the receive ring without copy
+     * @param[in] callback function to call with each message
+     * @param[in] block true, wait till a block of frames is ready.
+     *                  false, do not wait
+     * @return number of messages received or negative on failure
+     * @note The callback is called with the messages of a single block.
+     *  The block is returned to the kernel when the function returns.
+     * @note the message buffer points to the PTP message in the ring,
+     *  the source address is the source MAC address.
+     */
+    ssize_t rcvRing(const SockMsgCallback &callback, bool block = false) const;
+    /**
+     * Get the socket receive statistics
+     * @param[out] packets number of frames the kernel received,
+     *  including the dropped frames
+     * @param[out] drops number of frames dropped, as the receive ring
+     *  or the socket receive buffer were full
+     * @return true on success
+     * @note the statistics are counted since the socket initializing
+     */
+    bool getRxStats(uint64_t &packets, uint64_t &drops) const;
+#endif /* SWIG */
 };
 
 __PTPMGMT_NAMESPACE_END
@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief io_uring send and receive for sockets
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * @details
+ *  Receive messages into buffers owned by the kernel ring,
+ *  and send messages without a system call per message.
+ * @note The io_uring socket is available in C++ only.
+ */
+
+#ifndef __PTPMGMT_URING_H
+#define __PTPMGMT_URING_H
+
+#ifdef __cplusplus
+#include <deque>
+#include <vector>
+#include "sock.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+/**
+ * @brief Send and receive with io_uring
+ * @details
+ *  Use a multishot receive with a registered buffer ring.
+ *  The kernel receives the messages into the ring buffers,
+ *  without a system call per message.
+ *  The application gets the received messages with rcv(),
+ *  the messages are ready for parsing,
+ *  and returns the buffers with release().
+ *
+ *  Messages to send are queued with send() and submitted together
+ *  with submit(). The submitted messages are linked and sent in order.
+ *
+ *  When io_uring is not available, the object falls back to
+ *  the socket batch send and receive, using the same API.
+ * @note Supports SockUnix, SockIp4, SockIp6 and SockRaw.
+ *  Other socket classes use the fall back.
+ * @note The object is not thread safe.
+ */
+class SockUring
+{
+  private:
+    struct Ring;
+    const SockBase &m_sock;
+    Ring *m_ring = nullptr;
+    bool m_isInit = false;
+    size_t m_bufSize = 0; /* maximum message size */
+    size_t m_bufLen = 0; /* receive buffer size */
+    size_t m_bufCount = 0;
+    /* Receive buffers */
+    std::vector<uint8_t> m_bufs;
+    std::vector<size_t> m_freeBufs; /* fall back */
+    std::deque<SockMsg> m_ready;
+    size_t m_held = 0; /* buffers not in the kernel ring */
+    std::vector<bool> m_heldBufs; /* buffers given to the application */
+    /* Send slots */
+    std::vector<uint8_t> m_sendBufs;
+    std::vector<size_t> m_sendLens;
+    std::vector<size_t> m_freeSlots;
+    std::vector<size_t> m_queue;
+    size_t m_inFlight = 0;
+    size_t m_sendErrors = 0;
+    bool initRing();
+    void closeRing();
+    bool enter(unsigned minComplete);
+    void reap();
+    void arm();
+    void addBuf(size_t id);
+    bool rcvParse(uint8_t *buf, size_t len, SockMsg &msg) const;
+    ssize_t submitFallback();
+    ssize_t rcvFallback(SockMsg *msgs, size_t count, bool block);
+
+  public:
+    /**
+     * Construct an io_uring socket
+     * @param[in] sock socket to send and receive with
+     * @note the socket must live longer than this object
+     */
+    SockUring(const SockBase &sock);
+    ~SockUring();
+    /**
+     * Allocate the buffers and the ring
+     * @param[in] bufCount number of receive buffers and send slots
+     * @param[in] bufSize maximum message size
+     * @return true on success
+     * @note initialize the socket first
+     * @note If io_uring is not available, use the fall back.
+     *  The function fails only if the socket is not initialized
+     *  or on memory allocation failure.
+     * @note the number of receive buffers is rounded up to a power of 2
+     */
+    bool init(size_t bufCount = 64, size_t bufSize = 2000);
+    /**
+     * Release the buffers and the ring
+     * @note messages received and not released become invalid
+     */
+    void close();
+    /**
+     * Query if object uses io_uring
+     * @return true if object uses io_uring, false for fall back
+     */
+    bool isUring() const;
+    /**
+     * Get file description to poll for received messages
+     * @return file description
+     * @note the io_uring file description or the socket file description
+     */
+    int getFd() const;
+    /**
+     * Queue a message to send
+     * @param[in] msg pointer to message memory buffer
+     * @param[in] len message length
+     * @return true if message is queued
+     * @note the message is copied, the buffer can be reused
+     */
+    bool send(const void *msg, size_t len);
+    /**
+     * Submit the queued messages
+     * @return number of messages submitted or negative on failure
+     * @note with io_uring, the messages are linked and sent in order,
+     *  a failure cancels the following messages.
+     * @note messages that do not fit the submission queue stay queued
+     *  for the next call.
+     * @note each message sent advances the socket transmit timestamp ID,
+     *  like SockBase::send().
+     */
+    ssize_t submit();
+    /**
+     * Get number of messages queued or submitted, and not sent yet
+     * @return number of messages
+     */
+    size_t sendPending() const;
+    /**
+     * Get number of messages failed to send, and reset the counter
+     * @return number of messages
+     */
+    size_t sendErrors();
+    /**
+     * Receive messages
+     * @param[out] msgs array of messages, set buf, bufSize, len,
+     *  from and fromLen
+     * @param[in] count number of messages in array
+     * @param[in] block true, wait till the first message arrives.
+     *                  false, do not wait
+     * @return number of messages received or negative on failure
+     * @note The message buffers belong to the object,
+     *  call release() when done with them.
+     * @note The buffers hold the PTP messages, ready for parsing.
+     */
+    ssize_t rcv(SockMsg *msgs, size_t count, bool block = false);
+    /**
+     * Return received messages buffers
+     * @param[in] msgs array of messages from rcv()
+     * @param[in] count number of messages in array
+     * @note buffers already released are ignored
+     */
+    void release(const SockMsg *msgs, size_t count);
+};
+
+__PTPMGMT_NAMESPACE_END
+#endif /* __cplusplus */
+
+#endif /* __PTPMGMT_URING_H */
@@ -43,6 +43,10 @@ const ConfigFile::ConfigSection::range_t ConfigFile::ConfigSection::ranges[] = {
     rang_val(udp6_scope, 0xe, 0, 0xf),
     rang_val(udp_ttl, 1, 1, UINT8_MAX),
     rang_val(socket_priority, 0, 0, 15),
+    // Microseconds, the kernel uses an integer
+    rang_val(busy_poll, 0, 0, INT32_MAX),
+    rang_val(prefer_busy_poll, 0, 0, 1),
+    rang_val(busy_poll_spin, 0, 0, INT32_MAX),
     rang_val(network_transport, '4', '2', '6'),
     rang_val(active_key_id, 0, 0, UINT32_MAX),
     rang_val(spp, 0, 0, UINT8_MAX),
@@ -220,6 +224,9 @@ get_func(domainNumber)
 get_func(udp6_scope)
 get_func(udp_ttl)
 get_func(socket_priority)
+get_func32(busy_poll)
+get_func(prefer_busy_poll)
+get_func32(busy_poll_spin)
 get_func(network_transport)
 get_func32(active_key_id)
 get_func(spp)
@@ -540,6 +547,9 @@ C2CPP_func(domainNumber)
 C2CPP_func(udp6_scope)
 C2CPP_func(udp_ttl)
 C2CPP_func(socket_priority)
+C2CPP_funcN(32, busy_poll)
+C2CPP_func(prefer_busy_poll)
+C2CPP_funcN(32, busy_poll_spin)
 C2CPP_func(network_transport)
 C2CPP_funcN(16, active_key_id)
 C2CPP_func(spp)
@@ -598,6 +608,9 @@ static inline void ptpmgmt_cfg_asign_cb(ptpmgmt_cfg me)
     C_ASGN(sa_file);
     C_ASGN(ptp_dst_mac);
     C_ASGN(p2p_dst_mac);
+    C_ASGN(busy_poll);
+    C_ASGN(prefer_busy_poll);
+    C_ASGN(busy_poll_spin);
 }
 ptpmgmt_cfg ptpmgmt_cfg_alloc()
 {
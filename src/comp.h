@@ -14,6 +14,8 @@
 
 #include "config.h"
 #include <functional>
+#include <list>
+#include <unordered_map>
 #ifdef HAVE_ENDIAN_H
 #include <endian.h>
 #endif
@@ -387,6 +389,8 @@ struct MsgProc {
     template <typename T> bool vector_f(uint32_t count, vector<T> &vec);
     /* countless list process */
     template <typename T> bool vector_o(vector<T> &vec);
+    /* Fixed size TLVs, use generated codec */
+    template <typename T> bool codec_f(T &d);
 };
 
 void *cpp2cMngTlv(mng_vals_e tlv_id, const BaseMngTlv *tlv, void *&x);
@@ -465,6 +469,32 @@ struct HMAC_Key {
     virtual bool verify(const void *hData, size_t len, Binary &mac) = 0;
 };
 
+/* Least recently used cache of initialized HMAC keys */
+class HMAC_Cache
+{
+  private:
+    typedef pair<uint64_t, unique_ptr<HMAC_Key>> entry_t;
+    list<entry_t> m_lru; /* most recently used first */
+    unordered_map<uint64_t, list<entry_t>::iterator> m_map;
+    size_t m_capacity;
+    static uint64_t id(uint8_t spp, uint32_t key) {
+        return ((uint64_t)spp << 32) | key;
+    }
+    void evict();
+  public:
+    HMAC_Cache(size_t capacity) : m_capacity(capacity) {}
+    /* Get the key, allocate it on a miss */
+    HMAC_Key *get(const Spp &s, uint8_t spp, uint32_t key);
+    /* Move a key with the same type and value into the cache */
+    bool reuse(HMAC_Cache &from, const Spp &s, uint8_t spp, uint32_t key);
+    /* Initialize all keys of the SA, reuse keys of the previous cache */
+    bool load(const SaFile &sa, HMAC_Cache *from = nullptr);
+    void setCapacity(size_t capacity);
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return m_lru.size(); }
+    void clear();
+};
+
 /* structure for linking */
 struct HMAC_lib {
     function<HMAC_Key *()> m_alloc_key; /* Alocate HMAC_Key object */
@@ -489,6 +519,31 @@ bool hmac_isLibShared();
 void hmac_freeLib();
 size_t hmac_count();
 HMAC_Key *hmac_allocHMAC(HMAC_t type, const Binary &key);
+/* Built-in HMAC, used when no HMAC library is loaded */
+HMAC_Key *hmac_allocNative(HMAC_t type, const Binary &key);
+HMAC_Key *hmac_newNative(HMAC_t type);
+/* Use the CPU SHA and AES instructions, return true if any is used */
+bool hmac_nativeAccel(bool enable);
+
+/* ************************************************************************** */
+/* Shared by the management session and the gather */
+struct SessionReply;
+class SessionParse
+{
+  public:
+    /* Monotonic time in nanoseconds */
+    static uint64_t nowNs();
+    /* The caller takes the TLV objects from the message */
+    static MsgParams params(const MsgParams &prms);
+    /* Round up to milliseconds, poll() with zero timeout blocks */
+    static uint64_t toMs(uint64_t ns);
+    /* Parse a management reply or a management error reply */
+    static bool parse(Message &msg, const void *buf, ssize_t msgSize,
+        MNG_PARSE_ERROR_e &err);
+    /* Set the reply with the parsed message, take its TLV object */
+    static void setReply(Message &msg, MNG_PARSE_ERROR_e err,
+        SessionReply &reply);
+};
 
 __PTPMGMT_NAMESPACE_END
 
@@ -0,0 +1,160 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Query many local PTP daemons with a single Unix socket
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <unordered_map>
+#include "gather.h"
+#include "timeCvrt.h"
+#include "comp.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+static const size_t bufSize = 2000;
+
+ManagementGather::ManagementGather(const SockUnix &sock) : m_sock(sock),
+    m_msg(SessionParse::params(MsgParams()))
+{
+}
+ManagementGather::ManagementGather(const SockUnix &sock,
+    const MsgParams &prms) : m_sock(sock), m_msg(SessionParse::params(prms))
+{
+}
+Message &ManagementGather::getMessage()
+{
+    return m_msg;
+}
+bool ManagementGather::addPeer(const string &addr, uint64_t timeout_ms,
+    bool useAbstract)
+{
+    Peer peer = { addr, useAbstract, timeout_ms };
+    if(!peer.peer.set(addr, useAbstract))
+        return false;
+    for(const Peer &p : m_peers) {
+        if(p.peer == peer.peer) {
+            PTPMGMT_ERROR("Peer %s is already added", addr.c_str());
+            return false;
+        }
+    }
+    m_peers.push_back(peer);
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool ManagementGather::removePeer(const string &addr, bool useAbstract)
+{
+    for(auto it = m_peers.begin(); it != m_peers.end(); it++) {
+        if(it->addr == addr && it->useAbstract == useAbstract) {
+            m_peers.erase(it);
+            PTPMGMT_ERROR_CLR;
+            return true;
+        }
+    }
+    PTPMGMT_ERROR("Peer %s is not added", addr.c_str());
+    return false;
+}
+void ManagementGather::clearPeers()
+{
+    m_peers.clear();
+}
+size_t ManagementGather::peers() const
+{
+    return m_peers.size();
+}
+vector<GatherReply> ManagementGather::replies(MNG_PARSE_ERROR_e err) const
+{
+    vector<GatherReply> res(m_peers.size());
+    for(size_t i = 0; i < m_peers.size(); i++) {
+        res[i].peer = m_peers[i].addr;
+        res[i].useAbstract = m_peers[i].useAbstract;
+        res[i].reply.state = SESSION_SEND_FAIL;
+        res[i].reply.err = err;
+    }
+    return res;
+}
+bool ManagementGather::handle(const void *buf, ssize_t msgSize,
+    uint16_t sequence, SessionReply &reply)
+{
+    MNG_PARSE_ERROR_e err;
+    if(!SessionParse::parse(m_msg, buf, msgSize, err))
+        return false;
+    // Replies of previous queries
+    if(m_msg.getSequence() != sequence)
+        return false;
+    SessionParse::setReply(m_msg, err, reply);
+    return true;
+}
+vector<GatherReply> ManagementGather::query(actionField_e action,
+    mng_vals_e tlv_id, uint64_t timeout_ms, const BaseMngTlv *data)
+{
+    if(!m_msg.setAction(action, tlv_id, data))
+        return replies(MNG_PARSE_ERROR_INVALID_ID);
+    MNG_PARSE_ERROR_e err = m_req.prepare(m_msg);
+    m_msg.clearData(); // Do not keep the application TLV
+    if(err != MNG_PARSE_ERROR_OK)
+        return replies(err);
+    return query(m_req, timeout_ms);
+}
+vector<GatherReply> ManagementGather::query(PreparedRequest &req,
+    uint64_t timeout_ms)
+{
+    uint16_t sequence = m_seq++;
+    MNG_PARSE_ERROR_e err = req.setSequence(sequence);
+    vector<GatherReply> res = replies(err);
+    if(err != MNG_PARSE_ERROR_OK)
+        return res;
+    // Peers waiting for a reply by their address
+    unordered_map<UnixPeer, size_t, UnixPeer::Hash> pending;
+    vector<uint64_t> deadlines(m_peers.size());
+    uint64_t start = SessionParse::nowNs();
+    for(size_t i = 0; i < m_peers.size(); i++) {
+        const Peer &p = m_peers[i];
+        res[i].reply.sequence = sequence;
+        if(!m_sock.sendTo(req.getBuf().get(), req.getMsgLen(), p.peer))
+            continue;
+        res[i].reply.state = SESSION_TIMEOUT;
+        uint64_t to = p.timeout_ms > 0 ? p.timeout_ms : timeout_ms;
+        deadlines[i] = start + to * NSEC_PER_MSEC;
+        pending[p.peer] = i;
+    }
+    uint8_t buf[bufSize];
+    UnixPeer from;
+    while(!pending.empty()) {
+        ssize_t cnt;
+        while(!pending.empty() &&
+            (cnt = m_sock.rcvFrom(buf, bufSize, from)) > 0) {
+            auto it = pending.find(from);
+            if(it == pending.end())
+                continue;
+            SessionReply &reply = res[it->second].reply;
+            if(handle(buf, cnt, sequence, reply)) {
+                reply.rtt = SessionParse::nowNs() - start;
+                pending.erase(it);
+            }
+        }
+        // Peers without reply stay with SESSION_TIMEOUT
+        uint64_t now = SessionParse::nowNs();
+        uint64_t wait = UINT64_MAX;
+        for(auto it = pending.begin(); it != pending.end();) {
+            uint64_t deadline = deadlines[it->second];
+            if(deadline <= now)
+                it = pending.erase(it);
+            else {
+                wait = min(wait, deadline - now);
+                it++;
+            }
+        }
+        if(pending.empty())
+            break;
+        m_sock.poll(SessionParse::toMs(wait));
+    }
+    PTPMGMT_ERROR_CLR;
+    return res;
+}
+
+__PTPMGMT_NAMESPACE_END
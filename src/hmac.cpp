@@ -152,6 +152,15 @@ static void freeLib()
     }
 }
 void hmac_freeLib() { freeLib(); }
+// Use the loaded library or the built-in HMAC
+static HMAC_Key *allocKey(HMAC_t type)
+{
+    PTPMGMT_ERROR_CLR;
+    LIB_LOCK;
+    if(hmacLib == nullptr)
+        return hmac_newNative(type);
+    return ptpm_hmac_p->m_alloc_key();
+}
 #define HMAC_NAME useLib
 #define HMAC_IS_SHARED true
 #else // PIC
@@ -183,6 +192,14 @@ static void freeLib()
 void hmac_freeLib()
 {
 }
+// Use the linked library or the built-in HMAC
+static HMAC_Key *allocKey(HMAC_t type)
+{
+    PTPMGMT_ERROR_CLR;
+    if(ptpm_hmac_p == nullptr)
+        return hmac_newNative(type);
+    return ptpm_hmac_p->m_alloc_key();
+}
 #define HMAC_NAME ptpm_hmac_p->m_name
 #define HMAC_IS_SHARED false
 #endif // PIC
@@ -191,13 +208,11 @@ const char *hmac_loadLibrary() { return doLoadLibrary() ? nullptr : HMAC_NAME; }
 bool hmac_isLibShared() { return HMAC_IS_SHARED; }
 size_t hmac_count() { return hmacCount.load(); }
 HMAC_Key::~HMAC_Key() { hmacCount--; }
-HMAC_Key *hmac_allocHMAC(HMAC_t type, const Binary &key)
+static HMAC_Key *initKey(HMAC_Key *hmac, HMAC_t type, const Binary &key)
 {
-    if(doLoadLibrary())
-        return nullptr;
-    HMAC_Key *hmac = ptpm_hmac_p->m_alloc_key();
     if(hmac == nullptr) {
-        PTPMGMT_ERROR("allocation of HMAC_Key failed");
+        if(!Error::isError())
+            PTPMGMT_ERROR("allocation of HMAC_Key failed");
         return nullptr;
     }
     hmacCount++;
@@ -209,6 +224,82 @@ HMAC_Key *hmac_allocHMAC(HMAC_t type, const Binary &key)
     }
     return hmac;
 }
+HMAC_Key *hmac_allocHMAC(HMAC_t type, const Binary &key)
+{
+    return initKey(allocKey(type), type, key);
+}
+HMAC_Key *hmac_allocNative(HMAC_t type, const Binary &key)
+{
+    PTPMGMT_ERROR_CLR;
+    return initKey(hmac_newNative(type), type, key);
+}
+void HMAC_Cache::evict()
+{
+    while(m_lru.size() > m_capacity) {
+        m_map.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+}
+HMAC_Key *HMAC_Cache::get(const Spp &s, uint8_t spp, uint32_t key)
+{
+    auto it = m_map.find(id(spp, key));
+    if(it != m_map.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->second.get();
+    }
+    HMAC_Key *hmac = hmac_allocHMAC(s.htype(key), s.key(key));
+    if(hmac == nullptr)
+        return nullptr;
+    m_lru.emplace_front(id(spp, key), unique_ptr<HMAC_Key>(hmac));
+    m_map[id(spp, key)] = m_lru.begin();
+    evict();
+    return hmac;
+}
+bool HMAC_Cache::reuse(HMAC_Cache &from, const Spp &s, uint8_t spp,
+    uint32_t key)
+{
+    auto it = from.m_map.find(id(spp, key));
+    if(it == from.m_map.end())
+        return false;
+    HMAC_Key *hmac = it->second->second.get();
+    if(hmac->m_type != s.htype(key) || !(hmac->m_key == s.key(key)))
+        return false;
+    if(m_map.count(id(spp, key)) > 0)
+        return true;
+    m_lru.splice(m_lru.begin(), from.m_lru, it->second);
+    m_map[id(spp, key)] = m_lru.begin();
+    from.m_map.erase(it);
+    evict();
+    return true;
+}
+bool HMAC_Cache::load(const SaFile &sa, HMAC_Cache *from)
+{
+    size_t count = 0;
+    for(const auto &s : sa.m_spps)
+        count += s.second.m_keys.size();
+    if(count > m_capacity)
+        m_capacity = count;
+    for(const auto &s : sa.m_spps) {
+        for(const auto &k : s.second.m_keys) {
+            if(from != nullptr && reuse(*from, s.second, s.first, k.first))
+                continue;
+            if(get(s.second, s.first, k.first) == nullptr)
+                return false;
+        }
+    }
+    return true;
+}
+void HMAC_Cache::setCapacity(size_t capacity)
+{
+    m_capacity = capacity;
+    evict();
+}
+void HMAC_Cache::clear()
+{
+    m_map.clear();
+    m_lru.clear();
+}
+
 // Release on exit
 ON_EXIT_ATTR static void unLoadHmac() { freeLib(); }
 
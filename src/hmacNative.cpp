@@ -0,0 +1,575 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Built-in HMAC-SHA256 and AES-CMAC
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * @details
+ *  Native implementation used when no HMAC wrapper library is loaded.
+ *  SHA256 follows FIPS 180-4, HMAC follows RFC 2104,
+ *  AES follows FIPS 197 and CMAC follows RFC 4493.
+ *  Use the CPU SHA and AES instructions when available.
+ */
+
+#include "comp.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define HMAC_X86
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) ||\
+    (defined(__ARM_FEATURE_AES) && defined(__ARM_FEATURE_SHA2)))
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define HMAC_ARM
+#endif
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+static const size_t shaBlock = 64;
+static const size_t shaSize = 32;
+static const size_t aesBlock = 16;
+static const size_t aesMaxRounds = 14;
+
+// Wipe key material, the compiler may drop a memset() of a dead object
+static void wipe(void *buf, size_t len)
+{
+    volatile uint8_t *p = (volatile uint8_t *)buf;
+    while(len-- > 0)
+        *p++ = 0;
+}
+
+/* ************************************************************************** */
+/* SHA256 */
+
+// Process blocks of 64 bytes
+typedef void (*sha256Blocks_t)(uint32_t state[8], const uint8_t *p,
+    size_t blocks);
+
+static const uint32_t sha256Init[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+alignas(16) static const uint32_t sha256K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+static inline uint32_t ror(uint32_t v, int n)
+{
+    return (v >> n) | (v << (32 - n));
+}
+static inline uint32_t getBe32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+        ((uint32_t)p[2] << 8) | p[3];
+}
+static inline void setBe32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+static void sha256Portable(uint32_t state[8], const uint8_t *p, size_t blocks)
+{
+    uint32_t w[64];
+    for(; blocks > 0; blocks--, p += shaBlock) {
+        for(int i = 0; i < 16; i++)
+            w[i] = getBe32(p + i * 4);
+        for(int i = 16; i < 64; i++) {
+            uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^
+                (w[i - 15] >> 3);
+            uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^
+                (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for(int i = 0; i < 64; i++) {
+            uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) +
+                ((e & f) ^ (~e & g)) + sha256K[i] + w[i];
+            uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) +
+                ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+#ifdef HMAC_X86
+// Intel SHA extensions
+// Four rounds with message words vector
+#define SHA_NI_RND(j, cur)\
+    msg = _mm_add_epi32(cur, _mm_load_si128((const __m128i *)(sha256K + j * 4)));\
+    st1 = _mm_sha256rnds2_epu32(st1, st0, msg);\
+    st0 = _mm_sha256rnds2_epu32(st0, st1, _mm_shuffle_epi32(msg, 0x0e))
+// Message schedule
+#define SHA_NI_MSG1(m, cur) m = _mm_sha256msg1_epu32(m, cur)
+#define SHA_NI_MSG2(nxt, cur, prv)\
+    nxt = _mm_sha256msg2_epu32(_mm_add_epi32(nxt,\
+                _mm_alignr_epi8(cur, prv, 4)), cur)
+#define SHA_NI(j, cur, nxt, prv)\
+    SHA_NI_RND(j, cur);\
+    SHA_NI_MSG2(nxt, cur, prv);\
+    SHA_NI_MSG1(prv, cur)
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha256Ni(uint32_t state[8], const uint8_t *p, size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+            0x0405060700010203ULL);
+    __m128i tmp = _mm_loadu_si128((const __m128i *)state);
+    __m128i st1 = _mm_loadu_si128((const __m128i *)(state + 4));
+    tmp = _mm_shuffle_epi32(tmp, 0xb1); // CDAB
+    st1 = _mm_shuffle_epi32(st1, 0x1b); // EFGH
+    __m128i st0 = _mm_alignr_epi8(tmp, st1, 8); // ABEF
+    st1 = _mm_blend_epi16(st1, tmp, 0xf0); // CDGH
+    for(; blocks > 0; blocks--, p += shaBlock) {
+        __m128i abef = st0, cdgh = st1, msg;
+        __m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), mask);
+        __m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)
+                    (p + 16)), mask);
+        __m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)
+                    (p + 32)), mask);
+        __m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)
+                    (p + 48)), mask);
+        SHA_NI_RND(0, m0);
+        SHA_NI_RND(1, m1);
+        SHA_NI_MSG1(m0, m1);
+        SHA_NI_RND(2, m2);
+        SHA_NI_MSG1(m1, m2);
+        SHA_NI(3, m3, m0, m2);
+        SHA_NI(4, m0, m1, m3);
+        SHA_NI(5, m1, m2, m0);
+        SHA_NI(6, m2, m3, m1);
+        SHA_NI(7, m3, m0, m2);
+        SHA_NI(8, m0, m1, m3);
+        SHA_NI(9, m1, m2, m0);
+        SHA_NI(10, m2, m3, m1);
+        SHA_NI(11, m3, m0, m2);
+        SHA_NI(12, m0, m1, m3);
+        SHA_NI_RND(13, m1);
+        SHA_NI_MSG2(m2, m1, m0);
+        SHA_NI_RND(14, m2);
+        SHA_NI_MSG2(m3, m2, m1);
+        SHA_NI_RND(15, m3);
+        st0 = _mm_add_epi32(st0, abef);
+        st1 = _mm_add_epi32(st1, cdgh);
+    }
+    tmp = _mm_shuffle_epi32(st0, 0x1b); // FEBA
+    st1 = _mm_shuffle_epi32(st1, 0xb1); // DCHG
+    _mm_storeu_si128((__m128i *)state, _mm_blend_epi16(tmp, st1, 0xf0));
+    _mm_storeu_si128((__m128i *)(state + 4), _mm_alignr_epi8(st1, tmp, 8));
+}
+#endif /* HMAC_X86 */
+#ifdef HMAC_ARM
+// ARMv8 cryptography extension
+static void sha256Arm(uint32_t state[8], const uint8_t *p, size_t blocks)
+{
+    uint32x4_t st0 = vld1q_u32(state);
+    uint32x4_t st1 = vld1q_u32(state + 4);
+    for(; blocks > 0; blocks--, p += shaBlock) {
+        uint32x4_t abcd = st0, efgh = st1, m[4];
+        for(int j = 0; j < 4; j++)
+            m[j] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + j * 16)));
+        for(int j = 0; j < 16; j++) {
+            uint32x4_t &cur = m[j % 4];
+            uint32x4_t msg = vaddq_u32(cur, vld1q_u32(sha256K + j * 4));
+            if(j < 12)
+                cur = vsha256su1q_u32(vsha256su0q_u32(cur, m[(j + 1) % 4]),
+                        m[(j + 2) % 4], m[(j + 3) % 4]);
+            uint32x4_t t = st0;
+            st0 = vsha256hq_u32(st0, st1, msg);
+            st1 = vsha256h2q_u32(st1, t, msg);
+        }
+        st0 = vaddq_u32(st0, abcd);
+        st1 = vaddq_u32(st1, efgh);
+    }
+    vst1q_u32(state, st0);
+    vst1q_u32(state + 4, st1);
+}
+#endif /* HMAC_ARM */
+
+/* ************************************************************************** */
+/* AES */
+
+struct AesKey {
+    alignas(16) uint8_t rk[aesMaxRounds + 1][aesBlock]; // round keys
+    int rounds;
+};
+// CBC-MAC of blocks of 16 bytes, x holds the chain value
+typedef void (*aesCbc_t)(const AesKey &k, uint8_t x[aesBlock],
+    const uint8_t *p, size_t blocks);
+
+static const uint8_t sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b,
+    0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
+    0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26,
+    0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2,
+    0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0,
+    0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed,
+    0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f,
+    0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
+    0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec,
+    0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14,
+    0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
+    0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d,
+    0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f,
+    0x4b, 0xbd, 0x8b, 0x8a, 0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e,
+    0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+    0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f,
+    0xb0, 0x54, 0xbb, 0x16
+};
+static inline uint8_t xtime(uint8_t v)
+{
+    return (v << 1) ^ ((v & 0x80) ? 0x1b : 0);
+}
+static void aesExpand(AesKey &k, const uint8_t *key, size_t keyLen)
+{
+    size_t nk = keyLen / 4;
+    k.rounds = nk + 6;
+    uint8_t *w = &k.rk[0][0];
+    memcpy(w, key, keyLen);
+    uint8_t rcon = 1;
+    for(size_t i = nk; i < 4 * (nk + 7); i++) {
+        uint8_t t[4];
+        memcpy(t, w + (i - 1) * 4, 4);
+        if(i % nk == 0) {
+            uint8_t t0 = t[0];
+            t[0] = sbox[t[1]] ^ rcon;
+            t[1] = sbox[t[2]];
+            t[2] = sbox[t[3]];
+            t[3] = sbox[t0];
+            rcon = xtime(rcon);
+        } else if(nk > 6 && i % nk == 4) {
+            for(int j = 0; j < 4; j++)
+                t[j] = sbox[t[j]];
+        }
+        for(int j = 0; j < 4; j++)
+            w[i * 4 + j] = w[(i - nk) * 4 + j] ^ t[j];
+    }
+}
+static void aesEncrypt(const AesKey &k, uint8_t s[aesBlock])
+{
+    for(size_t i = 0; i < aesBlock; i++)
+        s[i] ^= k.rk[0][i];
+    for(int r = 1; r <= k.rounds; r++) {
+        uint8_t t[aesBlock];
+        // SubBytes and ShiftRows, the state is column major
+        for(size_t i = 0; i < aesBlock; i++)
+            t[i] = sbox[s[(i + (i % 4) * 4) % aesBlock]];
+        if(r < k.rounds) {
+            // MixColumns
+            for(size_t c = 0; c < aesBlock; c += 4) {
+                uint8_t a0 = t[c], a1 = t[c + 1], a2 = t[c + 2], a3 = t[c + 3];
+                uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+                t[c] ^= all ^ xtime(a0 ^ a1);
+                t[c + 1] ^= all ^ xtime(a1 ^ a2);
+                t[c + 2] ^= all ^ xtime(a2 ^ a3);
+                t[c + 3] ^= all ^ xtime(a3 ^ a0);
+            }
+        }
+        for(size_t i = 0; i < aesBlock; i++)
+            s[i] = t[i] ^ k.rk[r][i];
+    }
+}
+static void aesCbcPortable(const AesKey &k, uint8_t x[aesBlock],
+    const uint8_t *p, size_t blocks)
+{
+    for(; blocks > 0; blocks--, p += aesBlock) {
+        for(size_t i = 0; i < aesBlock; i++)
+            x[i] ^= p[i];
+        aesEncrypt(k, x);
+    }
+}
+#ifdef HMAC_X86
+__attribute__((target("aes,sse2")))
+static void aesCbcNi(const AesKey &k, uint8_t x[aesBlock], const uint8_t *p,
+    size_t blocks)
+{
+    __m128i rk[aesMaxRounds + 1];
+    for(int r = 0; r <= k.rounds; r++)
+        rk[r] = _mm_load_si128((const __m128i *)k.rk[r]);
+    __m128i s = _mm_loadu_si128((const __m128i *)x);
+    for(; blocks > 0; blocks--, p += aesBlock) {
+        s = _mm_xor_si128(s, _mm_loadu_si128((const __m128i *)p));
+        s = _mm_xor_si128(s, rk[0]);
+        for(int r = 1; r < k.rounds; r++)
+            s = _mm_aesenc_si128(s, rk[r]);
+        s = _mm_aesenclast_si128(s, rk[k.rounds]);
+    }
+    _mm_storeu_si128((__m128i *)x, s);
+}
+#endif /* HMAC_X86 */
+#ifdef HMAC_ARM
+static void aesCbcArm(const AesKey &k, uint8_t x[aesBlock], const uint8_t *p,
+    size_t blocks)
+{
+    uint8x16_t rk[aesMaxRounds + 1];
+    for(int r = 0; r <= k.rounds; r++)
+        rk[r] = vld1q_u8(k.rk[r]);
+    uint8x16_t s = vld1q_u8(x);
+    for(; blocks > 0; blocks--, p += aesBlock) {
+        s = veorq_u8(s, vld1q_u8(p));
+        for(int r = 0; r < k.rounds - 1; r++)
+            s = vaesmcq_u8(vaeseq_u8(s, rk[r]));
+        s = veorq_u8(vaeseq_u8(s, rk[k.rounds - 1]), rk[k.rounds]);
+    }
+    vst1q_u8(x, s);
+}
+#endif /* HMAC_ARM */
+
+/* ************************************************************************** */
+/* Runtime dispatch */
+
+static sha256Blocks_t sha256Blocks = sha256Portable;
+static aesCbc_t aesCbc = aesCbcPortable;
+
+bool hmac_nativeAccel(bool enable)
+{
+    sha256Blocks = sha256Portable;
+    aesCbc = aesCbcPortable;
+    if(!enable)
+        return false;
+    bool ret = false;
+#ifdef HMAC_X86
+    unsigned a, b, c, d;
+    if(__get_cpuid(1, &a, &b, &c, &d)) {
+        if((c & bit_AES) != 0) {
+            aesCbc = aesCbcNi;
+            ret = true;
+        }
+        bool sse = (c & bit_SSSE3) != 0 && (c & bit_SSE4_1) != 0;
+        if(sse && __get_cpuid_count(7, 0, &a, &b, &c, &d) &&
+            (b & bit_SHA) != 0) {
+            sha256Blocks = sha256Ni;
+            ret = true;
+        }
+    }
+#endif /* HMAC_X86 */
+#ifdef HMAC_ARM
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    if((hwcap & HWCAP_AES) != 0) {
+        aesCbc = aesCbcArm;
+        ret = true;
+    }
+    if((hwcap & HWCAP_SHA2) != 0) {
+        sha256Blocks = sha256Arm;
+        ret = true;
+    }
+#endif /* HMAC_ARM */
+    return ret;
+}
+// Probe the CPU on load
+static bool accelInit = hmac_nativeAccel(true);
+
+/* ************************************************************************** */
+/* MAC keys */
+
+struct HMAC_Native : public HMAC_Key {
+    bool verify(const void *hData, size_t len, Binary &mac) override final;
+};
+bool HMAC_Native::verify(const void *hData, size_t len, Binary &mac)
+{
+    size_t size = mac.size();
+    Binary o(size);
+    if(!digest(hData, len, o))
+        return false;
+    // Constant time compare
+    const uint8_t *m = mac.get(), *c = o.get();
+    uint8_t diff = 0;
+    for(size_t i = 0; i < size; i++)
+        diff |= m[i] ^ c[i];
+    return diff == 0;
+}
+static inline bool macSize(const Binary &mac, size_t max)
+{
+    if(mac.size() > max) {
+        PTPMGMT_ERROR("MAC size too big");
+        return false;
+    }
+    return true;
+}
+
+// HMAC-SHA256, keep the state after the inner and outer pad
+struct HMAC_Sha256 : public HMAC_Native {
+    uint32_t m_inner[8];
+    uint32_t m_outer[8];
+    ~HMAC_Sha256() override;
+    bool init() override final;
+    bool digest(const void *hData, size_t len, Binary &mac) override final;
+};
+// Hash the last partial block with the padding
+static void sha256Final(uint32_t state[8], const uint8_t *p, size_t len,
+    uint64_t total, uint8_t out[shaSize])
+{
+    uint8_t buf[shaBlock * 2] = {0};
+    if(len > 0)
+        memcpy(buf, p, len);
+    buf[len] = 0x80;
+    size_t size = len + 9 > shaBlock ? shaBlock * 2 : shaBlock;
+    uint64_t bits = total * 8;
+    setBe32(buf + size - 8, bits >> 32);
+    setBe32(buf + size - 4, bits);
+    sha256Blocks(state, buf, size / shaBlock);
+    for(int i = 0; i < 8; i++)
+        setBe32(out + i * 4, state[i]);
+}
+HMAC_Sha256::~HMAC_Sha256()
+{
+    wipe(m_inner, sizeof m_inner);
+    wipe(m_outer, sizeof m_outer);
+}
+bool HMAC_Sha256::init()
+{
+    uint8_t k[shaBlock] = {0};
+    size_t size = m_key.size();
+    if(size > shaBlock) {
+        // Long keys are hashed
+        uint32_t st[8];
+        memcpy(st, sha256Init, sizeof st);
+        size_t full = size / shaBlock;
+        sha256Blocks(st, m_key.get(), full);
+        sha256Final(st, m_key.get() + full * shaBlock, size % shaBlock, size, k);
+    } else
+        memcpy(k, m_key.get(), size);
+    uint8_t pad[shaBlock];
+    for(size_t i = 0; i < shaBlock; i++)
+        pad[i] = k[i] ^ 0x36;
+    memcpy(m_inner, sha256Init, sizeof m_inner);
+    sha256Blocks(m_inner, pad, 1);
+    for(size_t i = 0; i < shaBlock; i++)
+        pad[i] = k[i] ^ 0x5c;
+    memcpy(m_outer, sha256Init, sizeof m_outer);
+    sha256Blocks(m_outer, pad, 1);
+    wipe(k, sizeof k);
+    wipe(pad, sizeof pad);
+    return true;
+}
+bool HMAC_Sha256::digest(const void *hData, size_t len, Binary &mac)
+{
+    if(!macSize(mac, shaSize))
+        return false;
+    const uint8_t *p = (const uint8_t *)hData;
+    uint32_t st[8];
+    uint8_t h[shaSize];
+    memcpy(st, m_inner, sizeof st);
+    size_t full = len / shaBlock;
+    sha256Blocks(st, p, full);
+    sha256Final(st, p + full * shaBlock, len % shaBlock, shaBlock + len, h);
+    memcpy(st, m_outer, sizeof st);
+    sha256Final(st, h, shaSize, shaBlock + shaSize, h);
+    mac.setBin(h, mac.size());
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+
+// AES-CMAC, keep the round keys and the sub keys
+struct HMAC_Cmac : public HMAC_Native {
+    AesKey m_aes;
+    uint8_t m_k1[aesBlock];
+    uint8_t m_k2[aesBlock];
+    ~HMAC_Cmac() override;
+    bool init() override final;
+    bool digest(const void *hData, size_t len, Binary &mac) override final;
+};
+// Multiply by x in GF(2^128)
+static void cmacShift(uint8_t out[aesBlock], const uint8_t in[aesBlock])
+{
+    uint8_t msb = in[0] & 0x80;
+    for(size_t i = 0; i < aesBlock - 1; i++)
+        out[i] = (in[i] << 1) | (in[i + 1] >> 7);
+    out[aesBlock - 1] = (in[aesBlock - 1] << 1) ^ (msb ? 0x87 : 0);
+}
+HMAC_Cmac::~HMAC_Cmac()
+{
+    wipe(&m_aes, sizeof m_aes);
+    wipe(m_k1, sizeof m_k1);
+    wipe(m_k2, sizeof m_k2);
+}
+bool HMAC_Cmac::init()
+{
+    size_t size = m_type == HMAC_AES128 ? 16 : 32;
+    if(m_key.size() != size) {
+        PTPMGMT_ERROR("Wrong key size %zu for AES%zu", m_key.size(), size * 8);
+        return false;
+    }
+    aesExpand(m_aes, m_key.get(), size);
+    uint8_t l[aesBlock] = {0};
+    aesEncrypt(m_aes, l);
+    cmacShift(m_k1, l);
+    cmacShift(m_k2, m_k1);
+    wipe(l, sizeof l);
+    return true;
+}
+bool HMAC_Cmac::digest(const void *hData, size_t len, Binary &mac)
+{
+    if(!macSize(mac, aesBlock))
+        return false;
+    const uint8_t *p = (const uint8_t *)hData;
+    uint8_t x[aesBlock] = {0};
+    uint8_t last[aesBlock] = {0};
+    // The last block is complete only if the message is not empty
+    size_t full = len > 0 ? (len - 1) / aesBlock : 0;
+    size_t rest = len - full * aesBlock;
+    aesCbc(m_aes, x, p, full);
+    if(rest > 0)
+        memcpy(last, p + full * aesBlock, rest);
+    const uint8_t *k = m_k1;
+    if(rest < aesBlock) {
+        last[rest] = 0x80;
+        k = m_k2;
+    }
+    for(size_t i = 0; i < aesBlock; i++)
+        last[i] ^= k[i];
+    aesCbc(m_aes, x, last, 1);
+    mac.setBin(x, mac.size());
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+
+HMAC_Key *hmac_newNative(HMAC_t type)
+{
+    switch(type) {
+        case HMAC_SHA256:
+            return new HMAC_Sha256;
+        case HMAC_AES128:
+        case HMAC_AES256:
+            return new HMAC_Cmac;
+        default:
+            break;
+    }
+    PTPMGMT_ERROR("Unknown HMAC type %d", type);
+    return nullptr;
+}
+
+__PTPMGMT_NAMESPACE_END
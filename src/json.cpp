@@ -9,7 +9,6 @@
  *
  */
 
-#include <stack>
 #include <cmath>
 #include <mutex>
 #include "comp.h"
@@ -492,12 +491,12 @@ JS(EXTERNAL_GRANDMASTER_PROPERTIES_NP)
     procValue(#name, val.name)
 #define procType(type) \
     void procValue(const char *name, const type &val) {\
-        startName(name, " ");\
-        m_result += to_string(val);\
+        startName(name);\
+        putNum(val);\
     }\
     bool procValue(const char *name, type &val) override {\
-        startName(name, " ");\
-        m_result += to_string(val);\
+        startName(name);\
+        putNum(val);\
         return true;\
     }
 #define procTypeEnum(type, func)\
@@ -549,93 +548,262 @@ bool JsonProc::procData(mng_vals_e managementId, const BaseMngTlv *&tlv)
     }
 }
 
+// Size of the writer buffer, flushed to the sink when full
+static const size_t jsonBufSize = 1024;
+static const char spaces[] = "                                ";
+static const char hex[] = "0123456789abcdef";
+// Two digits of 0 to 99
+static const char digits[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
 struct JsonProcToJson : public JsonProc {
-    string m_result;
-    stack<bool> m_first_vals;
+    JsonSink &m_sink;
+    char m_buf[jsonBufSize];
+    size_t m_len = 0;
+    bool m_ok = true;
+    uint64_t m_first_vals = 0; // The first flag of the outer levels
+    int m_depth = 0;
     int m_base_indent;
-    bool m_first;
-    JsonProcToJson(const Message &msg, int indent);
-    JsonProcToJson(mng_vals_e managementId, const BaseMngTlv *tlv, int indent);
+    bool m_compact;
+    bool m_first = false;
+    JsonProcToJson(JsonSink &sink, bool compact, int indent) :
+        m_sink(sink), m_base_indent(compact ? 0 : indent), m_compact(compact) {}
+    void msg2json(const Message &msg);
     bool data2json(mng_vals_e managementId, const BaseMngTlv *tlv,
         bool header = true);
     bool smpte2json(SMPTE_ORGANIZATION_EXTENSION_t *tlv);
     void sig2json(tlvType_e tlvType, const BaseSigTlv *tlv);
+    bool flush() {
+        if(m_ok && m_len > 0)
+            m_ok = m_sink.write(m_buf, m_len);
+        m_len = 0;
+        return m_ok;
+    }
+    void put(const char *str, size_t len) {
+        if(m_len + len > jsonBufSize) {
+            flush();
+            if(len > jsonBufSize) {
+                if(m_ok)
+                    m_ok = m_sink.write(str, len);
+                return;
+            }
+        }
+        memcpy(m_buf + m_len, str, len);
+        m_len += len;
+    }
+    void put(const char *str) { put(str, strlen(str)); }
+    void put(const string &str) { put(str.c_str(), str.size()); }
+    void put(char c) {
+        if(m_len == jsonBufSize)
+            flush();
+        m_buf[m_len++] = c;
+    }
+    // JSON string with escaping
+    void putStr(const char *str, size_t len) {
+        put('"');
+        size_t start = 0;
+        for(size_t i = 0; i < len; i++) {
+            unsigned char c = str[i];
+            if(c >= 0x20 && c != '"' && c != '\\')
+                continue;
+            put(str + start, i - start);
+            start = i + 1;
+            put('\\');
+            switch(c) {
+                case '"':
+                    FALLTHROUGH;
+                case '\\':
+                    put(c);
+                    break;
+                case '\b':
+                    put('b');
+                    break;
+                case '\f':
+                    put('f');
+                    break;
+                case '\n':
+                    put('n');
+                    break;
+                case '\r':
+                    put('r');
+                    break;
+                case '\t':
+                    put('t');
+                    break;
+                default:
+                    put("u00", 3);
+                    put(hex[c >> 4]);
+                    put(hex[c & 0xf]);
+                    break;
+            }
+        }
+        put(str + start, len - start);
+        put('"');
+    }
+    void putNum(uint64_t val) {
+        char buf[20];
+        char *end = buf + sizeof buf, *cur = end;
+        while(val >= 100) {
+            cur -= 2;
+            memcpy(cur, digits + (val % 100) * 2, 2);
+            val /= 100;
+        }
+        if(val >= 10) {
+            cur -= 2;
+            memcpy(cur, digits + val * 2, 2);
+        } else
+            *--cur = '0' + val;
+        put(cur, end - cur);
+    }
+    void putNum(int64_t val) {
+        if(val < 0) {
+            put('-');
+            putNum(0 - (uint64_t)val);
+        } else
+            putNum((uint64_t)val);
+    }
+    void putNum(uint8_t val) { putNum((uint64_t)val); }
+    void putNum(uint16_t val) { putNum((uint64_t)val); }
+    void putNum(uint32_t val) { putNum((uint64_t)val); }
+    void putNum(int8_t val) { putNum((int64_t)val); }
+    void putNum(int16_t val) { putNum((int64_t)val); }
+    void putNum(int32_t val) { putNum((int64_t)val); }
+    // Same format as to_string()
+    void putNum(double val) {
+        char buf[64];
+        int len = snprintf(buf, sizeof buf, "%f", val);
+        if(len >= (int)sizeof buf)
+            put(to_string(val));
+        else if(len > 0)
+            put(buf, len);
+    }
+    void putNum(float val) { putNum((double)val); }
+    void putNum(long double val) {
+        char buf[64];
+        int len = snprintf(buf, sizeof buf, "%Lf", val);
+        if(len >= (int)sizeof buf)
+            put(to_string(val));
+        else if(len > 0)
+            put(buf, len);
+    }
+    // Same format as ClockIdentity_t::string()
+    void putClockId(const ClockIdentity_t &id) {
+        char buf[20];
+        char *cur = buf;
+        *cur++ = '"';
+        for(size_t i = 0; i < id.size(); i++) {
+            if(i == 3 || i == 5)
+                *cur++ = '.';
+            *cur++ = hex[id.v[i] >> 4];
+            *cur++ = hex[id.v[i] & 0xf];
+        }
+        *cur++ = '"';
+        put(buf, cur - buf);
+    }
     void close() {
         if(!m_first)
-            m_result += ',';
-        m_result += '\n';
+            put(',');
+        if(!m_compact)
+            put('\n');
         m_first = false;
     }
     void indent() {
-        m_result += string(m_first_vals.size() * 2 + m_base_indent, ' ');
+        if(m_compact)
+            return;
+        size_t len = m_depth * 2 + m_base_indent;
+        for(; len > sizeof spaces - 1; len -= sizeof spaces - 1)
+            put(spaces, sizeof spaces - 1);
+        put(spaces, len);
     }
-    void startName(const char *name, const char *end) {
+    // The value follows in the next line
+    void startName(const char *name, bool newLine = false) {
         close();
         indent();
-        m_result += '"';
-        m_result += name;
-        m_result += "\" :";
-        m_result += end;
+        put('"');
+        put(name);
+        if(m_compact)
+            put("\":", 2);
+        else if(newLine)
+            put("\" :\n", 4);
+        else
+            put("\" : ", 4);
+    }
+    void push() {
+        m_first_vals = (m_first_vals << 1) | m_first;
+        m_depth++;
+        m_first = true;
+    }
+    void pop() {
+        if(!m_compact)
+            put('\n');
+        m_first = (m_first_vals & 1) != 0;
+        m_first_vals >>= 1;
+        m_depth--;
+        indent();
     }
     void startObject() {
         indent();
-        m_result += "{";
-        m_first_vals.push(m_first);
-        m_first = true;
+        put('{');
+        push();
     }
     void closeObject() {
-        m_result += '\n';
-        m_first = m_first_vals.top();
-        m_first_vals.pop();
-        indent();
-        m_result += "}";
+        pop();
+        put('}');
     }
     void procObject(const char *name) {
-        startName(name, "\n");
+        startName(name, true);
         startObject();
     }
     void startArray() {
         indent();
-        m_result += "[";
-        m_first_vals.push(m_first);
-        m_first = true;
+        put('[');
+        push();
     }
     void closeArray() {
-        m_result += '\n';
-        m_first = m_first_vals.top();
-        m_first_vals.pop();
-        indent();
-        m_result += "]";
+        pop();
+        put(']');
     }
     void procArray(const char *name) {
-        startName(name, "\n");
+        startName(name, true);
         startArray();
     }
+    void procString(const char *name, const char *val) {
+        startName(name);
+        putStr(val, strlen(val));
+    }
     void procString(const char *name, const string &val) {
-        startName(name, " \"");
-        m_result += val;
-        m_result += '"';
+        startName(name);
+        putStr(val.c_str(), val.size());
     }
     void procValue(const char *name, const string &val) {
-        startName(name, " ");
-        m_result += val;
+        startName(name);
+        put(val);
     }
     void procValue(const char *name, const Binary &val) {
         procString(name, val.toId());
     }
     void procBool(const char *name, const bool &val) {
-        startName(name, " ");
-        m_result += val ? "true" : "false";
+        startName(name);
+        if(val)
+            put("true", 4);
+        else
+            put("false", 5);
     }
     void procValue(ClockIdentity_t &val) {
         indent();
-        m_result += '"';
-        m_result += val.string();
-        m_result += '"';
+        putClockId(val);
+    }
+    void procClockId(const char *name, const ClockIdentity_t &val) {
+        startName(name);
+        putClockId(val);
     }
     void procValue(const char *name, const PortIdentity_t &val) {
         procObject(name);
-        procString("clockIdentity", val.clockIdentity.string());
+        procClockId("clockIdentity", val.clockIdentity);
         procValue("portNumber", val.portNumber);
         closeObject();
     }
@@ -753,18 +921,18 @@ struct JsonProcToJson : public JsonProc {
         return true;
     }
     bool procValue(const char *name, ClockIdentity_t &val) override {
-        procString(name, val.string());
+        procClockId(name, val);
         return true;
     }
     bool procValue(const char *name, PortIdentity_t &val) override {
         procObject(name);
-        procString("clockIdentity", val.clockIdentity.string());
+        procClockId("clockIdentity", val.clockIdentity);
         procProperty(portNumber);
         closeObject();
         return true;
     }
     bool procValue(const char *name, PortAddress_t &val) override {
-        startName(name, "\n");
+        startName(name, true);
         procValue(val);
         return true;
     }
@@ -781,17 +949,17 @@ struct JsonProcToJson : public JsonProc {
         return true;
     }
     bool procValue(const char *name, FaultRecord_t &val) override {
-        startName(name, "\n");
+        startName(name, true);
         procValue(val);
         return true;
     }
     bool procValue(const char *name, AcceptableMaster_t &val) override {
-        startName(name, "\n");
+        startName(name, true);
         procValue(val);
         return true;
     }
     bool procValue(const char *name, LinuxptpUnicastMaster_t &val) override {
-        startName(name, "\n");
+        startName(name, true);
         procValue(val);
         return true;
     }
@@ -999,8 +1167,7 @@ bool JsonProcToJson::smpte2json(SMPTE_ORGANIZATION_EXTENSION_t *tlv)
     return true;
 }
 
-JsonProcToJson::JsonProcToJson(const Message &msg, int indent) :
-    m_base_indent(indent), m_first(false)
+void JsonProcToJson::msg2json(const Message &msg)
 {
     startObject();
     procValue("sequenceId", msg.getSequence());
@@ -1054,24 +1221,69 @@ JsonProcToJson::JsonProcToJson(const Message &msg, int indent) :
     closeObject();
 }
 
-JsonProcToJson::JsonProcToJson(mng_vals_e managementId, const BaseMngTlv *tlv,
-    int indent) : m_base_indent(indent), m_first(false)
+bool JsonStrSink::write(const char *str, size_t len)
+{
+    m_str.append(str, len);
+    return true;
+}
+
+JsonBufSink::JsonBufSink(char *buf, size_t size) : m_buf(buf), m_size(size)
+{
+    if(m_buf != nullptr && m_size > 0)
+        *m_buf = 0;
+}
+bool JsonBufSink::write(const char *str, size_t len)
+{
+    // Keep room for the null termination
+    if(m_buf == nullptr || m_len + len >= m_size)
+        return false;
+    memcpy(m_buf + m_len, str, len);
+    m_len += len;
+    m_buf[m_len] = 0;
+    return true;
+}
+size_t JsonBufSink::len() const
+{
+    return m_len;
+}
+void JsonBufSink::clear()
+{
+    m_len = 0;
+    if(m_buf != nullptr && m_size > 0)
+        *m_buf = 0;
+}
+
+bool msg2json(const Message &msg, JsonSink &sink, bool compact, int indent)
 {
-    data2json(managementId, tlv, false);
+    JsonProcToJson proc(sink, compact, indent);
+    proc.msg2json(msg);
+    return proc.flush();
+}
+
+bool tlv2json(mng_vals_e managementId, const BaseMngTlv *tlv, JsonSink &sink,
+    bool compact, int indent)
+{
+    if(tlv == nullptr || Message::isEmpty(managementId))
+        return sink.write("{}", 2); // empty JSON
+    JsonProcToJson proc(sink, compact, indent);
+    proc.data2json(managementId, tlv, false);
+    return proc.flush();
 }
 
 string msg2json(const Message &msg, int indent)
 {
-    JsonProcToJson proc(msg, indent);
-    return proc.m_result;
+    string ret;
+    JsonStrSink sink(ret);
+    msg2json(msg, sink, false, indent);
+    return ret;
 }
 
 string tlv2json(mng_vals_e managementId, const BaseMngTlv *tlv, int indent)
 {
-    if(tlv == nullptr || Message::isEmpty(managementId))
-        return "{}"; // empty JSON
-    JsonProcToJson proc(managementId, tlv, indent);
-    return proc.m_result;
+    string ret;
+    JsonStrSink sink(ret);
+    tlv2json(managementId, tlv, sink, false, indent);
+    return ret;
 }
 
 __PTPMGMT_NAMESPACE_END
@@ -369,7 +369,7 @@ struct JsonProcFrom : public JsonProc {
 bool Json2msg::fromJson(const string &json)
 {
     jsonMain jmain;
-    if(!jmain.parseBuffer(json)) {
+    if(!jmain.parseBuffer(json, false, true)) {
         PTPMGMT_ERROR("Parsing failed");
         return false;
     }
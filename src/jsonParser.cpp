@@ -22,10 +22,261 @@
 #include <cstring>
 #include <cinttypes>
 #include <cmath>
+#include <new>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#if defined(__GNUC__)
+#include <cpuid.h>
+#define JSON_AVX2
+#endif
+#elif defined(__ARM_NEON) && __BYTE_ORDER == __LITTLE_ENDIAN
+#include <arm_neon.h>
+#define JSON_NEON
+#endif
 
 using namespace std;
 
 const size_t lineSize = 512;
+// Linear search of keys in small objects
+const size_t linearKeys = 16;
+// Arena size for each byte of JSON
+const size_t arenaFactor = 4;
+const size_t arenaMinChunk = 1024;
+
+// Memory for a JSON value tree, released at once
+class jsonArena
+{
+  private:
+    struct Chunk {
+        Chunk *next;
+    };
+    Chunk *head = nullptr;
+    char *pos = nullptr;
+    char *end = nullptr;
+    size_t chunkSize;
+    bool grow(size_t size) {
+        size_t sz = max(chunkSize, size + alignof(max_align_t));
+        Chunk *c = (Chunk *)malloc(sizeof(Chunk) + sz);
+        if(c == nullptr)
+            return false;
+        c->next = head;
+        head = c;
+        pos = (char *)(c + 1);
+        end = pos + sz;
+        chunkSize = sz * 2;
+        return true;
+    }
+
+  public:
+    jsonArena(size_t size) : chunkSize(max(size, arenaMinChunk)) {}
+    ~jsonArena() {
+        while(head != nullptr) {
+            Chunk *c = head;
+            head = c->next;
+            free(c);
+        }
+    }
+    void *alloc(size_t size, size_t align = alignof(max_align_t)) {
+        for(;;) {
+            uintptr_t p = ((uintptr_t)pos + align - 1) &
+                ~(uintptr_t)(align - 1);
+            if(pos != nullptr && p + size <= (uintptr_t)end) {
+                pos = (char *)(p + size);
+                return (void *)p;
+            }
+            if(!grow(size))
+                return nullptr;
+        }
+    }
+};
+
+/*
+ * Vector scanning
+ * Compare a block of JSON bytes at once, and get a mask of the bytes
+ *  the scanner stops on. The mask uses maskBits bits per byte.
+ * The scanners stop on a null byte, so they do not pass the end of the
+ *  JSON or the end of a file line.
+ */
+enum e_span {
+    SPAN_WS,     // White spaces, stop on new line
+    SPAN_STR,    // String bytes without escape and non ASCII
+    SPAN_DIGIT,  // Digits
+    SPAN_LINE,   // Line comment
+    SPAN_BLOCK,  // Block comment, stop on star and new line
+};
+#if defined(__SSE2__)
+#define JSON_VEC
+typedef __m128i vec_t;
+static const size_t vecSize = 16;
+static const size_t maskBits = 1;
+static const uint64_t fullMask = UINT16_MAX;
+static inline vec_t vLoad(const char *p)
+{
+    return _mm_loadu_si128((const __m128i *)p);
+}
+static inline vec_t vEq(vec_t v, char c)
+{
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+static inline vec_t vOr(vec_t a, vec_t b) { return _mm_or_si128(a, b); }
+// Bytes above 0x7f
+static inline vec_t vHigh(vec_t v)
+{
+    return _mm_cmplt_epi8(v, _mm_setzero_si128());
+}
+static inline vec_t vNotDigit(vec_t v)
+{
+    // Bytes above 0x7f are negative and less than '0'
+    return vOr(_mm_cmplt_epi8(v, _mm_set1_epi8('0')),
+            _mm_cmpgt_epi8(v, _mm_set1_epi8('9')));
+}
+static inline uint64_t vMask(vec_t v) { return _mm_movemask_epi8(v); }
+#elif defined(JSON_NEON)
+#define JSON_VEC
+typedef uint8x16_t vec_t;
+static const size_t vecSize = 16;
+static const size_t maskBits = 4;
+static const uint64_t fullMask = UINT64_MAX;
+static inline vec_t vLoad(const char *p) { return vld1q_u8((const uint8_t *)p); }
+static inline vec_t vEq(vec_t v, char c)
+{
+    return vceqq_u8(v, vdupq_n_u8((uint8_t)c));
+}
+static inline vec_t vOr(vec_t a, vec_t b) { return vorrq_u8(a, b); }
+// Bytes above 0x7f
+static inline vec_t vHigh(vec_t v) { return vcgeq_u8(v, vdupq_n_u8(0x80)); }
+static inline vec_t vNotDigit(vec_t v)
+{
+    return vcgtq_u8(vsubq_u8(v, vdupq_n_u8('0')), vdupq_n_u8(9));
+}
+static inline uint64_t vMask(vec_t v)
+{
+    // Narrow each byte to 4 bits
+    uint8x8_t n = vshrn_n_u16(vreinterpretq_u16_u8(v), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(n), 0);
+}
+#endif
+#ifdef JSON_VEC
+template<e_span S> static inline uint64_t vStop(vec_t v)
+{
+    switch(S) {
+        case SPAN_WS:
+            return ~vMask(vOr(vOr(vEq(v, ' '), vEq(v, '\t')), vEq(v, '\r'))) &
+                fullMask;
+        case SPAN_STR:
+            return vMask(vOr(vOr(vEq(v, '"'), vEq(v, '\\')),
+                        vOr(vEq(v, 0), vHigh(v))));
+        case SPAN_DIGIT:
+            return vMask(vNotDigit(v));
+        case SPAN_LINE:
+            return vMask(vOr(vEq(v, '\n'), vEq(v, 0)));
+        case SPAN_BLOCK:
+            return vMask(vOr(vOr(vEq(v, '*'), vEq(v, '\n')), vEq(v, 0)));
+    }
+    return fullMask;
+}
+#endif /* JSON_VEC */
+#ifdef JSON_AVX2
+/*
+ * AVX2 scanner, used when the CPU supports it.
+ * The build does not assume AVX2, so the scanner is built for the AVX2
+ *  target and selected at load time.
+ */
+#define AVX2_FN __attribute__((target("avx2")))
+AVX2_FN static inline __m256i v2Eq(__m256i v, char c)
+{
+    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+}
+AVX2_FN static inline __m256i v2Or(__m256i a, __m256i b)
+{
+    return _mm256_or_si256(a, b);
+}
+AVX2_FN static inline uint32_t v2Mask(__m256i v)
+{
+    return (uint32_t)_mm256_movemask_epi8(v);
+}
+template<e_span S> AVX2_FN static inline uint32_t v2Stop(__m256i v)
+{
+    switch(S) {
+        case SPAN_WS:
+            return ~v2Mask(v2Or(v2Or(v2Eq(v, ' '), v2Eq(v, '\t')),
+                        v2Eq(v, '\r')));
+        case SPAN_STR:
+            // Bytes above 0x7f are negative
+            return v2Mask(v2Or(v2Or(v2Eq(v, '"'), v2Eq(v, '\\')),
+                        v2Or(v2Eq(v, 0),
+                            _mm256_cmpgt_epi8(_mm256_setzero_si256(), v))));
+        case SPAN_DIGIT:
+            // Bytes above 0x7f are negative and less than '0'
+            return v2Mask(v2Or(_mm256_cmpgt_epi8(_mm256_set1_epi8('0'), v),
+                        _mm256_cmpgt_epi8(v, _mm256_set1_epi8('9'))));
+        case SPAN_LINE:
+            return v2Mask(v2Or(v2Eq(v, '\n'), v2Eq(v, 0)));
+        case SPAN_BLOCK:
+            return v2Mask(v2Or(v2Or(v2Eq(v, '*'), v2Eq(v, '\n')),
+                        v2Eq(v, 0)));
+    }
+    return UINT32_MAX;
+}
+template<e_span S> AVX2_FN static size_t spanAvx2(const char *p, size_t len)
+{
+    size_t n = 0;
+    for(; n + 32 <= len; n += 32) {
+        uint32_t m = v2Stop<S>(_mm256_loadu_si256((const __m256i *)(p + n)));
+        if(m != 0)
+            return n + __builtin_ctz(m);
+    }
+    return n;
+}
+static bool cpuAvx2()
+{
+    unsigned int a, b, c, d;
+    if(!__get_cpuid(1, &a, &b, &c, &d) || (c & bit_OSXSAVE) == 0 ||
+        (c & bit_AVX) == 0)
+        return false;
+    // The system saves the AVX registers
+    uint32_t lo, hi;
+    __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    if((lo & 6) != 6)
+        return false;
+    return __get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & bit_AVX2) != 0;
+}
+static const bool useAvx2 = cpuAvx2();
+#endif /* JSON_AVX2 */
+// Number of bytes the scanner pass, the caller checks the rest
+template<e_span S> static inline size_t span(const char *p, const char *end)
+{
+    size_t n = 0;
+#ifdef JSON_VEC
+    const size_t len = end - p;
+#ifdef JSON_AVX2
+    if(useAvx2)
+        return spanAvx2<S>(p, len);
+#endif
+    for(; n + vecSize <= len; n += vecSize) {
+        uint64_t m = vStop<S>(vLoad(p + n));
+        if(m != 0)
+            return n + __builtin_ctzll(m) / maskBits;
+    }
+#else
+    (void)p;
+    (void)end;
+#endif /* JSON_VEC */
+    return n;
+}
+
+static inline int keyCmp(const char *a, size_t al, const char *b, size_t bl)
+{
+    int r = memcmp(a, b, min(al, bl));
+    if(r != 0)
+        return r;
+    return al < bl ? -1 : (al > bl ? 1 : 0);
+}
+static inline bool keyLess(const jsonMember &a, const jsonMember &b)
+{
+    return a.first.compare(b.first.c_str(), b.first.size()) < 0;
+}
 
 enum e_token {
     JSON_OBJ_STA, // { left curly bracket
@@ -47,10 +298,15 @@ class jsonParser
 {
   protected:
     const char *cur = nullptr;
+    const char *end = nullptr; // End of memory the scanners can read
     size_t lineNum = 0;
     bool useComments = false;
-
-  public:
+    bool inSitu = false; // Strings can be terminated in the JSON copy
+    jsonArena *arena = nullptr;
+    string scratch;
+    // Members and elements of the objects and arrays in parsing
+    vector<jsonMember> mStack;
+    vector<jsonValueBase *> eStack;
 
   protected:
     void skipBOM() {
@@ -65,6 +321,7 @@ class jsonParser
   private:
     bool skip_ws() {
         for(;; cur++) {
+            cur += span<SPAN_WS>(cur, end);
             if(isEOF())
                 return true;
             switch(*cur) {
@@ -91,6 +348,7 @@ class jsonParser
             case '/': // Comment until end of line
                 for(;;) {
                     cur++;
+                    cur += span<SPAN_LINE>(cur, end);
                     if(*cur == 0 || *cur == '\n') // end of file or line
                         return false; // Comment is end
                 }
@@ -98,6 +356,9 @@ class jsonParser
             case '*': // Comment until closing
                 for(;;) {
                     cur++;
+                    // The closing solidus must follow the star
+                    if(!haveCloseStar)
+                        cur += span<SPAN_BLOCK>(cur, end);
                     switch(*cur) {
                         case 0:
                             if(isEOF())
@@ -215,18 +476,92 @@ class jsonParser
         }
     }
 
+    void *alloc(size_t size) {
+        return arena != nullptr ? arena->alloc(size) : malloc(size);
+    }
+    const char *store(const string &str) {
+        size_t len = str.size();
+        char *ret = arena != nullptr ? (char *)arena->alloc(len + 1, 1) :
+            new char[len + 1];
+        if(ret != nullptr) {
+            memcpy(ret, str.c_str(), len);
+            ret[len] = 0;
+        }
+        return ret;
+    }
+    // Scan a string without escapes and terminate it in place
+    bool scanStr(const char *&str, size_t &len) {
+        const char *p = cur + 1;
+        for(;;) {
+            p += span<SPAN_STR>(p, end);
+            uint8_t a = *(uint8_t *)p;
+            switch(a) {
+                case 0: // End of JSON
+                    FALLTHROUGH;
+                case '\\': // Escape need decoding
+                    return false;
+                case '"':
+                    str = cur + 1;
+                    len = p - str;
+                    *const_cast<char *>(p) = 0;
+                    cur = p + 1;
+                    return true;
+                default:
+                    break;
+            }
+            p++;
+            if(a < 0x80)
+                continue;
+            // Same checks as checkUTF8()
+            if(a < 0xc0)
+                return false;
+            size_t e = a >= 0xe0 ? (a >= 0xf0 ? 4 : 3) : 2;
+            for(size_t i = 1; i < e; i++, p++) {
+                a = *(uint8_t *)p;
+                if(a < 0x80 || a >= 0xc0)
+                    return false;
+            }
+        }
+    }
+
   public:
     jsonParser(bool _c = false) : useComments(_c) {}
-    virtual ~jsonParser() {}
+    virtual ~jsonParser() { delete arena; }
     size_t getLine() {return lineNum;}
     bool init(const string &head) {
         if(head.empty())
             return false;
         cur = head.c_str();
+        end = cur + head.size() + 1;
         lineNum = 0;
         skipBOM();
         return true;
     }
+    bool initArena(const string &head) {
+        if(head.empty())
+            return false;
+        size_t len = head.size();
+        arena = new jsonArena((len + 1) * arenaFactor);
+        char *b = (char *)arena->alloc(len + 1, 1);
+        if(b == nullptr)
+            return false;
+        memcpy(b, head.c_str(), len + 1);
+        cur = b;
+        end = b + len + 1;
+        inSitu = true;
+        lineNum = 0;
+        skipBOM();
+        return true;
+    }
+    jsonArena *takeArena() {
+        jsonArena *ret = arena;
+        arena = nullptr;
+        return ret;
+    }
+    void release(jsonValueBase *e) {
+        if(arena == nullptr)
+            delete e;
+    }
     e_token getToken() {
         for(;;) {
             if(skip_ws())
@@ -263,12 +598,37 @@ class jsonParser
         return JSON_INV;
     }
     void closeTk() { cur++; }
-    bool getStr(string &ret) {
+    bool getStr(const char *&str, size_t &len) {
+        if(inSitu) {
+            const char *start = cur;
+            if(scanStr(str, len))
+                return true;
+            cur = start;
+        }
+        if(!decodeStr(scratch))
+            return false;
+        str = store(scratch);
+        len = scratch.size();
+        return str != nullptr;
+    }
+    bool getNum(const char *&str, size_t &len, size_t &dot_loc, size_t &e_loc) {
+        if(!getNum(scratch, dot_loc, e_loc))
+            return false;
+        str = store(scratch);
+        len = scratch.size();
+        return str != nullptr;
+    }
+    bool decodeStr(string &ret) {
         ret.clear();
         cur++;
         bool useSur = false; // Have UTF-16 surrogate pair
         uint16_t W1; // UTF-16 surrogate first value
         for(;;) {
+            if(!useSur) {
+                size_t n = span<SPAN_STR>(cur, end);
+                ret.append(cur, n);
+                cur += n;
+            }
             if(isEOF())
                 return false; //indicate a broken JSON
             if(useSur && *cur != '\\') // surrogate pair must follow
@@ -366,6 +726,18 @@ class jsonParser
         ret += first;
         size_t loc = 1;
         for(;;) {
+            size_t n = span<SPAN_DIGIT>(cur, end);
+            if(n > 0) {
+                // Digits after a leading zero are wrong
+                if((haveZero && loc + n - 1 > locZero) ||
+                    (*cur == '0' && zeroProhib))
+                    return false;
+                ret.append(cur, n);
+                cur += n;
+                loc += n;
+                lastNotDigit = false;
+                zeroProhib = false;
+            }
             if(isEOF() || strchr("]}, \n\r\t", *cur) != nullptr) {
                 if(lastNotDigit)
                     return false;
@@ -412,29 +784,112 @@ class jsonParser
             cur++;
         }
     }
+    template<typename T, typename A> jsonValueBase *create(A a) {
+        if(arena == nullptr)
+            return new T(a);
+        void *m = arena->alloc(sizeof(T));
+        if(m == nullptr)
+            return nullptr;
+        T *ret = new(m) T(a);
+        ret->m_arena = true;
+        return ret;
+    }
+    template<typename T> jsonValueBase *create() {
+        if(arena == nullptr)
+            return new T;
+        void *m = arena->alloc(sizeof(T));
+        if(m == nullptr)
+            return nullptr;
+        T *ret = new(m) T;
+        ret->m_arena = true;
+        return ret;
+    }
     jsonValueBase *ParserCreate(e_token tk) {
         switch(tk) {
             case JSON_OBJ_STA:
                 cur++;
-                return new jsonObject;
+                return create<jsonObject>();
             case JSON_ARR_STA:
                 cur++;
-                return new jsonArray;
+                return create<jsonArray>();
             case JSON_STR:
-                return new jsonValue(t_string);
+                return create<jsonValue>(t_string);
             case JSON_NUM:
-                return new jsonValue(t_number);
+                return create<jsonValue>(t_number);
             case JSON_TRUE:
-                return new jsonValue(true);
+                return create<jsonValue>(true);
             case JSON_FALSE:
-                return new jsonValue(false);
+                return create<jsonValue>(false);
             case JSON_NULL:
-                return new jsonValue();
+                return create<jsonValue>();
             default:
                 break;
         }
         return nullptr;
     }
+    // Object members in parsing
+    size_t membersStart() { return mStack.size(); }
+    size_t pushKey(const char *key, size_t len) {
+        mStack.push_back({jsonStr(key, len), nullptr});
+        return mStack.size() - 1;
+    }
+    void setMember(size_t index, jsonValueBase *e) { mStack[index].second = e; }
+    void dropMembers(size_t start) {
+        if(arena == nullptr)
+            for(size_t i = start; i < mStack.size(); i++) {
+                delete[] mStack[i].first.c_str();
+                delete mStack[i].second;
+            }
+        mStack.resize(start);
+    }
+    bool setMembers(jsonMember *&members, size_t &num, size_t start) {
+        size_t n = mStack.size() - start;
+        jsonMember *m = (jsonMember *)alloc(n * sizeof(jsonMember));
+        if(m == nullptr) {
+            dropMembers(start);
+            return false;
+        }
+        jsonMember *b = mStack.data() + start;
+        if(n < linearKeys) {
+            // Insertion sort is stable, and fast on sorted keys
+            for(size_t i = 0; i < n; i++) {
+                size_t j = i;
+                for(; j > 0 && keyLess(b[i], m[j - 1]); j--)
+                    m[j] = m[j - 1];
+                m[j] = b[i];
+            }
+        } else {
+            stable_sort(b, b + n, keyLess);
+            copy(b, b + n, m);
+        }
+        members = m;
+        num = n;
+        mStack.resize(start);
+        return true;
+    }
+    // Array elements in parsing
+    size_t elementsStart() { return eStack.size(); }
+    void pushElement(jsonValueBase *e) { eStack.push_back(e); }
+    void dropElements(size_t start) {
+        if(arena == nullptr)
+            for(size_t i = start; i < eStack.size(); i++)
+                delete eStack[i];
+        eStack.resize(start);
+    }
+    bool setElements(jsonValueBase **&elements, size_t &num, size_t start) {
+        size_t n = eStack.size() - start;
+        jsonValueBase **e =
+            (jsonValueBase **)alloc(n * sizeof(jsonValueBase *));
+        if(e == nullptr) {
+            dropElements(start);
+            return false;
+        }
+        copy(eStack.begin() + start, eStack.end(), e);
+        elements = e;
+        num = n;
+        eStack.resize(start);
+        return true;
+    }
 };
 
 class jsonParserFile : public jsonParser
@@ -457,6 +912,7 @@ class jsonParserFile : public jsonParser
         if(f == nullptr || fgets(buf, lineSize, f) == nullptr)
             return false;
         cur = buf;
+        end = buf + lineSize;
         lineNum = 0;
         skipBOM();
         return true;
@@ -475,9 +931,9 @@ bool jsonValue::parserVal(jsonParser *_p)
 {
     switch(m_type) {
         case t_string:
-            return _p->getStr(val);
+            return _p->getStr(val, len);
         case t_number:
-            return _p->getNum(val, dot_loc, e_loc);
+            return _p->getNum(val, len, dot_loc, e_loc);
         case t_boolean:
             FALLTHROUGH;
         case t_null:
@@ -494,40 +950,41 @@ bool jsonObject::parserVal(jsonParser *_p)
         _p->closeTk();
         return true;
     }
+    size_t start = _p->membersStart();
     for(;;) {
         // Key
-        string key;
+        const char *key;
+        size_t keyLen;
         tk = _p->getToken();
-        if(tk != JSON_STR || !_p->getStr(key))
-            return false;
+        if(tk != JSON_STR || !_p->getStr(key, keyLen))
+            break;
+        size_t index = _p->pushKey(key, keyLen);
         // member seperator
         tk = _p->getToken();
         if(tk != JSON_NAM_SEP)
-            return false;
+            break;
         _p->closeTk();
         // Value
         tk = _p->getToken();
         jsonValueBase *e = _p->ParserCreate(tk);
         if(e == nullptr)
-            return false;
+            break;
         if(!e->parserVal(_p)) {
-            delete e;
-            return false;
+            _p->release(e);
+            break;
         }
-        members.insert(make_pair(key, e));
+        _p->setMember(index, e);
         // Separetor or end of object
         tk = _p->getToken();
-        switch(tk) {
-            case JSON_OBJ_END:
-                _p->closeTk();
-                return true;
-            case JSON_VAL_SEP:
-                _p->closeTk();
-                break;
-            default:
-                return false;
+        if(tk == JSON_OBJ_END) {
+            _p->closeTk();
+            return _p->setMembers(members, num, start);
         }
+        if(tk != JSON_VAL_SEP)
+            break;
+        _p->closeTk();
     }
+    _p->dropMembers(start);
     return false;
 }
 bool jsonArray::parserVal(jsonParser *_p)
@@ -537,28 +994,27 @@ bool jsonArray::parserVal(jsonParser *_p)
         _p->closeTk();
         return true;
     }
+    size_t start = _p->elementsStart();
     for(;;) {
         jsonValueBase *e = _p->ParserCreate(tk);
         if(e == nullptr)
-            return false;
+            break;
         if(!e->parserVal(_p)) {
-            delete e;
-            return false;
+            _p->release(e);
+            break;
         }
-        elements.push_back(e);
+        _p->pushElement(e);
         tk = _p->getToken();
-        switch(tk) {
-            case JSON_ARR_END:
-                _p->closeTk();
-                return true;
-            case JSON_VAL_SEP:
-                _p->closeTk();
-                tk = _p->getToken();
-                break;
-            default:
-                return false;
+        if(tk == JSON_ARR_END) {
+            _p->closeTk();
+            return _p->setElements(elements, num, start);
         }
+        if(tk != JSON_VAL_SEP)
+            break;
+        _p->closeTk();
+        tk = _p->getToken();
     }
+    _p->dropElements(start);
     return false;
 }
 bool jsonMain::paresJson(jsonParser *_p)
@@ -570,22 +1026,49 @@ bool jsonMain::paresJson(jsonParser *_p)
     if(m == nullptr)
         return false;
     if(!m->parserVal(_p) || _p->getToken() != JSON_EOF) {
-        delete m;
+        _p->release(m);
         return false;
     }
-    delete main;
+    clear();
     main = m;
+    arena = _p->takeArena();
     return true;
 }
-jsonMain::~jsonMain() { delete main; }
-bool jsonMain::parseFile(const string &name, bool useComments)
+void jsonMain::clear()
 {
+    if(arena != nullptr)
+        delete arena; // Release all values at once
+    else
+        delete main;
+    main = nullptr;
+    arena = nullptr;
+}
+jsonMain::~jsonMain() { clear(); }
+bool jsonMain::parseFile(const string &name, bool useComments, bool useArena)
+{
+    if(useArena) {
+        if(name.empty())
+            return false;
+        FILE *f = fopen(name.c_str(), "r");
+        if(f == nullptr)
+            return false;
+        string buffer;
+        char buf[lineSize];
+        size_t len;
+        while((len = fread(buf, 1, lineSize, f)) > 0)
+            buffer.append(buf, len);
+        fclose(f);
+        return parseBuffer(buffer, useComments, true);
+    }
     jsonParserFile _p(useComments);
     return _p.open(name) && paresJson(&_p);
 }
-bool jsonMain::parseBuffer(const string &buffer, bool useComments)
+bool jsonMain::parseBuffer(const string &buffer, bool useComments,
+    bool useArena)
 {
     jsonParser _p(useComments);
+    if(useArena)
+        return _p.initArena(buffer) && paresJson(&_p);
     return _p.init(buffer) && paresJson(&_p);
 }
 bool jsonMain::empty() const { return main == nullptr; }
@@ -730,7 +1213,6 @@ string jsonValueBase::strToStr(const string &str)
 }
 e_type jsonValueBase::getType() const { return m_type; }
 #define cast1(n) dynamic_cast<n *>(const_cast<jsonValueBase *>(this))
-#define cast2(n) const_cast<decltype(n)*>(&n)
 jsonValue *jsonValueBase::getVal() const
 {
     return isJsonValue(m_type) ? cast1(jsonValue) : nullptr;
@@ -743,19 +1225,41 @@ jsonArray *jsonValueBase::getArr() const
 {
     return m_type == t_array ? cast1(jsonArray) : nullptr;
 }
-jsonValue::jsonValue(e_type type) : jsonValueBase(type) {}
-jsonValue::jsonValue(bool boolean) : jsonValueBase(t_boolean),
+jsonStr::jsonStr(const char *str, size_t len) : m_str(str), m_len(len) {}
+const char *jsonStr::c_str() const { return m_str; }
+size_t jsonStr::size() const { return m_len; }
+size_t jsonStr::length() const { return m_len; }
+bool jsonStr::empty() const { return m_len == 0; }
+int jsonStr::compare(const char *str, size_t len) const
+{
+    return keyCmp(m_str, m_len, str, len);
+}
+jsonStr::operator string() const { return string(m_str, m_len); }
+static const char emptyStr[] = "";
+jsonValue::jsonValue(e_type type) : jsonValueBase(type), val(emptyStr) {}
+jsonValue::jsonValue(bool boolean) : jsonValueBase(t_boolean), val(emptyStr),
     valBool(boolean) {}
-jsonValue::jsonValue() : jsonValueBase(t_null) {}
-jsonValue::jsonValue(const string &str) : jsonValueBase(t_string), val(str) {}
+jsonValue::jsonValue() : jsonValueBase(t_null), val(emptyStr) {}
+jsonValue::jsonValue(const string &str) : jsonValueBase(t_string),
+    len(str.size())
+{
+    char *v = new char[len + 1];
+    memcpy(v, str.c_str(), len + 1);
+    val = v;
+}
+jsonValue::~jsonValue()
+{
+    if(!m_arena && val != emptyStr)
+        delete[] val;
+}
 const char *jsonValue::getCStr() const
 {
-    return val.c_str();
+    return val;
 }
-const string &jsonValue::getStr() const { return val; }
+string jsonValue::getStr() const { return string(val, len); }
 size_t jsonValue::getStrLen() const
 {
-    return val.length();
+    return len;
 }
 bool jsonValue::getBool() const { return valBool; }
 bool jsonValue::getInt64(int64_t &_val, bool flexible) const
@@ -794,7 +1298,7 @@ bool jsonValue::getInt64(int64_t &_val, bool flexible) const
             return false;
     }
     char *endptr = nullptr;
-    _val = (int64_t)strtoimax(val.c_str(), &endptr, base);
+    _val = (int64_t)strtoimax(val, &endptr, base);
     return endptr != nullptr && (*endptr == 0 ||
             (flexible && strchr(" \n\r\t", *endptr) != nullptr));
 }
@@ -834,16 +1338,16 @@ bool jsonValue::getUint64(uint64_t &_val, bool flexible) const
             return false;
     }
     char *endptr = nullptr;
-    _val = (uint64_t)strtoumax(val.c_str(), &endptr, base);
+    _val = (uint64_t)strtoumax(val, &endptr, base);
     return endptr != nullptr && (*endptr == 0 ||
             (flexible && strchr(" \n\r\t", *endptr) != nullptr));
 }
 bool jsonValue::getFloat(long double &_val) const
 {
     if(m_type == t_number) {
-        size_t pos;
-        _val = stold(val, &pos);
-        if(pos == val.length())
+        char *endptr = nullptr;
+        _val = strtold(val, &endptr);
+        if(endptr == val + len)
             return true;
     }
     return false;
@@ -856,16 +1360,16 @@ bool jsonValue::getFrac(int64_t &integer, uint64_t &fraction,
             fraction = 0;
             return getInt64(integer);
         }
-        size_t aDot = val.length() - dot_loc - 1;
+        size_t aDot = len - dot_loc - 1;
         if(aDot <= fracSize) {
-            const string before = val.substr(0, dot_loc);
+            const string before(val, dot_loc);
             char *endptr = nullptr;
             integer = (int64_t)strtoimax(before.c_str(), &endptr, 10);
             if(endptr == nullptr || *endptr != 0)
                 return false;
-            const string after = val.substr(dot_loc + 1);
+            const char *after = val + dot_loc + 1;
             endptr = nullptr;
-            fraction = (uint64_t)strtoumax(after.c_str(), &endptr, 10);
+            fraction = (uint64_t)strtoumax(after, &endptr, 10);
             if(endptr == nullptr || *endptr != 0)
                 return false;
             /*for(size_t i = aDot; i < fracSize; i++)
@@ -882,9 +1386,9 @@ string jsonValue::toString(size_t) const
 {
     switch(m_type) {
         case t_string:
-            return strToStr(val);
+            return strToStr(getStr());
         case t_number:
-            return val;
+            return getStr();
         case t_boolean:
             return valBool ? "true" : "false";
         case t_null:
@@ -898,33 +1402,66 @@ jsonObject::jsonObject() : jsonValueBase(t_object)
 }
 jsonObject::~jsonObject()
 {
-    for(auto &i : members)
-        delete i.second;
+    if(!m_arena) {
+        for(size_t i = 0; i < num; i++) {
+            delete[] members[i].first.c_str();
+            delete members[i].second;
+        }
+        free(members);
+    }
 }
 size_t jsonObject::size() const
 {
-    return members.size();
+    return num;
+}
+obj_iter jsonObject::find(const char *key, size_t len) const
+{
+    if(num < linearKeys) {
+        for(size_t i = 0; i < num; i++) {
+            if(members[i].first.compare(key, len) == 0)
+                return obj_iter(members + i);
+        }
+        return end();
+    }
+    jsonMember k = {jsonStr(key, len), nullptr};
+    obj_iter it = lower_bound(begin(), end(), k, keyLess);
+    return it != end() && it->first.compare(key, len) == 0 ? it : end();
+}
+jsonValueBase *jsonObject::findOne(const char *key, size_t len) const
+{
+    obj_iter it = find(key, len);
+    return count(it, key, len) == 1 ? it->second : nullptr;
+}
+size_t jsonObject::count(obj_iter it, const char *key, size_t len) const
+{
+    // Members with the same key follow each other
+    size_t ret = 0;
+    for(; it != end() && it->first.compare(key, len) == 0; it++)
+        ret++;
+    return ret;
 }
 size_t jsonObject::count(const string &key) const
 {
-    return members.count(key);
+    return count(find(key.c_str(), key.size()), key.c_str(), key.size());
 }
-obj_iter jsonObject::find(const string &key) const
+size_t jsonObject::count(const char *key) const
 {
-    return cast2(members)->find(key);
+    size_t len = strlen(key);
+    return count(find(key, len), key, len);
 }
 std::pair<obj_iter, obj_iter> jsonObject::equal_range(const std::string &key)
 const
 {
-    return cast2(members)->equal_range(key);
+    obj_iter it = find(key.c_str(), key.size());
+    return make_pair(it, it + count(it, key.c_str(), key.size()));
 }
 obj_iter jsonObject::begin() const
 {
-    return cast2(members)->begin();
+    return obj_iter(members);
 }
 obj_iter jsonObject::end() const
 {
-    return cast2(members)->end();
+    return obj_iter(members + num);
 }
 e_type jsonObject::getType(const obj_iter &iter) const
 {
@@ -942,28 +1479,27 @@ jsonArray *jsonObject::getArr(const obj_iter &iter) const
 {
     return iter->second->getArr();
 }
-e_type jsonObject::getType(const string &key) const
-{
-    return count(key) == 1 ? getType(find(key)) : t_non;
-}
-jsonValue *jsonObject::getVal(const string &key) const
-{
-    return count(key) == 1 ? getVal(find(key)) : nullptr;
-}
-jsonObject *jsonObject::getObj(const string &key) const
-{
-    return count(key) == 1 ? getObj(find(key)) : nullptr;
-}
-jsonArray *jsonObject::getArr(const string &key) const
-{
-    return count(key) == 1 ? getArr(find(key)) : nullptr;
-}
+#define keyFunc(ret, func, non)\
+    ret jsonObject::func(const string &key) const\
+    {\
+        jsonValueBase *v = findOne(key.c_str(), key.size());\
+        return v != nullptr ? v->func() : non;\
+    }\
+    ret jsonObject::func(const char *key) const\
+    {\
+        jsonValueBase *v = findOne(key, strlen(key));\
+        return v != nullptr ? v->func() : non;\
+    }
+keyFunc(e_type, getType, t_non)
+keyFunc(jsonValue *, getVal, nullptr)
+keyFunc(jsonObject *, getObj, nullptr)
+keyFunc(jsonArray *, getArr, nullptr)
 string jsonObject::toString(size_t ident) const
 {
     string it1(2 * ident, ' ');
     string ret(it1 + "{\n");
-    if(!members.empty()) {
-        for(const auto &m : members)
+    if(num > 0) {
+        for(const auto &m : *this)
             ret += it1 + "  " + strToStr(m.first) + " : " +
                 m.second->toString(ident + 2) + ",\n";
         ret.erase(ret.size() - 2, 1); // Remove the last comma
@@ -976,36 +1512,39 @@ jsonArray::jsonArray() : jsonValueBase(t_array)
 }
 jsonArray::~jsonArray()
 {
-    for(auto &i : elements)
-        delete i;
+    if(!m_arena) {
+        for(size_t i = 0; i < num; i++)
+            delete elements[i];
+        free(elements);
+    }
 }
 size_t jsonArray::size() const
 {
-    return elements.size();
+    return num;
 }
 arr_iter jsonArray::begin() const
 {
-    return cast2(elements)->begin();
+    return arr_iter(elements);
 }
 arr_iter jsonArray::end() const
 {
-    return cast2(elements)->end();
+    return arr_iter(elements + num);
 }
 e_type jsonArray::getType(size_t index) const
 {
-    return index < elements.size() ? elements[index]->getType() : t_non;
+    return index < num ? elements[index]->getType() : t_non;
 }
 jsonValue *jsonArray::getVal(size_t index) const
 {
-    return index < elements.size() ? elements[index]->getVal() : nullptr;
+    return index < num ? elements[index]->getVal() : nullptr;
 }
 jsonObject *jsonArray::getObj(size_t index) const
 {
-    return index < elements.size() ? elements[index]->getObj() : nullptr;
+    return index < num ? elements[index]->getObj() : nullptr;
 }
 jsonArray *jsonArray::getArr(size_t index) const
 {
-    return index < elements.size() ? elements[index]->getArr() : nullptr;
+    return index < num ? elements[index]->getArr() : nullptr;
 }
 e_type jsonArray::getType(const arr_iter &iterator) const
 {
@@ -1027,8 +1566,8 @@ string jsonArray::toString(size_t ident) const
 {
     string it1(2 * ident, ' ');
     string ret = it1 + "[\n";
-    if(!elements.empty()) {
-        for(const auto &e : elements)
+    if(num > 0) {
+        for(const auto &e : *this)
             ret += it1 + "  " + e->toString(ident + 2) + ",\n";
         ret.erase(ret.size() - 2, 1); // Remove the last comma
     }
@@ -12,13 +12,14 @@
 #ifndef __PTPMGMT_JSON_PARSER_H
 #define __PTPMGMT_JSON_PARSER_H
 
-#include <map>
-#include <vector>
 #include <string>
 #include <cstdint>
+#include <cstddef>
+#include <iterator>
 
 class jsonMain;
 class jsonParser;
+class jsonArena;
 class jsonValue;
 class jsonObject;
 class jsonArray;
@@ -46,6 +47,7 @@ class jsonValueBase
 {
   protected:
     e_type m_type; /**< value type */
+    bool m_arena = false; /**< value memory belongs to the parser arena */
 
     /**
       * parse JSON value
@@ -66,6 +68,7 @@ class jsonValueBase
     jsonValueBase(e_type type);
 
     friend class jsonMain;
+    friend class jsonParser;
     friend class jsonObject;
     friend class jsonArray;
 
@@ -101,11 +104,63 @@ class jsonValueBase
     virtual std::string toString(size_t ident = 0) const = 0;
 };
 
+/**
+ * JSON string
+ * @note the string belongs to the JSON value holding it
+ */
+class jsonStr
+{
+  private:
+    const char *m_str;
+    size_t m_len;
+
+  public:
+    /**
+      * Constractor
+      * @param[in] str pointer to a null terminated string
+      * @param[in] len string length
+      */
+    jsonStr(const char *str = "", size_t len = 0);
+    /**
+      * Get String value
+      * @return pointer to a C string
+      */
+    const char *c_str() const;
+    /**
+      * Get String length
+      * @return length
+      */
+    size_t size() const;
+    /**
+      * Get String length
+      * @return length
+      */
+    size_t length() const;
+    /**
+      * Query if string is empty
+      * @return true if string is empty
+      */
+    bool empty() const;
+    /**
+      * Compare string
+      * @param[in] str pointer to string
+      * @param[in] len string length
+      * @return zero if equal, negative if less, positive if greater
+      */
+    int compare(const char *str, size_t len) const;
+    /**
+      * Convert to a standard string
+      * @return String
+      */
+    operator std::string() const;
+};
+
 /** class jsonValue for string, number, boolean or null value */
 class jsonValue : public jsonValueBase
 {
   private:
-    std::string val;
+    const char *val;
+    size_t len = 0;
     bool valBool = false;
     size_t dot_loc = 0;
     size_t e_loc = 0;
@@ -140,6 +195,7 @@ class jsonValue : public jsonValueBase
       * @param[in] str string value
       */
     jsonValue(const std::string &str);
+    ~jsonValue();
     /**
       * Get String value
       * @return pointer to a C string
@@ -149,7 +205,7 @@ class jsonValue : public jsonValueBase
       * Get String value
       * @return String
       */
-    const std::string &getStr() const;
+    std::string getStr() const;
     /**
       * Get String length
       * @return length
@@ -196,20 +252,95 @@ class jsonValue : public jsonValueBase
     std::string toString(size_t ident = 0) const override;
 };
 
+/**
+ * Iterator of contiguous values
+ * @note The iterator is not constructed implicitly,
+ *       so an index zero is not confused with an iterator.
+ */
+template<typename T> class jsonIter
+{
+  private:
+    T *p;
+
+  public:
+    /** iterator category */
+    typedef std::random_access_iterator_tag iterator_category;
+    /** iterator value type */
+    typedef T value_type;
+    /** iterator difference type */
+    typedef std::ptrdiff_t difference_type;
+    /** iterator pointer type */
+    typedef T *pointer;
+    /** iterator reference type */
+    typedef T &reference;
+    /**
+      * Constractor
+      * @param[in] ptr pointer to value
+      */
+    explicit jsonIter(T *ptr = nullptr) : p(ptr) {}
+    /** @cond internal */
+    T &operator*() const { return *p; }
+    T *operator->() const { return p; }
+    T &operator[](std::ptrdiff_t n) const { return p[n]; }
+    jsonIter &operator++() { p++; return *this; }
+    jsonIter operator++(int) { return jsonIter(p++); }
+    jsonIter &operator--() { p--; return *this; }
+    jsonIter operator--(int) { return jsonIter(p--); }
+    jsonIter &operator+=(std::ptrdiff_t n) { p += n; return *this; }
+    jsonIter &operator-=(std::ptrdiff_t n) { p -= n; return *this; }
+    jsonIter operator+(std::ptrdiff_t n) const { return jsonIter(p + n); }
+    jsonIter operator-(std::ptrdiff_t n) const { return jsonIter(p - n); }
+    std::ptrdiff_t operator-(const jsonIter &o) const { return p - o.p; }
+    bool operator==(const jsonIter &o) const { return p == o.p; }
+    bool operator!=(const jsonIter &o) const { return p != o.p; }
+    bool operator<(const jsonIter &o) const { return p < o.p; }
+    bool operator>(const jsonIter &o) const { return p > o.p; }
+    bool operator<=(const jsonIter &o) const { return p <= o.p; }
+    bool operator>=(const jsonIter &o) const { return p >= o.p; }
+    /** @endcond */
+};
+
+/** JSON object member */
+struct jsonMember {
+    jsonStr first; /**< member key */
+    jsonValueBase *second; /**< member value */
+};
+
 /** Iterator type of jsonObject members */
-typedef std::multimap<std::string, jsonValueBase *>::iterator obj_iter;
+typedef jsonIter<jsonMember> obj_iter;
 
-/** class jsonObject for holding JSON object with members */
+/**
+ * class jsonObject for holding JSON object with members
+ * @note members are stored contiguously and ordered by key,
+ *       members with the same key keep the order of the JSON.
+ */
 class jsonObject : public jsonValueBase
 {
   private:
-    std::multimap<std::string, jsonValueBase *> members;
+    jsonMember *members = nullptr;
+    size_t num = 0;
+    /**
+      * Get the first member with a key
+      * @param[in] key string
+      * @param[in] len key length
+      * @return iterator to the member or end
+      */
+    obj_iter find(const char *key, size_t len) const;
     /**
-      * Get a member with a key
+      * Get a single member with a key
       * @param[in] key string
-      * @return iterator to loop all members match the key
+      * @param[in] len key length
+      * @return the member value or null if key is missing or duplicate
       */
-    obj_iter find(const std::string &key) const;
+    jsonValueBase *findOne(const char *key, size_t len) const;
+    /**
+      * Count members with a key
+      * @param[in] it iterator to the first member with the key
+      * @param[in] key string
+      * @param[in] len key length
+      * @return number of members with a key
+      */
+    size_t count(obj_iter it, const char *key, size_t len) const;
 
   protected:
     /**
@@ -234,6 +365,12 @@ class jsonObject : public jsonValueBase
       * @return number of members with a key
       */
     size_t count(const std::string &key) const;
+    /**
+      * Get number of members with a key
+      * @param[in] key C string with key value
+      * @return number of members with a key
+      */
+    size_t count(const char *key) const;
     /**
       * Get a range of member using a key
       * @param[in] key string
@@ -281,6 +418,13 @@ class jsonObject : public jsonValueBase
       * @note Use on single member with this key!
       */
     e_type getType(const std::string &key) const;
+    /**
+      * Get member value type with key
+      * @param[in] key C string
+      * @return value type
+      * @note Use on single member with this key!
+      */
+    e_type getType(const char *key) const;
     /**
       * Get member value object with key
       * @param[in] key string
@@ -288,6 +432,13 @@ class jsonObject : public jsonValueBase
       * @note Use on single member with this key!
       */
     jsonValue *getVal(const std::string &key) const;
+    /**
+      * Get member value object with key
+      * @param[in] key C string
+      * @return value object
+      * @note Use on single member with this key!
+      */
+    jsonValue *getVal(const char *key) const;
     /**
       * Get member JSON object object with key
       * @param[in] key string
@@ -295,6 +446,13 @@ class jsonObject : public jsonValueBase
       * @note Use on single member with this key!
       */
     jsonObject *getObj(const std::string &key) const;
+    /**
+      * Get member JSON object object with key
+      * @param[in] key C string
+      * @return JSON object object
+      * @note Use on single member with this key!
+      */
+    jsonObject *getObj(const char *key) const;
     /**
       * Get member JSON array object with key
       * @param[in] key string
@@ -302,6 +460,13 @@ class jsonObject : public jsonValueBase
       * @note Use on single member with this key!
       */
     jsonArray *getArr(const std::string &key) const;
+    /**
+      * Get member JSON array object with key
+      * @param[in] key C string
+      * @return JSON array object
+      * @note Use on single member with this key!
+      */
+    jsonArray *getArr(const char *key) const;
     /**
       * convert JSON to string
       * @param[in] ident to use
@@ -311,13 +476,14 @@ class jsonObject : public jsonValueBase
 };
 
 /** Iterator type of jsonArray elements */
-typedef std::vector<jsonValueBase *>::iterator arr_iter;
+typedef jsonIter<jsonValueBase *> arr_iter;
 
 /** class jsonArray for holding JSON array with elements */
 class jsonArray : public jsonValueBase
 {
   private:
-    std::vector<jsonValueBase *> elements;
+    jsonValueBase **elements = nullptr;
+    size_t num = 0;
 
   protected:
     /**
@@ -401,11 +567,18 @@ class jsonArray : public jsonValueBase
     std::string toString(size_t ident = 0) const override;
 };
 
-/** class jsonMain for holding a JSON value */
+/**
+ * class jsonMain for holding a JSON value
+ * @note With the arena, the parser places all the values, the keys and
+ *       the strings in a single memory arena, released at once.
+ *       Strings without escapes point into a copy of the JSON.
+ */
 class jsonMain
 {
   private:
     jsonValueBase *main = nullptr;
+    jsonArena *arena = nullptr;
+    void clear();
 
   protected:
     /**
@@ -422,16 +595,20 @@ class jsonMain
       * Parse a JSON file
       * @param[in] file name
       * @param[in] useComments use javascript comments
+      * @param[in] useArena place the values in a single memory arena
       * @return valid JSON parsed
       */
-    bool parseFile(const std::string &file, bool useComments = false);
+    bool parseFile(const std::string &file, bool useComments = false,
+        bool useArena = false);
     /**
       * Parse JSONtring
       * @param[in] buffer contain JSON
       * @param[in] useComments use javascript comments
+      * @param[in] useArena place the values in a single memory arena
       * @return valid JSON parsed
       */
-    bool parseBuffer(const std::string &buffer, bool useComments = false);
+    bool parseBuffer(const std::string &buffer, bool useComments = false,
+        bool useArena = false);
     /**
       * Quary if value exist
       * @return no value exist
@@ -0,0 +1,159 @@
+dnl SPDX-License-Identifier: LGPL-3.0-or-later
+dnl SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+dnl
+dnl @file
+dnl @brief Codecs of fixed size management TLVs
+dnl
+dnl @author Erez Geva <ErezGeva2@@gmail.com>
+dnl @copyright © 2024 Erez Geva
+dnl
+dnl Create mngCodecs.h for internall use by library
+dnl Codecs use the dataField wire layout, as MsgProc build and parse.
+dnl
+dnl The TLVs layout is in mngLayout.m4
+dnl
+define(cd_dec, `ifelse($3, `R', `', `
+        dec`'ifelse($3, `F', `8', `$3')(d.$1, p + $2);')')dnl
+define(cd_enc, `
+        ifelse($3, `R', `p[$2] = 0;', $3, `F',
+            `encF(d.$1, d.flagsMask, p + $2);', `enc$3(d.$1, p + $2);')')dnl
+define(cd_tlv, `/* $1 codec */
+template <> struct MngCodec<$1_t> {
+    static const size_t size = $2;
+    static inline void dec(const uint8_t *p, $1_t &d) {pushdef(`ml',
+            `cd_dec($'`2, $'`3, $'`4)')$3popdef(`ml')
+    }
+    static inline void enc(uint8_t *p, $1_t &d) {pushdef(`ml',
+            `cd_enc($'`2, $'`3, $'`4)')$3popdef(`ml')
+    }
+};
+')dnl
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Codecs of fixed size management TLVs
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * This header is generated automatically, do @b NOT change,
+ * or use it in your application!
+ *
+ * The codecs check the dataField size once,
+ * and convert the fields with fixed offsets.
+ */
+
+#ifndef __PTPMGMT_MNG_CODECS_H
+#define __PTPMGMT_MNG_CODECS_H
+
+#include "comp.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+/* Fields in network order, the dataField may not be aligned */
+template <typename T> static inline void dec8(T &v, const uint8_t *p)
+{
+    v = (T)*p;
+}
+template <typename T> static inline void dec16(T &v, const uint8_t *p)
+{
+    uint16_t n;
+    memcpy(&n, p, sizeof n);
+    v = (T)net_to_cpu16(n);
+}
+template <typename T> static inline void dec32(T &v, const uint8_t *p)
+{
+    uint32_t n;
+    memcpy(&n, p, sizeof n);
+    v = (T)net_to_cpu32(n);
+}
+template <typename T> static inline void dec64(T &v, const uint8_t *p)
+{
+    uint64_t n;
+    memcpy(&n, p, sizeof n);
+    v = (T)net_to_cpu64(n);
+}
+static inline void decCI(ClockIdentity_t &v, const uint8_t *p)
+{
+    memcpy(v.v, p, sizeof v.v);
+}
+static inline void decPI(PortIdentity_t &v, const uint8_t *p)
+{
+    decCI(v.clockIdentity, p);
+    dec16(v.portNumber, p + 8);
+}
+static inline void decCQ(ClockQuality_t &v, const uint8_t *p)
+{
+    dec8(v.clockClass, p);
+    dec8(v.clockAccuracy, p + 1);
+    dec16(v.offsetScaledLogVariance, p + 2);
+}
+static inline void decTI(TimeInterval_t &v, const uint8_t *p)
+{
+    dec64(v.scaledNanoseconds, p);
+}
+template <typename T> static inline void enc8(T v, uint8_t *p)
+{
+    *p = (uint8_t)v;
+}
+template <typename T> static inline void enc16(T v, uint8_t *p)
+{
+    uint16_t n = cpu_to_net16((uint16_t)v);
+    memcpy(p, &n, sizeof n);
+}
+template <typename T> static inline void enc32(T v, uint8_t *p)
+{
+    uint32_t n = cpu_to_net32((uint32_t)v);
+    memcpy(p, &n, sizeof n);
+}
+template <typename T> static inline void enc64(T v, uint8_t *p)
+{
+    uint64_t n = cpu_to_net64((uint64_t)v);
+    memcpy(p, &n, sizeof n);
+}
+static inline void encCI(const ClockIdentity_t &v, uint8_t *p)
+{
+    memcpy(p, v.v, sizeof v.v);
+}
+static inline void encPI(const PortIdentity_t &v, uint8_t *p)
+{
+    encCI(v.clockIdentity, p);
+    enc16(v.portNumber, p + 8);
+}
+static inline void encCQ(const ClockQuality_t &v, uint8_t *p)
+{
+    enc8(v.clockClass, p);
+    enc8(v.clockAccuracy, p + 1);
+    enc16(v.offsetScaledLogVariance, p + 2);
+}
+static inline void encTI(const TimeInterval_t &v, uint8_t *p)
+{
+    enc64(v.scaledNanoseconds, p);
+}
+/* Same as MsgProc::procFlags() */
+static inline void encF(uint8_t &flags, const uint8_t flagsMask, uint8_t *p)
+{
+    if(flagsMask > 1) // Ensure we use proper bits
+        flags &= flagsMask;
+    else if(flags > 0) // We have single flag, any positive goes
+        flags = 1;
+    *p = flags;
+}
+
+/*
+ * Codec of a TLV dataField
+ * TLVs with zero size use the MsgProc functions
+ */
+template <typename T> struct MngCodec {
+    static const size_t size = 0;
+    static inline void dec(const uint8_t *, T &) {}
+    static inline void enc(uint8_t *, T &) {}
+};
+
+define(ml_tlv, `ifelse(index($3, C), -1, `', `cd_tlv($1, $2, `$4')')')dnl
+include(mngLayout.m4)dnl
+
+__PTPMGMT_NAMESPACE_END
+
+#endif /* __PTPMGMT_MNG_CODECS_H */
@@ -0,0 +1,105 @@
+dnl SPDX-License-Identifier: LGPL-3.0-or-later
+dnl SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+dnl
+dnl @file
+dnl @brief Wire layout of fixed size management TLVs
+dnl
+dnl @author Erez Geva <ErezGeva2@@gmail.com>
+dnl @copyright © 2024 Erez Geva
+dnl
+dnl Used by mngViews.m4 and mngCodecs.m4
+dnl The layout follows the dataField as MsgProc build and parse.
+dnl
+dnl ml_tlv(TLV ID, fields size, use, fields list)
+dnl  use: V - read only view, C - codec, VC - both
+dnl  Views use the fields size padded to even size.
+dnl ml(type, name, offset, kind)
+dnl ml_a(type, name, offset, count, kind)
+dnl  kind: 8, 16, 32, 64 - integer or enumerator
+dnl        CI - ClockIdentity_t, PI - PortIdentity_t
+dnl        CQ - ClockQuality_t, TI - TimeInterval_t
+dnl        F - flags, R - reserved octet
+dnl        L64 - 64 bits little endian, linuxptp statistics
+dnl  Arrays and L64 are supported by views only.
+dnl
+ml_tlv(DEFAULT_DATA_SET, 19, VC, `dnl
+ml(uint8_t, flags, 0, F)dnl
+ml(, , 1, R)dnl
+ml(UInteger16_t, numberPorts, 2, 16)dnl
+ml(UInteger8_t, priority1, 4, 8)dnl
+ml(ClockQuality_t, clockQuality, 5, CQ)dnl
+ml(UInteger8_t, priority2, 9, 8)dnl
+ml(ClockIdentity_t, clockIdentity, 10, CI)dnl
+ml(UInteger8_t, domainNumber, 18, 8)')dnl
+ml_tlv(CURRENT_DATA_SET, 18, VC, `dnl
+ml(UInteger16_t, stepsRemoved, 0, 16)dnl
+ml(TimeInterval_t, offsetFromMaster, 2, TI)dnl
+ml(TimeInterval_t, meanPathDelay, 10, TI)')dnl
+ml_tlv(PARENT_DATA_SET, 32, VC, `dnl
+ml(PortIdentity_t, parentPortIdentity, 0, PI)dnl
+ml(uint8_t, flags, 10, F)dnl
+ml(, , 11, R)dnl
+ml(UInteger16_t, observedParentOffsetScaledLogVariance, 12, 16)dnl
+ml(Integer32_t, observedParentClockPhaseChangeRate, 14, 32)dnl
+ml(UInteger8_t, grandmasterPriority1, 18, 8)dnl
+ml(ClockQuality_t, grandmasterClockQuality, 19, CQ)dnl
+ml(UInteger8_t, grandmasterPriority2, 23, 8)dnl
+ml(ClockIdentity_t, grandmasterIdentity, 24, CI)')dnl
+ml_tlv(TIME_PROPERTIES_DATA_SET, 4, VC, `dnl
+ml(Integer16_t, currentUtcOffset, 0, 16)dnl
+ml(uint8_t, flags, 2, F)dnl
+ml(timeSource_e, timeSource, 3, 8)')dnl
+ml_tlv(PORT_DATA_SET, 26, VC, `dnl
+ml(PortIdentity_t, portIdentity, 0, PI)dnl
+ml(portState_e, portState, 10, 8)dnl
+ml(Integer8_t, logMinDelayReqInterval, 11, 8)dnl
+ml(TimeInterval_t, peerMeanPathDelay, 12, TI)dnl
+ml(Integer8_t, logAnnounceInterval, 20, 8)dnl
+ml(UInteger8_t, announceReceiptTimeout, 21, 8)dnl
+ml(Integer8_t, logSyncInterval, 22, 8)dnl
+ml(delayMechanism_e, delayMechanism, 23, 8)dnl
+ml(Integer8_t, logMinPdelayReqInterval, 24, 8)dnl
+ml(Nibble_t, versionNumber, 25, 8)')dnl
+ml_tlv(TIME_STATUS_NP, 50, VC, `dnl
+ml(int64_t, master_offset, 0, 64)dnl
+ml(int64_t, ingress_time, 8, 64)dnl
+ml(Integer32_t, cumulativeScaledRateOffset, 16, 32)dnl
+ml(Integer32_t, scaledLastGmPhaseChange, 20, 32)dnl
+ml(UInteger16_t, gmTimeBaseIndicator, 24, 16)dnl
+ml(uint16_t, nanoseconds_msb, 26, 16)dnl
+ml(uint64_t, nanoseconds_lsb, 28, 64)dnl
+ml(uint16_t, fractional_nanoseconds, 36, 16)dnl
+ml(Integer32_t, gmPresent, 38, 32)dnl
+ml(ClockIdentity_t, gmIdentity, 42, CI)')dnl
+ml_tlv(GRANDMASTER_SETTINGS_NP, 8, C, `dnl
+ml(ClockQuality_t, clockQuality, 0, CQ)dnl
+ml(Integer16_t, currentUtcOffset, 4, 16)dnl
+ml(uint8_t, flags, 6, F)dnl
+ml(timeSource_e, timeSource, 7, 8)')dnl
+ml_tlv(PORT_DATA_SET_NP, 8, C, `dnl
+ml(UInteger32_t, neighborPropDelayThresh, 0, 32)dnl
+ml(Integer32_t, asCapable, 4, 32)')dnl
+ml_tlv(PORT_STATS_NP, 266, V, `dnl
+ml(PortIdentity_t, portIdentity, 0, PI)dnl
+ml_a(uint64_t, rxMsgType, 10, MAX_MESSAGE_TYPES, L64)dnl
+ml_a(uint64_t, txMsgType, 138, MAX_MESSAGE_TYPES, L64)')dnl
+ml_tlv(PORT_SERVICE_STATS_NP, 90, V, `dnl
+ml(PortIdentity_t, portIdentity, 0, PI)dnl
+ml(uint64_t, announce_timeout, 10, L64)dnl
+ml(uint64_t, sync_timeout, 18, L64)dnl
+ml(uint64_t, delay_timeout, 26, L64)dnl
+ml(uint64_t, unicast_service_timeout, 34, L64)dnl
+ml(uint64_t, unicast_request_timeout, 42, L64)dnl
+ml(uint64_t, master_announce_timeout, 50, L64)dnl
+ml(uint64_t, master_sync_timeout, 58, L64)dnl
+ml(uint64_t, qualification_timeout, 66, L64)dnl
+ml(uint64_t, sync_mismatch, 74, L64)dnl
+ml(uint64_t, followup_mismatch, 82, L64)')dnl
+ml_tlv(PORT_HWCLOCK_NP, 15, VC, `dnl
+ml(PortIdentity_t, portIdentity, 0, PI)dnl
+ml(Integer32_t, phc_index, 10, 32)dnl
+ml(UInteger8_t, flags, 14, 8)')dnl
+ml_tlv(CMLDS_INFO_NP, 16, C, `dnl
+ml(TimeInterval_t, meanLinkDelay, 0, TI)dnl
+ml(Integer32_t, scaledNeighborRateRatio, 8, 32)dnl
+ml(uint32_t, as_capable, 12, 32)')dnl
@@ -18,6 +18,7 @@
 #include "msg.h"
 #include "c/types.h"
 #include "c/mngTlvs.h"
+#include "mngCodecs.h"
 
 #if __FLOAT_WORD_ORDER__ == __ORDER_BIG_ENDIAN__
 #define ptpm_ordMod USE_BIG // Prefer network order
@@ -115,25 +116,47 @@ bool SUBSCRIBE_EVENTS_NP_t::div_event(int event, div_t &d)
     return true;
 }
 
+template <typename T> bool MsgProc::codec_f(T &d)
+{
+    const size_t size = MngCodec<T>::size;
+    if(m_left < (ssize_t)size)
+        return true;
+    if(m_build)
+        MngCodec<T>::enc(m_cur, d);
+    else
+        MngCodec<T>::dec(m_cur, d);
+    move(size);
+    return false;
+}
 MNG_PARSE_ERROR_e MsgProc::call_tlv_data(mng_vals_e id, BaseMngTlv *&tlv)
 {
+/* Fixed size TLVs use the generated codec, selected on compilation */
+#define _ptpmProc(n, d) (MngCodec<n##_t>::size > 0 ? codec_f(d) : n##_f(d))
 #define _ptpmCaseNA(n) case n: return MNG_PARSE_ERROR_OK
 #define _ptpmCaseUF(n) case n:\
         if(m_build) {\
             n##_t *a = dynamic_cast<n##_t *>(tlv);\
             if(a == nullptr)\
                 return MNG_PARSE_ERROR_MISMATCH_TLV;\
-            if(n##_f(*a))\
+            if(_ptpmProc(n, *a))\
                 return m_err;\
         } else {\
-            n##_t *t = new n##_t;\
-            if(t == nullptr)\
-                return MNG_PARSE_ERROR_MEM;\
-            if(n##_f(*t)) {\
-                delete t;\
+            /* Parse into the TLV if it is of proper type */\
+            n##_t *t = dynamic_cast<n##_t *>(tlv);\
+            if(t == nullptr) {\
+                t = new n##_t;\
+                if(t == nullptr)\
+                    return MNG_PARSE_ERROR_MEM;\
+            }\
+            if(_ptpmProc(n, *t)) {\
+                if(t != tlv)\
+                    delete t;\
                 return m_err;\
             }\
-            tlv = t;\
+            if(t != tlv) {\
+                delete tlv;\
+                tlv = t;\
+            }\
         }; break
     // The default error on build or parsing
     m_err = MNG_PARSE_ERROR_TOO_SMALL;
@@ -143,6 +166,7 @@ MNG_PARSE_ERROR_e MsgProc::call_tlv_data(mng_vals_e id, BaseMngTlv *&tlv)
         default:
             return MNG_PARSE_ERROR_UNSUPPORT;
     }
+#undef _ptpmProc
     // The mng ID is not supported yet
     return MNG_PARSE_ERROR_OK;
 }
@@ -549,7 +573,8 @@ bool MsgProc::procLe(uint64_t &val)
 template <typename T> bool MsgProc::vector_f(uint32_t count, vector<T> &vec)
 {
     vector_b(vec) {
-        vec.reserve(vec.size() + count);
+        vec.clear(); // Reused TLV may hold records
+        vec.reserve(count);
         for(uint32_t i = 0; i < count; i++) {
             T rec = {};
             if(proc(rec))
@@ -567,6 +592,7 @@ vf(LinuxptpUnicastMaster_t);
 template <typename T> bool MsgProc::vector_o(vector<T> &vec)
 {
     vector_b(vec) {
+        vec.clear(); // Reused TLV may hold records
         while(m_left >= (ssize_t)T::size()) {
             T rec = {};
             if(proc(rec))
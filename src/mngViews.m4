@@ -0,0 +1,164 @@
+dnl SPDX-License-Identifier: LGPL-3.0-or-later
+dnl SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+dnl
+dnl @file
+dnl @brief Create read only views of PTP management TLVs
+dnl
+dnl @author Erez Geva <ErezGeva2@@gmail.com>
+dnl @copyright © 2024 Erez Geva
+dnl
+dnl Create mngViews.h, read only views over the received dataField.
+dnl Views use the dataField wire layout, as parsed by MsgProc.
+dnl Only management TLVs with a fixed dataField size are supported.
+dnl
+dnl The TLVs layout is in mngLayout.m4
+dnl
+define(vw_s, `/** Read only view of $1 management TLV */
+class $1_v : public BaseMngView
+{
+  public:
+    /** Management TLV ID of the view */
+    static const mng_vals_e tlvId = $1;
+    /** dataField size */
+    static const size_t dataSize = $2;
+    /**
+     * Construct a view over a management TLV dataField
+     * @param[in] data pointer to the dataField
+     * @param[in] size of the dataField
+     * @note view is valid if dataField is large enough
+     */
+    $1_v(const void *data, size_t size) :
+        BaseMngView(data, size, dataSize) {}
+    /**
+     * Construct a view over a management TLV dataField
+     * @param[in] id management TLV ID of the dataField
+     * @param[in] data pointer to the dataField
+     * @param[in] size of the dataField
+     * @note view is valid if TLV ID match and dataField is large enough
+     */
+    $1_v(mng_vals_e id, const void *data, size_t size) :
+        BaseMngView(id == tlvId ? data : nullptr, size, dataSize) {}')dnl
+define(vw_e, `
+};
+')dnl
+dnl Getter and element size of a field kind
+define(vw_get, `ifelse($1, `CI', `getClockId', $1, `PI', `getPortId',
+    $1, `CQ', `getClockQuality', $1, `TI', `getTimeInterval',
+    $1, `L64', `getLe64', $1, `F', `get8', `get$1')')dnl
+define(vw_size, `ifelse($1, `L64', 8, `eval($1 / 8)')')dnl
+define(vw, `ifelse($4, `R', `', `
+    /** @return $2 */
+    $1 $2() const { return ($1)vw_get($4)($3); }')')dnl
+define(vw_a, `
+    /**
+     * Get $2 value
+     * @param[in] pos position in table
+     * @return $2 value or zero if position is out of range
+     */
+    $1 $2(size_t pos) const {
+        return pos < $4 ? ($1)vw_get($5)($3 + pos * vw_size($5)) : 0;
+    }')dnl
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Read only views of PTP management TLVs
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * This header is generated automatically, do @b NOT change.
+ *
+ * @details
+ *  Views wrap the dataField of a received management TLV.
+ *  Fields are decoded on access, without parsing the whole TLV.
+ *  Use with Message::parseView() and Message::view().
+ * @note The views are available in C++ only.
+ */
+
+#ifndef __PTPMGMT_MNG_VIEWS_H
+#define __PTPMGMT_MNG_VIEWS_H
+
+#ifdef __cplusplus
+#include "msg.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+/**
+ * @brief Base for read only views of management TLVs
+ * @details
+ *  The view does not copy the dataField.
+ *  The dataField size is checked once on construction,
+ *  fields are converted from network order on access.
+ * @attention The message buffer must remain valid and unchanged
+ *  while using the view.
+ *  Call isValid() before accessing any field.
+ */
+class BaseMngView
+{
+  protected:
+    /**< @cond internal */
+    const uint8_t *m_data;
+    BaseMngView(const void *data, size_t size, size_t dataSize) :
+        m_data(data != nullptr && size >= dataSize ?
+            (const uint8_t *)data : nullptr) {}
+    uint8_t get8(size_t off) const { return m_data[off]; }
+    uint16_t get16(size_t off) const {
+        return (uint16_t)(m_data[off] << 8 | m_data[off + 1]);
+    }
+    uint32_t get32(size_t off) const {
+        return (uint32_t)get16(off) << 16 | get16(off + 2);
+    }
+    uint64_t get64(size_t off) const {
+        return (uint64_t)get32(off) << 32 | get32(off + 4);
+    }
+    /* linuxptp statistics use little endian order */
+    uint64_t getLe64(size_t off) const {
+        uint64_t v = 0;
+        for(size_t i = 8; i > 0; i--)
+            v = v << 8 | m_data[off + i - 1];
+        return v;
+    }
+    ClockIdentity_t getClockId(size_t off) const {
+        ClockIdentity_t v;
+        for(size_t i = 0; i < sizeof v.v; i++)
+            v.v[i] = m_data[off + i];
+        return v;
+    }
+    PortIdentity_t getPortId(size_t off) const {
+        PortIdentity_t v;
+        v.clockIdentity = getClockId(off);
+        v.portNumber = get16(off + 8);
+        return v;
+    }
+    ClockQuality_t getClockQuality(size_t off) const {
+        ClockQuality_t v;
+        v.clockClass = get8(off);
+        v.clockAccuracy = (clockAccuracy_e)get8(off + 1);
+        v.offsetScaledLogVariance = get16(off + 2);
+        return v;
+    }
+    TimeInterval_t getTimeInterval(size_t off) const {
+        TimeInterval_t v;
+        v.scaledNanoseconds = (int64_t)get64(off);
+        return v;
+    }
+    /**< @endcond */
+
+  public:
+    /**
+     * Query if view is valid
+     * @return true if view wraps a dataField
+     */
+    bool isValid() const { return m_data != nullptr; }
+};
+
+define(ml_tlv, `ifelse(index($3, V), -1, `',
+    `vw_s($1, eval(($2 + 1) / 2 * 2))pushdef(`ml', defn(`vw'))dnl
+pushdef(`ml_a', defn(`vw_a'))$4popdef(`ml', `ml_a')vw_e()')')dnl
+include(mngLayout.m4)dnl
+
+__PTPMGMT_NAMESPACE_END
+#endif /* __cplusplus */
+
+#endif /* __PTPMGMT_MNG_VIEWS_H */
@@ -11,7 +11,10 @@
  */
 
 #include <cmath>
+#include <algorithm>
 #include "msg.h"
+#include "sock.h"
+#include "sigCols.h"
 #include "c/msg.h"
 #include "timeCvrt.h"
 #include "comp.h"
@@ -134,22 +137,149 @@ const static ManagementId_t mng_all_vals[] = {
     [n] = {.value = 0x##v, .scope = s_##sc, .allowed = a, .size = sz},
 #include "ids.h"
 };
+static const char *const mng_all_names[] = {
+#define A(n, v, sc, a, sz, f) [n] = #n,
+#include "ids.h"
+};
+/*
+ * managementId values use the upper nibble and the lower 6 bits only.
+ * Combine them to a dense index of the wire value to ID table.
+ */
+const uint16_t mngIdIdxMask = 0xfc0;
+const size_t mngIdIdxSize = 0x400;
+#define MNG_ID_IDX(v) ((((v) >> 6) & 0x3c0) | ((v) & 0x3f))
+#define A(n, v, sc, a, sz, f) static_assert((0x##v & mngIdIdxMask) == 0,\
+        "managementId " #v " of " #n " does not fit the index");
+#include "ids.h"
+static_assert(LAST_MNG_ID < UINT8_MAX, "IDs table use uint8_t");
+/* Lookup tables of management IDs, build once */
+struct MngIdsTables {
+    /* mng_vals_e + 1 per wire value index, zero for unknown */
+    uint8_t wire[mngIdIdxSize];
+    /* All suffixes of all IDs names, sorted case insensitive */
+    struct suffix {
+        uint8_t id;
+        uint8_t off;
+        const char *str() const { return mng_all_names[id] + off; }
+    };
+    vector<suffix> names;
+    MngIdsTables() : wire{0} {
+        for(int i = FIRST_MNG_ID; i < LAST_MNG_ID; i++) {
+            wire[MNG_ID_IDX(mng_all_vals[i].value)] = i + 1;
+            size_t len = strlen(mng_all_names[i]);
+            for(size_t off = 0; off < len; off++)
+                names.push_back({(uint8_t)i, (uint8_t)off});
+        }
+        std::sort(names.begin(), names.end(),
+        [](const suffix & a, const suffix & b) {
+            return strcasecmp(a.str(), b.str()) < 0;
+        });
+    }
+};
+static const MngIdsTables &mngIdsTables()
+{
+    static const MngIdsTables tbls;
+    return tbls;
+}
+/* Parsed management TLVs kept for reuse, see MsgParams::reuseTlvs */
+struct MngTlvsPool {
+    unique_ptr<BaseMngTlv> tlvs[LAST_MNG_ID];
+    unique_ptr<BaseMngTlv> smpte; /* SMPTE Organization Extension TLV */
+    /* Management TLV ID of the TLV the Message object holds */
+    mng_vals_e dataId = NULL_PTP_MANAGEMENT;
+    unique_ptr<BaseMngTlv> &slot(mng_vals_e id) {
+        return id == SMPTE_MNG_ID ? smpte : tlvs[id];
+    }
+    BaseMngTlv *take(mng_vals_e id) { return slot(id).release(); }
+    /* Return the Message object TLV to the pool */
+    void store(unique_ptr<BaseMngTlv> &data) {
+        if(data != nullptr && dataId != NULL_PTP_MANAGEMENT)
+            slot(dataId) = std::move(data);
+        dataId = NULL_PTP_MANAGEMENT;
+    }
+};
+/*
+ * Parse state shared by the messages of a batch.
+ * Messages of a batch usually come from the same peer with the same
+ *  header fields, management TLV and key.
+ */
+struct Message::BatchCache {
+    /* Parsing progress of the current message */
+    enum Stage { NONE, HEADER, TLV_ID } stage = NONE;
+    /* Parameters checked and TLV pool allocated */
+    bool prepared = false;
+    bool auth = false; /* verify management messages authentication */
+    /* Checked header fields of the last valid header */
+    bool haveHdr = false;
+    uint8_t typeSdo, version, minorSdo;
+    int8_t logInterval;
+    msgType_e type;
+    uint32_t sdoId;
+    /* Last management ID, in network order */
+    bool haveId = false;
+    uint16_t wireId;
+    mng_vals_e id;
+    /* Last authentication key */
+    bool haveKey = false;
+    uint8_t spp;
+    uint32_t keyID;
+    size_t macSize;
+    HMAC_Key *hmac;
+    bool hdrHit(const managementMessage_p *msg) const {
+        return haveHdr && msg->messageType_majorSdoId == typeSdo &&
+            msg->versionPTP == version && msg->minorSdoId == minorSdo &&
+            msg->logMessageInterval == logInterval;
+    }
+    void hdrSet(const managementMessage_p *msg, const Message &m) {
+        haveHdr = true;
+        typeSdo = msg->messageType_majorSdoId;
+        version = msg->versionPTP;
+        minorSdo = msg->minorSdoId;
+        logInterval = msg->logMessageInterval;
+        type = m.m_type;
+        sdoId = m.m_sdoId;
+    }
+};
+/* Use signalling TLV from previous parse if available */
+template <typename T> static inline T *allocSigTlv(BaseSigTlv *reuse)
+{
+    T *t = dynamic_cast<T *>(reuse);
+    if(t == nullptr) {
+        delete reuse;
+        t = new T;
+    }
+    return t;
+}
 bool Message::findTlvId(uint16_t val, mng_vals_e &rid, implementSpecific_e spec)
 {
-    mng_vals_e id;
     uint16_t value = net_to_cpu16(val);
-    switch(value) {
-#define A(n, v, sc, a, sz, f) case 0x##v: id = n; break;
-#include "ids.h"
-        default:
-            return false;
-    }
+    if((value & mngIdIdxMask) > 0)
+        return false;
+    uint8_t i = mngIdsTables().wire[MNG_ID_IDX(value)];
+    if(i == 0)
+        return false;
+    mng_vals_e id = (mng_vals_e)(i - 1);
     /* block linuxptp if it is not used */
     if(spec != linuxptp && mng_all_vals[id].allowed & A_USE_LINUXPTP)
         return false;
     rid = id;
     return true;
 }
+bool Message::findReplyId(uint16_t val, BatchCache *cache)
+{
+    if(cache != nullptr && cache->haveId && cache->wireId == val) {
+        m_replayTlv_id = cache->id;
+        return true;
+    }
+    if(!findTlvId(val, m_replayTlv_id, m_prms.implementSpecific))
+        return false;
+    if(cache != nullptr) {
+        cache->haveId = true;
+        cache->wireId = val;
+        cache->id = m_replayTlv_id;
+    }
+    return true;
+}
 bool Message::checkReplyAction(uint8_t actionField)
 {
     uint8_t allowed = mng_all_vals[m_replayTlv_id].allowed;
@@ -178,6 +308,54 @@ bool Message::allowedAction(mng_vals_e id, actionField_e action)
         return false;
     return mng_all_vals[id].allowed & (1 << action);
 }
+/*
+ * Signalling filter bitmap position
+ * TLV types are allocated from the start of a few ranges,
+ * the bitmap holds the first 64 TLV types of each range.
+ * Return -1 for TLV types outside the bitmap.
+ */
+static inline int sigTlvBit(tlvType_e type)
+{
+    int range;
+    switch(type >> 8) {
+        case 0x00:
+            range = 0;
+            break;
+        case 0x40:
+            range = 1;
+            break;
+        case 0x80:
+            range = 2;
+            break;
+        case 0x7f: // linuxptp
+            range = 3;
+            break;
+        default:
+            return -1;
+    }
+    if((type & 0xc0) != 0)
+        return -1;
+    return range << 6 | (type & 0x3f);
+}
+void Message::setSigFilter()
+{
+    memset(m_allowSigBits, 0, sizeof m_allowSigBits);
+    m_allowSigOthers = 0;
+    for(const auto &a : m_prms.allowSigTlvs) {
+        int bit = sigTlvBit(a.first);
+        if(bit < 0)
+            m_allowSigOthers++;
+        else
+            m_allowSigBits[bit >> 6] |= (uint64_t)1 << (bit & 0x3f);
+    }
+}
+bool Message::isSigTlv(tlvType_e type) const
+{
+    int bit = sigTlvBit(type);
+    if(bit < 0)
+        return m_allowSigOthers > 0 && m_prms.isSigTlv(type);
+    return (m_allowSigBits[bit >> 6] >> (bit & 0x3f)) & 1;
+}
 Message::Message() :
     m_sigTlvs(*this),
     m_init(m_peer),
@@ -192,6 +370,7 @@ Message::Message(const MsgParams &prms) :
 {
     if(m_prms.transportSpecific > 0xf)
         m_prms.transportSpecific = 0;
+    setSigFilter();
 }
 Message::~Message()
 {
@@ -230,6 +409,7 @@ bool Message::updateParams(const MsgParams &prms)
     if(prms.transportSpecific > 0xf)
         return false;
     m_prms = prms;
+    setSigFilter();
     return true;
 }
 bool Message::useAuth(const ConfigFile &cfg, const string &section)
@@ -250,6 +430,7 @@ bool Message::useAuth(const SaFile &sa, uint8_t sppID, uint32_t keyID)
         if(hmac == nullptr)
             return false;
         m_hmac.reset(hmac);
+        m_hmacCache.reset();
         m_sa = sa;
         m_sppID = sppID;
         m_keyID = keyID;
@@ -272,6 +453,54 @@ bool Message::changeAuth(uint8_t sppID, uint32_t keyID)
     }
     return false;
 }
+bool Message::rotateAuth(const SaFile &sa, uint8_t sppID, uint32_t keyID)
+{
+    if(!sa.have(sppID, keyID))
+        return false;
+    // Prepare all keys before the replacement
+    unique_ptr<HMAC_Cache> cache(new HMAC_Cache(m_hmacCacheSize));
+    if(!cache->load(sa, m_hmacCache.get()))
+        return false;
+    const Spp &s = sa.spp(sppID);
+    unique_ptr<HMAC_Key> hmac;
+    if(!m_haveAuth || m_hmac->m_type != s.htype(keyID) ||
+        !(m_hmac->m_key == s.key(keyID))) {
+        hmac.reset(hmac_allocHMAC(s.htype(keyID), s.key(keyID)));
+        if(!hmac)
+            return false;
+    }
+    m_sa = sa;
+    if(hmac)
+        m_hmac = move(hmac);
+    m_hmacCache = move(cache);
+    m_sppID = sppID;
+    m_keyID = keyID;
+    m_haveAuth = true;
+    return true;
+}
+bool Message::rotateAuth(const SaFile &sa)
+{
+    if(!m_haveAuth)
+        return false;
+    return rotateAuth(sa, m_sppID, m_keyID);
+}
+bool Message::preloadAuth()
+{
+    if(!m_haveAuth)
+        return false;
+    if(!m_hmacCache)
+        m_hmacCache.reset(new HMAC_Cache(m_hmacCacheSize));
+    return m_hmacCache->load(m_sa);
+}
+bool Message::setAuthCacheSize(size_t size)
+{
+    if(size == 0)
+        return false;
+    m_hmacCacheSize = size;
+    if(m_hmacCache)
+        m_hmacCache->setCapacity(size);
+    return true;
+}
 bool Message::changeAuth(uint32_t keyID)
 {
     if(m_haveAuth && m_sa.have(m_sppID, keyID)) {
@@ -466,31 +695,97 @@ size_t Message::getMsgLen() const
 }
 MNG_PARSE_ERROR_e Message::parse(const void *buf, ssize_t bufSize)
 {
+    return parseMsg(buf, bufSize, nullptr, false);
+}
+MNG_PARSE_ERROR_e Message::parse(const void *buf, ssize_t bufSize,
+    BaseMngTlv &tlv)
+{
+    return parseMsg(buf, bufSize, &tlv, false);
+}
+MNG_PARSE_ERROR_e Message::parseView(const void *buf, ssize_t bufSize)
+{
+    return parseMsg(buf, bufSize, nullptr, true);
+}
+MNG_PARSE_ERROR_e Message::parseVisit(const void *buf, ssize_t bufSize,
+    const function<bool (const Message &msg, tlvType_e tlvType,
+        const BaseSigTlv *tlv)> &callback)
+{
+    return parseMsg(buf, bufSize, nullptr, false, &callback);
+}
+MNG_PARSE_ERROR_e Message::parseVisitCl(const void *buf, ssize_t bufSize,
+    MessageSigTlvCallback &callback)
+{
+    const sigVisit_f visit = [&callback](const Message & msg,
+    tlvType_e tlvType, const BaseSigTlv * tlv) {
+        return callback.callback(msg, tlvType, tlv);
+    };
+    return parseMsg(buf, bufSize, nullptr, false, &visit);
+}
+MNG_PARSE_ERROR_e Message::parseColumns(const void *buf, ssize_t bufSize,
+    SigColumns &cols)
+{
+    return parseMsg(buf, bufSize, nullptr, false, nullptr, &cols);
+}
+MNG_PARSE_ERROR_e Message::parseMsg(const void *buf, ssize_t bufSize,
+    BaseMngTlv *into, bool view, const sigVisit_f *visit, SigColumns *cols,
+    BatchCache *cache)
+{
+    m_viewData = nullptr;
+    m_viewSize = 0;
+    // A batch checks the parameters once
+    if(cache == nullptr || !cache->prepared) {
+        if(m_prms.reuseTlvs) {
+            if(m_pool == nullptr) {
+                m_pool.reset(new MngTlvsPool);
+                if(m_pool == nullptr)
+                    return MNG_PARSE_ERROR_MEM;
+            } else
+                m_pool->store(m_dataGet);
+        } else if(m_pool != nullptr)
+            m_pool.reset(); // Reuse is disabled, release the pool
+        if(cache != nullptr) {
+            cache->prepared = true;
+            cache->auth = m_haveAuth && (m_prms.rcvAuth & RCV_AUTH_MNG) > 0;
+        }
+    }
     if(bufSize < sigBaseSize)
         return MNG_PARSE_ERROR_TOO_SMALL;
     managementMessage_p *msg = (managementMessage_p *)buf;
     ssize_t msgSize = (ssize_t)net_to_cpu16(msg->messageLength);
     if(msgSize > bufSize)
         return MNG_PARSE_ERROR_HEADER;
-    m_type = (msgType_e)(msg->messageType_majorSdoId & 0xf);
-    switch(m_type) {
-        case Signaling:
-            if(!m_prms.rcvSignaling)
+    // Skip the fixed header fields checks, when they match the previous
+    bool hdrHit = cache != nullptr && cache->hdrHit(msg);
+    if(hdrHit)
+        m_type = cache->type;
+    else {
+        m_type = (msgType_e)(msg->messageType_majorSdoId & 0xf);
+        switch(m_type) {
+            case Signaling:
+                if(!m_prms.rcvSignaling)
+                    return MNG_PARSE_ERROR_HEADER;
+                break;
+            case Management:
+                break;
+            default:
                 return MNG_PARSE_ERROR_HEADER;
-            break;
-        case Management:
-            if(msgSize < mngMsgMinSize)
-                return MNG_PARSE_ERROR_TOO_SMALL;
-            break;
-        default:
-            return MNG_PARSE_ERROR_HEADER;
+        }
     }
+    if(m_type == Management && msgSize < mngMsgMinSize)
+        return MNG_PARSE_ERROR_TOO_SMALL;
     m_versionPTP = msg->versionPTP & 0xf;
     m_minorVersionPTP = msg->versionPTP >> 4;
-    if(m_versionPTP != ptp_major_ver ||
-        msg->logMessageInterval != logMessageIntervalDef)
-        return MNG_PARSE_ERROR_HEADER;
-    m_sdoId = msg->minorSdoId | ((msg->messageType_majorSdoId & 0xf0) << 4);
+    if(hdrHit)
+        m_sdoId = cache->sdoId;
+    else {
+        if(m_versionPTP != ptp_major_ver ||
+            msg->logMessageInterval != logMessageIntervalDef)
+            return MNG_PARSE_ERROR_HEADER;
+        m_sdoId = msg->minorSdoId |
+            ((msg->messageType_majorSdoId & 0xf0) << 4);
+        if(cache != nullptr)
+            cache->hdrSet(msg, *this);
+    }
     m_domainNumber = msg->domainNumber;
     m_isUnicast = msg->flagField[0] & unicastFlag;
     m_PTPProfileSpecific = msg->flagField[0] &
@@ -503,12 +798,14 @@ MNG_PARSE_ERROR_e Message::parse(const void *buf, ssize_t bufSize)
     m_target.portNumber = net_to_cpu16(msg->targetPortIdentity.portNumber);
     memcpy(m_target.clockIdentity.v, msg->targetPortIdentity.clockIdentity.v,
         m_target.clockIdentity.size());
+    if(cache != nullptr)
+        cache->stage = BatchCache::HEADER;
     MsgProc mp;
     if(m_type == Signaling) {
         // Real initializing
         mp.m_cur = (uint8_t *)buf + sigBaseSize;
         mp.m_size = msgSize - sigBaseSize; // pass left to parseSig()
-        return parseSig(buf, &mp);
+        return parseSig(buf, &mp, visit, cols);
     }
     m_sigTlvs.m_lastSig = false;
     // Management message part
@@ -525,8 +822,10 @@ MNG_PARSE_ERROR_e Message::parse(const void *buf, ssize_t bufSize)
         return MNG_PARSE_ERROR_TOO_SMALL;
     msgSize -= tlvSize;
     MNG_PARSE_ERROR_e errAuth = MNG_PARSE_ERROR_OK;
-    if(m_haveAuth && (m_prms.rcvAuth & RCV_AUTH_MNG) > 0) {
-        errAuth = parseAuth(buf, (uint8_t *)cur + tlvSize, msgSize, true);
+    if(cache != nullptr ? cache->auth :
+        m_haveAuth && (m_prms.rcvAuth & RCV_AUTH_MNG) > 0) {
+        errAuth = parseAuth(buf, (uint8_t *)cur + tlvSize, msgSize, true,
+                cache);
         if(errAuth != MNG_PARSE_ERROR_OK && (m_prms.rcvAuth & RCV_AUTH_IGNORE) == 0)
             return errAuth;
     }
@@ -543,9 +842,10 @@ MNG_PARSE_ERROR_e Message::parse(const void *buf, ssize_t bufSize)
             if(mp.m_left < (ssize_t)sizeof(*errTlv))
                 return MNG_PARSE_ERROR_TOO_SMALL;
             errTlv = (managementErrorTLV_p *)cur;
-            if(!findTlvId(errTlv->managementId, m_replayTlv_id,
-                    m_prms.implementSpecific))
+            if(!findReplyId(errTlv->managementId, cache))
                 return MNG_PARSE_ERROR_INVALID_ID;
+            if(cache != nullptr)
+                cache->stage = BatchCache::TLV_ID;
             if(!checkReplyAction(actionField))
                 return MNG_PARSE_ERROR_ACTION;
             m_errorId =
@@ -566,18 +866,44 @@ MNG_PARSE_ERROR_e Message::parse(const void *buf, ssize_t bufSize)
             if(mp.m_left < lengthFieldMngBase)
                 return MNG_PARSE_ERROR_TOO_SMALL;
             // managementId
-            if(!findTlvId(*cur++, m_replayTlv_id, m_prms.implementSpecific))
+            if(!findReplyId(*cur++, cache))
                 return MNG_PARSE_ERROR_INVALID_ID;
+            if(cache != nullptr)
+                cache->stage = BatchCache::TLV_ID;
             if(!checkReplyAction(actionField))
                 return MNG_PARSE_ERROR_ACTION;
             mp.m_left -= lengthFieldMngBase;
             if(mp.m_left == 0)
                 return errAuth;
             mp.m_cur = (uint8_t *)cur;
+            m_viewData = mp.m_cur;
+            m_viewSize = mp.m_left;
+            if(view) {
+                // Leave the dataField for the view
+                m_dataGet.reset();
+                return errAuth;
+            }
+            if(into != nullptr) {
+                if(!verifyTlv(m_replayTlv_id, into))
+                    return MNG_PARSE_ERROR_MISMATCH_TLV;
+                tlv = into;
+                err = mp.call_tlv_data(m_replayTlv_id, tlv);
+                if(err != MNG_PARSE_ERROR_OK)
+                    return err;
+                m_dataGet.reset();
+                return errAuth;
+            }
+            tlv = m_pool != nullptr ? m_pool->take(m_replayTlv_id) : nullptr;
             err = mp.call_tlv_data(m_replayTlv_id, tlv);
-            if(err != MNG_PARSE_ERROR_OK)
+            if(err != MNG_PARSE_ERROR_OK) {
+                // Keep the storage for next parse
+                if(m_pool != nullptr)
+                    m_pool->slot(m_replayTlv_id).reset(tlv);
                 return err;
+            }
             m_dataGet.reset(tlv);
+            if(m_pool != nullptr)
+                m_pool->dataId = m_replayTlv_id;
             return errAuth;
         case ORGANIZATION_EXTENSION:
             if(m_prms.rcvSMPTEOrg) {
@@ -587,15 +913,37 @@ MNG_PARSE_ERROR_e Message::parse(const void *buf, ssize_t bufSize)
                 m_replyAction = COMMAND;
                 mp.m_cur = (uint8_t *)cur;
                 SMPTE_ORGANIZATION_EXTENSION_t *tlvOrg;
-                tlvOrg = new SMPTE_ORGANIZATION_EXTENSION_t;
-                if(tlvOrg == nullptr)
-                    return MNG_PARSE_ERROR_MEM;
-                if(mp.SMPTE_ORGANIZATION_EXTENSION_f(*tlvOrg)) {
-                    delete tlvOrg;
-                    return mp.m_err;
+                if(into != nullptr) {
+                    tlvOrg =
+                        dynamic_cast<SMPTE_ORGANIZATION_EXTENSION_t *>(into);
+                    if(tlvOrg == nullptr)
+                        return MNG_PARSE_ERROR_MISMATCH_TLV;
+                    if(mp.SMPTE_ORGANIZATION_EXTENSION_f(*tlvOrg))
+                        return mp.m_err;
+                    m_dataGet.reset();
+                } else {
+                    tlv = nullptr;
+                    if(m_pool != nullptr)
+                        tlv = m_pool->take(SMPTE_MNG_ID);
+                    tlvOrg =
+                        dynamic_cast<SMPTE_ORGANIZATION_EXTENSION_t *>(tlv);
+                    if(tlvOrg == nullptr) {
+                        delete tlv;
+                        tlvOrg = new SMPTE_ORGANIZATION_EXTENSION_t;
+                        if(tlvOrg == nullptr)
+                            return MNG_PARSE_ERROR_MEM;
+                    }
+                    if(mp.SMPTE_ORGANIZATION_EXTENSION_f(*tlvOrg)) {
+                        delete tlvOrg;
+                        return mp.m_err;
+                    }
+                    m_dataGet.reset(tlvOrg);
+                    if(m_pool != nullptr)
+                        m_pool->dataId = SMPTE_MNG_ID;
                 }
-                m_dataGet.reset(tlvOrg);
                 m_replayTlv_id = SMPTE_MNG_ID;
+                if(cache != nullptr)
+                    cache->stage = BatchCache::TLV_ID;
                 if(errAuth != MNG_PARSE_ERROR_OK)
                     return errAuth;
                 return MNG_PARSE_ERROR_SMPTE;
@@ -612,10 +960,33 @@ MNG_PARSE_ERROR_e Message::parse(const Buf &buf, ssize_t bufSize)
     // As user used too big size in the recieve function
     // But if it does, we need protection!
     return (ssize_t)buf.size() < bufSize ? MNG_PARSE_ERROR_TOO_SMALL :
-        parse(buf.get(), bufSize);
+        parseMsg(buf.get(), bufSize, nullptr, false);
+}
+MNG_PARSE_ERROR_e Message::parse(const Buf &buf, ssize_t bufSize,
+    BaseMngTlv &tlv)
+{
+    return (ssize_t)buf.size() < bufSize ? MNG_PARSE_ERROR_TOO_SMALL :
+        parseMsg(buf.get(), bufSize, &tlv, false);
+}
+MNG_PARSE_ERROR_e Message::parseView(const Buf &buf, ssize_t bufSize)
+{
+    return (ssize_t)buf.size() < bufSize ? MNG_PARSE_ERROR_TOO_SMALL :
+        parseMsg(buf.get(), bufSize, nullptr, true);
+}
+MNG_PARSE_ERROR_e Message::parseVisitCl(const Buf &buf, ssize_t bufSize,
+    MessageSigTlvCallback &callback)
+{
+    return (ssize_t)buf.size() < bufSize ? MNG_PARSE_ERROR_TOO_SMALL :
+        parseVisitCl(buf.get(), bufSize, callback);
+}
+MNG_PARSE_ERROR_e Message::parseColumns(const Buf &buf, ssize_t bufSize,
+    SigColumns &cols)
+{
+    return (ssize_t)buf.size() < bufSize ? MNG_PARSE_ERROR_TOO_SMALL :
+        parseMsg(buf.get(), bufSize, nullptr, false, nullptr, &cols);
 }
 MNG_PARSE_ERROR_e Message::parseAuth(const void *buf, const void *auth,
-    ssize_t left, bool check)
+    ssize_t left, bool check, BatchCache *cache)
 {
     if(left < (ssize_t)authTlvSize)
         return MNG_PARSE_ERROR_AUTH_NONE;
@@ -624,7 +995,10 @@ MNG_PARSE_ERROR_e Message::parseAuth(const void *buf, const void *auth,
         return MNG_PARSE_ERROR_AUTH_NONE;
     uint8_t spp = atlv->spp;
     uint32_t keyID = net_to_cpu32(atlv->keyID);
-    if(!m_sa.have(spp, keyID))
+    // A batch keeps the key of the previous message
+    bool keyHit = cache != nullptr && cache->haveKey && cache->spp == spp &&
+        cache->keyID == keyID;
+    if(!keyHit && !m_sa.have(spp, keyID))
         return MNG_PARSE_ERROR_AUTH_NOKEY;
     size_t len;
     if(check) {
@@ -641,21 +1015,37 @@ MNG_PARSE_ERROR_e Message::parseAuth(const void *buf, const void *auth,
         return MNG_PARSE_ERROR_AUTH; // We do not support optional
     if((len & 1) > 0 || len < 2)
         return MNG_PARSE_ERROR_AUTH;
-    // Delete hmac once the function exit :-)
-    unique_ptr<HMAC_Key> hmac_alloc;
     HMAC_Key *hmac;
-    const Spp &s = m_sa.spp(spp);
-    if(len > s.mac_size(m_keyID))
-        return MNG_PARSE_ERROR_AUTH_WRONG;
-    if(m_sppID == spp && m_keyID == keyID)
-        // Using the same key for sending
-        hmac = m_hmac.get();
-    else {
-        hmac = hmac_allocHMAC(s.htype(keyID), s.key(keyID));
-        if(hmac == nullptr)
-            return MNG_PARSE_ERROR_AUTH;
-        // We allocate, we will delete on exit
-        hmac_alloc.reset(hmac);
+    if(keyHit) {
+        if(len > cache->macSize)
+            return MNG_PARSE_ERROR_AUTH_WRONG;
+        hmac = cache->hmac;
+    } else {
+        const Spp &s = m_sa.spp(spp);
+        size_t macSize = s.mac_size(keyID);
+        if(len > macSize)
+            return MNG_PARSE_ERROR_AUTH_WRONG;
+        if(m_sppID == spp && m_keyID == keyID)
+            // Using the same key for sending
+            hmac = m_hmac.get();
+        else {
+            // The cache may drop the batch key
+            if(cache != nullptr)
+                cache->haveKey = false;
+            // Keep the key for the following messages
+            if(!m_hmacCache)
+                m_hmacCache.reset(new HMAC_Cache(m_hmacCacheSize));
+            hmac = m_hmacCache->get(s, spp, keyID);
+            if(hmac == nullptr)
+                return MNG_PARSE_ERROR_AUTH;
+        }
+        if(cache != nullptr) {
+            cache->haveKey = true;
+            cache->spp = spp;
+            cache->keyID = keyID;
+            cache->macSize = macSize;
+            cache->hmac = hmac;
+        }
     }
     // Add authentication optional length here
     uint8_t *icv = (uint8_t *)(atlv + 1);
@@ -671,7 +1061,7 @@ MNG_PARSE_ERROR_e Message::parseAuth(const void *buf, const void *auth,
     return MNG_PARSE_ERROR_OK;
 }
 #define caseBuildAct(n) {\
-        n##_t *t = new n##_t;\
+        n##_t *t = allocSigTlv<n##_t>(m_sigTlvs.reuse(tlvType));\
         if(t == nullptr)\
             return MNG_PARSE_ERROR_MEM;\
         if(mp.n##_f(*t)) {\
@@ -682,11 +1072,59 @@ MNG_PARSE_ERROR_e Message::parseAuth(const void *buf, const void *auth,
         break;\
     }
 #define caseBuild(n) n: caseBuildAct(n)
-MNG_PARSE_ERROR_e Message::parseSig(const void *buf, MsgProc *pMp)
+MNG_PARSE_ERROR_e Message::parseSigAuth(const void *buf, const uint8_t *cur,
+    ssize_t left)
+{
+    bool all = (m_prms.rcvAuth & RCV_AUTH_SIG_ALL) > 0;
+    tlvType_e lastTlv = (tlvType_e)0;
+    const void *lastAuth = nullptr;
+    uint16_t lastAuthLen = 0;
+    MNG_PARSE_ERROR_e errAuth = MNG_PARSE_ERROR_OK;
+    while(left >= tlvSizeHdr) {
+        const uint16_t *hdr = (const uint16_t *)cur;
+        lastTlv = (tlvType_e)net_to_cpu16(hdr[0]);
+        uint16_t lengthField = net_to_cpu16(hdr[1]);
+        left -= tlvSizeHdr;
+        if(lengthField > left)
+            return MNG_PARSE_ERROR_TOO_SMALL;
+        left -= lengthField;
+        if(lastTlv == AUTHENTICATION) {
+            lastAuthLen = lengthField + tlvSizeHdr;
+            lastAuth = cur;
+            if(all) {
+                errAuth = parseAuth(buf, lastAuth, lastAuthLen);
+                if(errAuth != MNG_PARSE_ERROR_OK &&
+                    (m_prms.rcvAuth & RCV_AUTH_IGNORE) == 0)
+                    return errAuth;
+            }
+        }
+        cur += tlvSizeHdr + lengthField;
+    }
+    if(lastTlv != AUTHENTICATION)
+        return MNG_PARSE_ERROR_AUTH_NONE;
+    if(!all)
+        errAuth = parseAuth(buf, lastAuth, lastAuthLen);
+    return errAuth;
+}
+MNG_PARSE_ERROR_e Message::parseSig(const void *buf, MsgProc *pMp,
+    const sigVisit_f *visit, SigColumns *cols)
 {
     MsgProc &mp = *pMp;
     ssize_t leftAll = mp.m_size;
-    m_sigTlvs.clearToUse();
+    bool sigAuth = m_haveAuth &&
+        (m_prms.rcvAuth & (RCV_AUTH_SIG_ALL | RCV_AUTH_SIG_LAST)) > 0;
+    if(visit != nullptr)
+        m_sigTlvs.clearToVisit();
+    else
+        m_sigTlvs.clearToUse(m_prms.reuseTlvs);
+    // The visitor and the columns should only see authenticated TLVs
+    bool preAuth = visit != nullptr || cols != nullptr;
+    if(preAuth && sigAuth) {
+        MNG_PARSE_ERROR_e err = parseSigAuth(buf, mp.m_cur, leftAll);
+        if(err != MNG_PARSE_ERROR_OK)
+            return err;
+        sigAuth = false;
+    }
     tlvType_e lastTlv = (tlvType_e)0;
     void *lastAuth = nullptr;
     uint16_t lastAuthLen = 0;
@@ -702,7 +1140,7 @@ MNG_PARSE_ERROR_e Message::parseSig(const void *buf, MsgProc *pMp)
             return MNG_PARSE_ERROR_TOO_SMALL;
         leftAll -= lengthField;
         if(tlvType == AUTHENTICATION) {
-            if(m_haveAuth) {
+            if(m_haveAuth && !preAuth) {
                 lastAuthLen = lengthField + tlvSizeHdr;
                 lastAuth = cur - 1;
                 if((m_prms.rcvAuth & RCV_AUTH_SIG_ALL) > 0) {
@@ -715,11 +1153,19 @@ MNG_PARSE_ERROR_e Message::parseSig(const void *buf, MsgProc *pMp)
             continue;
         }
         // Check signalling filter
-        if(m_prms.filterSignaling && !m_prms.isSigTlv(tlvType)) {
+        if(m_prms.filterSignaling && !isSigTlv(tlvType)) {
             // TLV not in filter is skiped
             mp.m_cur += lengthField;
             continue;
         }
+        if(cols != nullptr &&
+            SigColumns::isColumnsTlv(tlvType, m_prms.implementSpecific)) {
+            MNG_PARSE_ERROR_e err = cols->append(tlvType, mp.m_cur, lengthField);
+            if(err != MNG_PARSE_ERROR_OK)
+                return err;
+            mp.m_cur += lengthField;
+            continue;
+        }
         mp.m_left = lengthField; // for build functions
         BaseSigTlv *tlv = nullptr;
         mng_vals_e managementId;
@@ -746,7 +1192,9 @@ MNG_PARSE_ERROR_e Message::parseSig(const void *buf, MsgProc *pMp)
                 errTlv = (managementErrorTLV_p *)mp.m_cur;
                 if(findTlvId(errTlv->managementId, managementId,
                         m_prms.implementSpecific)) {
-                    MANAGEMENT_ERROR_STATUS_t *d = new MANAGEMENT_ERROR_STATUS_t;
+                    MANAGEMENT_ERROR_STATUS_t *d =
+                        allocSigTlv<MANAGEMENT_ERROR_STATUS_t>(
+                            m_sigTlvs.reuse(tlvType));
                     if(d == nullptr)
                         return MNG_PARSE_ERROR_MEM;
                     mp.m_cur += sizeof(*errTlv);
@@ -769,14 +1217,18 @@ MNG_PARSE_ERROR_e Message::parseSig(const void *buf, MsgProc *pMp)
                         m_prms.implementSpecific) && mp.m_left > 2) {
                     mp.m_cur += 2; // 2 bytes of managementId
                     mp.m_left -= 2;
-                    BaseMngTlv *mtlv;
+                    MANAGEMENT_t *d =
+                        allocSigTlv<MANAGEMENT_t>(m_sigTlvs.reuse(tlvType));
+                    if(d == nullptr)
+                        return MNG_PARSE_ERROR_MEM;
+                    BaseMngTlv *mtlv = nullptr;
+                    if(d->managementId == managementId)
+                        mtlv = d->tlvData.release();
                     MNG_PARSE_ERROR_e err = mp.call_tlv_data(managementId, mtlv);
-                    if(err != MNG_PARSE_ERROR_OK)
-                        return err;
-                    MANAGEMENT_t *d = new MANAGEMENT_t;
-                    if(d == nullptr) {
+                    if(err != MNG_PARSE_ERROR_OK) {
                         delete mtlv;
-                        return MNG_PARSE_ERROR_MEM;
+                        delete d;
+                        return err;
                     }
                     d->managementId = managementId;
                     d->tlvData.reset(mtlv);
@@ -792,10 +1244,16 @@ MNG_PARSE_ERROR_e Message::parseSig(const void *buf, MsgProc *pMp)
         }
         if(mp.m_left > 0)
             mp.m_cur += mp.m_left;
-        m_sigTlvs.push(tlvType, tlv);
+        if(visit == nullptr)
+            m_sigTlvs.push(tlvType, tlv);
+        else if(tlv != nullptr) {
+            bool stop = (*visit)(*this, tlvType, tlv);
+            m_sigTlvs.keep(tlvType, tlv); // Reuse with next TLV
+            if(stop)
+                break;
+        }
     }
-    if(m_haveAuth &&
-        (m_prms.rcvAuth & (RCV_AUTH_SIG_ALL | RCV_AUTH_SIG_LAST)) > 0) {
+    if(sigAuth) {
         if(lastTlv != AUTHENTICATION)
             return MNG_PARSE_ERROR_AUTH_NONE;
         if((m_prms.rcvAuth & RCV_AUTH_SIG_ALL) == 0)
@@ -909,6 +1367,7 @@ const MessageSigTlvs &Message::getSigTlvs() const
 bool Message::disableAuth()
 {
     m_haveAuth = false;
+    m_hmacCache.reset();
     return true;
 }
 int Message::usedAuthSppID() const
@@ -1031,47 +1490,52 @@ const char *Message::act2str_c(actionField_e action)
 }
 const char *Message::mng2str_c(mng_vals_e id)
 {
-    switch(id) {
-#define A(n, v, sc, a, sz, f) case n: return #n;
-#include "ids.h"
-        default:
-            break;
-    }
+    if(id >= FIRST_MNG_ID && id < LAST_MNG_ID)
+        return mng_all_names[id];
     return "unknown";
 }
 const bool Message::findMngID(const string &str, mng_vals_e &id, bool exact)
 {
     if(str.empty())
         return false;
-    int (*_strcmp)(const char *, const char *);
-    if(!exact) {
-        _strcmp = strcasecmp;
-        if(strcasestr(str.c_str(), "NULL") != nullptr) {
-            id = NULL_PTP_MANAGEMENT;
-            return true;
-        }
-    } else
-        _strcmp = strcmp; // Excect match
+    if(!exact && strcasestr(str.c_str(), "NULL") != nullptr) {
+        id = NULL_PTP_MANAGEMENT;
+        return true;
+    }
+    // Find all names containing the string, they have a suffix starting with it
+    typedef MngIdsTables::suffix suffix;
+    const char *s = str.c_str();
+    size_t len = str.size();
+    const vector<suffix> &names = mngIdsTables().names;
+    auto first = std::lower_bound(names.begin(), names.end(), s,
+    [len](const suffix & a, const char *b) {
+        return strncasecmp(a.str(), b, len) < 0;
+    });
+    auto last = std::upper_bound(first, names.end(), s,
+    [len](const char *a, const suffix & b) {
+        return strncasecmp(a, b.str(), len) < 0;
+    });
+    int (*_strcmp)(const char *, const char *) = exact ? strcmp : strcasecmp;
     int find = 0;
-    for(int i = FIRST_MNG_ID; i < LAST_MNG_ID; i++) {
-        mng_vals_e cid = (mng_vals_e)i;
-        const char *sid = mng2str_c(cid);
+    mng_vals_e cid = NULL_PTP_MANAGEMENT;
+    for(auto it = first; it != last; ++it) {
         // A whole word match!
-        if(_strcmp(str.c_str(), sid) == 0) {
-            id = cid;
+        if(it->off == 0 && _strcmp(mng_all_names[it->id], s) == 0) {
+            id = (mng_vals_e)it->id;
             return true;
         }
-        // Partial match
-        if(!exact && strcasestr(sid, str.c_str()) != nullptr) {
-            id = cid;
-            find++;
-            // Once we have 2 partial match
-            // We stick to a whole word match
-            if(find > 1)
-                exact = true;
+        // Partial match, count each ID once
+        if(!exact) {
+            if(find == 0) {
+                cid = (mng_vals_e)it->id;
+                find = 1;
+            } else if(it->id != cid)
+                find = 2;
         }
     }
     // We found 1 partial match :-)
+    if(find == 1)
+        id = cid;
     return find == 1;
 }
 const char *Message::errId2str_c(managementErrorId_e err)
@@ -1412,6 +1876,39 @@ MessageSigTlvs::MessageSigTlvs(MessageSigTlvs &&o) : m_msg(o.m_msg),
     }
     o.m_lastSig = false;
 }
+void MessageSigTlvs::clearToUse(bool reuse)
+{
+    if(reuse)
+        m_spare.swap(m_tlvs); // Keep last TLVs for reuse
+    else
+        m_spare.clear();
+    m_tlvs.clear();
+    m_lastSig = true;
+}
+void MessageSigTlvs::clearToVisit()
+{
+    // Visitor reuse all TLVs objects
+    for(auto &t : m_tlvs)
+        m_spare.push_back(std::move(t));
+    m_tlvs.clear();
+    m_lastSig = true;
+}
+BaseSigTlv *MessageSigTlvs::reuse(tlvType_e tlvType)
+{
+    for(auto &t : m_spare)
+        if(t.m_tlvType == tlvType && t.m_tlv != nullptr)
+            return t.m_tlv.release();
+    return nullptr;
+}
+void MessageSigTlvs::keep(tlvType_e tlvType, BaseSigTlv *tlv)
+{
+    for(auto &t : m_spare)
+        if(t.m_tlvType == tlvType && t.m_tlv == nullptr) {
+            t.m_tlv.reset(tlv);
+            return;
+        }
+    m_spare.push_back(MessageSigTlv(tlv, tlvType));
+}
 void MessageSigTlvs::push(tlvType_e tlvType, BaseSigTlv *tlv)
 {
     if(tlv != nullptr)
@@ -1497,6 +1994,225 @@ MessageSigTlvs::iterator MessageSigTlvs::end() const
     return MessageSigTlvs::iterator(m_tlvs.end());
 }
 
+/* The batch keeps the TLV objects for reuse */
+static inline MsgParams batchParams(const MsgParams &prms)
+{
+    MsgParams p = prms;
+    p.reuseTlvs = true;
+    return p;
+}
+MessageBatch::MessageBatch() : m_msg(batchParams(MsgParams()))
+{
+}
+MessageBatch::MessageBatch(const MsgParams &prms) : m_msg(batchParams(prms))
+{
+}
+Message &MessageBatch::getMessage()
+{
+    return m_msg;
+}
+void MessageBatch::clear()
+{
+    m_count = 0;
+}
+MNG_PARSE_ERROR_e MessageBatch::add(const void *buf, ssize_t msgSize,
+    Message::BatchCache &cache)
+{
+    if(m_count == m_recs.size())
+        m_recs.emplace_back();
+    Rec &r = m_recs[m_count++];
+    if(m_msg.m_pool != nullptr) {
+        // Return the previous TLV object of this position to the pool
+        m_msg.m_pool->store(m_msg.m_dataGet);
+        if(r.data != nullptr)
+            m_msg.m_pool->slot(r.tlvId) = std::move(r.data);
+    } else
+        m_msg.m_dataGet.reset();
+    r = Rec();
+    if(buf == nullptr) {
+        r.err = MNG_PARSE_ERROR_TOO_SMALL;
+        return r.err;
+    }
+    cache.stage = Message::BatchCache::NONE;
+    r.err = m_msg.parseMsg(buf, msgSize, nullptr, false, nullptr, nullptr,
+            &cache);
+    // Copy only the fields parsed from this message
+    if(cache.stage >= Message::BatchCache::HEADER) {
+        r.type = m_msg.m_type;
+        r.peer = m_msg.m_peer;
+        r.sequence = m_msg.m_sequence;
+    }
+    if(cache.stage >= Message::BatchCache::TLV_ID) {
+        r.replyAction = m_msg.m_replyAction;
+        r.tlvId = m_msg.m_replayTlv_id;
+    }
+    if(r.err == MNG_PARSE_ERROR_MSG)
+        r.errId = m_msg.m_errorId;
+    // Take the TLV object parsed
+    r.data = std::move(m_msg.m_dataGet);
+    if(m_msg.m_pool != nullptr)
+        m_msg.m_pool->dataId = NULL_PTP_MANAGEMENT;
+    return r.err;
+}
+MNG_PARSE_ERROR_e MessageBatch::append(const void *buf, ssize_t msgSize)
+{
+    Message::BatchCache cache;
+    return add(buf, msgSize, cache);
+}
+MNG_PARSE_ERROR_e MessageBatch::append(const Buf &buf, ssize_t msgSize)
+{
+    return append((ssize_t)buf.size() < msgSize ? nullptr : buf.get(),
+            msgSize);
+}
+static inline const void *batchBuf(const void *buf, ssize_t)
+{
+    return buf;
+}
+static inline const void *batchBuf(const Buf &buf, ssize_t msgSize)
+{
+    return (ssize_t)buf.size() < msgSize ? nullptr : buf.get();
+}
+template <typename T> size_t MessageBatch::parseAll(const T *bufs,
+    const ssize_t *sizes, size_t count)
+{
+    clear();
+    if(bufs == nullptr || sizes == nullptr)
+        return 0;
+    if(m_recs.size() < count)
+        m_recs.resize(count);
+    // Share the parameters, header, TLV ID and key checks in the batch
+    Message::BatchCache cache;
+    size_t ret = 0;
+    for(size_t i = 0; i < count; i++)
+        if(add(batchBuf(bufs[i], sizes[i]), sizes[i], cache) ==
+            MNG_PARSE_ERROR_OK)
+            ret++;
+    return ret;
+}
+size_t MessageBatch::parse(const void *const *bufs, const ssize_t *sizes,
+    size_t count)
+{
+    return parseAll(bufs, sizes, count);
+}
+size_t MessageBatch::parse(const Buf *bufs, const ssize_t *sizes,
+    size_t count)
+{
+    return parseAll(bufs, sizes, count);
+}
+size_t MessageBatch::size() const
+{
+    return m_count;
+}
+MNG_PARSE_ERROR_e MessageBatch::getErr(size_t position) const
+{
+    return position < m_count ? m_recs[position].err :
+        MNG_PARSE_ERROR_UNSUPPORT;
+}
+msgType_e MessageBatch::getType(size_t position) const
+{
+    return position < m_count ? m_recs[position].type : Management;
+}
+const PortIdentity_t &MessageBatch::getPeer(size_t position) const
+{
+    static const PortIdentity_t empty = PortIdentity_t();
+    return position < m_count ? m_recs[position].peer : empty;
+}
+uint16_t MessageBatch::getSequence(size_t position) const
+{
+    return position < m_count ? m_recs[position].sequence : 0;
+}
+actionField_e MessageBatch::getReplyAction(size_t position) const
+{
+    return position < m_count ? m_recs[position].replyAction : RESPONSE;
+}
+mng_vals_e MessageBatch::getTlvId(size_t position) const
+{
+    return position < m_count ? m_recs[position].tlvId : NULL_PTP_MANAGEMENT;
+}
+managementErrorId_e MessageBatch::getErrId(size_t position) const
+{
+    return position < m_count ? m_recs[position].errId :
+        (managementErrorId_e)0;
+}
+const BaseMngTlv *MessageBatch::getData(size_t position) const
+{
+    return position < m_count ? m_recs[position].data.get() : nullptr;
+}
+
+PreparedRequest::PreparedRequest()
+{
+}
+PreparedRequest::PreparedRequest(Message &msg)
+{
+    prepare(msg);
+}
+PreparedRequest::~PreparedRequest()
+{
+}
+MNG_PARSE_ERROR_e PreparedRequest::prepare(Message &msg, uint16_t sequence)
+{
+    m_len = 0;
+    m_macSize = 0;
+    m_hmac.reset();
+    ssize_t size = msg.getMsgPlanedLen();
+    if(size < 0)
+        return MNG_PARSE_ERROR_INVALID_ID;
+    if(m_buf.size() < (size_t)size && !m_buf.alloc(size))
+        return MNG_PARSE_ERROR_MEM;
+    MNG_PARSE_ERROR_e err = msg.build(m_buf, sequence);
+    if(err != MNG_PARSE_ERROR_OK)
+        return err;
+    if(msg.m_haveAuth && msg.m_prms.sendAuth) {
+        // Use our own key, so the request do not depend on the message
+        const Spp &s = msg.m_sa.spp(msg.m_sppID);
+        m_hmac.reset(hmac_allocHMAC(s.htype(msg.m_keyID), s.key(msg.m_keyID)));
+        if(!m_hmac)
+            return MNG_PARSE_ERROR_AUTH;
+        m_macSize = s.mac_size(msg.m_keyID);
+        m_mac.resize(m_macSize); // Allocate ICV buffer once
+    }
+    m_len = msg.getMsgLen();
+    return MNG_PARSE_ERROR_OK;
+}
+bool PreparedRequest::isReady() const
+{
+    return m_len > 0;
+}
+MNG_PARSE_ERROR_e PreparedRequest::setSequence(uint16_t sequence)
+{
+    if(m_len == 0)
+        return MNG_PARSE_ERROR_TOO_SMALL;
+    managementMessage_p *msg = (managementMessage_p *)m_buf.get();
+    msg->sequenceId = cpu_to_net16(sequence);
+    if(m_macSize > 0) {
+        // The ICV is at the end of the message
+        size_t size = m_len - m_macSize;
+        if(!m_hmac->digest(msg, size, m_mac))
+            return MNG_PARSE_ERROR_AUTH;
+        m_mac.copy((uint8_t *)msg + size);
+    }
+    return MNG_PARSE_ERROR_OK;
+}
+uint16_t PreparedRequest::getSequence() const
+{
+    if(m_len == 0)
+        return 0;
+    return net_to_cpu16(((managementMessage_p *)m_buf.get())->sequenceId);
+}
+const Buf &PreparedRequest::getBuf() const
+{
+    return m_buf;
+}
+size_t PreparedRequest::getMsgLen() const
+{
+    return m_len;
+}
+bool PreparedRequest::send(const SockBase &sock, uint16_t sequence)
+{
+    return setSequence(sequence) == MNG_PARSE_ERROR_OK &&
+        sock.send(m_buf, m_len);
+}
+
 __PTPMGMT_NAMESPACE_END
 
 __PTPMGMT_NAMESPACE_USE;
@@ -1535,6 +2251,7 @@ static inline MsgParams &getMsgParams(ptpmgmt_cpMsgParams p)
     r.rcvSMPTEOrg = p->rcvSMPTEOrg;
     r.sendAuth = p->sendAuth;
     r.rcvAuth = (MsgParams_RcvAuth_e)p->rcvAuth;
+    r.reuseTlvs = p->reuseTlvs;
     r.implementSpecific = (implementSpecific_e)p->implementSpecific;
     memcpy(r.target.clockIdentity.v, p->target.clockIdentity.v,
         ClockIdentity_t::size());
@@ -1658,6 +2375,26 @@ static bool ptpmgmt_msg_changeAuthKey(ptpmgmt_msg m, uint32_t key)
         return ((Message *)m->_this)->changeAuth(key);
     return false;
 }
+static bool ptpmgmt_msg_rotateAuth(ptpmgmt_msg m, const_ptpmgmt_safile sa,
+    uint8_t spp, uint32_t key)
+{
+    if(m != nullptr && m->_this != nullptr && sa != nullptr && sa->_this != nullptr)
+        return ((Message *)m->_this)->rotateAuth(*(const SaFile *)sa->_this, spp,
+                key);
+    return false;
+}
+static bool ptpmgmt_msg_preloadAuth(ptpmgmt_msg m)
+{
+    if(m != nullptr && m->_this != nullptr)
+        return ((Message *)m->_this)->preloadAuth();
+    return false;
+}
+static bool ptpmgmt_msg_setAuthCacheSize(ptpmgmt_msg m, size_t size)
+{
+    if(m != nullptr && m->_this != nullptr)
+        return ((Message *)m->_this)->setAuthCacheSize(size);
+    return false;
+}
 static bool ptpmgmt_msg_disableAuth(ptpmgmt_msg m)
 {
     if(m != nullptr && m->_this != nullptr)
@@ -1835,6 +2572,29 @@ static bool ptpmgmt_msg_traversSigTlvs(ptpmgmt_msg m, void *cookie,
     }
     return false;
 }
+static ptpmgmt_MNG_PARSE_ERROR_e ptpmgmt_msg_parseVisit(ptpmgmt_msg m,
+    const void *buf, ssize_t msgSize, void *cookie,
+    ptpmgmt_msg_sig_callback callback)
+{
+    if(m != nullptr && m->_this != nullptr && buf != nullptr &&
+        callback != nullptr) {
+        return (ptpmgmt_MNG_PARSE_ERROR_e)
+            ((Message *)m->_this)->parseVisit(buf, msgSize,
+                [&m, cookie, callback](
+        const Message &, tlvType_e tlvType, const BaseSigTlv * tlv) {
+            void *x = nullptr;
+            void *x2 = nullptr;
+            void *sig = cpp2cSigTlv(tlvType, tlv, x, x2);
+            if(sig != nullptr) {
+                C_SWP(dataSig1, sig);
+                C_SWP(dataSig2, x);
+                C_SWP(dataSig3, x2);
+            }
+            return callback(cookie, m, (ptpmgmt_tlvType_e)tlvType, sig);
+        });
+    }
+    return PTPMGMT_MNG_PARSE_ERROR_UNSUPPORT;
+}
 C2CPP_ret(size_t, getSigTlvsCount, 0)
 static const void *ptpmgmt_msg_getSigTlv(ptpmgmt_msg m, size_t position)
 {
@@ -1955,6 +2715,10 @@ static inline void ptpmgmt_msg_asign_cb(ptpmgmt_msg m)
     C_ASGN(getSigTlvType);
     C_ASGN(getSigMngTlvType);
     C_ASGN(getSigMngTlv);
+    C_ASGN(parseVisit);
+    C_ASGN(rotateAuth);
+    C_ASGN(preloadAuth);
+    C_ASGN(setAuthCacheSize);
     // set MsgParams
     const MsgParams &pm = ((Message *)m->_this)->getParams();
     m->_prms._this = (void *)&pm; // point to actual message parameters
@@ -2004,6 +2768,141 @@ ptpmgmt_msg ptpmgmt_msg_alloc_wrap(const Message &msg)
     ptpmgmt_msg_asign_cb(m);
     return m;
 }
+static void ptpmgmt_msg_batch_free(ptpmgmt_msg_batch b)
+{
+    if(b != nullptr) {
+        if(b->_msg != nullptr) {
+            b->_msg->free(b->_msg);
+            free(b->_msg);
+        }
+        delete(MessageBatch *)b->_this;
+        free(b->data);
+        free(b->dataTbl);
+        free(b);
+    }
+}
+static ptpmgmt_msg ptpmgmt_msg_batch_getMsg(ptpmgmt_msg_batch b)
+{
+    if(b != nullptr && b->_this != nullptr) {
+        if(b->_msg == nullptr)
+            b->_msg = ptpmgmt_msg_alloc_wrap(
+                    ((MessageBatch *)b->_this)->getMessage());
+        return b->_msg;
+    }
+    return nullptr;
+}
+static void ptpmgmt_msg_batch_clear(const_ptpmgmt_msg_batch b)
+{
+    if(b != nullptr && b->_this != nullptr)
+        ((MessageBatch *)b->_this)->clear();
+}
+static ptpmgmt_MNG_PARSE_ERROR_e ptpmgmt_msg_batch_append(
+    const_ptpmgmt_msg_batch b, const void *buf, ssize_t msgSize)
+{
+    if(b != nullptr && b->_this != nullptr)
+        return (ptpmgmt_MNG_PARSE_ERROR_e)
+            ((MessageBatch *)b->_this)->append(buf, msgSize);
+    return PTPMGMT_MNG_PARSE_ERROR_UNSUPPORT;
+}
+static size_t ptpmgmt_msg_batch_parse(const_ptpmgmt_msg_batch b,
+    const void *const *bufs, const ssize_t *sizes, size_t count)
+{
+    if(b != nullptr && b->_this != nullptr)
+        return ((MessageBatch *)b->_this)->parse(bufs, sizes, count);
+    return 0;
+}
+static size_t ptpmgmt_msg_batch_size(const_ptpmgmt_msg_batch b)
+{
+    if(b != nullptr && b->_this != nullptr)
+        return ((MessageBatch *)b->_this)->size();
+    return 0;
+}
+#define C2CPP_batch(func, ret, def)\
+    static ret ptpmgmt_msg_batch_##func(const_ptpmgmt_msg_batch b,\
+        size_t position) {\
+        if(b != nullptr && b->_this != nullptr)\
+            return (ret)((MessageBatch *)b->_this)->func(position);\
+        return def; }
+C2CPP_batch(getErr, ptpmgmt_MNG_PARSE_ERROR_e,
+    PTPMGMT_MNG_PARSE_ERROR_UNSUPPORT)
+C2CPP_batch(getType, ptpmgmt_msgType_e, ptpmgmt_Management)
+C2CPP_batch(getSequence, uint16_t, 0)
+C2CPP_batch(getReplyAction, ptpmgmt_actionField_e, PTPMGMT_RESPONSE)
+C2CPP_batch(getTlvId, ptpmgmt_mng_vals_e, PTPMGMT_NULL_PTP_MANAGEMENT)
+C2CPP_batch(getErrId, ptpmgmt_managementErrorId_e,
+    (ptpmgmt_managementErrorId_e)0)
+static const ptpmgmt_PortIdentity_t *ptpmgmt_msg_batch_getPeer(
+    ptpmgmt_msg_batch b, size_t position)
+{
+    if(b != nullptr && b->_this != nullptr) {
+        const PortIdentity_t &p = ((MessageBatch *)b->_this)->getPeer(position);
+        ptpmgmt_PortIdentity_t *l = &(b->_peer);
+        memcpy(l->clockIdentity.v, p.clockIdentity.v, ClockIdentity_t::size());
+        l->portNumber = p.portNumber;
+        return l;
+    }
+    return nullptr;
+}
+static const void *ptpmgmt_msg_batch_getData(ptpmgmt_msg_batch b,
+    size_t position)
+{
+    if(b != nullptr && b->_this != nullptr) {
+        MessageBatch *me = (MessageBatch *)b->_this;
+        const BaseMngTlv *t = me->getData(position);
+        if(t != nullptr) {
+            void *x = nullptr;
+            void *tlv = cpp2cMngTlv(me->getTlvId(position), t, x);
+            if(tlv != nullptr) {
+                free(b->data);
+                b->data = tlv;
+                free(b->dataTbl);
+                b->dataTbl = x;
+                return tlv;
+            }
+        }
+    }
+    return nullptr;
+}
+static inline ptpmgmt_msg_batch ptpmgmt_msg_batch_alloc_cb(MessageBatch *me)
+{
+    if(me == nullptr)
+        return nullptr;
+    ptpmgmt_msg_batch b =
+        (ptpmgmt_msg_batch)malloc(sizeof(ptpmgmt_msg_batch_t));
+    if(b == nullptr) {
+        delete me;
+        return nullptr;
+    }
+    memset(b, 0, sizeof(ptpmgmt_msg_batch_t));
+    b->_this = (void *)me;
+#undef C_ASGN
+#define C_ASGN(n) b->n = ptpmgmt_msg_batch_##n
+    C_ASGN(free);
+    C_ASGN(getMsg);
+    C_ASGN(clear);
+    C_ASGN(append);
+    C_ASGN(parse);
+    C_ASGN(size);
+    C_ASGN(getErr);
+    C_ASGN(getType);
+    C_ASGN(getPeer);
+    C_ASGN(getSequence);
+    C_ASGN(getReplyAction);
+    C_ASGN(getTlvId);
+    C_ASGN(getErrId);
+    C_ASGN(getData);
+    return b;
+}
+ptpmgmt_msg_batch ptpmgmt_msg_batch_alloc()
+{
+    return ptpmgmt_msg_batch_alloc_cb(new MessageBatch);
+}
+ptpmgmt_msg_batch ptpmgmt_msg_batch_alloc_prms(ptpmgmt_cpMsgParams prms)
+{
+    if(prms == nullptr || prms->_this == nullptr)
+        return nullptr;
+    return ptpmgmt_msg_batch_alloc_cb(new MessageBatch(getMsgParams(prms)));
+}
 static const size_t tlv_c_size[] = {
 #define _ptpmCaseNA(n) [PTPMGMT_##n] = 0,
 #define _ptpmCaseUF(n) [PTPMGMT_##n] = sizeof(ptpmgmt_##n##_t),
@@ -0,0 +1,261 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Poll many sockets, clocks and timers in a single thread
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "comp.h"
+#include <climits>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include "poller.h"
+#include "timeCvrt.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+// Maximum events per a single wait
+static const int maxEvents = 64;
+
+SockPoller::SockPoller()
+{
+    m_fd = epoll_create1(EPOLL_CLOEXEC);
+}
+SockPoller::~SockPoller()
+{
+    for(auto &e : m_entries) {
+        if(e.second.isTimer)
+            ::close(e.first);
+    }
+    if(m_fd >= 0)
+        ::close(m_fd);
+}
+int SockPoller::getFd() const
+{
+    return m_fd;
+}
+bool SockPoller::addEntry(int fd, const Entry &entry)
+{
+    if(m_fd < 0) {
+        PTPMGMT_ERROR("Poller is not initialized");
+        return false;
+    }
+    if(fd < 0) {
+        PTPMGMT_ERROR("File description is not initialized");
+        return false;
+    }
+    if(m_entries.count(fd) > 0) {
+        PTPMGMT_ERROR("File description is already registered");
+        return false;
+    }
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if(epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        PTPMGMT_ERROR_P("epoll_ctl");
+        return false;
+    }
+    m_entries[fd] = entry;
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockPoller::removeEntry(int fd)
+{
+    auto it = m_entries.find(fd);
+    if(it == m_entries.end()) {
+        PTPMGMT_ERROR("File description is not registered");
+        return false;
+    }
+    // The kernel removes closed file descriptions
+    epoll_ctl(m_fd, EPOLL_CTL_DEL, fd, nullptr);
+    if(it->second.isTimer)
+        ::close(fd);
+    m_entries.erase(it);
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockPoller::add(int fd, const PollerCallback &callback)
+{
+    if(!callback) {
+        PTPMGMT_ERROR("Missing callback");
+        return false;
+    }
+    Entry e;
+    e.callback = callback;
+    return addEntry(fd, e);
+}
+bool SockPoller::add(const SockBase &sock, const PollerCallback &callback)
+{
+    return add(sock.getFd(), callback);
+}
+bool SockPoller::add(const PtpClock &clock, const PollerCallback &callback)
+{
+    return add(clock.getFd(), callback);
+}
+bool SockPoller::add(ManagementSession &session)
+{
+    Entry e;
+    e.session = &session;
+    if(!addEntry(session.getSocket().getFd(), e))
+        return false;
+    m_sessions.push_back(&session);
+    return true;
+}
+bool SockPoller::remove(int fd)
+{
+    auto it = m_entries.find(fd);
+    if(it != m_entries.end() && it->second.isTimer) {
+        PTPMGMT_ERROR("Use cancelTimer() for timers");
+        return false;
+    }
+    if(it != m_entries.end() && it->second.session != nullptr)
+        return remove(*it->second.session);
+    return removeEntry(fd);
+}
+bool SockPoller::remove(const SockBase &sock)
+{
+    return remove(sock.getFd());
+}
+bool SockPoller::remove(const PtpClock &clock)
+{
+    return remove(clock.getFd());
+}
+bool SockPoller::remove(ManagementSession &session)
+{
+    for(auto it = m_sessions.begin(); it != m_sessions.end(); it++) {
+        if(*it == &session) {
+            m_sessions.erase(it);
+            return removeEntry(session.getSocket().getFd());
+        }
+    }
+    PTPMGMT_ERROR("Session is not registered");
+    return false;
+}
+int SockPoller::addTimer(uint64_t timeout_ms,
+    const PollerTimerCallback &callback, bool periodic)
+{
+    if(timeout_ms == 0) {
+        PTPMGMT_ERROR("Timer without timeout");
+        return -1;
+    }
+    if(!callback) {
+        PTPMGMT_ERROR("Missing callback");
+        return -1;
+    }
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if(fd < 0) {
+        PTPMGMT_ERROR_P("timerfd_create");
+        return -1;
+    }
+    itimerspec its = {};
+    its.it_value.tv_sec = timeout_ms / MSEC_PER_SEC;
+    its.it_value.tv_nsec = (timeout_ms % MSEC_PER_SEC) * NSEC_PER_MSEC;
+    if(periodic)
+        its.it_interval = its.it_value;
+    if(timerfd_settime(fd, 0, &its, nullptr) != 0) {
+        PTPMGMT_ERROR_P("timerfd_settime");
+        ::close(fd);
+        return -1;
+    }
+    Entry e;
+    e.timerCallback = callback;
+    e.isTimer = true;
+    e.periodic = periodic;
+    if(!addEntry(fd, e)) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+bool SockPoller::cancelTimer(int timerId)
+{
+    auto it = m_entries.find(timerId);
+    if(it == m_entries.end() || !it->second.isTimer) {
+        PTPMGMT_ERROR("Timer is not pending");
+        return false;
+    }
+    return removeEntry(timerId);
+}
+ssize_t SockPoller::dispatch(uint64_t timeout_ms)
+{
+    if(m_fd < 0) {
+        PTPMGMT_ERROR("Poller is not initialized");
+        return -1;
+    }
+    if(m_entries.empty()) {
+        PTPMGMT_ERROR("Nothing to poll");
+        return -1;
+    }
+    // epoll_wait() blocks with negative timeout
+    int wait = -1;
+    if(timeout_ms > 0)
+        wait = std::min(timeout_ms, (uint64_t)INT_MAX);
+    // Wake up for the first session request timeout
+    for(ManagementSession *s : m_sessions) {
+        uint64_t t;
+        if(s->nextTimeout(t) && (wait < 0 || t < (uint64_t)wait))
+            wait = t;
+    }
+    epoll_event evs[maxEvents];
+    int cnt = epoll_wait(m_fd, evs, maxEvents, wait);
+    if(cnt < 0) {
+        if(errno != EINTR) {
+            PTPMGMT_ERROR_P("epoll_wait");
+            return -1;
+        }
+        cnt = 0;
+    }
+    size_t done = 0;
+    for(int i = 0; i < cnt; i++) {
+        int fd = evs[i].data.fd;
+        // A previous callback may remove the entry
+        auto it = m_entries.find(fd);
+        if(it == m_entries.end())
+            continue;
+        if(it->second.isTimer) {
+            uint64_t expirations;
+            if(read(fd, &expirations, sizeof expirations) < 0)
+                continue;
+            // Keep a copy, as the callback may cancel the timer
+            PollerTimerCallback callback = it->second.timerCallback;
+            if(!it->second.periodic)
+                removeEntry(fd);
+            callback(fd);
+            done++;
+        } else if(it->second.session != nullptr)
+            done += it->second.session->process();
+        else {
+            PollerCallback callback = it->second.callback;
+            callback(fd);
+            done++;
+        }
+    }
+    // Sessions with timeout and without replies
+    std::vector<ManagementSession *> sessions = m_sessions;
+    for(ManagementSession *s : sessions)
+        done += s->expire();
+    PTPMGMT_ERROR_CLR;
+    return done;
+}
+bool SockPoller::run()
+{
+    m_stop = false;
+    while(!m_stop) {
+        if(dispatch() < 0)
+            return false;
+    }
+    return true;
+}
+void SockPoller::stop()
+{
+    m_stop = true;
+}
+
+__PTPMGMT_NAMESPACE_END
@@ -0,0 +1,335 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Management session with many requests in flight
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <vector>
+#include "session.h"
+#include "timeCvrt.h"
+#include "comp.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+static const size_t bufSize = 2000;
+static const uint16_t allPorts = UINT16_MAX;
+
+uint64_t SessionParse::nowNs()
+{
+    timespec ts;
+    if(clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+    return ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+MsgParams SessionParse::params(const MsgParams &prms)
+{
+    MsgParams p = prms;
+    p.reuseTlvs = false;
+    return p;
+}
+uint64_t SessionParse::toMs(uint64_t ns)
+{
+    return (ns + NSEC_PER_MSEC - 1) / NSEC_PER_MSEC;
+}
+bool SessionParse::parse(Message &msg, const void *buf, ssize_t msgSize,
+    MNG_PARSE_ERROR_e &err)
+{
+    // Replies with an empty dataField do not reset the TLV
+    msg.m_dataGet.reset();
+    err = msg.parse(buf, msgSize);
+    // Only management replies and management error replies
+    return err == MNG_PARSE_ERROR_OK || err == MNG_PARSE_ERROR_MSG;
+}
+void SessionParse::setReply(Message &msg, MNG_PARSE_ERROR_e err,
+    SessionReply &reply)
+{
+    reply.state = SESSION_REPLY;
+    reply.err = err;
+    reply.sequence = msg.getSequence();
+    reply.peer = msg.getPeer();
+    reply.tlvId = msg.getTlvId();
+    reply.replyAction = msg.getReplyAction();
+    reply.errId = msg.getErrId();
+    reply.data.reset(msg.m_dataGet.release());
+}
+void SessionRttStats::add(uint64_t ns)
+{
+    if(count == 0 || ns < min)
+        min = ns;
+    if(ns > max)
+        max = ns;
+    sum += ns;
+    count++;
+}
+static inline bool isAllClocks(const ClockIdentity_t &id)
+{
+    for(size_t i = 0; i < sizeof id.v; i++) {
+        if(id.v[i] != UINT8_MAX)
+            return false;
+    }
+    return true;
+}
+// All clocks and all ports match any peer
+static inline bool matchPeer(const PortIdentity_t &target,
+    const PortIdentity_t &peer)
+{
+    return (target.portNumber == allPorts ||
+            target.portNumber == peer.portNumber) &&
+        (isAllClocks(target.clockIdentity) ||
+            target.clockIdentity == peer.clockIdentity);
+}
+
+ManagementSession::ManagementSession(const SockBase &sock) : m_sock(sock),
+    m_msg(SessionParse::params(MsgParams())), m_buf(bufSize)
+{
+}
+ManagementSession::ManagementSession(const SockBase &sock,
+    const MsgParams &prms) : m_sock(sock), m_msg(SessionParse::params(prms)),
+    m_buf(bufSize)
+{
+}
+ManagementSession::~ManagementSession()
+{
+    cancel();
+}
+Message &ManagementSession::getMessage()
+{
+    return m_msg;
+}
+bool ManagementSession::send(const PortIdentity_t &target,
+    actionField_e action, mng_vals_e tlv_id, uint64_t timeout_ms,
+    const SessionCallback &callback, const BaseMngTlv *data,
+    SessionReply &reply)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    if(m_reqs.size() > UINT16_MAX) {
+        PTPMGMT_ERROR("All sequence IDs are in flight");
+        reply.err = MNG_PARSE_ERROR_TOO_SMALL;
+        return false;
+    }
+    // Skip sequence IDs in flight
+    while(m_reqs.count(m_seq) > 0)
+        m_seq++;
+    uint16_t sequence = m_seq;
+    reply.sequence = sequence;
+    if(!m_msg.setAction(action, tlv_id, data)) {
+        reply.err = MNG_PARSE_ERROR_INVALID_ID;
+        return false;
+    }
+    m_msg.m_prms.target = target;
+    reply.err = m_msg.build(m_buf, sequence);
+    m_msg.clearData(); // Do not keep the application TLV
+    if(reply.err != MNG_PARSE_ERROR_OK)
+        return false;
+    Req &r = m_reqs[sequence];
+    r.target = target;
+    r.sent = SessionParse::nowNs();
+    r.deadline = r.sent + timeout_ms * NSEC_PER_MSEC;
+    r.callback = callback;
+    r.txId = m_sock.getTxId();
+    if(!m_sock.send(m_buf, m_msg.getMsgLen())) {
+        m_reqs.erase(sequence);
+        return false;
+    }
+    m_seq++;
+    return true;
+}
+bool ManagementSession::request(const PortIdentity_t &target,
+    actionField_e action, mng_vals_e tlv_id, uint64_t timeout_ms,
+    const SessionCallback &callback, const BaseMngTlv *data)
+{
+    SessionReply reply;
+    return send(target, action, tlv_id, timeout_ms, callback, data, reply);
+}
+std::future<SessionReply> ManagementSession::requestFuture(
+    const PortIdentity_t &target, actionField_e action, mng_vals_e tlv_id,
+    uint64_t timeout_ms, const BaseMngTlv *data)
+{
+    // The callback must be copyable
+    std::shared_ptr<std::promise<SessionReply>> promise(
+        new std::promise<SessionReply>);
+    SessionReply reply;
+    if(!send(target, action, tlv_id, timeout_ms,
+    [promise](const SessionReply & r) { promise->set_value(r); }, data,
+        reply)) {
+        reply.state = SESSION_SEND_FAIL;
+        promise->set_value(reply);
+    }
+    return promise->get_future();
+}
+bool ManagementSession::handle(const void *buf, ssize_t msgSize,
+    const Timestamp_t &rxTs, SessionReply &reply, SessionCallback &callback)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    MNG_PARSE_ERROR_e err;
+    if(!SessionParse::parse(m_msg, buf, msgSize, err))
+        return false;
+    auto it = m_reqs.find(m_msg.getSequence());
+    if(it == m_reqs.end() || !matchPeer(it->second.target, m_msg.getPeer()))
+        return false;
+    SessionParse::setReply(m_msg, err, reply);
+    reply.rtt = SessionParse::nowNs() - it->second.sent;
+    const Timestamp_t &txTs = it->second.txTs;
+    if(!rxTs.isZero() && !txTs.isZero() && !(rxTs < txTs)) {
+        Timestamp_t d = rxTs;
+        d -= txTs;
+        reply.wireRtt = d.toNanoseconds();
+        m_stats.wireRtt.add(reply.wireRtt);
+    }
+    m_stats.rtt.add(reply.rtt);
+    callback = std::move(it->second.callback);
+    m_reqs.erase(it);
+    return true;
+}
+bool ManagementSession::handle(const void *buf, ssize_t msgSize)
+{
+    SessionReply reply;
+    SessionCallback callback;
+    if(!handle(buf, msgSize, Timestamp_t(), reply, callback))
+        return false;
+    // Call without holding the lock
+    if(callback)
+        callback(reply);
+    return true;
+}
+size_t ManagementSession::expire()
+{
+    std::vector<std::pair<uint16_t, SessionCallback>> done;
+    uint64_t now = SessionParse::nowNs();
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for(auto it = m_reqs.begin(); it != m_reqs.end();) {
+            if(it->second.deadline <= now) {
+                done.push_back({it->first, std::move(it->second.callback)});
+                it = m_reqs.erase(it);
+            } else
+                it++;
+        }
+    }
+    SessionReply reply;
+    reply.state = SESSION_TIMEOUT;
+    for(auto &d : done) {
+        reply.sequence = d.first;
+        if(d.second)
+            d.second(reply);
+    }
+    return done.size();
+}
+size_t ManagementSession::cancel()
+{
+    std::map<uint16_t, Req> reqs;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        reqs.swap(m_reqs);
+    }
+    SessionReply reply;
+    reply.state = SESSION_CANCEL;
+    for(auto &r : reqs) {
+        reply.sequence = r.first;
+        if(r.second.callback)
+            r.second.callback(reply);
+    }
+    return reqs.size();
+}
+size_t ManagementSession::pending() const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_reqs.size();
+}
+bool ManagementSession::nextTimeout(uint64_t &timeout_ms) const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    if(m_reqs.empty())
+        return false;
+    uint64_t now = SessionParse::nowNs();
+    uint64_t wait = UINT64_MAX;
+    for(const auto &r : m_reqs) {
+        if(r.second.deadline <= now) {
+            wait = 0;
+            break;
+        }
+        if(r.second.deadline - now < wait)
+            wait = r.second.deadline - now;
+    }
+    timeout_ms = SessionParse::toMs(wait);
+    return true;
+}
+SessionStats ManagementSession::getStats() const
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_stats;
+}
+void ManagementSession::resetStats()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_stats = SessionStats();
+}
+const SockBase &ManagementSession::getSocket() const
+{
+    return m_sock;
+}
+ssize_t ManagementSession::rcv(void *buf, Timestamp_t &rxTs)
+{
+    if(!m_sock.isTimestamping())
+        return m_sock.rcv(buf, bufSize);
+    // Take the requests transmit timestamps before their replies
+    Timestamp_t ts;
+    uint32_t id;
+    while(m_sock.getTxTs(ts, id)) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for(auto &r : m_reqs) {
+            if(r.second.txId == id) {
+                r.second.txTs = ts;
+                break;
+            }
+        }
+    }
+    return m_sock.rcvTs(buf, bufSize, rxTs);
+}
+size_t ManagementSession::process(uint64_t timeout_ms)
+{
+    uint8_t buf[bufSize];
+    size_t done = 0;
+    uint64_t end = SessionParse::nowNs() + timeout_ms * NSEC_PER_MSEC;
+    for(;;) {
+        // Many threads can receive, each receive a different message
+        ssize_t cnt;
+        Timestamp_t rxTs;
+        while((cnt = rcv(buf, rxTs)) > 0) {
+            SessionReply reply;
+            SessionCallback callback;
+            if(handle(buf, cnt, rxTs, reply, callback)) {
+                // Call without holding the lock
+                if(callback)
+                    callback(reply);
+                done++;
+            }
+        }
+        done += expire();
+        if(timeout_ms == 0 || m_sock.getFd() < 0)
+            break;
+        uint64_t wait;
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            if(m_reqs.empty())
+                break;
+            uint64_t now = SessionParse::nowNs();
+            if(now >= end)
+                break;
+            wait = end - now;
+            for(const auto &r : m_reqs) {
+                if(r.second.deadline > now && r.second.deadline - now < wait)
+                    wait = r.second.deadline - now;
+            }
+        }
+        m_sock.poll(SessionParse::toMs(wait));
+    }
+    return done;
+}
+
+__PTPMGMT_NAMESPACE_END
@@ -0,0 +1,337 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Signalling TLV records in columns
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <type_traits>
+#include "sigCols.h"
+#include "comp.h"
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+#if defined(__SSE2__)
+#include <immintrin.h>
+#if defined(__GNUC__)
+#include <cpuid.h>
+#define SIG_X86
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#endif /* __BYTE_ORDER == __LITTLE_ENDIAN */
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+// Records size on the wire
+static const size_t rxSyncTimingRec = 34;
+static const size_t rxSyncComputedRec = 22;
+static const size_t txEventTimestampsRec = 12;
+static const size_t delayTimingRec = 30;
+// TLV fields before the records
+static const size_t portIdSize = 10;
+static const size_t portIdFlagsSize = 12; // with flags and reserved
+
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+#ifdef SIG_X86
+// Reverse the bytes of each 2, 4 and 8 bytes word
+static const uint8_t swapMask[3][16] = {
+    {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+    {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12},
+    {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8},
+};
+/*
+ * The build does not assume SSSE3 or AVX2.
+ * The shuffle kernels are built for their targets and selected at load time.
+ */
+template <size_t W> __attribute__((target("ssse3")))
+static size_t swapSsse3(uint8_t *p, size_t len)
+{
+    size_t i = 0;
+    const __m128i m = _mm_loadu_si128((const __m128i *)swapMask[W / 4]);
+    for(; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        _mm_storeu_si128((__m128i *)(p + i), _mm_shuffle_epi8(v, m));
+    }
+    return i;
+}
+template <size_t W> __attribute__((target("avx2")))
+static size_t swapAvx2(uint8_t *p, size_t len)
+{
+    size_t i = 0;
+    const __m128i m = _mm_loadu_si128((const __m128i *)swapMask[W / 4]);
+    const __m256i m2 = _mm256_broadcastsi128_si256(m);
+    for(; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        _mm256_storeu_si256((__m256i *)(p + i), _mm256_shuffle_epi8(v, m2));
+    }
+    for(; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        _mm_storeu_si128((__m128i *)(p + i), _mm_shuffle_epi8(v, m));
+    }
+    return i;
+}
+enum swapLevel_e {
+    SWAP_SSE2,
+    SWAP_SSSE3,
+    SWAP_AVX2,
+};
+static swapLevel_e cpuSwapLevel()
+{
+    unsigned int a, b, c, d;
+    if(!__get_cpuid(1, &a, &b, &c, &d) || (c & bit_SSSE3) == 0)
+        return SWAP_SSE2;
+    if((c & bit_OSXSAVE) == 0 || (c & bit_AVX) == 0)
+        return SWAP_SSSE3;
+    // The system saves the AVX registers
+    uint32_t lo, hi;
+    __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    if((lo & 6) == 6 && __get_cpuid_count(7, 0, &a, &b, &c, &d) &&
+        (b & bit_AVX2) != 0)
+        return SWAP_AVX2;
+    return SWAP_SSSE3;
+}
+static const swapLevel_e swapLevel = cpuSwapLevel();
+#endif /* SIG_X86 */
+/*
+ * Swap the bytes of each W bytes word using vector instructions
+ * Return number of bytes swapped, the caller swaps the rest
+ */
+template <size_t W> static inline size_t swapVec(uint8_t *p, size_t len)
+{
+    size_t i = 0;
+#ifdef SIG_X86
+    switch(swapLevel) {
+        case SWAP_AVX2:
+            return swapAvx2<W>(p, len);
+        case SWAP_SSSE3:
+            return swapSsse3<W>(p, len);
+        default:
+            break;
+    }
+#endif /* SIG_X86 */
+#if defined(__SSE2__)
+    for(; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        // Reverse the 16 bits words, then swap the bytes of each word
+        switch(W) {
+            case 4:
+                v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+                break;
+            case 8:
+                v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1b), 0x1b);
+                break;
+            default:
+                break;
+        }
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128((__m128i *)(p + i), v);
+    }
+#elif defined(__ARM_NEON)
+    for(; i + 16 <= len; i += 16) {
+        uint8x16_t v = vld1q_u8(p + i);
+        switch(W) {
+            case 2:
+                v = vrev16q_u8(v);
+                break;
+            case 4:
+                v = vrev32q_u8(v);
+                break;
+            default:
+                v = vrev64q_u8(v);
+                break;
+        }
+        vst1q_u8(p + i, v);
+    }
+#else
+    (void)p;
+    (void)len;
+#endif
+    return i;
+}
+#endif /* __BYTE_ORDER == __LITTLE_ENDIAN */
+// Convert a column from network order in place
+template <typename T> static inline void netToCpu(T *col, size_t cnt)
+{
+    size_t i = 0;
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    i = swapVec<sizeof(T)>((uint8_t *)col, cnt * sizeof(T)) / sizeof(T);
+#endif
+    for(; i < cnt; i++)
+        col[i] = net_to_cpu(col[i]);
+}
+/*
+ * Append a field of all records to a column
+ * Load a full word ending at the field end in network order,
+ *  and clear the bytes before the field.
+ * Fields shorter than the word always follow another field in the record.
+ * The column is converted in one pass.
+ */
+template <typename T, size_t S = sizeof(T)> static inline void gather(
+    std::vector<T> &col, const uint8_t *cur, size_t recSize, size_t cnt)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    const size_t skip = sizeof(U) - S;
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    const U mask = ~(U)0 << (8 * skip);
+#else
+    const U mask = ~(U)0 >> (8 * skip);
+#endif
+    size_t n = col.size();
+    col.resize(n + cnt);
+    U *d = (U *)col.data() + n;
+    cur -= skip;
+    for(size_t i = 0; i < cnt; i++, cur += recSize) {
+        U v;
+        memcpy(&v, cur, sizeof v);
+        d[i] = v & mask;
+    }
+    netToCpu(d, cnt);
+}
+static inline void gather(TimestampColumn &col, const uint8_t *cur,
+    size_t recSize, size_t cnt)
+{
+    gather<UInteger48_t, sizeof_UInteger48_t>(col.secondsField, cur, recSize,
+        cnt);
+    gather(col.nanosecondsField, cur + sizeof_UInteger48_t, recSize, cnt);
+}
+static inline void portId(PortIdentity_t &id, const uint8_t *cur)
+{
+    memcpy(id.clockIdentity.v, cur, id.clockIdentity.size());
+    id.portNumber = net_to_cpu16(*(const uint16_t *)(cur + 8));
+}
+template <typename T> static inline void trimCol(std::vector<T> &col,
+    size_t maxRecords)
+{
+    if(col.size() > maxRecords)
+        col.erase(col.begin(), col.end() - maxRecords);
+}
+static inline void trimCol(TimestampColumn &col, size_t maxRecords)
+{
+    trimCol(col.secondsField, maxRecords);
+    trimCol(col.nanosecondsField, maxRecords);
+}
+
+bool SigColumns::isColumnsTlv(tlvType_e tlvType, implementSpecific_e spec)
+{
+    switch(tlvType) {
+        case SLAVE_RX_SYNC_TIMING_DATA:
+            FALLTHROUGH;
+        case SLAVE_RX_SYNC_COMPUTED_DATA:
+            FALLTHROUGH;
+        case SLAVE_TX_EVENT_TIMESTAMPS:
+            return true;
+        case SLAVE_DELAY_TIMING_DATA_NP:
+            return spec == linuxptp;
+        default:
+            return false;
+    }
+}
+MNG_PARSE_ERROR_e SigColumns::append(tlvType_e tlvType, const uint8_t *cur,
+    size_t len)
+{
+    size_t cnt;
+    switch(tlvType) {
+        case SLAVE_RX_SYNC_TIMING_DATA:
+            if(len < portIdSize)
+                return MNG_PARSE_ERROR_TOO_SMALL;
+            portId(rxSyncTiming.syncSourcePortIdentity, cur);
+            cur += portIdSize;
+            cnt = (len - portIdSize) / rxSyncTimingRec;
+            gather(rxSyncTiming.sequenceId, cur, rxSyncTimingRec, cnt);
+            gather(rxSyncTiming.syncOriginTimestamp, cur + 2, rxSyncTimingRec,
+                cnt);
+            gather(rxSyncTiming.totalCorrectionField, cur + 12, rxSyncTimingRec,
+                cnt);
+            gather(rxSyncTiming.scaledCumulativeRateOffset, cur + 20,
+                rxSyncTimingRec, cnt);
+            gather(rxSyncTiming.syncEventIngressTimestamp, cur + 24,
+                rxSyncTimingRec, cnt);
+            break;
+        case SLAVE_RX_SYNC_COMPUTED_DATA:
+            if(len < portIdFlagsSize)
+                return MNG_PARSE_ERROR_TOO_SMALL;
+            portId(rxSyncComputed.sourcePortIdentity, cur);
+            rxSyncComputed.computedFlags = cur[portIdSize];
+            cur += portIdFlagsSize;
+            cnt = (len - portIdFlagsSize) / rxSyncComputedRec;
+            gather(rxSyncComputed.sequenceId, cur, rxSyncComputedRec, cnt);
+            gather(rxSyncComputed.offsetFromMaster, cur + 2, rxSyncComputedRec,
+                cnt);
+            gather(rxSyncComputed.meanPathDelay, cur + 10, rxSyncComputedRec,
+                cnt);
+            gather(rxSyncComputed.scaledNeighborRateRatio, cur + 18,
+                rxSyncComputedRec, cnt);
+            break;
+        case SLAVE_TX_EVENT_TIMESTAMPS:
+            if(len < portIdFlagsSize)
+                return MNG_PARSE_ERROR_TOO_SMALL;
+            portId(txEventTimestamps.sourcePortIdentity, cur);
+            txEventTimestamps.eventMessageType = (msgType_e)cur[portIdSize];
+            cur += portIdFlagsSize;
+            cnt = (len - portIdFlagsSize) / txEventTimestampsRec;
+            gather(txEventTimestamps.sequenceId, cur, txEventTimestampsRec, cnt);
+            gather(txEventTimestamps.eventEgressTimestamp, cur + 2,
+                txEventTimestampsRec, cnt);
+            break;
+        case SLAVE_DELAY_TIMING_DATA_NP:
+            if(len < portIdSize)
+                return MNG_PARSE_ERROR_TOO_SMALL;
+            portId(delayTiming.sourcePortIdentity, cur);
+            cur += portIdSize;
+            cnt = (len - portIdSize) / delayTimingRec;
+            gather(delayTiming.sequenceId, cur, delayTimingRec, cnt);
+            gather(delayTiming.delayOriginTimestamp, cur + 2, delayTimingRec,
+                cnt);
+            gather(delayTiming.totalCorrectionField, cur + 12, delayTimingRec,
+                cnt);
+            gather(delayTiming.delayResponseTimestamp, cur + 20, delayTimingRec,
+                cnt);
+            break;
+        default:
+            return MNG_PARSE_ERROR_INVALID_TLV;
+    }
+    return MNG_PARSE_ERROR_OK;
+}
+size_t SigColumns::size(tlvType_e tlvType) const
+{
+    switch(tlvType) {
+        case SLAVE_RX_SYNC_TIMING_DATA:
+            return rxSyncTiming.sequenceId.size();
+        case SLAVE_RX_SYNC_COMPUTED_DATA:
+            return rxSyncComputed.sequenceId.size();
+        case SLAVE_TX_EVENT_TIMESTAMPS:
+            return txEventTimestamps.sequenceId.size();
+        case SLAVE_DELAY_TIMING_DATA_NP:
+            return delayTiming.sequenceId.size();
+        default:
+            return 0;
+    }
+}
+void SigColumns::trim(size_t maxRecords)
+{
+    trimCol(rxSyncTiming.sequenceId, maxRecords);
+    trimCol(rxSyncTiming.syncOriginTimestamp, maxRecords);
+    trimCol(rxSyncTiming.totalCorrectionField, maxRecords);
+    trimCol(rxSyncTiming.scaledCumulativeRateOffset, maxRecords);
+    trimCol(rxSyncTiming.syncEventIngressTimestamp, maxRecords);
+    trimCol(rxSyncComputed.sequenceId, maxRecords);
+    trimCol(rxSyncComputed.offsetFromMaster, maxRecords);
+    trimCol(rxSyncComputed.meanPathDelay, maxRecords);
+    trimCol(rxSyncComputed.scaledNeighborRateRatio, maxRecords);
+    trimCol(txEventTimestamps.sequenceId, maxRecords);
+    trimCol(txEventTimestamps.eventEgressTimestamp, maxRecords);
+    trimCol(delayTiming.sequenceId, maxRecords);
+    trimCol(delayTiming.delayOriginTimestamp, maxRecords);
+    trimCol(delayTiming.totalCorrectionField, maxRecords);
+    trimCol(delayTiming.delayResponseTimestamp, maxRecords);
+}
+void SigColumns::clear()
+{
+    trim(0);
+}
+
+__PTPMGMT_NAMESPACE_END
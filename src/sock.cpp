@@ -10,6 +10,7 @@
  */
 
 #include "comp.h"
+#include <algorithm>
 #ifdef HAVE_PWD_H
 #include <pwd.h>
 #endif
@@ -33,6 +34,9 @@
 #endif
 #ifdef __linux__
 #include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#include <sys/mman.h>
 #endif
 #include "sock.h"
 #include "c/sock.h"
@@ -45,6 +49,27 @@ const uint16_t udp_port = 320;
 const char *ipv4_udp_mc = "224.0.1.129";
 const char *ipv6_udp_mc = "ff0e::181";
 
+// Maximum messages per a single batch system call
+const size_t batch_max = 64;
+// Receive ring frame size, TPACKET_V3 frames use the block space as needed
+const size_t ring_frame_size = 2048;
+// Kernel timestamps flags
+const int ts_sw_flags = SOF_TIMESTAMPING_RX_SOFTWARE |
+    SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+const int ts_hw_flags = SOF_TIMESTAMPING_RX_HARDWARE |
+    SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+// Transmit timestamps with the message ID and without the message
+const int ts_tx_flags = SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+// Timestamps with the extended error and its source address
+const size_t ts_control_size = CMSG_SPACE(3 * sizeof(timespec)) +
+    CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6));
+#ifndef IPV6_MULTICAST_ALL
+#define IPV6_MULTICAST_ALL 29 // Linux 4.20
+#endif
+// Receive timestamps and the arrival interface
+const size_t pktinfo_control_size = ts_control_size +
+    CMSG_SPACE(sizeof(in6_pktinfo));
+
 const char *useDefstrPre = "/var/run/user/"; // System provide per user
 const char *useDefstrPost = "/pmc.";
 const char *useDefstr = "/.pmc."; // relative to home directory
@@ -55,20 +80,22 @@ string SockUnix::m_homeDir;
 
 // Berkeley Packet Filter code
 // The code run on network order (big endian).
-// 0x30 Load bottom (2 last bytes of word)
-#if 0
+// 0x30 Load byte
 const uint16_t OP_LDB = BPF_LD  | BPF_B   | BPF_ABS;
-#endif
 // 0x28 Load high (2 first bytes)
 const uint16_t OP_LDH = BPF_LD  | BPF_H   | BPF_ABS;
 // 0x20 Load word (4 bytes)
-#if 0
 const uint16_t OP_LDW = BPF_LD  | BPF_W   | BPF_ABS;
-#endif
+// 0x74 Shift right
+const uint16_t OP_RSH = BPF_ALU | BPF_RSH | BPF_K;
+// 0x54 Bitwise and
+const uint16_t OP_AND = BPF_ALU | BPF_AND | BPF_K;
 // 0x15 Jump Equal
 const uint16_t OP_JEQ = BPF_JMP | BPF_JEQ | BPF_K;
 //  0x6 Return with pass or drop
 const uint16_t OP_RET = BPF_RET | BPF_K;
+// Pass the whole frame
+const uint32_t bpf_pass = 0x40000;
 
 /*
  * Filter to receive PTP frames with ethernet protocol 1558
@@ -80,8 +107,8 @@ const sock_filter bpf_code[] = {
     // opcode  Jump true  Jump false  field (32 bits)
     { OP_LDH,  0,         0,          12 },
     { OP_JEQ,  0,         1,          ETH_P_1588 },
-    { OP_RET,  0,         0,          0x40000 }, // pass
-    { OP_RET,  0,         0,          0 },       // toss
+    { OP_RET,  0,         0,          bpf_pass }, // pass
+    { OP_RET,  0,         0,          0 },        // toss
 };
 const sock_fprog bpf = {
     // Number of code lines
@@ -89,6 +116,76 @@ const sock_fprog bpf = {
     .filter = (sock_filter *)bpf_code,
 };
 
+// PTP message header offsets used by the messages filter
+const size_t ptp_domain_off = 4;
+const size_t ptp_target_off = 34; // Management and signalling
+// UDP sockets filter starts with the UDP header
+const size_t udp_hdr_len = 8;
+
+// Classic BPF loads words in network order
+static inline uint32_t bpfWord(const uint8_t *v)
+{
+    return (uint32_t)v[0] << 24 | (uint32_t)v[1] << 16 |
+        (uint32_t)v[2] << 8 | v[3];
+}
+static inline bool attachBpf(int fd, const vector<sock_filter> &code)
+{
+    const sock_fprog prog = {
+        .len = (unsigned short)code.size(),
+        .filter = (sock_filter *)code.data(),
+    };
+    if(setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof prog) != 0) {
+        PTPMGMT_ERROR_P("SO_ATTACH_FILTER");
+        return false;
+    }
+    return true;
+}
+// Fetch the timestamp from the received control messages
+static inline void cmsgTs(msghdr &msg, bool hardware, Timestamp_t &ts)
+{
+    ts = Timestamp_t();
+    for(cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+        cm = CMSG_NXTHDR(&msg, cm)) {
+        if(cm->cmsg_level != SOL_SOCKET)
+            continue;
+        timespec t[3]; // software, legacy and hardware
+        switch(cm->cmsg_type) {
+            case SCM_TIMESTAMPING:
+                memcpy(t, CMSG_DATA(cm), sizeof t);
+                if(hardware)
+                    t[0] = t[2];
+                break;
+            case SCM_TIMESTAMPNS:
+                if(hardware)
+                    continue;
+                memcpy(t, CMSG_DATA(cm), sizeof t[0]);
+                break;
+            default:
+                continue;
+        }
+        if(t[0].tv_sec != 0 || t[0].tv_nsec != 0)
+            ts = t[0];
+    }
+}
+// Fetch the sent message ID from the error queue control messages
+static inline bool cmsgTxId(msghdr &msg, uint32_t &id)
+{
+    for(cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+        cm = CMSG_NXTHDR(&msg, cm)) {
+        if((cm->cmsg_level != SOL_IP || cm->cmsg_type != IP_RECVERR) &&
+            (cm->cmsg_level != SOL_IPV6 || cm->cmsg_type != IPV6_RECVERR) &&
+            (cm->cmsg_level != SOL_PACKET ||
+                cm->cmsg_type != PACKET_TX_TIMESTAMP))
+            continue;
+        sock_extended_err err;
+        memcpy(&err, CMSG_DATA(cm), sizeof err);
+        if(err.ee_errno == ENOMSG && err.ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+            id = err.ee_data;
+            return true;
+        }
+    }
+    return false;
+}
 static inline bool ensureDir(const char *name)
 {
     // Verify name is a folder
@@ -127,21 +224,34 @@ void SockBase::closeBase()
     }
     closeChild();
     m_isInit = false;
+    m_txTs = false;
 }
 SockBase::~SockBase() { closeBase(); }
 void SockBase::close() { closeBase(); }
-bool SockBase::init() { return initBase(); }
+bool SockBase::init()
+{
+    if(!initBase())
+        return false;
+    if(m_useTs && !initTs()) {
+        closeBase();
+        return false;
+    }
+    return true;
+}
 bool SockBase::send(const void *msg, size_t len) const
 {
-    return sendBase(msg, len);
+    if(!sendBase(msg, len))
+        return false;
+    m_txId++;
+    return true;
 }
 bool SockBase::send(const Buf &buf, size_t len) const
 {
-    return sendBase(buf.get(), len);
+    return send(buf.get(), len);
 }
 bool SockBase::sendBuf(const Buf &buf, size_t len) const
 {
-    return sendBase(buf.get(), len);
+    return send(buf.get(), len);
 }
 ssize_t SockBase::rcv(void *buf, size_t bufSize, bool block) const
 {
@@ -155,6 +265,183 @@ ssize_t SockBase::rcvBuf(Buf &buf, bool block) const
 {
     return rcvBase(buf.get(), buf.size(), block);
 }
+ssize_t SockBase::sendBatch(const SockMsg *msgs, size_t count) const
+{
+    if(msgs == nullptr || count == 0) {
+        PTPMGMT_ERROR("No messages to send");
+        return -1;
+    }
+    ssize_t cnt = sendBatchBase(msgs, count);
+    if(cnt > 0)
+        m_txId += cnt;
+    return cnt;
+}
+ssize_t SockBase::rcvBatch(SockMsg *msgs, size_t count, bool block) const
+{
+    if(msgs == nullptr || count == 0) {
+        PTPMGMT_ERROR("No messages to receive");
+        return -1;
+    }
+    return rcvBatchBase(msgs, count, block);
+}
+// Sockets without batch system calls, send one message at a time
+ssize_t SockBase::sendBatchBase(const SockMsg *msgs, size_t count) const
+{
+    size_t i;
+    for(i = 0; i < count; i++) {
+        if(!sendBase(msgs[i].buf, msgs[i].len))
+            break;
+    }
+    if(i == 0)
+        return -1;
+    PTPMGMT_ERROR_CLR;
+    return i;
+}
+// Sockets without batch system calls, receive while messages are waiting
+ssize_t SockBase::rcvBatchBase(SockMsg *msgs, size_t count, bool block) const
+{
+    size_t i;
+    for(i = 0; i < count; i++) {
+        // Only wait for the first message
+        ssize_t cnt = rcvBase(msgs[i].buf, msgs[i].bufSize, block && i == 0);
+        if(cnt < 0)
+            break;
+        msgs[i].len = cnt;
+        msgs[i].fromLen = 0;
+    }
+    if(i == 0)
+        return -1;
+    PTPMGMT_ERROR_CLR;
+    return i;
+}
+// Count the messages sent in full, a short send fails as sendReply()
+static size_t batchSent(const mmsghdr *hdrs, int cnt, const SockMsg *msgs,
+    size_t hdrLen)
+{
+    int i;
+    for(i = 0; i < cnt; i++) {
+        size_t len = msgs[i].len + hdrLen;
+        if(hdrs[i].msg_len != len) {
+            PTPMGMT_ERROR("send %u instead of %zu", hdrs[i].msg_len, len);
+            break;
+        }
+    }
+    return i;
+}
+// Batch receive drops the messages the single receive fails on.
+// Move a following message into the place of a dropped message.
+static bool batchMove(SockMsg *msgs, size_t to, size_t from, size_t len)
+{
+    if(len > msgs[to].bufSize)
+        return false;
+    if(to != from)
+        memcpy(msgs[to].buf, msgs[from].buf, len);
+    msgs[to].len = len;
+    return true;
+}
+bool SockBase::setTimestamping(bool enable, bool hardware)
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Socket is already initialized");
+        return false;
+    }
+    m_useTs = enable;
+    m_hwTs = enable && hardware;
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockBase::isTimestamping() const
+{
+    return m_useTs;
+}
+bool SockBase::isHwTimestamping() const
+{
+    return m_hwTs;
+}
+bool SockBase::initTs()
+{
+    int flags = (m_hwTs ? ts_hw_flags : ts_sw_flags) | ts_tx_flags;
+    if(setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+            sizeof flags) != 0) {
+        PTPMGMT_ERROR_P("SO_TIMESTAMPING");
+        return false;
+    }
+    // The kernel starts counting the sent messages
+    m_txId = 0;
+    m_txTs = true;
+    return true;
+}
+ssize_t SockBase::rcvTsBase(void *, size_t, bool, Timestamp_t &) const
+{
+    PTPMGMT_ERROR("Socket does not support timestamps");
+    return -1;
+}
+bool SockBase::busyWait(uint64_t &) const
+{
+    return false;
+}
+ssize_t SockBase::rcvTs(void *buf, size_t bufSize, Timestamp_t &ts,
+    bool block) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return -1;
+    }
+    if(!m_useTs) {
+        PTPMGMT_ERROR("Socket does not use timestamps");
+        return -1;
+    }
+    return rcvTsBase(buf, bufSize, block, ts);
+}
+ssize_t SockBase::rcvTs(Buf &buf, Timestamp_t &ts, bool block) const
+{
+    return rcvTs(buf.get(), buf.size(), ts, block);
+}
+uint32_t SockBase::getTxId() const
+{
+    return m_txId;
+}
+bool SockBase::getTxTs(Timestamp_t &ts, uint32_t &id, bool block) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return false;
+    }
+    if(!m_txTs) {
+        PTPMGMT_ERROR("Socket does not use transmit timestamps");
+        return false;
+    }
+    uint8_t control[ts_control_size];
+    for(;;) {
+        msghdr msg = {0};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof control;
+        // Reading the error queue never blocks
+        ssize_t cnt = recvmsg(m_fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        if(cnt >= 0) {
+            // Skip other errors
+            if(cmsgTxId(msg, id)) {
+                cmsgTs(msg, m_hwTs, ts);
+                PTPMGMT_ERROR_CLR;
+                return true;
+            }
+            continue;
+        }
+        if(errno != EAGAIN || !block) {
+            PTPMGMT_ERROR_P("recvmsg");
+            return false;
+        }
+        // The kernel always polls the error queue
+        struct pollfd fds;
+        fds.fd = m_fd;
+        fds.events = 0;
+        fds.revents = 0;
+        if(::poll(&fds, 1, -1) < 0 && errno != EINTR) {
+            PTPMGMT_ERROR_P("poll");
+            return false;
+        }
+    }
+}
 int SockBase::getFd() const { return m_fd; }
 int SockBase::fileno() const { return m_fd; }
 bool SockBase::poll(uint64_t timeout_ms) const
@@ -163,9 +450,14 @@ bool SockBase::poll(uint64_t timeout_ms) const
         PTPMGMT_ERROR("Socket is not initialized");
         return false;
     }
+    uint64_t left = timeout_ms * NSEC_PER_MSEC;
+    if(busyWait(left)) {
+        PTPMGMT_ERROR_CLR;
+        return true;
+    }
     int to;
-    if(timeout_ms > 0)
-        to = timeout_ms;
+    if(timeout_ms > 0) // Round up, poll should not end before the timeout
+        to = (left + NSEC_PER_MSEC - 1) / NSEC_PER_MSEC;
     else
         to = -1;
     struct pollfd fds;
@@ -253,21 +545,84 @@ bool SockUnix::initBase()
     PTPMGMT_ERROR_CLR;
     return true;
 }
+UnixPeer::UnixPeer()
+{
+    clear();
+}
+UnixPeer::UnixPeer(const string &addr, bool useAbstract)
+{
+    set(addr, useAbstract);
+}
+// Set length from the socket address length
+void UnixPeer::setLen(size_t addrLen)
+{
+    size_t len = 0;
+    if(addrLen > offsetof(sockaddr_un, sun_path))
+        len = min(addrLen - offsetof(sockaddr_un, sun_path), unix_path_max);
+    // The socket address may be padded with zeros
+    while(len > 0 && m_addr.sun_path[len - 1] == 0)
+        len--;
+    m_len = len;
+}
+bool UnixPeer::set(const string &addr, bool useAbstract)
+{
+    clear();
+    size_t off = useAbstract ? 1 : 0;
+    if(!testUnix(addr, off))
+        return false;
+    memcpy(m_addr.sun_path + off, addr.c_str(), addr.size());
+    setLen(offsetof(sockaddr_un, sun_path) + off + addr.size());
+    return true;
+}
+void UnixPeer::clear()
+{
+    m_addr = {0};
+    m_addr.sun_family = AF_UNIX;
+    m_len = 0;
+}
+bool UnixPeer::empty() const
+{
+    return m_len == 0;
+}
+bool UnixPeer::isAbstract() const
+{
+    return m_len > 0 && m_addr.sun_path[0] == 0;
+}
+string UnixPeer::str() const
+{
+    return string(m_addr.sun_path, m_len);
+}
+// FNV-1a
+size_t UnixPeer::hash() const
+{
+    uint64_t h = 0xcbf29ce484222325;
+    for(size_t i = 0; i < m_len; i++) {
+        h ^= (uint8_t)m_addr.sun_path[i];
+        h *= 0x100000001b3;
+    }
+    return h;
+}
+bool UnixPeer::operator==(const UnixPeer &other) const
+{
+    return m_len == other.m_len &&
+        memcmp(m_addr.sun_path, other.m_addr.sun_path, m_len) == 0;
+}
+bool UnixPeer::operator<(const UnixPeer &other) const
+{
+    if(m_len != other.m_len)
+        return m_len < other.m_len;
+    return memcmp(m_addr.sun_path, other.m_addr.sun_path, m_len) < 0;
+}
 bool SockUnix::setPeerInternal(const string &str, bool useAbstract)
 {
-    if(!testUnix(str, useAbstract ? 1 : 0))
+    if(!m_peerAddr.set(str, useAbstract))
         return false;
-    if(useAbstract)
-        m_peer = string(1, '\0') + str;
-    else
-        m_peer = str;
-    setUnixAddr(m_peerAddr, m_peer);
+    m_peer = m_peerAddr.str();
     PTPMGMT_ERROR_CLR;
     return true;
 }
 SockUnix::SockUnix()
 {
-    setUnixAddr(m_peerAddr, m_peer);
 }
 const string &SockUnix::getPeerAddress() const
 {
@@ -379,29 +734,33 @@ bool SockUnix::sendBase(const void *msg, size_t len) const
     }
     if(!testUnix(m_peer))
         return false;
-    return sendAny(msg, len, m_peerAddr);
+    return sendAny(msg, len, m_peerAddr.m_addr);
 }
 bool SockUnix::sendTo(const void *msg, size_t len, const string &addrStr,
     bool useAbstract) const
 {
-    if(!m_isInit) {
-        PTPMGMT_ERROR("Socket is not initialized");
-        return false;
-    }
-    if(!testUnix(addrStr, useAbstract ? 1 : 0))
+    UnixPeer peer;
+    if(!peer.set(addrStr, useAbstract))
         return false;
-    sockaddr_un addr;
-    if(useAbstract)
-        setUnixAddr(addr, string(1, '\0') + addrStr);
-    else
-        setUnixAddr(addr, addrStr);
-    return sendAny(msg, len, addr);
+    return sendTo(msg, len, peer);
 }
 bool SockUnix::sendTo(const Buf &buf, size_t len, const string &addrStr,
     bool useAbstract) const
 {
     return sendTo(buf.get(), len, addrStr, useAbstract);
 }
+bool SockUnix::sendTo(const void *msg, size_t len, const UnixPeer &peer) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return false;
+    }
+    if(peer.empty()) {
+        PTPMGMT_ERROR("Empty peer address");
+        return false;
+    }
+    return sendAny(msg, len, peer.m_addr);
+}
 ssize_t SockUnix::rcvBase(void *buf, size_t bufSize, bool block) const
 {
     if(!m_isInit) {
@@ -410,11 +769,11 @@ ssize_t SockUnix::rcvBase(void *buf, size_t bufSize, bool block) const
     }
     if(!testUnix(m_peer))
         return -1;
-    string from;
+    UnixPeer from;
     ssize_t cnt = rcvFrom(buf, bufSize, from, block);
     if(cnt < 0)
         return -1;
-    if(from != m_peer) {
+    if(from != m_peerAddr) {
         PTPMGMT_ERROR("Wrong peer");
         return -1;
     }
@@ -424,19 +783,77 @@ ssize_t SockUnix::rcvBase(void *buf, size_t bufSize, bool block) const
     }
     return cnt;
 }
+bool SockUnix::initTs()
+{
+    if(m_hwTs) {
+        PTPMGMT_ERROR("Unix socket does not support hardware timestamps");
+        return false;
+    }
+    // The kernel stamps the message when the peer sends it
+    int on = 1;
+    if(setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof on) != 0) {
+        PTPMGMT_ERROR_P("SO_TIMESTAMPNS");
+        return false;
+    }
+    return true;
+}
+ssize_t SockUnix::rcvTsBase(void *buf, size_t bufSize, bool block,
+    Timestamp_t &ts) const
+{
+    if(!testUnix(m_peer))
+        return -1;
+    UnixPeer from;
+    iovec iov = { .iov_base = buf, .iov_len = bufSize };
+    uint8_t control[ts_control_size];
+    msghdr msg = {
+        .msg_name = &from.m_addr,
+        .msg_namelen = sizeof from.m_addr,
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof control
+    };
+    ssize_t cnt = recvmsg(m_fd, &msg, block ? 0 : MSG_DONTWAIT);
+    if(cnt < 0) {
+        PTPMGMT_ERROR_P("recvmsg");
+        return -1;
+    }
+    from.setLen(msg.msg_namelen);
+    if(from != m_peerAddr) {
+        PTPMGMT_ERROR("Wrong peer");
+        return -1;
+    }
+    if(cnt == 0) {
+        PTPMGMT_ERROR("empty message");
+        return -1;
+    }
+    cmsgTs(msg, false, ts);
+    PTPMGMT_ERROR_CLR;
+    return cnt;
+}
 ssize_t SockUnix::rcvFrom(void *buf, size_t bufSize, string &from,
     bool block) const
+{
+    UnixPeer peer;
+    ssize_t cnt = rcvFrom(buf, bufSize, peer, block);
+    if(cnt >= 0)
+        from = peer.str();
+    return cnt;
+}
+ssize_t SockUnix::rcvFrom(void *buf, size_t bufSize, UnixPeer &from,
+    bool block) const
 {
     if(!m_isInit) {
         PTPMGMT_ERROR("Socket is not initialized");
         return -1;
     }
-    sockaddr_un addr;
-    socklen_t len = sizeof addr;
+    from.clear();
+    socklen_t len = sizeof from.m_addr;
     int flags = 0;
     if(!block)
         flags |= MSG_DONTWAIT;
-    ssize_t cnt = recvfrom(m_fd, buf, bufSize, flags, (sockaddr *)&addr, &len);
+    ssize_t cnt = recvfrom(m_fd, buf, bufSize, flags,
+            (sockaddr *)&from.m_addr, &len);
     if(cnt < 0) {
         PTPMGMT_ERROR_P("recv");
         return -1;
@@ -445,8 +862,7 @@ ssize_t SockUnix::rcvFrom(void *buf, size_t bufSize, string &from,
         PTPMGMT_ERROR("rcv %zd more than buffer size %zu", cnt, bufSize);
         return -1;
     }
-    addr.sun_path[unix_path_max] = 0; // Ensure string is null terminated
-    from = addr.sun_path;
+    from.setLen(len);
     PTPMGMT_ERROR_CLR;
     return cnt;
 }
@@ -531,7 +947,159 @@ bool SockBaseIf::setAll(const IfInfo &ifObj, const ConfigFile &cfg,
 bool SockBaseIf::setAllInit(const IfInfo &ifObj, const ConfigFile &cfg,
     const string &section)
 {
-    return setAll(ifObj, cfg, section) && initBase();
+    return setAll(ifObj, cfg, section) && init();
+}
+bool SockBaseIf::setFilter(const MsgParams &prms, bool useSelfId)
+{
+    if(prms.transportSpecific > 0xf) {
+        PTPMGMT_ERROR("Wrong transport specific 0x%x", prms.transportSpecific);
+        return false;
+    }
+    m_filterPrms = prms;
+    m_filterSelfId = useSelfId;
+    m_useFilter = true;
+    if(m_isInit && !attachFilter())
+        return false;
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockBaseIf::removeFilter()
+{
+    if(m_useFilter) {
+        m_useFilter = false;
+        if(m_isInit && !attachFilter())
+            return false;
+    }
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockBaseIf::setBusyPoll(uint32_t busy_poll, bool prefer_busy_poll,
+    uint32_t busy_poll_spin)
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Socket is already initialized");
+        return false;
+    }
+    if(busy_poll > INT32_MAX) {
+        PTPMGMT_ERROR("Busy poll %u out of range", busy_poll);
+        return false;
+    }
+#ifndef SO_PREFER_BUSY_POLL // Linux 5.11
+    if(prefer_busy_poll) {
+        PTPMGMT_ERROR("Prefer busy poll is not supported");
+        return false;
+    }
+#endif
+    m_busyPoll = busy_poll;
+    m_preferBusyPoll = prefer_busy_poll;
+    m_busySpin = busy_poll_spin;
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockBaseIf::setBusyPoll(const ConfigFile &cfg, const string &section)
+{
+    return setBusyPoll(cfg.busy_poll(section), cfg.prefer_busy_poll(section) > 0,
+            cfg.busy_poll_spin(section));
+}
+bool SockBaseIf::initBusyPoll() const
+{
+    if(m_busyPoll > 0 && setsockopt(m_fd, SOL_SOCKET, SO_BUSY_POLL,
+            &m_busyPoll, sizeof m_busyPoll) != 0) {
+        PTPMGMT_ERROR_P("SO_BUSY_POLL");
+        return false;
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    int on = 1;
+    if(m_preferBusyPoll && setsockopt(m_fd, SOL_SOCKET, SO_PREFER_BUSY_POLL,
+            &on, sizeof on) != 0) {
+        PTPMGMT_ERROR_P("SO_PREFER_BUSY_POLL");
+        return false;
+    }
+#endif
+    return true;
+}
+/*
+ * Spin on a non blocking receive, with busy poll the kernel polls
+ *  the network device on each receive.
+ * Peek, so the message stays in the socket.
+ */
+bool SockBaseIf::rcvReady() const
+{
+    uint8_t c;
+    return recv(m_fd, &c, sizeof c, MSG_PEEK | MSG_DONTWAIT) >= 0;
+}
+bool SockBaseIf::busyWait(uint64_t &timeout_ns) const
+{
+    if(m_busySpin == 0)
+        return false;
+    uint64_t spin = (uint64_t)m_busySpin * NSEC_PER_USEC;
+    if(timeout_ns > 0)
+        spin = min(spin, timeout_ns);
+    timespec start, now;
+    if(clock_gettime(CLOCK_MONOTONIC, &start) != 0)
+        return false;
+    for(;;) {
+        if(rcvReady())
+            return true;
+        if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+            return false;
+        Timestamp_t s(start), n(now);
+        n -= s;
+        uint64_t pass = n.toNanoseconds();
+        if(pass >= spin) {
+            if(timeout_ns > 0)
+                timeout_ns = pass < timeout_ns ? timeout_ns - pass : 0;
+            return false;
+        }
+    }
+}
+/*
+ * Filter PTP messages of the filter parameters
+ * The filter drops other messages in the kernel,
+ *  so they do not wake the application.
+ */
+void SockBaseIf::ptpFilter(vector<sock_filter> &code, size_t offset) const
+{
+    const MsgParams &p = m_filterPrms;
+    // Jumps to drop, set when the filter is complete
+    vector<size_t> drops;
+    auto add = [&code](uint16_t op, uint32_t k, uint8_t jt = 0, uint8_t jf = 0) {
+        code.push_back({ op, jt, jf, k });
+    };
+    auto addDrop = [&](uint16_t op, uint32_t k, uint8_t jt = 0) {
+        drops.push_back(code.size());
+        add(op, k, jt);
+    };
+    // majorSdoId is transport specific
+    add(OP_LDB, offset);
+    add(OP_RSH, 4);
+    addDrop(OP_JEQ, p.transportSpecific);
+    add(OP_LDB, offset);
+    add(OP_AND, 0xf);
+    if(p.rcvSignaling)
+        add(OP_JEQ, Management, 1);
+    addDrop(OP_JEQ, p.rcvSignaling ? Signaling : Management);
+    add(OP_LDB, offset + ptp_domain_off);
+    addDrop(OP_JEQ, p.domainNumber);
+    if(m_filterSelfId) {
+        const uint8_t *clk = p.self_id.clockIdentity.v;
+        size_t off = offset + ptp_target_off;
+        add(OP_LDW, off);
+        add(OP_JEQ, bpfWord(clk), 0, 2);
+        add(OP_LDW, off + 4);
+        addDrop(OP_JEQ, bpfWord(clk + 4), 3); // to port number
+        // Wild card clock identity
+        addDrop(OP_JEQ, UINT32_MAX);
+        add(OP_LDW, off + 4);
+        addDrop(OP_JEQ, UINT32_MAX);
+        add(OP_LDH, off + ClockIdentity_t::size());
+        add(OP_JEQ, p.self_id.portNumber, 1);
+        addDrop(OP_JEQ, UINT16_MAX);
+    }
+    add(OP_RET, bpf_pass);
+    for(size_t i : drops)
+        code[i].jf = code.size() - i - 1;
+    add(OP_RET, 0);
 }
 SockIp::SockIp(int domain, const char *mcast, sockaddr *addr, size_t len) :
     m_domain(domain),
@@ -560,6 +1128,171 @@ bool SockIp::setUdpTtl(const ConfigFile &cfg, const string &section)
     PTPMGMT_ERROR_CLR;
     return true;
 }
+bool SockIp::addInt(const IfInfo &ifObj)
+{
+    if(!m_have_if) {
+        PTPMGMT_ERROR("Set the interface first");
+        return false;
+    }
+    if(hasIf(ifObj.ifIndex())) {
+        PTPMGMT_ERROR("Interface %s is already used", ifObj.ifName().c_str());
+        return false;
+    }
+    m_ifs.push_back(ifObj.ifIndex());
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockIp::hasIf(int ifIndex) const
+{
+    return ifIndex == m_ifIndex ||
+        find(m_ifs.begin(), m_ifs.end(), ifIndex) != m_ifs.end();
+}
+bool SockIp::addIfUsingName(const string &ifName)
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Socket is already initialized");
+        return false;
+    }
+    IfInfo ifObj;
+    if(!ifObj.initUsingName(ifName))
+        return false;
+    return addInt(ifObj);
+}
+bool SockIp::addIfUsingIndex(int ifIndex)
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Socket is already initialized");
+        return false;
+    }
+    IfInfo ifObj;
+    if(!ifObj.initUsingIndex(ifIndex))
+        return false;
+    return addInt(ifObj);
+}
+bool SockIp::addIf(const IfInfo &ifObj)
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Socket is already initialized");
+        return false;
+    }
+    if(!ifObj.isInit())
+        return false;
+    return addInt(ifObj);
+}
+bool SockIp::clearIfs()
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Socket is already initialized");
+        return false;
+    }
+    m_ifs.clear();
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+size_t SockIp::ifsCount() const
+{
+    return m_have_if ? m_ifs.size() + 1 : 0;
+}
+/*
+ * Select the interface with the packet information,
+ *  the kernel uses the interface address as source address.
+ */
+bool SockIp::sendIf(const void *msg, size_t len, int ifIndex) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return false;
+    }
+    if(!hasIf(ifIndex)) {
+        PTPMGMT_ERROR("Interface %d is not used by socket", ifIndex);
+        return false;
+    }
+    if(m_ifs.empty())
+        return send(msg, len);
+    iovec iov = { .iov_base = (void *)msg, .iov_len = len };
+    sockaddr_storage addr;
+    memcpy(&addr, m_addr, m_addr_len);
+    uint8_t control[CMSG_SPACE(sizeof(in6_pktinfo))] = { 0 };
+    msghdr hdr = {
+        .msg_name = &addr,
+        .msg_namelen = (socklen_t)m_addr_len,
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+    };
+    cmsghdr *cm = (cmsghdr *)control;
+    if(m_domain == AF_INET) {
+        in_pktinfo info = {};
+        info.ipi_ifindex = ifIndex;
+        cm->cmsg_level = IPPROTO_IP;
+        cm->cmsg_type = IP_PKTINFO;
+        cm->cmsg_len = CMSG_LEN(sizeof info);
+        memcpy(CMSG_DATA(cm), &info, sizeof info);
+        hdr.msg_controllen = CMSG_SPACE(sizeof info);
+    } else {
+        in6_pktinfo info = {};
+        info.ipi6_ifindex = ifIndex;
+        cm->cmsg_level = IPPROTO_IPV6;
+        cm->cmsg_type = IPV6_PKTINFO;
+        cm->cmsg_len = CMSG_LEN(sizeof info);
+        memcpy(CMSG_DATA(cm), &info, sizeof info);
+        hdr.msg_controllen = CMSG_SPACE(sizeof info);
+        // Link local scope must match the interface
+        sockaddr_in6 *a6 = (sockaddr_in6 *)&addr;
+        if(a6->sin6_scope_id != 0)
+            a6->sin6_scope_id = ifIndex;
+    }
+    ssize_t cnt = sendmsg(m_fd, &hdr, 0);
+    if(!sendReply(cnt, len))
+        return false;
+    m_txId++; // Count like send(), to match the kernel timestamps ID
+    return true;
+}
+ssize_t SockIp::rcvIf(void *buf, size_t bufSize, int &ifIndex,
+    bool block) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return -1;
+    }
+    if(m_ifs.empty()) {
+        ifIndex = m_ifIndex;
+        return rcvBase(buf, bufSize, block);
+    }
+    iovec iov = { .iov_base = buf, .iov_len = bufSize };
+    uint8_t control[pktinfo_control_size];
+    msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof control
+    };
+    ssize_t cnt = recvmsg(m_fd, &msg, block ? 0 : MSG_DONTWAIT);
+    if(cnt < 0) {
+        PTPMGMT_ERROR_P("recvmsg");
+        return -1;
+    }
+    ifIndex = -1;
+    for(cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+        cm = CMSG_NXTHDR(&msg, cm)) {
+        if(cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_PKTINFO) {
+            in_pktinfo info;
+            memcpy(&info, CMSG_DATA(cm), sizeof info);
+            ifIndex = info.ipi_ifindex;
+        } else if(cm->cmsg_level == IPPROTO_IPV6 &&
+            cm->cmsg_type == IPV6_PKTINFO) {
+            in6_pktinfo info;
+            memcpy(&info, CMSG_DATA(cm), sizeof info);
+            ifIndex = info.ipi6_ifindex;
+        }
+    }
+    if(ifIndex < 0) {
+        PTPMGMT_ERROR("Missing packet interface");
+        return -1;
+    }
+    PTPMGMT_ERROR_CLR;
+    return cnt;
+}
 bool SockIp::sendBase(const void *msg, size_t len) const
 {
     if(!m_isInit) {
@@ -590,6 +1323,126 @@ ssize_t SockIp::rcvBase(void *buf, size_t bufSize, bool block) const
     PTPMGMT_ERROR_CLR;
     return cnt;
 }
+ssize_t SockIp::rcvTsBase(void *buf, size_t bufSize, bool block,
+    Timestamp_t &ts) const
+{
+    iovec iov = { .iov_base = buf, .iov_len = bufSize };
+    uint8_t control[ts_control_size];
+    msghdr msg = {
+        .msg_iov = &iov,
+        .msg_iovlen = 1,
+        .msg_control = control,
+        .msg_controllen = sizeof control
+    };
+    ssize_t cnt = recvmsg(m_fd, &msg, block ? 0 : MSG_DONTWAIT);
+    if(cnt < 0) {
+        PTPMGMT_ERROR_P("recvmsg");
+        return -1;
+    }
+    cmsgTs(msg, m_hwTs, ts);
+    PTPMGMT_ERROR_CLR;
+    return cnt;
+}
+ssize_t SockIp::sendBatchBase(const SockMsg *msgs, size_t count) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return -1;
+    }
+    mmsghdr hdrs[batch_max];
+    iovec iovs[batch_max];
+    size_t sent = 0;
+    while(sent < count) {
+        size_t num = std::min(count - sent, batch_max);
+        for(size_t i = 0; i < num; i++) {
+            iovs[i].iov_base = msgs[sent + i].buf;
+            iovs[i].iov_len = msgs[sent + i].len;
+            hdrs[i] = {};
+            hdrs[i].msg_hdr.msg_name = m_addr;
+            hdrs[i].msg_hdr.msg_namelen = m_addr_len;
+            hdrs[i].msg_hdr.msg_iov = iovs + i;
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int cnt = sendmmsg(m_fd, hdrs, num, 0);
+        if(cnt < 0) {
+            if(sent > 0)
+                break;
+            PTPMGMT_ERROR_P("sendmmsg");
+            return -1;
+        }
+        size_t done = batchSent(hdrs, cnt, msgs + sent, 0);
+        sent += done;
+        if(done < (size_t)cnt && sent == 0)
+            return -1;
+        if(done < num)
+            break;
+    }
+    PTPMGMT_ERROR_CLR;
+    return sent;
+}
+ssize_t SockIp::rcvBatchBase(SockMsg *msgs, size_t count, bool block) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return -1;
+    }
+    mmsghdr hdrs[batch_max];
+    iovec iovs[batch_max];
+    sockaddr_storage addrs[batch_max];
+    // Only wait for the first message
+    int flags = block ? MSG_WAITFORONE : MSG_DONTWAIT;
+    size_t rcvd = 0;
+    while(rcvd < count) {
+        size_t num = std::min(count - rcvd, batch_max);
+        for(size_t i = 0; i < num; i++) {
+            iovs[i].iov_base = msgs[rcvd + i].buf;
+            iovs[i].iov_len = msgs[rcvd + i].bufSize;
+            hdrs[i] = {};
+            hdrs[i].msg_hdr.msg_name = addrs + i;
+            hdrs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            hdrs[i].msg_hdr.msg_iov = iovs + i;
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int cnt = recvmmsg(m_fd, hdrs, num, flags, nullptr);
+        if(cnt < 0) {
+            if(rcvd > 0)
+                break;
+            PTPMGMT_ERROR_P("recvmmsg");
+            return -1;
+        }
+        size_t valid = 0;
+        for(int i = 0; i < cnt; i++) {
+            // Drop truncated messages
+            if((hdrs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0 ||
+                !batchMove(msgs + rcvd, valid, i, hdrs[i].msg_len))
+                continue;
+            SockMsg &m = msgs[rcvd + valid++];
+            m.fromLen = 0;
+            switch(addrs[i].ss_family) {
+                case AF_INET:
+                    m.fromLen = sizeof(in_addr);
+                    memcpy(m.from, &((sockaddr_in *)(addrs + i))->sin_addr,
+                        m.fromLen);
+                    break;
+                case AF_INET6:
+                    m.fromLen = sizeof(in6_addr);
+                    memcpy(m.from, &((sockaddr_in6 *)(addrs + i))->sin6_addr,
+                        m.fromLen);
+                    break;
+                default:
+                    break;
+            }
+        }
+        rcvd += valid;
+        // Wait again if all the messages are dropped
+        if((size_t)cnt < num && rcvd > 0)
+            break;
+        if(rcvd > 0)
+            flags = MSG_DONTWAIT;
+    }
+    PTPMGMT_ERROR_CLR;
+    return rcvd;
+}
 bool SockIp::initBase()
 {
     if(m_isInit) {
@@ -615,12 +1468,15 @@ bool SockIp::initBase()
         PTPMGMT_ERROR_P("setsockopt SO_REUSEADDR failed");
         return false;
     }
+    if(!initBusyPoll())
+        return false;
     if(bind(m_fd, m_addr, m_addr_len) != 0) {
         PTPMGMT_ERROR_P("bind");
         return false;
     }
-    if(setsockopt(m_fd, SOL_SOCKET, SO_BINDTODEVICE, m_ifName.c_str(),
-            m_ifName.length()) != 0) {
+    // With added interfaces, receive from all of them
+    if(m_ifs.empty() && setsockopt(m_fd, SOL_SOCKET, SO_BINDTODEVICE,
+            m_ifName.c_str(), m_ifName.length()) != 0) {
         PTPMGMT_ERROR_P("BINDTODEVICE");
         return false;
     }
@@ -630,10 +1486,26 @@ bool SockIp::initBase()
     }
     if(!initIp())
         return false;
+    if(m_useFilter && !attachFilter())
+        return false;
     m_isInit = true;
     PTPMGMT_ERROR_CLR;
     return true;
 }
+bool SockIp::attachFilter() const
+{
+    if(m_useFilter) {
+        vector<sock_filter> code;
+        ptpFilter(code, udp_hdr_len);
+        return attachBpf(m_fd, code);
+    }
+    int on = 1;
+    if(setsockopt(m_fd, SOL_SOCKET, SO_DETACH_FILTER, &on, sizeof on) != 0) {
+        PTPMGMT_ERROR_P("SO_DETACH_FILTER");
+        return false;
+    }
+    return true;
+}
 SockIp4::SockIp4() : SockIp(AF_INET, ipv4_udp_mc, (sockaddr *) & m_addr4,
         sizeof m_addr4)
 {
@@ -652,10 +1524,29 @@ bool SockIp4::initIp()
     ip_mreqn req;
     memset(&req, 0, sizeof req);
     req.imr_multiaddr = *(in_addr *)m_mcast.get();
-    req.imr_ifindex = m_ifIndex;
-    if(setsockopt(m_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &req, sizeof req) != 0) {
-        PTPMGMT_ERROR_P("IP_ADD_MEMBERSHIP");
-        return false;
+    vector<int> ifs(1, m_ifIndex);
+    ifs.insert(ifs.end(), m_ifs.begin(), m_ifs.end());
+    for(int ifIndex : ifs) {
+        req.imr_ifindex = ifIndex;
+        if(setsockopt(m_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &req,
+                sizeof req) != 0) {
+            PTPMGMT_ERROR_P("IP_ADD_MEMBERSHIP");
+            return false;
+        }
+    }
+    if(!m_ifs.empty()) {
+        // Receive only the groups joined by the socket
+        int off = 0;
+        if(setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_ALL, &off,
+                sizeof off) != 0) {
+            PTPMGMT_ERROR_P("IP_MULTICAST_ALL");
+            return false;
+        }
+        int on = 1;
+        if(setsockopt(m_fd, IPPROTO_IP, IP_PKTINFO, &on, sizeof on) != 0) {
+            PTPMGMT_ERROR_P("IP_PKTINFO");
+            return false;
+        }
     }
     int off = 0;
     if(setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &off, sizeof off) != 0) {
@@ -675,7 +1566,7 @@ bool SockIp4::initIp()
 }
 bool SockIp4::setAllBase(const ConfigFile &cfg, const string &section)
 {
-    return setUdpTtl(cfg, section);
+    return setUdpTtl(cfg, section) && setBusyPoll(cfg, section);
 }
 SockIp6::SockIp6() : SockIp(AF_INET6, ipv6_udp_mc, (sockaddr *) & m_addr6,
         sizeof m_addr6)
@@ -700,10 +1591,30 @@ bool SockIp6::initIp()
     ipv6_mreq req;
     memset(&req, 0, sizeof req);
     req.ipv6mr_multiaddr = *(in6_addr *)m_mcast.get();
-    req.ipv6mr_interface = m_ifIndex;
-    if(setsockopt(m_fd, IPPROTO_IPV6, IPV6_ADD_MEMBERSHIP, &req, sizeof req) != 0) {
-        PTPMGMT_ERROR_P("IPV6_ADD_MEMBERSHIP");
-        return false;
+    vector<int> ifs(1, m_ifIndex);
+    ifs.insert(ifs.end(), m_ifs.begin(), m_ifs.end());
+    for(int ifIndex : ifs) {
+        req.ipv6mr_interface = ifIndex;
+        if(setsockopt(m_fd, IPPROTO_IPV6, IPV6_ADD_MEMBERSHIP, &req,
+                sizeof req) != 0) {
+            PTPMGMT_ERROR_P("IPV6_ADD_MEMBERSHIP");
+            return false;
+        }
+    }
+    if(!m_ifs.empty()) {
+        // Receive only the groups joined by the socket
+        int off = 0;
+        if(setsockopt(m_fd, IPPROTO_IPV6, IPV6_MULTICAST_ALL, &off,
+                sizeof off) != 0) {
+            PTPMGMT_ERROR_P("IPV6_MULTICAST_ALL");
+            return false;
+        }
+        int on = 1;
+        if(setsockopt(m_fd, IPPROTO_IPV6, IPV6_RECVPKTINFO, &on,
+                sizeof on) != 0) {
+            PTPMGMT_ERROR_P("IPV6_RECVPKTINFO");
+            return false;
+        }
     }
     int off = 0;
     if(setsockopt(m_fd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &off, sizeof off) != 0) {
@@ -749,11 +1660,17 @@ bool SockIp6::setScope(const ConfigFile &cfg, const string &section)
 }
 bool SockIp6::setAllBase(const ConfigFile &cfg, const string &section)
 {
-    return setUdpTtl(cfg, section) && setScope(cfg, section);
+    return setUdpTtl(cfg, section) && setScope(cfg, section) &&
+        setBusyPoll(cfg, section);
 }
 SockRaw::SockRaw() : m_init(m_hdr)
 {
 }
+SockRaw::~SockRaw()
+{
+    // The base class destructor can not call closeChild()
+    closeRing();
+}
 bool SockRaw::setPtpDstMacStr(const string &str)
 {
     if(m_isInit) {
@@ -861,10 +1778,10 @@ bool SockRaw::initBase()
         PTPMGMT_ERROR_P("SO_PRIORITY");
         return false;
     }
-    if(setsockopt(m_fd, SOL_SOCKET, SO_ATTACH_FILTER, &bpf, sizeof bpf) != 0) {
-        PTPMGMT_ERROR_P("SO_ATTACH_FILTER");
+    if(!initBusyPoll())
+        return false;
+    if(!attachFilter())
         return false;
-    }
     packet_mreq mreq = {0};
     mreq.mr_ifindex = m_ifIndex;
     mreq.mr_type = PACKET_MR_MULTICAST;
@@ -882,6 +1799,10 @@ bool SockRaw::initBase()
         PTPMGMT_ERROR_P("bind");
         return false;
     }
+    m_rxPackets = 0;
+    m_rxDrops = 0;
+    if(m_ringBlocksNum > 0 && !initRing())
+        return false;
     // TX
     m_addr.sll_halen = m_ptp_dst_mac.length();
     m_ptp_dst_mac.copy(m_addr.sll_addr);
@@ -923,6 +1844,43 @@ ssize_t SockRaw::rcvBase(void *buf, size_t bufSize, bool block) const
         PTPMGMT_ERROR("Socket is not initialized");
         return -1;
     }
+    return rcvMsg(buf, bufSize, block, nullptr);
+}
+ssize_t SockRaw::rcvTsBase(void *buf, size_t bufSize, bool block,
+    Timestamp_t &ts) const
+{
+    return rcvMsg(buf, bufSize, block, &ts);
+}
+ssize_t SockRaw::rcvMsg(void *buf, size_t bufSize, bool block,
+    Timestamp_t *ts) const
+{
+    if(m_ring != nullptr) {
+        SockMsg msg;
+        const uint8_t *frame = ringNext(block);
+        if(frame == nullptr)
+            return -1;
+        if(ts != nullptr) {
+            const tpacket3_hdr *hdr = (const tpacket3_hdr *)frame;
+            if(m_hwTs && (hdr->tp_status & TP_STATUS_TS_RAW_HARDWARE) == 0)
+                *ts = Timestamp_t();
+            else
+                *ts = Timestamp_t(hdr->tp_sec, hdr->tp_nsec);
+        }
+        if(!ringMsg(frame, msg)) {
+            ringDone();
+            PTPMGMT_ERROR("rcv %zu less than Ethernet header", msg.len);
+            return -1;
+        }
+        if(msg.len > bufSize) {
+            ringDone();
+            PTPMGMT_ERROR("rcv %zu more than buffer size %zu", msg.len, bufSize);
+            return -1;
+        }
+        memcpy(buf, msg.buf, msg.len);
+        ringDone();
+        PTPMGMT_ERROR_CLR;
+        return msg.len;
+    }
     int flags = 0;
     if(!block)
         flags |= MSG_DONTWAIT;
@@ -941,11 +1899,18 @@ ssize_t SockRaw::rcvBase(void *buf, size_t bufSize, bool block) const
         .msg_iov = iov_rx,
         .msg_iovlen = 2
     };
+    uint8_t control[ts_control_size];
+    if(ts != nullptr) {
+        msg_rx.msg_control = control;
+        msg_rx.msg_controllen = sizeof control;
+    }
     ssize_t cnt = recvmsg(m_fd, &msg_rx, flags);
     if(cnt < 0) {
         PTPMGMT_ERROR_P("recvmsg");
         return -1;
     }
+    if(ts != nullptr)
+        cmsgTs(msg_rx, m_hwTs, *ts);
     if(cnt < (ssize_t)(sizeof rx_buf)) {
         PTPMGMT_ERROR("rcv %zu less than Ethernet header", cnt);
         return -1;
@@ -960,7 +1925,358 @@ ssize_t SockRaw::rcvBase(void *buf, size_t bufSize, bool block) const
 }
 bool SockRaw::setAllBase(const ConfigFile &cfg, const string &section)
 {
-    return setPtpDstMac(cfg, section) && setSocketPriority(cfg, section);
+    return setPtpDstMac(cfg, section) && setSocketPriority(cfg, section) &&
+        setBusyPoll(cfg, section);
+}
+
+bool SockRaw::attachFilter() const
+{
+    if(!m_useFilter) {
+        if(setsockopt(m_fd, SOL_SOCKET, SO_ATTACH_FILTER, &bpf,
+                sizeof bpf) != 0) {
+            PTPMGMT_ERROR_P("SO_ATTACH_FILTER");
+            return false;
+        }
+        return true;
+    }
+    // PTP Ethernet protocol, the message follows the Ethernet header
+    vector<sock_filter> code(bpf_code, bpf_code + 2);
+    ptpFilter(code, sizeof(ethhdr));
+    code[1].jf = code.size() - 2 - 1;
+    return attachBpf(m_fd, code);
+}
+bool SockRaw::setRxRing(size_t blockSize, size_t blocksNum,
+    uint32_t timeout_ms)
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Socket is already initialized");
+        return false;
+    }
+    if(blocksNum > 0) {
+        size_t page = sysconf(_SC_PAGESIZE);
+        if(blockSize < page || blockSize % page != 0 ||
+            (blockSize & (blockSize - 1)) != 0) {
+            PTPMGMT_ERROR("Wrong ring block size %zu", blockSize);
+            return false;
+        }
+        if(blocksNum > UINT32_MAX / (blockSize / ring_frame_size)) {
+            PTPMGMT_ERROR("Too many ring blocks %zu", blocksNum);
+            return false;
+        }
+    }
+    m_ringBlockSize = blockSize;
+    m_ringBlocksNum = blocksNum;
+    m_ringTimeout = timeout_ms;
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+bool SockRaw::isRxRing() const
+{
+    return m_ring != nullptr;
+}
+bool SockRaw::initRing()
+{
+    int ver = TPACKET_V3;
+    if(setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &ver, sizeof ver) != 0) {
+        PTPMGMT_ERROR_P("PACKET_VERSION");
+        return false;
+    }
+    tpacket_req3 req = {0};
+    req.tp_block_size = m_ringBlockSize;
+    req.tp_block_nr = m_ringBlocksNum;
+    // TPACKET_V3 use variable frame size, the kernel only verify it
+    req.tp_frame_size = ring_frame_size;
+    req.tp_frame_nr = m_ringBlockSize / ring_frame_size * m_ringBlocksNum;
+    req.tp_retire_blk_tov = m_ringTimeout;
+    if(setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof req) != 0) {
+        PTPMGMT_ERROR_P("PACKET_RX_RING");
+        return false;
+    }
+    void *ring = mmap(nullptr, m_ringBlockSize * m_ringBlocksNum,
+            PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if(ring == MAP_FAILED) {
+        PTPMGMT_ERROR_P("mmap");
+        return false;
+    }
+    m_ring = (uint8_t *)ring;
+    m_ringBlock = 0;
+    m_ringLeft = 0;
+    m_ringFrame = nullptr;
+    return true;
+}
+void SockRaw::closeRing()
+{
+    if(m_ring != nullptr) {
+        munmap(m_ring, m_ringBlockSize * m_ringBlocksNum);
+        m_ring = nullptr;
+    }
+}
+void SockRaw::closeChild()
+{
+    closeRing();
+}
+bool SockRaw::initTs()
+{
+    if(!SockBase::initTs())
+        return false;
+    // The receive ring uses software timestamps by default
+    if(m_hwTs && m_ring != nullptr) {
+        int flags = SOF_TIMESTAMPING_RAW_HARDWARE;
+        if(setsockopt(m_fd, SOL_PACKET, PACKET_TIMESTAMP, &flags,
+                sizeof flags) != 0) {
+            PTPMGMT_ERROR_P("PACKET_TIMESTAMP");
+            return false;
+        }
+    }
+    return true;
+}
+const uint8_t *SockRaw::ringNext(bool block) const
+{
+    while(m_ringLeft == 0) {
+        tpacket_block_desc *bd = (tpacket_block_desc *)(m_ring +
+                m_ringBlock * m_ringBlockSize);
+        // An empty block
+        if(m_ringFrame != nullptr) {
+            ringDone();
+            continue;
+        }
+        uint32_t status = __atomic_load_n(&bd->hdr.bh1.block_status,
+                __ATOMIC_ACQUIRE);
+        if((status & TP_STATUS_USER) != 0) {
+            m_ringLeft = bd->hdr.bh1.num_pkts;
+            m_ringFrame = (uint8_t *)bd + bd->hdr.bh1.offset_to_first_pkt;
+            continue;
+        }
+        if(!block) {
+            errno = EAGAIN;
+            PTPMGMT_ERROR_P("No frame is ready");
+            return nullptr;
+        }
+        uint64_t forever = 0;
+        if(busyWait(forever))
+            continue;
+        // The kernel wakes us when a block is ready
+        pollfd fds = { .fd = m_fd, .events = POLLIN };
+        if(::poll(&fds, 1, -1) < 0 && errno != EINTR) {
+            PTPMGMT_ERROR_P("poll");
+            return nullptr;
+        }
+    }
+    const uint8_t *frame = m_ringFrame;
+    m_ringFrame += ((const tpacket3_hdr *)frame)->tp_next_offset;
+    m_ringLeft--;
+    return frame;
+}
+bool SockRaw::rcvReady() const
+{
+    if(m_ring == nullptr)
+        return SockBaseIf::rcvReady();
+    if(m_ringLeft > 0)
+        return true;
+    const tpacket_block_desc *bd = (tpacket_block_desc *)(m_ring +
+            m_ringBlock * m_ringBlockSize);
+    return (__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) &
+            TP_STATUS_USER) != 0;
+}
+bool SockRaw::ringMsg(const uint8_t *frame, SockMsg &msg) const
+{
+    const tpacket3_hdr *hdr = (const tpacket3_hdr *)frame;
+    msg.len = hdr->tp_snaplen;
+    // A frame shorter than Ethernet header carries no message
+    if(msg.len < sizeof(ethhdr))
+        return false;
+    const ethhdr *eth = (const ethhdr *)(frame + hdr->tp_mac);
+    msg.buf = (void *)(eth + 1);
+    msg.len -= sizeof(ethhdr);
+    msg.bufSize = msg.len;
+    msg.fromLen = ETH_ALEN;
+    memcpy(msg.from, eth->h_source, ETH_ALEN);
+    return true;
+}
+void SockRaw::ringDone() const
+{
+    // Return the block to the kernel after the last frame
+    if(m_ringLeft > 0 || m_ringFrame == nullptr)
+        return;
+    tpacket_block_desc *bd = (tpacket_block_desc *)(m_ring +
+            m_ringBlock * m_ringBlockSize);
+    __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+        __ATOMIC_RELEASE);
+    m_ringFrame = nullptr;
+    m_ringBlock = (m_ringBlock + 1) % m_ringBlocksNum;
+}
+ssize_t SockRaw::rcvRing(const SockMsgCallback &callback, bool block) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return -1;
+    }
+    if(m_ring == nullptr) {
+        PTPMGMT_ERROR("Socket does not use a receive ring");
+        return -1;
+    }
+    if(!callback) {
+        PTPMGMT_ERROR("Missing callback");
+        return -1;
+    }
+    const uint8_t *frame = ringNext(block);
+    if(frame == nullptr) {
+        if(!block && Error::getErrno() == EAGAIN) {
+            PTPMGMT_ERROR_CLR;
+            return 0;
+        }
+        return -1;
+    }
+    // Use the frames of the current block
+    size_t cnt = 0;
+    for(;;) {
+        SockMsg msg;
+        if(ringMsg(frame, msg)) {
+            callback(msg);
+            cnt++;
+        }
+        if(m_ringLeft == 0)
+            break;
+        frame = ringNext(false);
+    }
+    ringDone();
+    PTPMGMT_ERROR_CLR;
+    return cnt;
+}
+bool SockRaw::getRxStats(uint64_t &packets, uint64_t &drops) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return false;
+    }
+    // The kernel reset the counters on each read
+    tpacket_stats_v3 st = {0};
+    socklen_t len = sizeof st;
+    if(getsockopt(m_fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) != 0) {
+        PTPMGMT_ERROR_P("PACKET_STATISTICS");
+        return false;
+    }
+    m_rxPackets += st.tp_packets;
+    m_rxDrops += st.tp_drops;
+    packets = m_rxPackets;
+    drops = m_rxDrops;
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+ssize_t SockRaw::sendBatchBase(const SockMsg *msgs, size_t count) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return -1;
+    }
+    mmsghdr hdrs[batch_max];
+    iovec iovs[batch_max][2];
+    size_t sent = 0;
+    while(sent < count) {
+        size_t num = std::min(count - sent, batch_max);
+        for(size_t i = 0; i < num; i++) {
+            iovs[i][0].iov_base = (void *) &m_hdr;
+            iovs[i][0].iov_len = sizeof m_hdr;
+            iovs[i][1].iov_base = msgs[sent + i].buf;
+            iovs[i][1].iov_len = msgs[sent + i].len;
+            hdrs[i] = {};
+            hdrs[i].msg_hdr.msg_name = (void *) &m_addr;
+            hdrs[i].msg_hdr.msg_namelen = sizeof m_addr;
+            hdrs[i].msg_hdr.msg_iov = iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 2;
+        }
+        int cnt = sendmmsg(m_fd, hdrs, num, 0);
+        if(cnt < 0) {
+            if(sent > 0)
+                break;
+            PTPMGMT_ERROR_P("sendmmsg");
+            return -1;
+        }
+        size_t done = batchSent(hdrs, cnt, msgs + sent, sizeof m_hdr);
+        sent += done;
+        if(done < (size_t)cnt && sent == 0)
+            return -1;
+        if(done < num)
+            break;
+    }
+    PTPMGMT_ERROR_CLR;
+    return sent;
+}
+ssize_t SockRaw::rcvBatchBase(SockMsg *msgs, size_t count, bool block) const
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return -1;
+    }
+    if(m_ring != nullptr) {
+        size_t i = 0;
+        while(i < count) {
+            // Only wait for the first message
+            const uint8_t *frame = ringNext(block && i == 0);
+            if(frame == nullptr)
+                break;
+            SockMsg msg;
+            SockMsg &m = msgs[i];
+            // Drop frames shorter than Ethernet header and truncated frames
+            if(ringMsg(frame, msg) && msg.len <= m.bufSize) {
+                m.len = msg.len;
+                memcpy(m.buf, msg.buf, m.len);
+                m.fromLen = msg.fromLen;
+                memcpy(m.from, msg.from, msg.fromLen);
+                i++;
+            }
+            ringDone();
+        }
+        if(i == 0)
+            return -1;
+        PTPMGMT_ERROR_CLR;
+        return i;
+    }
+    mmsghdr hdrs[batch_max];
+    iovec iovs[batch_max][2];
+    ethhdr rx_hdrs[batch_max];
+    // Only wait for the first message
+    int flags = block ? MSG_WAITFORONE : MSG_DONTWAIT;
+    size_t rcvd = 0;
+    while(rcvd < count) {
+        size_t num = std::min(count - rcvd, batch_max);
+        for(size_t i = 0; i < num; i++) {
+            iovs[i][0].iov_base = rx_hdrs + i;
+            iovs[i][0].iov_len = sizeof(ethhdr);
+            iovs[i][1].iov_base = msgs[rcvd + i].buf;
+            iovs[i][1].iov_len = msgs[rcvd + i].bufSize;
+            hdrs[i] = {};
+            hdrs[i].msg_hdr.msg_iov = iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 2;
+        }
+        int cnt = recvmmsg(m_fd, hdrs, num, flags, nullptr);
+        if(cnt < 0) {
+            if(rcvd > 0)
+                break;
+            PTPMGMT_ERROR_P("recvmmsg");
+            return -1;
+        }
+        size_t valid = 0;
+        for(int i = 0; i < cnt; i++) {
+            size_t len = hdrs[i].msg_len;
+            // Drop truncated frames and frames shorter than Ethernet header
+            if((hdrs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0 ||
+                len < sizeof(ethhdr) ||
+                !batchMove(msgs + rcvd, valid, i, len - sizeof(ethhdr)))
+                continue;
+            SockMsg &m = msgs[rcvd + valid++];
+            m.fromLen = ETH_ALEN;
+            memcpy(m.from, rx_hdrs[i].h_source, ETH_ALEN);
+        }
+        rcvd += valid;
+        // Wait again if all the frames are dropped
+        if((size_t)cnt < num && rcvd > 0)
+            break;
+        if(rcvd > 0)
+            flags = MSG_DONTWAIT;
+    }
+    PTPMGMT_ERROR_CLR;
+    return rcvd;
 }
 
 __PTPMGMT_NAMESPACE_END
@@ -1018,6 +2334,76 @@ static ssize_t ptpmgmt_sk_rcv(const_ptpmgmt_sk sk, void *buf, size_t bufSize,
         return s->rcv(buf, bufSize, block);
     return false;
 }
+// The C datagram entry is used as the C++ one
+static_assert(sizeof(ptpmgmt_sk_msg_t) == sizeof(SockMsg),
+    "ptpmgmt_sk_msg_t and SockMsg differ");
+static_assert(offsetof(ptpmgmt_sk_msg_t, len) == offsetof(SockMsg, len) &&
+    offsetof(ptpmgmt_sk_msg_t, from) == offsetof(SockMsg, from) &&
+    offsetof(ptpmgmt_sk_msg_t, fromLen) == offsetof(SockMsg, fromLen),
+    "ptpmgmt_sk_msg_t and SockMsg differ");
+static ssize_t ptpmgmt_sk_sendBatch(const_ptpmgmt_sk sk,
+    const_ptpmgmt_sk_msg msgs, size_t count)
+{
+    SockBase *s = valid_sk(sk);
+    if(s != nullptr)
+        return s->sendBatch((const SockMsg *)msgs, count);
+    return -1;
+}
+static ssize_t ptpmgmt_sk_rcvBatch(const_ptpmgmt_sk sk, ptpmgmt_sk_msg msgs,
+    size_t count, bool block)
+{
+    SockBase *s = valid_sk(sk);
+    if(s != nullptr)
+        return s->rcvBatch((SockMsg *)msgs, count, block);
+    return -1;
+}
+static bool ptpmgmt_sk_setTimestamping(ptpmgmt_sk sk, bool enable,
+    bool hardware)
+{
+    SockBase *s = valid_sk(sk);
+    if(s != nullptr)
+        return s->setTimestamping(enable, hardware);
+    return false;
+}
+static bool ptpmgmt_sk_isTimestamping(const_ptpmgmt_sk sk)
+{
+    SockBase *s = valid_sk(sk);
+    if(s != nullptr)
+        return s->isTimestamping();
+    return false;
+}
+static ssize_t ptpmgmt_sk_rcvTs(const_ptpmgmt_sk sk, void *buf,
+    size_t bufSize, ptpmgmt_Timestamp_t *ts, bool block)
+{
+    SockBase *s = valid_sk(sk);
+    if(s == nullptr || ts == nullptr)
+        return -1;
+    Timestamp_t t;
+    ssize_t ret = s->rcvTs(buf, bufSize, t, block);
+    ts->secondsField = t.secondsField;
+    ts->nanosecondsField = t.nanosecondsField;
+    return ret;
+}
+static uint32_t ptpmgmt_sk_getTxId(const_ptpmgmt_sk sk)
+{
+    SockBase *s = valid_sk(sk);
+    if(s != nullptr)
+        return s->getTxId();
+    return 0;
+}
+static bool ptpmgmt_sk_getTxTs(const_ptpmgmt_sk sk, ptpmgmt_Timestamp_t *ts,
+    uint32_t *id, bool block)
+{
+    SockBase *s = valid_sk(sk);
+    if(s == nullptr || ts == nullptr || id == nullptr)
+        return false;
+    Timestamp_t t;
+    if(!s->getTxTs(t, *id, block))
+        return false;
+    ts->secondsField = t.secondsField;
+    ts->nanosecondsField = t.nanosecondsField;
+    return true;
+}
 static int ptpmgmt_sk_getFd(const_ptpmgmt_sk sk)
 {
     SockBase *s = valid_sk(sk);
@@ -1409,6 +2795,140 @@ static bool ptpmgmt_sk_setSocketPriorityCfg(ptpmgmt_sk sk,
     SockRaw *s = valid_rsk(sk);
     C2CPP_func(setSocketPriority);
 }
+static bool non_ptpmgmt_sk_setFilter(ptpmgmt_sk, ptpmgmt_cpMsgParams, bool)
+{
+    return false;
+}
+static bool ptpmgmt_sk_setFilter(ptpmgmt_sk sk, ptpmgmt_cpMsgParams prms,
+    bool useSelfId)
+{
+    SockBaseIf *s = valid_isk(sk);
+    if(s == nullptr || prms == nullptr)
+        return false;
+    // The parameters the filter uses
+    MsgParams p;
+    p.transportSpecific = prms->transportSpecific;
+    p.domainNumber = prms->domainNumber;
+    p.rcvSignaling = prms->rcvSignaling;
+    memcpy(p.self_id.clockIdentity.v, prms->self_id.clockIdentity.v,
+        ClockIdentity_t::size());
+    p.self_id.portNumber = prms->self_id.portNumber;
+    return s->setFilter(p, useSelfId);
+}
+static bool non_ptpmgmt_sk_removeFilter(ptpmgmt_sk)
+{
+    return false;
+}
+static bool ptpmgmt_sk_removeFilter(ptpmgmt_sk sk)
+{
+    SockBaseIf *s = valid_isk(sk);
+    if(s != nullptr)
+        return s->removeFilter();
+    return false;
+}
+static bool non_ptpmgmt_sk_setBusyPoll(ptpmgmt_sk, uint32_t, bool, uint32_t)
+{
+    return false;
+}
+static bool ptpmgmt_sk_setBusyPoll(ptpmgmt_sk sk, uint32_t busy_poll,
+    bool prefer_busy_poll, uint32_t busy_poll_spin)
+{
+    SockBaseIf *s = valid_isk(sk);
+    if(s != nullptr)
+        return s->setBusyPoll(busy_poll, prefer_busy_poll, busy_poll_spin);
+    return false;
+}
+static bool non_ptpmgmt_sk_setBusyPollCfg(ptpmgmt_sk, const_ptpmgmt_cfg,
+    const char *)
+{
+    return false;
+}
+static bool ptpmgmt_sk_setBusyPollCfg(ptpmgmt_sk sk, const_ptpmgmt_cfg cfg,
+    const char *section)
+{
+    SockBaseIf *s = valid_isk(sk);
+    C2CPP_func(setBusyPoll);
+}
+static bool non_ptpmgmt_sk_addIfUsingName(ptpmgmt_sk, const char *)
+{
+    return false;
+}
+static bool ptpmgmt_sk_addIfUsingName(ptpmgmt_sk sk, const char *ifName)
+{
+    SockIp *s = valid_ipsk(sk);
+    if(s != nullptr && ifName != nullptr)
+        return s->addIfUsingName(ifName);
+    return false;
+}
+static bool non_ptpmgmt_sk_addIfUsingIndex(ptpmgmt_sk, int)
+{
+    return false;
+}
+static bool ptpmgmt_sk_addIfUsingIndex(ptpmgmt_sk sk, int ifIndex)
+{
+    SockIp *s = valid_ipsk(sk);
+    if(s != nullptr)
+        return s->addIfUsingIndex(ifIndex);
+    return false;
+}
+static bool non_ptpmgmt_sk_addIf(ptpmgmt_sk, const_ptpmgmt_ifInfo)
+{
+    return false;
+}
+static bool ptpmgmt_sk_addIf(ptpmgmt_sk sk, const_ptpmgmt_ifInfo ifObj)
+{
+    SockIp *s = valid_ipsk(sk);
+    if(s != nullptr && ifObj != nullptr && ifObj->_this != nullptr)
+        return s->addIf(*(const IfInfo *)ifObj->_this);
+    return false;
+}
+static bool non_ptpmgmt_sk_clearIfs(ptpmgmt_sk)
+{
+    return false;
+}
+static bool ptpmgmt_sk_clearIfs(ptpmgmt_sk sk)
+{
+    SockIp *s = valid_ipsk(sk);
+    if(s != nullptr)
+        return s->clearIfs();
+    return false;
+}
+static size_t non_ptpmgmt_sk_ifsCount(const_ptpmgmt_sk)
+{
+    return 0;
+}
+static size_t ptpmgmt_sk_ifsCount(const_ptpmgmt_sk sk)
+{
+    SockIp *s = valid_ipsk(sk);
+    if(s != nullptr)
+        return s->ifsCount();
+    return 0;
+}
+static bool non_ptpmgmt_sk_sendIf(const_ptpmgmt_sk, const void *, size_t, int)
+{
+    return false;
+}
+static bool ptpmgmt_sk_sendIf(const_ptpmgmt_sk sk, const void *msg,
+    size_t len, int ifIndex)
+{
+    SockIp *s = valid_ipsk(sk);
+    if(s != nullptr && msg != nullptr)
+        return s->sendIf(msg, len, ifIndex);
+    return false;
+}
+static ssize_t non_ptpmgmt_sk_rcvIf(const_ptpmgmt_sk, void *, size_t, int *,
+    bool)
+{
+    return -1;
+}
+static ssize_t ptpmgmt_sk_rcvIf(const_ptpmgmt_sk sk, void *buf,
+    size_t bufSize, int *ifIndex, bool block)
+{
+    SockIp *s = valid_ipsk(sk);
+    if(s != nullptr && buf != nullptr && ifIndex != nullptr)
+        return s->rcvIf(buf, bufSize, *ifIndex, block);
+    return -1;
+}
 static ptpmgmt_sk ptpmgmt_sk_alloc_all(ptpmgmt_socket_class type, SockBase *sko)
 {
     ptpmgmt_sk sk = (ptpmgmt_sk)malloc(sizeof(ptpmgmt_sk_t));
@@ -1449,6 +2969,17 @@ static ptpmgmt_sk ptpmgmt_sk_alloc_all(ptpmgmt_socket_class type, SockBase *sko)
     C_NO_ASGN(setPtpDstMacCfg);
     C_NO_ASGN(setSocketPriority);
     C_NO_ASGN(setSocketPriorityCfg);
+    C_NO_ASGN(setFilter);
+    C_NO_ASGN(removeFilter);
+    C_NO_ASGN(setBusyPoll);
+    C_NO_ASGN(setBusyPollCfg);
+    C_NO_ASGN(addIfUsingName);
+    C_NO_ASGN(addIfUsingIndex);
+    C_NO_ASGN(addIf);
+    C_NO_ASGN(clearIfs);
+    C_NO_ASGN(ifsCount);
+    C_NO_ASGN(sendIf);
+    C_NO_ASGN(rcvIf);
     switch(type) {
         case ptpmgmt_SockUnix:
             if(sko == nullptr)
@@ -1479,9 +3010,20 @@ static ptpmgmt_sk ptpmgmt_sk_alloc_all(ptpmgmt_socket_class type, SockBase *sko)
             C_ASGN(setIf);
             C_ASGN(setAll);
             C_ASGN(setAllInit);
+            C_ASGN(setFilter);
+            C_ASGN(removeFilter);
+            C_ASGN(setBusyPoll);
+            C_ASGN(setBusyPollCfg);
             // IP sockets
             C_ASGN(setUdpTtl);
             C_ASGN(setUdpTtlCfg);
+            C_ASGN(addIfUsingName);
+            C_ASGN(addIfUsingIndex);
+            C_ASGN(addIf);
+            C_ASGN(clearIfs);
+            C_ASGN(ifsCount);
+            C_ASGN(sendIf);
+            C_ASGN(rcvIf);
             break;
         case ptpmgmt_SockIp6:
             if(sko == nullptr)
@@ -1492,9 +3034,20 @@ static ptpmgmt_sk ptpmgmt_sk_alloc_all(ptpmgmt_socket_class type, SockBase *sko)
             C_ASGN(setIf);
             C_ASGN(setAll);
             C_ASGN(setAllInit);
+            C_ASGN(setFilter);
+            C_ASGN(removeFilter);
+            C_ASGN(setBusyPoll);
+            C_ASGN(setBusyPollCfg);
             // IP sockets
             C_ASGN(setUdpTtl);
             C_ASGN(setUdpTtlCfg);
+            C_ASGN(addIfUsingName);
+            C_ASGN(addIfUsingIndex);
+            C_ASGN(addIf);
+            C_ASGN(clearIfs);
+            C_ASGN(ifsCount);
+            C_ASGN(sendIf);
+            C_ASGN(rcvIf);
             // IPv6
             C_ASGN(setScope);
             C_ASGN(setScopeCfg);
@@ -1514,6 +3067,10 @@ static ptpmgmt_sk ptpmgmt_sk_alloc_all(ptpmgmt_socket_class type, SockBase *sko)
             C_ASGN(setIf);
             C_ASGN(setAll);
             C_ASGN(setAllInit);
+            C_ASGN(setFilter);
+            C_ASGN(removeFilter);
+            C_ASGN(setBusyPoll);
+            C_ASGN(setBusyPollCfg);
             break;
         default:
             free(sk);
@@ -1534,6 +3091,13 @@ static ptpmgmt_sk ptpmgmt_sk_alloc_all(ptpmgmt_socket_class type, SockBase *sko)
     C_ASGN(init);
     C_ASGN(send);
     C_ASGN(rcv);
+    C_ASGN(sendBatch);
+    C_ASGN(rcvBatch);
+    C_ASGN(setTimestamping);
+    C_ASGN(isTimestamping);
+    C_ASGN(rcvTs);
+    C_ASGN(getTxId);
+    C_ASGN(getTxTs);
     C_ASGN(getFd);
     sk->fileno = ptpmgmt_sk_getFd;
     C_ASGN(poll);
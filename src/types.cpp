@@ -340,7 +340,8 @@ MsgParams::MsgParams() :
     filterSignaling(true),
     rcvSMPTEOrg(true),
     sendAuth(true),
-    rcvAuth(RCV_AUTH_ALL)
+    rcvAuth(RCV_AUTH_ALL),
+    reuseTlvs(false)
 {
 }
 
@@ -375,6 +376,7 @@ void cpyMsgParams(ptpmgmt_pMsgParams p)
     p->rcvSMPTEOrg = r.rcvSMPTEOrg;
     p->sendAuth = r.sendAuth;
     p->rcvAuth = (ptpmgmt_MsgParams_RcvAuth_e)r.rcvAuth;
+    p->reuseTlvs = r.reuseTlvs;
     p->implementSpecific = (ptpmgmt_implementSpecific_e)r.implementSpecific;
     memcpy(p->target.clockIdentity.v, r.target.clockIdentity.v,
         ClockIdentity_t::size());
@@ -958,6 +958,17 @@ cpp_cod(`  private:')dnl
 cpp_cod(`    /** when filter TLVs in signalling messages')dnl
 cpp_cod(`     * allow TLVs that are in the map, the bool value is ignored */')dnl
 cpp_cod(`    std::map<tlvType_e, bool> allowSigTlvs;')dnl
+cpp_cod(`    friend class Message;')dnl
+cpp_cod(`')dnl
+cpp_cod(`  public:')dnl
+    /* New fields are added at the end, to keep the structure layout */
+    /**
+     * Reuse parsed TLVs objects in following parse
+     * The Message object keeps the TLVs of last parse
+     *  and overwrite them in the next parse of the same TLV type.
+     * Steady state parsing does not allocate memory.
+     */
+    bool reuseTlvs;
 };
 cpp_cod(`/** Base for all Management TLV structures */')dnl
 cpp_cod(`struct BaseMngTlv {')dnl
@@ -0,0 +1,613 @@
+/* SPDX-License-Identifier: LGPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief io_uring send and receive for sockets
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ * @details
+ *  Use the kernel interface directly, without liburing.
+ *
+ */
+
+#include "comp.h"
+#include <cerrno>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#include "uring.h"
+
+__PTPMGMT_NAMESPACE_BEGIN
+
+static inline size_t roundPow2(size_t v)
+{
+    size_t r = 1;
+    while(r < v)
+        r <<= 1;
+    return r;
+}
+
+#ifdef HAVE_IO_URING
+// Multishot receive user data, send use the slot number plus one
+static const uint64_t rcvUserData = 0;
+// Buffers group of the receive buffer ring
+static const uint16_t bufGroup = 0;
+
+struct SockUring::Ring {
+    int fd = -1;
+    /* Submission queue */
+    void *sqPtr = MAP_FAILED;
+    size_t sqSize = 0;
+    io_uring_sqe *sqes = (io_uring_sqe *)MAP_FAILED;
+    size_t sqesSize = 0;
+    unsigned *sqHead, *sqTail, *sqArray;
+    unsigned sqMask, sqEntries;
+    unsigned toSubmit = 0;
+    /* Completion queue */
+    void *cqPtr = MAP_FAILED;
+    size_t cqSize = 0;
+    unsigned *cqHead, *cqTail;
+    unsigned cqMask;
+    io_uring_cqe *cqes;
+    /* Receive buffer ring */
+    io_uring_buf_ring *bufRing = (io_uring_buf_ring *)MAP_FAILED;
+    size_t bufRingSize = 0;
+    uint16_t bufMask;
+    uint16_t bufTail = 0;
+    /* Multishot receive */
+    msghdr rcvHdr = {};
+    size_t nameLen = 0; /* Space for source address */
+    size_t hdrLen = 0; /* Ethernet header of raw socket */
+    bool armed = false;
+    bool rcvFail = false;
+    /* Send headers per slot */
+    std::vector<msghdr> sendHdrs;
+    std::vector<iovec> sendIovs;
+    const SockUnix *unixSk = nullptr;
+    const SockIp *ipSk = nullptr;
+    const SockRaw *rawSk = nullptr;
+    ~Ring() {
+        if(bufRing != MAP_FAILED)
+            munmap(bufRing, bufRingSize);
+        if(sqes != MAP_FAILED)
+            munmap(sqes, sqesSize);
+        if(cqPtr != MAP_FAILED && cqPtr != sqPtr)
+            munmap(cqPtr, cqSize);
+        if(sqPtr != MAP_FAILED)
+            munmap(sqPtr, sqSize);
+        if(fd >= 0)
+            ::close(fd);
+    }
+    unsigned sqSpace() const {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        return sqEntries - (*sqTail - head);
+    }
+    io_uring_sqe *getSqe() {
+        unsigned tail = *sqTail;
+        if(tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+            return nullptr;
+        unsigned index = tail & sqMask;
+        io_uring_sqe *sqe = sqes + index;
+        *sqe = {};
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        toSubmit++;
+        return sqe;
+    }
+};
+
+bool SockUring::initRing()
+{
+    Ring *r = new Ring;
+    m_ring = r;
+    r->unixSk = dynamic_cast<const SockUnix *>(&m_sock);
+    r->ipSk = dynamic_cast<const SockIp *>(&m_sock);
+    r->rawSk = dynamic_cast<const SockRaw *>(&m_sock);
+    if(r->unixSk != nullptr)
+        r->nameLen = sizeof(sockaddr_un);
+    else if(r->ipSk != nullptr)
+        r->nameLen = sizeof(sockaddr_in6);
+    else if(r->rawSk != nullptr)
+        r->hdrLen = sizeof(ethhdr);
+    else
+        return false; // Unknown socket class
+    // Sends and the receive
+    io_uring_params p = {};
+    r->fd = syscall(__NR_io_uring_setup, roundPow2(m_bufCount + 1), &p);
+    if(r->fd < 0)
+        return false;
+    r->sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cqSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP)
+        r->sqSize = r->cqSize = std::max(r->sqSize, r->cqSize);
+    r->sqPtr = mmap(nullptr, r->sqSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if(r->sqPtr == MAP_FAILED)
+        return false;
+    if(p.features & IORING_FEAT_SINGLE_MMAP)
+        r->cqPtr = r->sqPtr;
+    else {
+        r->cqPtr = mmap(nullptr, r->cqSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_CQ_RING);
+        if(r->cqPtr == MAP_FAILED)
+            return false;
+    }
+    r->sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    r->sqes = (io_uring_sqe *)mmap(nullptr, r->sqesSize,
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd,
+            IORING_OFF_SQES);
+    if(r->sqes == MAP_FAILED)
+        return false;
+    uint8_t *sq = (uint8_t *)r->sqPtr;
+    r->sqHead = (unsigned *)(sq + p.sq_off.head);
+    r->sqTail = (unsigned *)(sq + p.sq_off.tail);
+    r->sqArray = (unsigned *)(sq + p.sq_off.array);
+    r->sqMask = *(unsigned *)(sq + p.sq_off.ring_mask);
+    r->sqEntries = *(unsigned *)(sq + p.sq_off.ring_entries);
+    uint8_t *cq = (uint8_t *)r->cqPtr;
+    r->cqHead = (unsigned *)(cq + p.cq_off.head);
+    r->cqTail = (unsigned *)(cq + p.cq_off.tail);
+    r->cqMask = *(unsigned *)(cq + p.cq_off.ring_mask);
+    r->cqes = (io_uring_cqe *)(cq + p.cq_off.cqes);
+    // Register the receive buffer ring, the ring must be page aligned
+    r->bufRingSize = m_bufCount * sizeof(io_uring_buf);
+    r->bufRing = (io_uring_buf_ring *)mmap(nullptr, r->bufRingSize,
+            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(r->bufRing == MAP_FAILED)
+        return false;
+    io_uring_buf_reg reg = {};
+    reg.ring_addr = (uint64_t)r->bufRing;
+    reg.ring_entries = m_bufCount;
+    reg.bgid = bufGroup;
+    if(syscall(__NR_io_uring_register, r->fd, IORING_REGISTER_PBUF_RING,
+            &reg, 1) != 0)
+        return false;
+    r->bufMask = m_bufCount - 1;
+    // Receive buffer starts with io_uring_recvmsg_out and the source address
+    r->rcvHdr.msg_namelen = r->nameLen;
+    m_bufLen = sizeof(io_uring_recvmsg_out) + r->nameLen + r->hdrLen +
+        m_bufSize;
+    m_bufs.resize(m_bufCount * m_bufLen);
+    for(size_t id = 0; id < m_bufCount; id++)
+        addBuf(id);
+    r->sendHdrs.resize(m_bufCount);
+    r->sendIovs.resize(m_bufCount * 2);
+    for(size_t i = 0; i < m_bufCount; i++) {
+        msghdr &h = r->sendHdrs[i];
+        iovec *iov = &r->sendIovs[i * 2];
+        h = {};
+        h.msg_iov = iov;
+        if(r->unixSk != nullptr) {
+            h.msg_name = (void *) &r->unixSk->m_peerAddr.m_addr;
+            h.msg_namelen = sizeof(sockaddr_un);
+        } else if(r->ipSk != nullptr) {
+            h.msg_name = r->ipSk->m_addr;
+            h.msg_namelen = r->ipSk->m_addr_len;
+        } else {
+            h.msg_name = (void *) &r->rawSk->m_addr;
+            h.msg_namelen = sizeof(sockaddr_ll);
+            iov->iov_base = (void *) &r->rawSk->m_hdr;
+            iov->iov_len = sizeof(ethhdr);
+            iov++;
+            h.msg_iovlen++;
+        }
+        iov->iov_base = m_sendBufs.data() + i * m_bufSize;
+        h.msg_iovlen++;
+    }
+    // The kernel check the multishot receive on submit
+    arm();
+    if(!enter(0))
+        return false;
+    reap();
+    return !r->rcvFail;
+}
+void SockUring::closeRing()
+{
+    delete m_ring;
+    m_ring = nullptr;
+}
+bool SockUring::enter(unsigned minComplete)
+{
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for(;;) {
+        int ret = syscall(__NR_io_uring_enter, m_ring->fd, m_ring->toSubmit,
+                minComplete, flags, nullptr, 0);
+        if(ret >= 0) {
+            m_ring->toSubmit -= std::min((unsigned)ret, m_ring->toSubmit);
+            return true;
+        }
+        if(errno != EINTR) {
+            PTPMGMT_ERROR_P("io_uring_enter");
+            return false;
+        }
+    }
+}
+void SockUring::reap()
+{
+    Ring *r = m_ring;
+    unsigned head = *r->cqHead;
+    unsigned tail = __atomic_load_n(r->cqTail, __ATOMIC_ACQUIRE);
+    for(; head != tail; head++) {
+        io_uring_cqe *cqe = r->cqes + (head & r->cqMask);
+        if(cqe->user_data == rcvUserData) {
+            if(!(cqe->flags & IORING_CQE_F_MORE))
+                r->armed = false;
+            if(cqe->res < 0) {
+                // Out of buffers, arm again when the buffers are released
+                if(cqe->res != -ENOBUFS)
+                    r->rcvFail = true;
+                continue;
+            }
+            if(!(cqe->flags & IORING_CQE_F_BUFFER))
+                continue;
+            size_t id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+            SockMsg msg;
+            if(id < m_bufCount &&
+                rcvParse(m_bufs.data() + id * m_bufLen, cqe->res, msg)) {
+                m_ready.push_back(msg);
+                m_heldBufs[id] = true;
+                m_held++;
+            } else if(id < m_bufCount)
+                addBuf(id);
+        } else {
+            size_t slot = cqe->user_data - 1;
+            // Raw socket sends the Ethernet header with the message
+            if(cqe->res < 0 ||
+                (size_t)cqe->res != m_sendLens[slot] + r->hdrLen)
+                m_sendErrors++;
+            else
+                m_sock.m_txId++; // Count like SockBase::send()
+            m_freeSlots.push_back(slot);
+            m_inFlight--;
+        }
+    }
+    __atomic_store_n(r->cqHead, head, __ATOMIC_RELEASE);
+}
+void SockUring::arm()
+{
+    io_uring_sqe *sqe = m_ring->getSqe();
+    if(sqe == nullptr)
+        return;
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = m_sock.getFd();
+    sqe->addr = (uint64_t) &m_ring->rcvHdr;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = bufGroup;
+    sqe->user_data = rcvUserData;
+    m_ring->armed = true;
+}
+void SockUring::addBuf(size_t id)
+{
+    Ring *r = m_ring;
+    // In C++ the kernel header flexible array does not start at offset 0
+    io_uring_buf *b = (io_uring_buf *)r->bufRing + (r->bufTail & r->bufMask);
+    b->addr = (uint64_t)(m_bufs.data() + id * m_bufLen);
+    b->len = m_bufLen;
+    b->bid = id;
+    r->bufTail++;
+    __atomic_store_n(&r->bufRing->tail, r->bufTail, __ATOMIC_RELEASE);
+}
+bool SockUring::rcvParse(uint8_t *buf, size_t len, SockMsg &msg) const
+{
+    const Ring *r = m_ring;
+    io_uring_recvmsg_out *out = (io_uring_recvmsg_out *)buf;
+    if(len < sizeof(io_uring_recvmsg_out) + r->nameLen ||
+        (out->flags & MSG_TRUNC) != 0)
+        return false;
+    uint8_t *name = buf + sizeof(io_uring_recvmsg_out);
+    uint8_t *payload = name + r->nameLen;
+    size_t plen = out->payloadlen;
+    if(payload + plen > buf + len)
+        return false;
+    msg.fromLen = 0;
+    if(r->unixSk != nullptr) {
+        // Receive only from the peer, as SockUnix::rcv()
+        UnixPeer from;
+        size_t addrLen = std::min((size_t)out->namelen, r->nameLen);
+        memcpy(&from.m_addr, name, addrLen);
+        from.setLen(addrLen);
+        if(plen == 0 || from != r->unixSk->m_peerAddr)
+            return false;
+    } else if(r->ipSk != nullptr) {
+        sockaddr *addr = (sockaddr *)name;
+        if(addr->sa_family == AF_INET) {
+            msg.fromLen = sizeof(in_addr);
+            memcpy(msg.from, &((sockaddr_in *)addr)->sin_addr, msg.fromLen);
+        } else if(addr->sa_family == AF_INET6) {
+            msg.fromLen = sizeof(in6_addr);
+            memcpy(msg.from, &((sockaddr_in6 *)addr)->sin6_addr, msg.fromLen);
+        }
+    } else {
+        // A frame shorter than Ethernet header carries no message
+        if(plen <= r->hdrLen)
+            return false;
+        msg.fromLen = ETH_ALEN;
+        memcpy(msg.from, ((ethhdr *)payload)->h_source, ETH_ALEN);
+        payload += r->hdrLen;
+        plen -= r->hdrLen;
+    }
+    msg.buf = payload;
+    msg.bufSize = m_bufSize;
+    msg.len = plen;
+    return true;
+}
+#else /* HAVE_IO_URING */
+struct SockUring::Ring {};
+bool SockUring::initRing() { return false; }
+void SockUring::closeRing() {}
+bool SockUring::enter(unsigned) { return false; }
+void SockUring::reap() {}
+void SockUring::arm() {}
+void SockUring::addBuf(size_t) {}
+bool SockUring::rcvParse(uint8_t *, size_t, SockMsg &) const { return false; }
+#endif /* HAVE_IO_URING */
+
+SockUring::SockUring(const SockBase &sock) : m_sock(sock)
+{
+}
+SockUring::~SockUring()
+{
+    close();
+}
+bool SockUring::init(size_t bufCount, size_t bufSize)
+{
+    if(m_isInit) {
+        PTPMGMT_ERROR("Already initialized");
+        return false;
+    }
+    if(m_sock.getFd() < 0) {
+        PTPMGMT_ERROR("Socket is not initialized");
+        return false;
+    }
+    if(bufCount == 0 || bufCount > UINT16_MAX / 2 || bufSize == 0) {
+        PTPMGMT_ERROR("Wrong buffers count or size");
+        return false;
+    }
+    m_bufCount = roundPow2(bufCount);
+    m_bufSize = bufSize;
+    m_sendBufs.resize(m_bufCount * m_bufSize);
+    m_sendLens.resize(m_bufCount);
+    m_heldBufs.assign(m_bufCount, false);
+    for(size_t i = m_bufCount; i > 0; i--)
+        m_freeSlots.push_back(i - 1);
+    if(!initRing()) {
+        // Fall back to the socket calls
+        closeRing();
+        m_bufLen = m_bufSize;
+        m_bufs.resize(m_bufCount * m_bufLen);
+        m_freeBufs.clear();
+        for(size_t id = m_bufCount; id > 0; id--)
+            m_freeBufs.push_back(id - 1);
+    }
+    m_isInit = true;
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+void SockUring::close()
+{
+    closeRing();
+    m_bufs.clear();
+    m_freeBufs.clear();
+    m_ready.clear();
+    m_held = 0;
+    m_heldBufs.clear();
+    m_sendBufs.clear();
+    m_sendLens.clear();
+    m_freeSlots.clear();
+    m_queue.clear();
+    m_inFlight = 0;
+    m_sendErrors = 0;
+    m_isInit = false;
+}
+bool SockUring::isUring() const
+{
+    return m_ring != nullptr;
+}
+int SockUring::getFd() const
+{
+#ifdef HAVE_IO_URING
+    if(m_ring != nullptr)
+        return m_ring->fd;
+#endif
+    return m_sock.getFd();
+}
+bool SockUring::send(const void *msg, size_t len)
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Not initialized");
+        return false;
+    }
+    if(msg == nullptr || len == 0 || len > m_bufSize) {
+        PTPMGMT_ERROR("Wrong message size %zu", len);
+        return false;
+    }
+    if(m_freeSlots.empty() && m_ring != nullptr)
+        reap();
+    if(m_freeSlots.empty()) {
+        PTPMGMT_ERROR("All send slots are in use");
+        return false;
+    }
+    size_t slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    memcpy(m_sendBufs.data() + slot * m_bufSize, msg, len);
+    m_sendLens[slot] = len;
+    m_queue.push_back(slot);
+    PTPMGMT_ERROR_CLR;
+    return true;
+}
+ssize_t SockUring::submitFallback()
+{
+    std::vector<SockMsg> msgs(m_queue.size());
+    for(size_t i = 0; i < m_queue.size(); i++) {
+        msgs[i].buf = m_sendBufs.data() + m_queue[i] * m_bufSize;
+        msgs[i].len = m_sendLens[m_queue[i]];
+    }
+    ssize_t cnt = m_sock.sendBatch(msgs.data(), msgs.size());
+    size_t sent = cnt > 0 ? cnt : 0;
+    m_sendErrors += m_queue.size() - sent;
+    m_freeSlots.insert(m_freeSlots.end(), m_queue.begin(), m_queue.end());
+    m_queue.clear();
+    return cnt;
+}
+ssize_t SockUring::submit()
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Not initialized");
+        return -1;
+    }
+    if(m_queue.empty()) {
+        PTPMGMT_ERROR_CLR;
+        return 0;
+    }
+    if(m_ring == nullptr)
+        return submitFallback();
+#ifdef HAVE_IO_URING
+    // Fill only the entries the submission queue can hold,
+    // the rest stay queued for the next call
+    size_t num = std::min(m_queue.size(), (size_t)m_ring->sqSpace());
+    if(num == 0) {
+        PTPMGMT_ERROR("Submission queue is full");
+        return -1;
+    }
+    for(size_t i = 0; i < num; i++) {
+        size_t slot = m_queue[i];
+        io_uring_sqe *sqe = m_ring->getSqe();
+        msghdr &h = m_ring->sendHdrs[slot];
+        h.msg_iov[h.msg_iovlen - 1].iov_len = m_sendLens[slot];
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = m_sock.getFd();
+        sqe->addr = (uint64_t) &h;
+        sqe->len = 1;
+        sqe->user_data = slot + 1;
+        // Send in order
+        if(i + 1 < num)
+            sqe->flags = IOSQE_IO_LINK;
+    }
+    m_queue.erase(m_queue.begin(), m_queue.begin() + num);
+    m_inFlight += num;
+    if(!enter(0))
+        return -1;
+    reap();
+    PTPMGMT_ERROR_CLR;
+    return num;
+#else
+    return -1;
+#endif
+}
+size_t SockUring::sendPending() const
+{
+    return m_queue.size() + m_inFlight;
+}
+size_t SockUring::sendErrors()
+{
+    if(m_ring != nullptr)
+        reap();
+    size_t ret = m_sendErrors;
+    m_sendErrors = 0;
+    return ret;
+}
+ssize_t SockUring::rcvFallback(SockMsg *msgs, size_t count, bool block)
+{
+    size_t num = std::min(count, m_freeBufs.size());
+    if(num == 0) {
+        PTPMGMT_ERROR("All receive buffers are in use");
+        return -1;
+    }
+    for(size_t i = 0; i < num; i++) {
+        msgs[i].buf = m_bufs.data() + m_freeBufs[m_freeBufs.size() - 1 - i] *
+            m_bufLen;
+        msgs[i].bufSize = m_bufSize;
+    }
+    ssize_t cnt = m_sock.rcvBatch(msgs, num, block);
+    if(cnt < 0) {
+        int err = Error::getErrno();
+        if(!block && (err == EAGAIN || err == EWOULDBLOCK)) {
+            PTPMGMT_ERROR_CLR;
+            return 0;
+        }
+        return -1;
+    }
+    for(ssize_t i = 0; i < cnt; i++)
+        m_heldBufs[m_freeBufs[m_freeBufs.size() - 1 - i]] = true;
+    m_freeBufs.resize(m_freeBufs.size() - cnt);
+    m_held += cnt;
+    return cnt;
+}
+ssize_t SockUring::rcv(SockMsg *msgs, size_t count, bool block)
+{
+    if(!m_isInit) {
+        PTPMGMT_ERROR("Not initialized");
+        return -1;
+    }
+    if(msgs == nullptr || count == 0) {
+        PTPMGMT_ERROR("No messages to receive");
+        return -1;
+    }
+    if(m_ring == nullptr)
+        return rcvFallback(msgs, count, block);
+#ifdef HAVE_IO_URING
+    // Arm again when the kernel has buffers
+    if(!m_ring->armed && m_held < m_bufCount)
+        arm();
+    if(m_ring->toSubmit > 0 && !enter(0))
+        return -1;
+    reap();
+    while(block && m_ready.empty()) {
+        if(m_ring->rcvFail) {
+            PTPMGMT_ERROR("Receive fails");
+            return -1;
+        }
+        if(!m_ring->armed) {
+            // The multishot receive may end while the kernel has buffers
+            if(m_held >= m_bufCount) {
+                PTPMGMT_ERROR("All receive buffers are in use");
+                return -1;
+            }
+            arm();
+        }
+        if(!enter(1))
+            return -1;
+        reap();
+    }
+    size_t num = std::min(count, m_ready.size());
+    for(size_t i = 0; i < num; i++) {
+        msgs[i] = m_ready.front();
+        m_ready.pop_front();
+    }
+    PTPMGMT_ERROR_CLR;
+    return num;
+#else
+    return -1;
+#endif
+}
+void SockUring::release(const SockMsg *msgs, size_t count)
+{
+    if(!m_isInit || msgs == nullptr)
+        return;
+    for(size_t i = 0; i < count; i++) {
+        const uint8_t *buf = (const uint8_t *)msgs[i].buf;
+        if(buf < m_bufs.data() || buf >= m_bufs.data() + m_bufs.size())
+            continue;
+        size_t id = (buf - m_bufs.data()) / m_bufLen;
+        // Skip buffers not held, a buffer is returned only once
+        if(!m_heldBufs[id])
+            continue;
+        m_heldBufs[id] = false;
+        if(m_ring != nullptr)
+            addBuf(id);
+        else
+            m_freeBufs.push_back(id);
+        m_held--;
+    }
+}
+
+__PTPMGMT_NAMESPACE_END
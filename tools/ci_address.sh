@@ -534,8 +534,9 @@ config_report()
  local list='build host TCL_MINVER PERL PY3_VER RUBY_VER PHP_VER PHP_UNIT
    LUA_VERS LUA_VER USE_ENDIAN PERL5_VER HAVE_LIBCHRONY_HEADER PDF2SVG
    GO_MINVER DOTTOOL ASTYLE_MINVER HAVE_GTEST_HEADER HAVE_CRITERION_HEADER
-   HAVE_GMOCK_HEADER CPPCHECK SWIG_MINVER DOXYGEN_MINVER CMARK MARKDOWN
-   PANDOC PACKAGE_VERSION CXX_VERSION CXX CC_VERSION CC CHRPATH PATCHELF
+   HAVE_GMOCK_HEADER HAVE_GBENCH_HEADER CPPCHECK SWIG_MINVER DOXYGEN_MINVER
+   CMARK MARKDOWN PANDOC PACKAGE_VERSION CXX_VERSION CXX CC_VERSION CC CHRPATH
+   PATCHELF
    HAVE_SSL_HEADER HAVE_GCRYPT_HEADER HAVE_GNUTLS_HEADER HAVE_NETTLE_HEADER
    PERL5_HAVE_TEST LUA_UNIT_VERS'
  local langs='tcl perl5 python3 ruby php lua go'
@@ -590,6 +591,7 @@ config_report()
  [[ -n "$HAVE_GTEST_HEADER" ]] && local -r gtest='v' || local -r gtest='x'
  [[ -n "$HAVE_GMOCK_HEADER" ]] && local -r gmock='v' || local -r gmock='x'
  [[ -n "$HAVE_CRITERION_HEADER" ]] && local -r crtest='v' || local -r crtest='x'
+ [[ -n "$HAVE_GBENCH_HEADER" ]] && local -r gbench='v' || local -r gbench='x'
  [[ -n "$CPPCHECK" ]] && local -r cppcheck='v' || local -r cppcheck='x'
  [[ -n "$SWIG_MINVER" ]] && local -r swig="$SWIG_MINVER" || local -r swig='x'
  [[ -n "$DOXYGEN_MINVER" ]] && local -r doxy="$DOXYGEN_MINVER" || local -r doxy='x'
@@ -610,6 +612,7 @@ ssl '$ssl' gcrypt '$gcrypt' gnutls '$gnutls' nettle '$nettle'
 Doxygen '$doxy' dot '$dver' Pandoc '$pandoc' pdf2svg '$pdf2svg'
 cppcheck '$cppcheck' astyle '$astyle'
 Google test '$gtest' Google test mock '$gmock' Criterion test '$crtest'
+Google benchmark '$gbench'
 swig '$swig' Python '$python3' Ruby '$ruby'
 Perl '$perl5' perl5-test '$tperl5' go '$go' tcl '$tcl'
 PHP '$php' PHP-unit '$uphp'
@@ -77,6 +77,30 @@ Test(MessageAuthTest, MethodChangeAuthKey)
     s->free(s);
 }
 
+// Test replace the SA
+// bool rotateAuth(ptpmgmt_msg msg, const_ptpmgmt_safile sa, uint8_t spp,
+//     uint32_t key)
+// bool preloadAuth(ptpmgmt_msg msg)
+// bool setAuthCacheSize(ptpmgmt_msg msg, size_t size)
+Test(MessageAuthTest, MethodRotateAuth)
+{
+    ptpmgmt_safile s = ptpmgmt_safile_alloc();
+    cr_assert(not(zero(ptr, s)));
+    cr_expect(s->read_sa(s, "utest/sa_file.cfg"));
+    ptpmgmt_msg m = ptpmgmt_msg_alloc();
+    cr_assert(not(zero(ptr, m)));
+    cr_expect(not(m->preloadAuth(m)));
+    cr_expect(m->setAuthCacheSize(m, 2));
+    cr_expect(m->useAuth(m, s, 2, 10));
+    cr_expect(m->rotateAuth(m, s, 1, 2));
+    cr_expect(eq(int, m->usedAuthSppID(m), 1));
+    cr_expect(eq(u32, m->usedAuthKeyID(m), 2));
+    cr_expect(not(m->rotateAuth(m, s, 3, 1)));
+    cr_expect(m->preloadAuth(m));
+    m->free(m);
+    s->free(s);
+}
+
 // Test disable authntication
 // bool haveAuth(const_ptpmgmt_msg msg)
 // bool disableAuth(ptpmgmt_msg msg)
@@ -23,6 +23,9 @@ Test(ConfigFileTest, MethodEmptyConstructor)
     cr_expect(eq(i8, f->udp6_scope(f, NULL), 0xe));
     cr_expect(eq(i8, f->udp_ttl(f, NULL), 1));
     cr_expect(eq(i8, f->socket_priority(f, NULL), 0));
+    cr_expect(eq(u32, f->busy_poll(f, NULL), 0));
+    cr_expect(eq(i8, f->prefer_busy_poll(f, NULL), 0));
+    cr_expect(eq(u32, f->busy_poll_spin(f, NULL), 0));
     cr_expect(eq(i8, f->network_transport(f, NULL), '4'));
     cr_expect(eq(i32, f->active_key_id(f, NULL), 0));
     cr_expect(eq(i8, f->spp(f, NULL), 0));
@@ -61,6 +64,9 @@ Test(ConfigFileTest, MethodReadConfiguration)
     cr_expect(eq(i8, f->udp6_scope(f, NULL), 0xd));
     cr_expect(eq(i8, f->udp_ttl(f, NULL), 3));
     cr_expect(eq(i8, f->socket_priority(f, NULL), 11));
+    cr_expect(eq(u32, f->busy_poll(f, NULL), 50));
+    cr_expect(eq(i8, f->prefer_busy_poll(f, NULL), 0));
+    cr_expect(eq(u32, f->busy_poll_spin(f, NULL), 20));
     cr_expect(eq(i8, f->network_transport(f, NULL), '6'));
     cr_expect(eq(i32, f->active_key_id(f, NULL), 10));
     cr_expect(eq(i8, f->spp(f, NULL), 2));
@@ -146,6 +152,24 @@ Test(ConfigFileTest, MethodSocketPriority)
     f->free(f);
 }
 
+// Tests get busy poll parameters
+// uint32_t busy_poll(ptpmgmt_cfg _this, const char *section)
+// uint8_t prefer_busy_poll(ptpmgmt_cfg _this, const char *section)
+// uint32_t busy_poll_spin(ptpmgmt_cfg _this, const char *section)
+Test(ConfigFileTest, MethodBusyPoll)
+{
+    ptpmgmt_cfg f = ptpmgmt_cfg_alloc();
+    cr_assert(not(zero(ptr, f)));
+    cr_expect(f->read_cfg(f, "utest/testing.cfg"));
+    cr_expect(eq(u32, f->busy_poll(f, "dumm"), 30));
+    cr_expect(eq(u32, f->busy_poll(f, "non"), 50));
+    cr_expect(eq(i8, f->prefer_busy_poll(f, "dumm"), 1));
+    cr_expect(eq(i8, f->prefer_busy_poll(f, "non"), 0));
+    cr_expect(eq(u32, f->busy_poll_spin(f, "dumm"), 10));
+    cr_expect(eq(u32, f->busy_poll_spin(f, "non"), 20));
+    f->free(f);
+}
+
 // Tests get network transport type parameter
 // uint8_t network_transport(ptpmgmt_cfg _this, const char *section)
 Test(ConfigFileTest, MethodNetworkTransport)
@@ -82,6 +82,7 @@ Test(MessageTest, MethodGetParams)
     cr_expect(eq(int, p->rcvSMPTEOrg, p1->rcvSMPTEOrg));
     cr_expect(eq(i8, p->sendAuth, p1->sendAuth));
     cr_expect(eq(i8, p->rcvAuth, p1->rcvAuth));
+    cr_expect(eq(int, p->reuseTlvs, p1->reuseTlvs));
     m->free(m);
     p1->free(p1);
 }
@@ -119,6 +120,7 @@ Test(MessageTest, MethodUpdateParams)
     cr_expect(eq(int, p->rcvSMPTEOrg, p1->rcvSMPTEOrg));
     cr_expect(eq(i8, p->sendAuth, p1->sendAuth));
     cr_expect(eq(i8, p->rcvAuth, p1->rcvAuth));
+    cr_expect(eq(int, p->reuseTlvs, p1->reuseTlvs));
     m->free(m);
     p1->free(p1);
 }
@@ -1832,6 +1834,37 @@ Test(MessageTest, MethodTraversSigTlvs)
     cr_expect(m->traversSigTlvs(m, &a, verifyPr1));
 }
 
+// Test visit signalling message TLVs while parsing
+// enum ptpmgmt_MNG_PARSE_ERROR_e parseVisit(ptpmgmt_msg m, const void *buf,
+//     ssize_t msgSize, void *cookie, ptpmgmt_msg_sig_callback callback)
+Test(MessageTest, MethodParseVisit)
+{
+    ptpmgmt_msg m = ptpmgmt_msg_alloc();
+    cr_assert(not(zero(ptr, m)));
+    struct ptpmgmt_PRIORITY1_t p;
+    p.priority1 = 137;
+    cr_expect(m->setAction(m, PTPMGMT_SET, PTPMGMT_PRIORITY1, &p));
+    uint8_t buf[70];
+    cr_expect(eq(int, m->build(m, buf, sizeof buf, 1), PTPMGMT_MNG_PARSE_ERROR_OK));
+    buf[46] = PTPMGMT_RESPONSE;
+    buf[0] = (buf[0] & 0xf0) | ptpmgmt_Signaling; // messageType
+    buf[3] = 52; // header.messageLength
+    buf[32] = 5; // controlField
+    // Move the 8 bytes of Mng TLV
+    for(int i = 0; i < 8; i++)
+        buf[44 + i] = buf[48 + i];
+    ptpmgmt_pMsgParams mp = m->getParams(m);
+    mp->rcvSignaling = true;
+    mp->filterSignaling = false;
+    cr_expect(m->updateParams(m, mp));
+    struct cookie_t a = { 0xfefe };
+    cr_expect(eq(int, m->parseVisit(m, buf, 52, &a, verifyPr1),
+            PTPMGMT_MNG_PARSE_ERROR_SIG));
+    // TLVs are not stored
+    cr_expect(eq(int, m->getSigTlvsCount(m), 0));
+    m->free(m);
+}
+
 // Test get number of TLVs in a PTP signaling message
 // size_t getSigTlvsCount(const_ptpmgmt_msg m)
 Test(MessageTest, MethodGetSigTlvsCount)
@@ -1954,6 +1987,51 @@ Test(MessageTest, MethodGetSigMngTlvType)
     m->free(m);
 }
 
+// Test batch parse of many messages
+// ptpmgmt_msg_batch ptpmgmt_msg_batch_alloc()
+// size_t parse(const_ptpmgmt_msg_batch batch, const void *const *bufs,
+//     const ssize_t *sizes, size_t count)
+// size_t size(const_ptpmgmt_msg_batch batch)
+// enum ptpmgmt_MNG_PARSE_ERROR_e getErr(const_ptpmgmt_msg_batch batch,
+//     size_t position)
+// uint16_t getSequence(const_ptpmgmt_msg_batch batch, size_t position)
+// enum ptpmgmt_mng_vals_e getTlvId(const_ptpmgmt_msg_batch batch,
+//     size_t position)
+// const void *getData(ptpmgmt_msg_batch batch, size_t position)
+// void free(ptpmgmt_msg_batch batch)
+Test(MessageBatchTest, MethodParse)
+{
+    ptpmgmt_msg m = ptpmgmt_msg_alloc();
+    cr_assert(not(zero(ptr, m)));
+    struct ptpmgmt_PRIORITY1_t p;
+    uint8_t buf[2][70];
+    for(int i = 0; i < 2; i++) {
+        p.priority1 = 10 + i;
+        cr_expect(m->setAction(m, PTPMGMT_SET, PTPMGMT_PRIORITY1, &p));
+        cr_expect(eq(int, m->build(m, buf[i], sizeof buf[i], 20 + i),
+                PTPMGMT_MNG_PARSE_ERROR_OK));
+        // actionField location IEEE "PTP management message"
+        // Change to response action of get/set message
+        buf[i][46] = PTPMGMT_RESPONSE;
+    }
+    m->free(m);
+    const void *bufs[2] = { buf[0], buf[1] };
+    ssize_t sizes[2] = { 56, 56 };
+    ptpmgmt_msg_batch b = ptpmgmt_msg_batch_alloc();
+    cr_assert(not(zero(ptr, b)));
+    cr_expect(eq(sz, b->parse(b, bufs, sizes, 2), 2));
+    cr_expect(eq(sz, b->size(b), 2));
+    cr_expect(eq(int, b->getErr(b, 1), PTPMGMT_MNG_PARSE_ERROR_OK));
+    cr_expect(eq(u16, b->getSequence(b, 1), 21));
+    cr_expect(eq(int, b->getTlvId(b, 1), PTPMGMT_PRIORITY1));
+    const struct ptpmgmt_PRIORITY1_t *p1 =
+        (const struct ptpmgmt_PRIORITY1_t *)b->getData(b, 1);
+    cr_assert(not(zero(ptr, (void *)p1)));
+    cr_expect(eq(int, p1->priority1, 11));
+    cr_expect(not(zero(ptr, b->getMsg(b))));
+    b->free(b);
+}
+
 // ptpmgmt_tlv_mem ptpmgmt_tlv_mem_alloc()
 // enum ptpmgmt_mng_vals_e getID(const_ptpmgmt_tlv_mem self)
 // enum ptpmgmt_mng_vals_e id
@@ -546,6 +546,219 @@ Test(SockIp4Test, MethodRcv)
     sk->free(sk);
 }
 
+// Tests sendBatch method
+// ssize_t sendBatch(const_ptpmgmt_sk sk, const_ptpmgmt_sk_msg msgs,
+//     size_t count)
+Test(SockIp4Test, MethodSendBatch)
+{
+    ptpmgmt_sk sk = ptpmgmt_sk_alloc(ptpmgmt_SockIp4);
+    useTestMode(true);
+    bool r1 = sk->setIfUsingIndex(sk, 7);
+    bool r2 = sk->setUdpTtl(sk, 7);
+    bool r3 = sk->init(sk);
+    uint8_t buf[5];
+    memcpy(buf, "\x1\x2\x3\x4\x5", 5);
+    struct ptpmgmt_sk_msg_t msgs[3];
+    for(size_t i = 0; i < 3; i++) {
+        msgs[i].buf = buf;
+        msgs[i].len = sizeof buf;
+    }
+    bool r4 = sk->sendBatch(sk, msgs, 3) == 3;
+    sk->close(sk);
+    useTestMode(false);
+    cr_expect(r1);
+    cr_expect(r2);
+    cr_expect(r3);
+    cr_expect(r4);
+    sk->free(sk);
+}
+
+// Tests rcvBatch method
+// ssize_t rcvBatch(const_ptpmgmt_sk sk, ptpmgmt_sk_msg msgs, size_t count,
+//     bool block)
+Test(SockIp4Test, MethodRcvBatch)
+{
+    ptpmgmt_sk sk = ptpmgmt_sk_alloc(ptpmgmt_SockIp4);
+    useTestMode(true);
+    bool r1 = sk->setIfUsingIndex(sk, 7);
+    bool r2 = sk->setUdpTtl(sk, 7);
+    bool r3 = sk->init(sk);
+    uint8_t bufs[3][10];
+    struct ptpmgmt_sk_msg_t msgs[3];
+    for(size_t i = 0; i < 3; i++) {
+        msgs[i].buf = bufs[i];
+        msgs[i].bufSize = sizeof bufs[i];
+    }
+    bool r4 = sk->rcvBatch(sk, msgs, 3, false) == 2;
+    bool r5 = msgs[1].len == 5;
+    bool r6 = memcmp(bufs[1], "\x2\x4\x5\x6\x7", 5) == 0;
+    bool r7 = msgs[0].fromLen == 4;
+    bool r8 = memcmp(msgs[0].from, "\xc0\x0\x2\x1", 4) == 0;
+    sk->close(sk);
+    useTestMode(false);
+    cr_expect(r1);
+    cr_expect(r2);
+    cr_expect(r3);
+    cr_expect(r4);
+    cr_expect(r5);
+    cr_expect(r6);
+    cr_expect(r7);
+    cr_expect(r8);
+    sk->free(sk);
+}
+
+// Tests rcvTs method
+// bool setTimestamping(ptpmgmt_sk sk, bool enable, bool hardware)
+// bool isTimestamping(const_ptpmgmt_sk sk)
+// ssize_t rcvTs(const_ptpmgmt_sk sk, void *buf, size_t bufSize,
+//     struct ptpmgmt_Timestamp_t *ts, bool block)
+// uint32_t getTxId(const_ptpmgmt_sk sk)
+// bool getTxTs(const_ptpmgmt_sk sk, struct ptpmgmt_Timestamp_t *ts,
+//     uint32_t *id, bool block)
+Test(SockIp4Test, MethodRcvTs)
+{
+    ptpmgmt_sk sk = ptpmgmt_sk_alloc(ptpmgmt_SockIp4);
+    useTestMode(true);
+    bool r1 = sk->setIfUsingIndex(sk, 7);
+    bool r2 = sk->setUdpTtl(sk, 7);
+    bool r3 = sk->setTimestamping(sk, true, false);
+    bool r4 = sk->isTimestamping(sk);
+    bool r5 = sk->init(sk);
+    uint8_t buf[10];
+    struct ptpmgmt_Timestamp_t ts;
+    bool r6 = sk->rcvTs(sk, buf, sizeof buf, &ts, false) == 5;
+    bool r7 = memcmp(buf, "\x2\x4\x5\x6\x7", 5) == 0;
+    bool r8 = ts.secondsField == 12 && ts.nanosecondsField == 147;
+    bool r9 = sk->send(sk, "\x1\x2\x3\x4\x5", 5);
+    bool r10 = sk->getTxId(sk) == 1;
+    uint32_t id;
+    bool r11 = sk->getTxTs(sk, &ts, &id, false);
+    bool r12 = id == 3 && ts.secondsField == 13 && ts.nanosecondsField == 148;
+    sk->close(sk);
+    useTestMode(false);
+    cr_expect(r1);
+    cr_expect(r2);
+    cr_expect(r3);
+    cr_expect(r4);
+    cr_expect(r5);
+    cr_expect(r6);
+    cr_expect(r7);
+    cr_expect(r8);
+    cr_expect(r9);
+    cr_expect(r10);
+    cr_expect(r11);
+    cr_expect(r12);
+    sk->free(sk);
+}
+
+// Tests busy poll
+// bool setBusyPoll(ptpmgmt_sk sk, uint32_t busy_poll,
+//     bool prefer_busy_poll, uint32_t busy_poll_spin)
+// bool setBusyPollCfg(ptpmgmt_sk sk, const_ptpmgmt_cfg cfg,
+//     const char *section)
+Test(SockIp4Test, MethodBusyPoll)
+{
+    ptpmgmt_sk sk = ptpmgmt_sk_alloc(ptpmgmt_SockIp4);
+    ptpmgmt_cfg f = ptpmgmt_cfg_alloc();
+    useTestMode(true);
+    bool r1 = sk->setIfUsingIndex(sk, 7);
+    bool r2 = sk->setUdpTtl(sk, 7);
+    bool r3 = sk->setBusyPoll(sk, 30, true, 10);
+    bool r4 = f->read_cfg(f, "utest/testing.cfg");
+    bool r5 = sk->setBusyPollCfg(sk, f, "dumm");
+    bool r6 = sk->init(sk);
+    bool r7 = !sk->setBusyPoll(sk, 30, false, 0);
+    // The spin finds the message before poll()
+    bool r8 = sk->poll(sk, 1);
+    sk->close(sk);
+    useTestMode(false);
+    cr_expect(r1);
+    cr_expect(r2);
+    cr_expect(r3);
+    cr_expect(r4);
+    cr_expect(r5);
+    cr_expect(r6);
+    cr_expect(r7);
+    cr_expect(r8);
+    sk->free(sk);
+    f->free(f);
+}
+
+// Tests setFilter method
+// bool setFilter(ptpmgmt_sk sk, ptpmgmt_cpMsgParams prms, bool useSelfId)
+// bool removeFilter(ptpmgmt_sk sk)
+Test(SockIp4Test, MethodSetFilter)
+{
+    ptpmgmt_sk sk = ptpmgmt_sk_alloc(ptpmgmt_SockIp4);
+    ptpmgmt_pMsgParams prms = ptpmgmt_MsgParams_alloc();
+    prms->domainNumber = 3;
+    useTestMode(true);
+    bool r1 = sk->setIfUsingIndex(sk, 7);
+    bool r2 = sk->setUdpTtl(sk, 7);
+    bool r3 = sk->setFilter(sk, prms, false);
+    bool r4 = sk->init(sk);
+    // UDP header and Management message header
+    uint8_t pkt[8 + 54] = { 0 };
+    pkt[8] = 0xd;
+    pkt[8 + 4] = 3;
+    bool r5 = runFilter(pkt, sizeof pkt) != 0;
+    pkt[8 + 4] = 4;
+    bool r6 = runFilter(pkt, sizeof pkt) == 0;
+    bool r7 = sk->removeFilter(sk);
+    bool r8 = runFilter(pkt, sizeof pkt) != 0;
+    sk->close(sk);
+    useTestMode(false);
+    cr_expect(r1);
+    cr_expect(r2);
+    cr_expect(r3);
+    cr_expect(r4);
+    cr_expect(r5);
+    cr_expect(r6);
+    cr_expect(r7);
+    cr_expect(r8);
+    prms->free(prms);
+    sk->free(sk);
+}
+
+// Tests multiple interfaces
+// bool addIfUsingName(ptpmgmt_sk sk, const char *ifName)
+// bool clearIfs(ptpmgmt_sk sk)
+// bool addIfUsingIndex(ptpmgmt_sk sk, int ifIndex)
+// size_t ifsCount(const_ptpmgmt_sk sk)
+// bool sendIf(const_ptpmgmt_sk sk, const void *msg, size_t len, int ifIndex)
+// ssize_t rcvIf(const_ptpmgmt_sk sk, void *buf, size_t bufSize,
+//     int *ifIndex, bool block)
+Test(SockIp4Test, MethodMultiIf)
+{
+    ptpmgmt_sk sk = ptpmgmt_sk_alloc(ptpmgmt_SockIp4);
+    useTestMode(true);
+    bool r1 = sk->setIfUsingIndex(sk, 7);
+    bool r2 = sk->setUdpTtl(sk, 7);
+    bool r3 = sk->addIfUsingName(sk, "eth1");
+    bool r4 = sk->clearIfs(sk);
+    bool r5 = sk->addIfUsingIndex(sk, 8);
+    size_t cnt = sk->ifsCount(sk);
+    bool r6 = sk->init(sk);
+    bool r7 = sk->sendIf(sk, "\x1\x2\x3\x4\x5", 5, 8);
+    uint8_t buf[10];
+    int ifIndex = 0;
+    ssize_t ret = sk->rcvIf(sk, buf, sizeof buf, &ifIndex, false);
+    sk->close(sk);
+    useTestMode(false);
+    cr_expect(r1);
+    cr_expect(r2);
+    cr_expect(r3);
+    cr_expect(r4);
+    cr_expect(r5);
+    cr_expect(eq(sz, cnt, 2));
+    cr_expect(r6);
+    cr_expect(r7);
+    cr_expect(eq(sz, ret, 5));
+    cr_expect(zero(memcmp(buf, "\x2\x4\x5\x6\x7", 5)));
+    cr_expect(eq(int, ifIndex, 8));
+    sk->free(sk);
+}
+
 // Tests setIfUsingIndex method
 // bool setIfUsingIndex(ptpmgmt_sk sk, int ifIndex)
 // bool setUdpTtl(ptpmgmt_sk sk, uint8_t udp_ttl)
@@ -77,6 +77,46 @@ TEST(MessageAuthTest, MethodDisableAuth)
     EXPECT_FALSE(m.haveAuth());
 }
 
+// Test replace the SA
+// bool rotateAuth(const SaFile &sa, uint8_t spp, uint32_t key)
+// bool rotateAuth(const SaFile &sa)
+TEST(MessageAuthTest, MethodRotateAuth)
+{
+    SaFile s, s2;
+    EXPECT_TRUE(s.read_sa("utest/sa_file.cfg"));
+    EXPECT_TRUE(s2.read_sa("utest/sa_file.cfg"));
+    Message m;
+    EXPECT_FALSE(m.rotateAuth(s2));
+    EXPECT_TRUE(m.useAuth(s, 2, 10));
+    EXPECT_TRUE(m.rotateAuth(s2));
+    EXPECT_EQ(m.usedAuthSppID(), 2);
+    EXPECT_EQ(m.usedAuthKeyID(), 10);
+    EXPECT_TRUE(m.rotateAuth(s2, 1, 2));
+    EXPECT_EQ(m.usedAuthSppID(), 1);
+    EXPECT_EQ(m.usedAuthKeyID(), 2);
+    // Missing key, keep the previous SA
+    EXPECT_FALSE(m.rotateAuth(s2, 3, 1));
+    EXPECT_EQ(m.usedAuthSppID(), 1);
+    EXPECT_EQ(m.usedAuthKeyID(), 2);
+    EXPECT_TRUE(m.haveAuth());
+}
+
+// Test keys cache
+// bool preloadAuth()
+// bool setAuthCacheSize(size_t size)
+TEST(MessageAuthTest, MethodPreloadAuth)
+{
+    SaFile s;
+    EXPECT_TRUE(s.read_sa("utest/sa_file.cfg"));
+    Message m;
+    EXPECT_FALSE(m.preloadAuth());
+    EXPECT_FALSE(m.setAuthCacheSize(0));
+    EXPECT_TRUE(m.setAuthCacheSize(2));
+    EXPECT_TRUE(m.useAuth(s, 2, 10));
+    EXPECT_TRUE(m.preloadAuth());
+    EXPECT_TRUE(m.setAuthCacheSize(1));
+}
+
 // Test get SA
 // const SaFile &getSa() const
 TEST(MessageAuthTest, MethodGetSa)
@@ -148,6 +188,38 @@ TEST(MessageAuthTest, MethodBuild)
     EXPECT_EQ(memcmp(buf, ret, sizeof ret), 0);
 }
 
+// Test prepared request recalculate the ICV
+// MNG_PARSE_ERROR_e prepare(Message &msg, uint16_t sequence)
+// MNG_PARSE_ERROR_e setSequence(uint16_t sequence)
+TEST(MessageAuthTest, MethodPreparedRequest)
+{
+    Message m;
+    MsgParams pm = m.getParams();
+    pm.minorVersion = 1; // Authentication need IEEE 1588-2019
+    EXPECT_TRUE(m.updateParams(pm));
+    PRIORITY1_t p;
+    p.priority1 = 0x7f;
+    EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+    SaFile s;
+    EXPECT_TRUE(s.read_sa("utest/sa_file.cfg"));
+    EXPECT_TRUE(m.useAuth(s, 2, 10));
+    uint8_t buf[90];
+    EXPECT_EQ(m.build(buf, sizeof buf, 137), MNG_PARSE_ERROR_OK);
+    PreparedRequest r;
+    EXPECT_EQ(r.prepare(m, 1), MNG_PARSE_ERROR_OK);
+    EXPECT_TRUE(r.isReady());
+    EXPECT_EQ(r.getMsgLen(), 82);
+    EXPECT_NE(memcmp(r.getBuf().get(), buf, 82), 0);
+    EXPECT_EQ(r.setSequence(137), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(r.getSequence(), 137);
+    EXPECT_EQ(memcmp(r.getBuf().get(), buf, 82), 0);
+    // The request keeps its own key
+    EXPECT_TRUE(m.disableAuth());
+    EXPECT_EQ(r.setSequence(1), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(r.setSequence(137), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(memcmp(r.getBuf().get(), buf, 82), 0);
+}
+
 // Test parse management message with auth TLV
 // MNG_PARSE_ERROR_e parse(const void *buf, ssize_t msgSize)
 TEST(MessageAuthTest, MethodParse)
@@ -171,6 +243,48 @@ TEST(MessageAuthTest, MethodParse)
             0xf, 0x69, 0x4d, 0x8f
         };
     EXPECT_EQ(m.parse(p1, sizeof p1), MNG_PARSE_ERROR_OK);
+    // Verify with a key other than the send key
+    EXPECT_TRUE(m.changeAuth(1, 2));
+    EXPECT_EQ(m.parse(p1, sizeof p1), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(m.parse(p1, sizeof p1), MNG_PARSE_ERROR_OK);
+    // Wrong ICV
+    p1[81]++;
+    EXPECT_EQ(m.parse(p1, sizeof p1), MNG_PARSE_ERROR_AUTH_WRONG);
+}
+
+// Test batch parse with auth TLV, the batch reuses the key
+// size_t parse(const void *const *bufs, const ssize_t *sizes, size_t count)
+TEST(MessageAuthTest, MethodBatchParse)
+{
+    MessageBatch b;
+    Message &m = b.getMessage();
+    MsgParams pm = m.getParams();
+    pm.minorVersion = 1; // Authentication need IEEE 1588-2019
+    EXPECT_TRUE(m.updateParams(pm));
+    SaFile s;
+    EXPECT_TRUE(s.read_sa("utest/sa_file.cfg"));
+    EXPECT_TRUE(m.useAuth(s, 1, 2));
+    uint8_t p1[82] = {13, 0x12, 0, 82, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x89, 4, 0x7f, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 1, 1, 2, 0, 0, 1, 0, 4, 0x20,
+            5, 0x7f, 0, // 56
+            // Authentication TLV
+            0x80, 9, 0, 22, 2, 0, 0, 0, 0, 10,
+            // ICV of 16 bytes
+            0x78, 0x87, 0x56, 0xc2, 0xf1, 0x57, 0x42, 0x92, 0x14, 0xaa, 0x6b, 0xaa,
+            0xf, 0x69, 0x4d, 0x8f
+        };
+    uint8_t p2[82];
+    memcpy(p2, p1, sizeof p1);
+    // Wrong ICV
+    p2[81]++;
+    const void *bufs[3] = { p1, p1, p2 };
+    ssize_t sizes[3] = { 82, 82, 82 };
+    EXPECT_EQ(b.parse(bufs, sizes, 3), 2);
+    EXPECT_EQ(b.getErr(0), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(b.getErr(1), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(b.getErr(2), MNG_PARSE_ERROR_AUTH_WRONG);
+    EXPECT_EQ(b.getTlvId(1), PRIORITY1);
 }
 
 // Test receive Signaling with authentication
@@ -199,5 +313,42 @@ TEST(MessageAuthTest, MethodSig)
     EXPECT_TRUE(m.isLastMsgSig());
 }
 
+// Test signalling visitor see only authenticated TLVs
+// MNG_PARSE_ERROR_e parseVisit(const void *buf, ssize_t msgSize,
+//     const std::function<bool (const Message &msg, tlvType_e tlvType,
+//         const BaseSigTlv *tlv)> &callback)
+TEST(MessageAuthTest, MethodSigVisit)
+{
+    Message m;
+    MsgParams pm = m.getParams();
+    pm.minorVersion = 1; // Authentication need IEEE 1588-2019
+    pm.rcvSignaling = true;
+    pm.filterSignaling = false;
+    EXPECT_TRUE(m.updateParams(pm));
+    SaFile s;
+    EXPECT_TRUE(s.read_sa("utest/sa_file.cfg"));
+    EXPECT_TRUE(m.useAuth(s, 2, 10));
+    uint8_t p1[78] = {12, 0x12, 0, 78, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 5, 0x7f, 0xff, 0xff, 0xff,
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0, 1, 0, 4,
+            0x20, 5, 1, 0, // 52
+            // Authentication TLV
+            0x80, 9, 0, 22, 2, 0, 0, 0, 0, 10,
+            // ICV of 16 bytes
+            0xa2, 0xd2, 0x82, 0x95, 0x96, 0xf1, 0x4f, 0xb3, 4, 0xe4, 0xc7,
+            0xdd, 0x5e, 0x51, 0x74, 0x63
+        };
+    int cnt = 0;
+    auto visit = [&cnt](const Message &, tlvType_e tlvType,
+    const BaseSigTlv *) { cnt++; return tlvType != MANAGEMENT; };
+    EXPECT_EQ(m.parseVisit(p1, sizeof p1, visit), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(cnt, 1);
+    // Wrong ICV
+    p1[77]++;
+    cnt = 0;
+    EXPECT_EQ(m.parseVisit(p1, sizeof p1, visit), MNG_PARSE_ERROR_AUTH_WRONG);
+    EXPECT_EQ(cnt, 0);
+}
+
 /// printf("Error %s\n", m.err2str_c(m.parse
 /// for(size_t i=0; i < 52; i++){printf("0x%x, ", buf[i]);}printf("\n");
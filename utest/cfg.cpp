@@ -24,6 +24,9 @@ TEST(ConfigFileTest, MethodEmptyConstructor)
     EXPECT_EQ(f.udp6_scope(), 0xe);
     EXPECT_EQ(f.udp_ttl(), 1);
     EXPECT_EQ(f.socket_priority(), 0);
+    EXPECT_EQ(f.busy_poll(), 0);
+    EXPECT_EQ(f.prefer_busy_poll(), 0);
+    EXPECT_EQ(f.busy_poll_spin(), 0);
     EXPECT_EQ(f.network_transport(), '4');
     EXPECT_EQ(f.active_key_id(), 0);
     EXPECT_EQ(f.spp(), 0);
@@ -50,6 +53,9 @@ TEST(ConfigFileTest, MethodReadConfiguration)
     EXPECT_EQ(f.udp6_scope(), 0xd);
     EXPECT_EQ(f.udp_ttl(), 3);
     EXPECT_EQ(f.socket_priority(), 11);
+    EXPECT_EQ(f.busy_poll(), 50);
+    EXPECT_EQ(f.prefer_busy_poll(), 0);
+    EXPECT_EQ(f.busy_poll_spin(), 20);
     EXPECT_EQ(f.network_transport(), '6');
     EXPECT_EQ(f.active_key_id(), 10);
     EXPECT_EQ(f.spp(), 2);
@@ -114,6 +120,22 @@ TEST(ConfigFileTest, MethodSocketPriority)
     EXPECT_EQ(f.socket_priority("non"), 11);
 }
 
+// Tests get busy poll parameters
+// uint32_t busy_poll(const std::string &section = "") const
+// uint8_t prefer_busy_poll(const std::string &section = "") const
+// uint32_t busy_poll_spin(const std::string &section = "") const
+TEST(ConfigFileTest, MethodBusyPoll)
+{
+    ConfigFile f;
+    EXPECT_TRUE(f.read_cfg("utest/testing.cfg"));
+    EXPECT_EQ(f.busy_poll("dumm"), 30);
+    EXPECT_EQ(f.busy_poll("non"), 50);
+    EXPECT_EQ(f.prefer_busy_poll("dumm"), 1);
+    EXPECT_EQ(f.prefer_busy_poll("non"), 0);
+    EXPECT_EQ(f.busy_poll_spin("dumm"), 10);
+    EXPECT_EQ(f.busy_poll_spin("non"), 20);
+}
+
 // Tests get network transport type parameter
 // uint8_t network_transport(const std::string &section = "") const
 TEST(ConfigFileTest, MethodNetworkTransport)
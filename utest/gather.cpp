@@ -0,0 +1,161 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Gather management requests class unit tests
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include "gather.h"
+
+using namespace ptpmgmt;
+
+// Unix socket of a PTP daemon
+class Responder
+{
+  public:
+    int m_fd = -1;
+    std::string m_addr;
+    bool m_abstract;
+    Responder(const std::string &addr, bool abstract) : m_addr(addr),
+        m_abstract(abstract) {
+        m_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        sockaddr_un a = {};
+        a.sun_family = AF_UNIX;
+        memcpy(a.sun_path + (abstract ? 1 : 0), addr.c_str(), addr.size());
+        if(!abstract)
+            unlink(addr.c_str());
+        if(bind(m_fd, (sockaddr *)&a, sizeof a) != 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+    ~Responder() {
+        if(m_fd >= 0)
+            ::close(m_fd);
+        if(!m_abstract)
+            unlink(m_addr.c_str());
+    }
+    // Receive a request and send back a reply to the request source
+    // Reply from the request target port, with priority1 of value
+    bool reply(uint8_t value) {
+        pollfd pfd = { m_fd, POLLIN, 0 };
+        if(::poll(&pfd, 1, 1000) != 1)
+            return false;
+        uint8_t buf[100];
+        sockaddr_un from;
+        socklen_t len = sizeof from;
+        ssize_t size = recvfrom(m_fd, buf, sizeof buf, 0, (sockaddr *)&from,
+                &len);
+        if(size < 56)
+            return false;
+        // sourcePortIdentity = targetPortIdentity
+        memcpy(buf + 20, buf + 34, 10);
+        // actionField location IEEE "PTP management message"
+        buf[46] = RESPONSE;
+        buf[54] = value; // priority1
+        return sendto(m_fd, buf, size, 0, (sockaddr *)&from, len) == size;
+    }
+};
+
+class GatherTest : public ::testing::Test
+{
+  protected:
+    SockUnix sk;
+    MsgParams prms;
+    std::string base;
+    void SetUp() override {
+        prms.useZeroGet = false; // Reply with dataField
+        base = "/tmp/gather_utest." + std::to_string(getpid());
+        unlink((base + ".me").c_str());
+        ASSERT_TRUE(sk.setSelfAddress(base + ".me"));
+        ASSERT_TRUE(sk.init());
+    }
+    void TearDown() override {
+        sk.close();
+        unlink((base + ".me").c_str());
+    }
+};
+
+// Tests peers
+// bool addPeer(const std::string &addr, uint64_t timeout_ms = 0,
+//     bool useAbstract = false)
+// bool removePeer(const std::string &addr, bool useAbstract = false)
+// void clearPeers()
+// size_t peers() const
+TEST_F(GatherTest, MethodPeers)
+{
+    ManagementGather g(sk);
+    EXPECT_EQ(g.peers(), 0);
+    EXPECT_FALSE(g.addPeer(""));
+    EXPECT_TRUE(g.addPeer("/peer1"));
+    EXPECT_FALSE(g.addPeer("/peer1"));
+    // The abstract address differs
+    EXPECT_TRUE(g.addPeer("/peer1", 10, true));
+    EXPECT_TRUE(g.addPeer("/peer2"));
+    EXPECT_EQ(g.peers(), 3);
+    EXPECT_FALSE(g.removePeer("/peer3"));
+    EXPECT_TRUE(g.removePeer("/peer1", true));
+    EXPECT_FALSE(g.removePeer("/peer1", true));
+    EXPECT_EQ(g.peers(), 2);
+    g.clearPeers();
+    EXPECT_EQ(g.peers(), 0);
+}
+
+// Tests gather replies, timeout and send failure
+// std::vector<GatherReply> query(actionField_e action, mng_vals_e tlv_id,
+//     uint64_t timeout_ms, const BaseMngTlv *data = nullptr)
+TEST_F(GatherTest, MethodQuery)
+{
+    ManagementGather g(sk, prms);
+    Responder r1(base + ".1", false), r2("gather_utest.2", true),
+              silent(base + ".3", false);
+    ASSERT_GE(r1.m_fd, 0);
+    ASSERT_GE(r2.m_fd, 0);
+    ASSERT_GE(silent.m_fd, 0);
+    EXPECT_TRUE(g.addPeer(r1.m_addr));
+    EXPECT_TRUE(g.addPeer(r2.m_addr, 0, true));
+    EXPECT_TRUE(g.addPeer(silent.m_addr, 20));
+    EXPECT_TRUE(g.addPeer(base + ".none"));
+    for(uint16_t seq = 0; seq < 2; seq++) {
+        bool ok1 = false, ok2 = false;
+        // Reply in reverse order
+        std::thread t([&]() {
+            ok2 = r2.reply(seq + 2);
+            ok1 = r1.reply(seq + 1);
+        });
+        std::vector<GatherReply> res = g.query(GET, PRIORITY1, 1000);
+        t.join();
+        EXPECT_TRUE(ok1);
+        EXPECT_TRUE(ok2);
+        ASSERT_EQ(res.size(), 4);
+        EXPECT_STREQ(res[0].peer.c_str(), r1.m_addr.c_str());
+        EXPECT_FALSE(res[0].useAbstract);
+        EXPECT_STREQ(res[1].peer.c_str(), r2.m_addr.c_str());
+        EXPECT_TRUE(res[1].useAbstract);
+        for(int i = 0; i < 2; i++) {
+            SessionReply &r = res[i].reply;
+            EXPECT_EQ(r.state, SESSION_REPLY);
+            EXPECT_EQ(r.err, MNG_PARSE_ERROR_OK);
+            EXPECT_EQ(r.sequence, seq);
+            EXPECT_EQ(r.tlvId, PRIORITY1);
+            EXPECT_EQ(r.replyAction, RESPONSE);
+            EXPECT_GT(r.rtt, 0);
+            const PRIORITY1_t *p = dynamic_cast<const PRIORITY1_t *>
+                (r.data.get());
+            ASSERT_NE(p, nullptr);
+            EXPECT_EQ(p->priority1, seq + i + 1);
+        }
+        EXPECT_EQ(res[2].reply.state, SESSION_TIMEOUT);
+        EXPECT_EQ(res[2].reply.data.get(), nullptr);
+        EXPECT_EQ(res[3].reply.state, SESSION_SEND_FAIL);
+    }
+}
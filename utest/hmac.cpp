@@ -140,3 +140,40 @@ TEST(hmacTest, AES256)
     EXPECT_TRUE(hmac->verify(hData, sizeof hData, mac));
     delete hmac;
 }
+
+// Compare the built-in HMAC to the library
+static void cmpNative(HMAC_t type, size_t keyLen, size_t size)
+{
+    Binary key(bkey, keyLen);
+    HMAC_Key *hmac = hmac_allocHMAC(type, key);
+    ASSERT_NE(hmac, nullptr);
+    for(int accel = 1; accel >= 0; accel--) {
+        hmac_nativeAccel(accel);
+        HMAC_Key *native = hmac_allocNative(type, key);
+        ASSERT_NE(native, nullptr);
+        EXPECT_EQ(native->m_type, type);
+        for(size_t len = 0; len <= sizeof hData; len++) {
+            Binary mac(size), nmac(size);
+            EXPECT_TRUE(hmac->digest(hData, len, mac));
+            EXPECT_TRUE(native->digest(hData, len, nmac));
+            EXPECT_EQ(mac, nmac);
+            EXPECT_TRUE(native->verify(hData, len, mac));
+        }
+        delete native;
+    }
+    hmac_nativeAccel(true);
+    delete hmac;
+}
+
+// Tests the built-in HMAC
+// HMAC_Key *hmac_allocNative(HMAC_t type, const Binary &key)
+// bool hmac_nativeAccel(bool enable)
+TEST(hmacTest, Native)
+{
+    cmpNative(HMAC_SHA256, 32, 32);
+    cmpNative(HMAC_SHA256, 32, 16);
+    cmpNative(HMAC_SHA256, 16, 32);
+    cmpNative(HMAC_AES128, 16, 16);
+    cmpNative(HMAC_AES256, 32, 16);
+    EXPECT_EQ(hmac_count(), 0);
+}
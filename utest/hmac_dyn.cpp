@@ -89,3 +89,21 @@ TEST(hmacTest, DynLoadGnutls)
     hmac_freeLib();
     EXPECT_EQ(hmac_count(), 0);
 }
+
+// Use the built-in HMAC, when no library is loaded
+TEST(hmacTest, DynNative)
+{
+    Binary key(bkey, 32);
+    HMAC_Key *hmac = hmac_allocHMAC(HMAC_AES256, key);
+    ASSERT_NE(hmac, nullptr);
+    EXPECT_EQ(hmac_count(), 1);
+    Binary mac(16);
+    EXPECT_TRUE(hmac->digest(hData, sizeof hData, mac));
+    uint8_t ret[16] = { 0x2b, 0x7c, 0xc1, 0x7b, 0xd0, 0xa9, 0x7a, 0xb1, 0x6f,
+            0x82, 0x80, 0x6d, 0xb0, 0xaf, 0xed, 0x51
+        };
+    EXPECT_EQ(memcmp(mac.get(), ret, mac.size()), 0);
+    EXPECT_TRUE(hmac->verify(hData, sizeof hData, mac));
+    delete hmac;
+    EXPECT_EQ(hmac_count(), 0);
+}
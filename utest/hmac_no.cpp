@@ -5,7 +5,8 @@
  * @brief Unit tests for absent of any hmac library.
  *
  * This is internal API test,
- * to ensure static link without any hmac library works.
+ * to ensure static link without any hmac library
+ * uses the built-in HMAC.
  *
  * @author Erez Geva <ErezGeva2@@gmail.com>
  * @copyright © 2024 Erez Geva
@@ -21,9 +22,110 @@ TEST(hmacTest, NoHmac)
     Binary key(16);
     EXPECT_EQ(hmac_count(), 0);
     HMAC_Key *hmac = hmac_allocHMAC(HMAC_AES128, key);
-    /* There is no HMAC library, so we return nullptr! */
-    ASSERT_EQ(hmac, nullptr);
+    /* There is no HMAC library, so we use the built-in HMAC */
+    ASSERT_NE(hmac, nullptr);
+    EXPECT_EQ(hmac_count(), 1);
+    delete hmac;
     EXPECT_EQ(hmac_count(), 0);
     /* No library is loaded! */
     EXPECT_EQ(hmac_loadLibrary(), nullptr);
+    /* AES128 uses 16 bytes key */
+    Binary key2(32);
+    EXPECT_EQ(hmac_allocHMAC(HMAC_AES128, key2), nullptr);
+    EXPECT_EQ(hmac_count(), 0);
+}
+
+// Check the built-in HMAC with and without the CPU instructions
+static void check(HMAC_t type, const Binary &key, const char *data,
+    size_t len, const uint8_t *ret, size_t size)
+{
+    for(int accel = 1; accel >= 0; accel--) {
+        hmac_nativeAccel(accel);
+        HMAC_Key *hmac = hmac_allocHMAC(type, key);
+        ASSERT_NE(hmac, nullptr);
+        Binary mac(size);
+        EXPECT_TRUE(hmac->digest(data, len, mac));
+        EXPECT_EQ(memcmp(mac.get(), ret, size), 0);
+        EXPECT_TRUE(hmac->verify(data, len, mac));
+        mac[0] ^= 1;
+        EXPECT_FALSE(hmac->verify(data, len, mac));
+        delete hmac;
+    }
+    hmac_nativeAccel(true);
+}
+
+// RFC 4231 test cases 2 and 6
+TEST(hmacTest, NativeSHA256)
+{
+    Binary key;
+    key.fromHex("4a656665"); // "Jefe"
+    uint8_t ret[32] = { 0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a,
+            0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08,
+            0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38,
+            0x43
+        };
+    const char *data = "what do ya want for nothing?";
+    check(HMAC_SHA256, key, data, strlen(data), ret, 32);
+    check(HMAC_SHA256, key, data, strlen(data), ret, 16);
+    // Key longer than a SHA256 block
+    Binary key2(131);
+    for(size_t i = 0; i < key2.size(); i++)
+        key2.setBin(i, 0xaa);
+    uint8_t ret2[32] = { 0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f, 0x0d,
+            0x8a, 0x26, 0xaa, 0xcb, 0xf5, 0xb7, 0x7f, 0x8e, 0x0b, 0xc6, 0x21,
+            0x37, 0x28, 0xc5, 0x14, 0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f,
+            0x54
+        };
+    const char *data2 = "Test Using Larger Than Block-Size Key - Hash Key First";
+    check(HMAC_SHA256, key2, data2, strlen(data2), ret2, 32);
+}
+
+// RFC 4493 and NIST SP 800-38B examples
+static const char cmacMsg[] = "\x6b\xc1\xbe\xe2\x2e\x40\x9f\x96\xe9\x3d"
+    "\x7e\x11\x73\x93\x17\x2a\xae\x2d\x8a\x57\x1e\x03\xac\x9c\x9e\xb7"
+    "\x6f\xac\x45\xaf\x8e\x51\x30\xc8\x1c\x46\xa3\x5c\xe4\x11\xe5\xfb"
+    "\xc1\x19\x1a\x0a\x52\xef\xf6\x9f\x24\x45\xdf\x4f\x9b\x17\xad\x2b"
+    "\x41\x7b\xe6\x6c\x37\x10";
+TEST(hmacTest, NativeAES128)
+{
+    Binary key;
+    key.fromHex("2b7e151628aed2a6abf7158809cf4f3c");
+    uint8_t ret0[16] = { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f,
+            0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46
+        };
+    check(HMAC_AES128, key, cmacMsg, 0, ret0, 16);
+    uint8_t ret16[16] = { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7,
+            0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c
+        };
+    check(HMAC_AES128, key, cmacMsg, 16, ret16, 16);
+    uint8_t ret40[16] = { 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30,
+            0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27
+        };
+    check(HMAC_AES128, key, cmacMsg, 40, ret40, 16);
+    uint8_t ret64[16] = { 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc,
+            0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe
+        };
+    check(HMAC_AES128, key, cmacMsg, 64, ret64, 16);
+}
+
+TEST(hmacTest, NativeAES256)
+{
+    Binary key;
+    key.fromHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4");
+    uint8_t ret0[16] = { 0x02, 0x89, 0x62, 0xf6, 0x1b, 0x7b, 0xf8, 0x9e, 0xfc,
+            0x6b, 0x55, 0x1f, 0x46, 0x67, 0xd9, 0x83
+        };
+    check(HMAC_AES256, key, cmacMsg, 0, ret0, 16);
+    uint8_t ret16[16] = { 0x28, 0xa7, 0x02, 0x3f, 0x45, 0x2e, 0x8f, 0x82, 0xbd,
+            0x4b, 0xf2, 0x8d, 0x8c, 0x37, 0xc3, 0x5c
+        };
+    check(HMAC_AES256, key, cmacMsg, 16, ret16, 16);
+    uint8_t ret40[16] = { 0xaa, 0xf3, 0xd8, 0xf1, 0xde, 0x56, 0x40, 0xc2, 0x32,
+            0xf5, 0xb1, 0x69, 0xb9, 0xc9, 0x11, 0xe6
+        };
+    check(HMAC_AES256, key, cmacMsg, 40, ret40, 16);
+    uint8_t ret64[16] = { 0xe1, 0x99, 0x21, 0x90, 0x54, 0x9f, 0x6e, 0xd5, 0x69,
+            0x6a, 0x2c, 0x05, 0x6c, 0x31, 0x54, 0x10
+        };
+    check(HMAC_AES256, key, cmacMsg, 64, ret64, 16);
 }
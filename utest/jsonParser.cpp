@@ -470,3 +470,151 @@ TEST(jsonParser, file)
     ASSERT_NE(s, nullptr);
     EXPECT_STREQ(s->getCStr(), "ISO 8879:1986");
 }
+
+TEST(jsonParser, arena)
+{
+    jsonMain j;
+    const char j1[] =
+        "{"
+        " \"x\" : \"a\\tb\","
+        " \"a\" : [ 0, \"" u_umlut "\", true, null ],"
+        " \"b\" : { \"c\" : -1.5 },"
+        " \"a\" : 1"
+        "}";
+    EXPECT_TRUE(j.parseBuffer(j1, false, true));
+    ASSERT_FALSE(j.empty());
+    EXPECT_EQ(j.getType(), t_object);
+    jsonObject *o = j.getObj();
+    ASSERT_NE(o, nullptr);
+    EXPECT_EQ(o->size(), 4);
+    EXPECT_EQ(o->count("a"), 2);
+    EXPECT_EQ(o->getType("a"), t_non);
+    // Same result as without the arena
+    jsonMain j0;
+    EXPECT_TRUE(j0.parseBuffer(j1));
+    EXPECT_EQ(j.toString(), j0.toString());
+    // String with escape
+    jsonValue *s = o->getVal("x");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->getStrLen(), 3);
+    EXPECT_STREQ(s->getCStr(), "a\tb");
+    auto range = o->equal_range("a");
+    ASSERT_EQ(range.second - range.first, 2);
+    jsonArray *a = o->getArr(range.first);
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(a->size(), 4);
+    s = a->getVal(1);
+    ASSERT_NE(s, nullptr);
+    EXPECT_STREQ(s->getCStr(), u_umlut);
+    EXPECT_EQ(a->getType(2), t_boolean);
+    EXPECT_EQ(a->getType(3), t_null);
+    jsonObject *b = o->getObj("b");
+    ASSERT_NE(b, nullptr);
+    s = b->getVal("c");
+    ASSERT_NE(s, nullptr);
+    long double f;
+    EXPECT_TRUE(s->getFloat(f));
+    EXPECT_DOUBLE_EQ(f, -1.5);
+    // Failed parsing keeps the last value
+    EXPECT_FALSE(j.parseBuffer("{ \"a\" : [ 1, 2 }", false, true));
+    EXPECT_FALSE(j.parseBuffer("\"\x80\"", false, true));
+    EXPECT_EQ(j.getObj(), o);
+    // Large object, use binary search, with both modes
+    std::string j2 = "{";
+    for(char c = 'z'; c >= 'a'; c--) {
+        j2 += " \"";
+        j2 += c;
+        j2 += "\" : ";
+        j2 += std::to_string(c - 'a');
+        j2 += c > 'a' ? "," : "}";
+    }
+    for(int arena = 0; arena < 2; arena++) {
+        EXPECT_TRUE(j.parseBuffer(j2, false, arena == 1));
+        o = j.getObj();
+        ASSERT_NE(o, nullptr);
+        EXPECT_EQ(o->size(), 26);
+        uint64_t u = 0;
+        for(const auto &m : *o) {
+            ASSERT_EQ(m.first.size(), 1);
+            EXPECT_EQ(m.first.c_str()[0], 'a' + u);
+            s = m.second->getVal();
+            ASSERT_NE(s, nullptr);
+            uint64_t v;
+            EXPECT_TRUE(s->getUint64(v));
+            EXPECT_EQ(v, u++);
+        }
+        s = o->getVal("q");
+        ASSERT_NE(s, nullptr);
+        EXPECT_TRUE(s->getUint64(u));
+        EXPECT_EQ(u, 16);
+        EXPECT_EQ(o->count(std::string("qq")), 0);
+    }
+    // File
+    EXPECT_TRUE(j.parseFile("utest/test.json", true, true));
+    o = j.getObj();
+    ASSERT_NE(o, nullptr);
+    o = o->getObj("glossary");
+    ASSERT_NE(o, nullptr);
+    o = o->getObj("GlossDiv");
+    ASSERT_NE(o, nullptr);
+    o = o->getObj("GlossList");
+    ASSERT_NE(o, nullptr);
+    o = o->getObj("GlossEntry");
+    ASSERT_NE(o, nullptr);
+    EXPECT_EQ(o->size(), 7);
+    s = o->getVal("GlossTerm");
+    ASSERT_NE(s, nullptr);
+    EXPECT_EQ(s->getStr(), "Standard Generalized Markup Language");
+}
+
+TEST(jsonParser, longTokens)
+{
+    jsonMain j;
+    const std::string l(40, 'x');
+    const std::string sp = "  \t \r\n      \t\t\t\t\t\t\t\n                                  ";
+    // Strings, white spaces and numbers longer than the scanner blocks
+    const std::string j1 = sp + "{" + sp + "\"" + l + "\"" + sp + ":" + sp +
+        "[\"" + l + "\\n" + l + "\\u00dc" + l + u_umlut + l + "\"," + sp +
+        "1234567890123456789, -0.1234567890123456789e-1234567890123" + sp +
+        "]" + sp + "}" + sp;
+    for(int arena = 0; arena < 2; arena++) {
+        EXPECT_TRUE(j.parseBuffer(j1, false, arena == 1));
+        jsonObject *o = j.getObj();
+        ASSERT_NE(o, nullptr);
+        jsonArray *a = o->getArr(l);
+        ASSERT_NE(a, nullptr);
+        EXPECT_EQ(a->size(), 3);
+        jsonValue *s = a->getVal(0);
+        ASSERT_NE(s, nullptr);
+        EXPECT_EQ(s->getStr(), l + "\n" + l + u_umlut + l + u_umlut + l);
+        s = a->getVal(1);
+        ASSERT_NE(s, nullptr);
+        uint64_t u;
+        EXPECT_TRUE(s->getUint64(u));
+        EXPECT_EQ(u, 1234567890123456789);
+        s = a->getVal(2);
+        ASSERT_NE(s, nullptr);
+        EXPECT_STREQ(s->getCStr(), "-0.1234567890123456789e-1234567890123");
+        // Wrong tokens after long valid parts
+        EXPECT_FALSE(j.parseBuffer(sp + "[\"" + l + "\x80" + l + "\"]", false,
+                arena == 1));
+        EXPECT_FALSE(j.parseBuffer(sp + "[\"" + l + "\xc3" + "\"]", false,
+                arena == 1));
+        EXPECT_FALSE(j.parseBuffer(sp + "[\"" + l + "]", false, arena == 1));
+        EXPECT_FALSE(j.parseBuffer(sp + "[01234567890123456789012345]", false,
+                arena == 1));
+        EXPECT_FALSE(j.parseBuffer(sp + "[-01234567890123456789012345]", false,
+                arena == 1));
+        EXPECT_FALSE(j.parseBuffer(sp + "[1e01234567890123456789012345]", false,
+                arena == 1));
+        EXPECT_FALSE(j.parseBuffer(sp + "[1" + l + "]", false, arena == 1));
+        // Long comments
+        EXPECT_TRUE(j.parseBuffer("// " + l + l + "\n/* " + l + "\n" + l +
+                "* / **/ 1 /*" + l + "*/", true, arena == 1));
+        s = j.getVal();
+        ASSERT_NE(s, nullptr);
+        EXPECT_TRUE(s->getUint64(u));
+        EXPECT_EQ(u, 1);
+        EXPECT_FALSE(j.parseBuffer("/* " + l + l + " 1", true, arena == 1));
+    }
+}
@@ -18,6 +18,7 @@
 #include <climits>
 #include <ctime>
 #include <map>
+#include <vector>
 #include <pwd.h>
 #include <dlfcn.h>
 #include <unistd.h>
@@ -32,14 +33,20 @@
 #include <sys/timex.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <arpa/inet.h>
 #include <net/if.h>
 #include <netinet/in.h>
 #include <linux/filter.h>
 #include <linux/if_packet.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
 #include <linux/sockios.h>
 #include <linux/ptp_clock.h>
 #include <linux/ethtool.h>
+#ifndef IPV6_MULTICAST_ALL
+#define IPV6_MULTICAST_ALL 29 // Linux 4.20
+#endif
 /*****************************************************************************/
 static bool didInit = false;
 static bool testMode = false;
@@ -47,9 +54,11 @@ static bool rootMode;
 struct fdesc_info {
     int domain;
     clockid_t clkID;
+    bool txTsDone; // error queue is empty
 };
 std::map<int, fdesc_info> fdesc;
 std::map<clockid_t, int> clkId2FD;
+static std::vector<sock_filter> lastFilter;
 static time_t cur_sec;
 void useTestMode(bool n)
 {
@@ -59,8 +68,52 @@ void useTestMode(bool n)
     cur_sec = 0;
     fdesc.clear();
     clkId2FD.clear();
+    lastFilter.clear();
 }
 void useRoot(bool n) {rootMode = n;}
+// Classic BPF with the instructions the library uses
+unsigned int runFilter(const void *pkt, size_t len)
+{
+    if(lastFilter.empty())
+        return len; // No filter
+    const uint8_t *p = (const uint8_t *)pkt;
+    uint32_t a = 0;
+    for(size_t pc = 0; pc < lastFilter.size(); pc++) {
+        const sock_filter &f = lastFilter[pc];
+        switch(f.code) {
+            case BPF_LD | BPF_B | BPF_ABS:
+                if(f.k + 1 > len)
+                    return 0;
+                a = p[f.k];
+                break;
+            case BPF_LD | BPF_H | BPF_ABS:
+                if(f.k + 2 > len)
+                    return 0;
+                a = p[f.k] << 8 | p[f.k + 1];
+                break;
+            case BPF_LD | BPF_W | BPF_ABS:
+                if(f.k + 4 > len)
+                    return 0;
+                a = (uint32_t)p[f.k] << 24 | p[f.k + 1] << 16 |
+                    p[f.k + 2] << 8 | p[f.k + 3];
+                break;
+            case BPF_ALU | BPF_RSH | BPF_K:
+                a >>= f.k;
+                break;
+            case BPF_ALU | BPF_AND | BPF_K:
+                a &= f.k;
+                break;
+            case BPF_JMP | BPF_JEQ | BPF_K:
+                pc += a == f.k ? f.jt : f.jf;
+                break;
+            case BPF_RET | BPF_K:
+                return f.k;
+            default:
+                return 0;
+        }
+    }
+    return 0;
+}
 /*****************************************************************************/
 #define sysFuncDec(ret, name, ...)\
     ret (*_##name)(__VA_ARGS__);\
@@ -80,6 +133,8 @@ sysFuncDec(int, poll, pollfd *, nfds_t, int);
 sysFuncDec(int, __poll_chk, pollfd *, nfds_t, int, size_t);
 sysFuncDec(int, bind, int, const sockaddr *, socklen_t) throw();
 sysFuncDec(int, setsockopt, int, int, int, const void *, socklen_t) throw();
+sysFuncDec(int, getsockopt, int, int, int, void *, socklen_t *) throw();
+sysFuncDec(void *, mmap, void *, size_t, int, int, int, off_t) throw();
 sysFuncDec(ssize_t, recv, int, void *, size_t, int);
 sysFuncDec(ssize_t, recvfrom, int, void *, size_t, int, sockaddr *,
     socklen_t *);
@@ -87,6 +142,8 @@ sysFuncDec(ssize_t, sendto, int, const void *, size_t, int, const sockaddr *,
     socklen_t);
 sysFuncDec(ssize_t, recvmsg, int, msghdr *, int);
 sysFuncDec(ssize_t, sendmsg, int, const msghdr *, int);
+sysFuncDec(int, recvmmsg, int, mmsghdr *, unsigned int, int, timespec *);
+sysFuncDec(int, sendmmsg, int, mmsghdr *, unsigned int, int);
 sysFuncDec(uid_t, getuid, void) throw();
 sysFuncDec(pid_t, getpid, void) throw();
 sysFuncDec(int, unlink, const char *) throw();
@@ -121,6 +178,8 @@ void initLibSys(void)
     sysFuncAgn(int, __poll_chk, pollfd *, nfds_t, int, size_t);
     sysFuncAgn(int, bind, int, const sockaddr *, socklen_t);
     sysFuncAgn(int, setsockopt, int, int, int, const void *, socklen_t);
+    sysFuncAgn(int, getsockopt, int, int, int, void *, socklen_t *);
+    sysFuncAgn(void *, mmap, void *, size_t, int, int, int, off_t);
     sysFuncAgn(ssize_t, recv, int, void *, size_t, int);
     sysFuncAgn(ssize_t, recvfrom, int, void *, size_t, int, sockaddr *,
         socklen_t *);
@@ -128,6 +187,8 @@ void initLibSys(void)
         socklen_t);
     sysFuncAgn(ssize_t, recvmsg, int, msghdr *, int);
     sysFuncAgn(ssize_t, sendmsg, int, const msghdr *, int);
+    sysFuncAgn(int, recvmmsg, int, mmsghdr *, unsigned int, int, timespec *);
+    sysFuncAgn(int, sendmmsg, int, mmsghdr *, unsigned int, int);
     sysFuncAgn(uid_t, getuid, void);
     sysFuncAgn(pid_t, getpid, void);
     sysFuncAgn(int, unlink, const char *);
@@ -314,6 +375,11 @@ const uint8_t ip_multicast_if[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 7 };
 const uint8_t ipv6_add_membership[20] = { 255, 15, 0, 0, 0, 0, 0, 0, 0,
         0, 0, 0, 0, 0, 1, 129, 7
     };
+// Second interface eth1 with index 8
+const uint8_t ip_add_membership8[12] = { 224, 0, 1, 129, 0, 0, 0, 0, 8 };
+const uint8_t ipv6_add_membership8[20] = { 255, 15, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 1, 129, 8
+    };
 const uint8_t ipv6_multicast_if[20] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
         0, 0, 0, 0, 0, 7
     };
@@ -330,6 +396,158 @@ const uint8_t msg_name[20] = { 17, 0, 0, 3, 7, 0, 0, 0, 0,
         0, 0, 6, 1, 27, 23, 15, 12
     };
 const uint8_t msg_iov_0[14] = {1, 27, 23, 15, 12, 0, 1, 2, 3, 4, 5, 6, 136, 247 };
+const int ts_sw_flags = SOF_TIMESTAMPING_RX_SOFTWARE |
+    SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+    SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+const int ts_hw_flags = SOF_TIMESTAMPING_RX_HARDWARE |
+    SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+    SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+/*****************************************************************************/
+static inline bool addCmsg(msghdr *msg, size_t &used, int level, int type,
+    const void *data, size_t len)
+{
+    if(used + CMSG_SPACE(len) > msg->msg_controllen)
+        return false;
+    cmsghdr *cm = (cmsghdr *)((uint8_t *)msg->msg_control + used);
+    cm->cmsg_level = level;
+    cm->cmsg_type = type;
+    cm->cmsg_len = CMSG_LEN(len);
+    memcpy(CMSG_DATA(cm), data, len);
+    used += CMSG_SPACE(len);
+    return true;
+}
+// Receive with software timestamp 12.147 and hardware timestamp 19.351
+static inline ssize_t recvTs(int fd, msghdr *msg, int flags)
+{
+    if(flags & ~MSG_DONTWAIT)
+        return retErr(ECONNRESET);
+    if(msg->msg_flags != 0)
+        return retErr(EINVAL);
+    int domain = fdesc[fd].domain;
+    size_t hdrLen = 0;
+    switch(domain) {
+        case AF_UNIX:
+            if(msg->msg_iovlen != 1 || msg->msg_name == nullptr ||
+                msg->msg_namelen < sizeof(sockaddr_un))
+                return retErr(EINVAL);
+            {
+                sockaddr_un *ua = (sockaddr_un *)msg->msg_name;
+                ua->sun_family = AF_UNIX;
+                strcpy(ua->sun_path, "/peer");
+                msg->msg_namelen = sizeof(sockaddr_un);
+            }
+            break;
+        case AF_INET:
+        case AF_INET6:
+            if(msg->msg_iovlen != 1 || msg->msg_name != nullptr)
+                return retErr(EINVAL);
+            break;
+        case AF_PACKET:
+            if(msg->msg_iovlen != 2 || msg->msg_name != nullptr ||
+                msg->msg_iov[0].iov_len != 14 ||
+                msg->msg_iov[0].iov_base == nullptr)
+                return retErr(EINVAL);
+            memcpy(msg->msg_iov[0].iov_base, msg_iov_0, sizeof msg_iov_0);
+            hdrLen = 14;
+            break;
+        default:
+            return retErr(EINVAL);
+    }
+    iovec &iov = msg->msg_iov[msg->msg_iovlen - 1];
+    if(iov.iov_len == 0 || iov.iov_base == nullptr)
+        return retErr(EINVAL);
+    size_t used = 0;
+    timespec ts[3] = { { 12, 147 }, { 0, 0 }, { 19, 351 } };
+    bool ret;
+    if(domain == AF_UNIX)
+        ret = addCmsg(msg, used, SOL_SOCKET, SCM_TIMESTAMPNS, ts, sizeof ts[0]);
+    else
+        ret = addCmsg(msg, used, SOL_SOCKET, SCM_TIMESTAMPING, ts, sizeof ts);
+    if(!ret)
+        return retErr(EINVAL);
+    // Packet information of eth1, if the buffer has room
+    if(domain == AF_INET) {
+        in_pktinfo info = {};
+        info.ipi_ifindex = 8;
+        addCmsg(msg, used, IPPROTO_IP, IP_PKTINFO, &info, sizeof info);
+    } else if(domain == AF_INET6) {
+        in6_pktinfo info = {};
+        info.ipi6_ifindex = 8;
+        addCmsg(msg, used, IPPROTO_IPV6, IPV6_PKTINFO, &info, sizeof info);
+    }
+    msg->msg_controllen = used;
+    return recvFill(iov.iov_base, iov.iov_len, flags) + hdrLen;
+}
+// Error queue with a single transmit timestamp of message ID 3,
+//  software timestamp 13.148 and hardware timestamp 20.352
+static inline ssize_t recvErrQueue(int fd, msghdr *msg, int flags)
+{
+    if(flags != (MSG_ERRQUEUE | MSG_DONTWAIT))
+        return retErr(ECONNRESET);
+    if(msg->msg_control == nullptr || msg->msg_iovlen != 0)
+        return retErr(EINVAL);
+    if(fdesc[fd].txTsDone)
+        return retErr(EAGAIN);
+    int level, type;
+    switch(fdesc[fd].domain) {
+        case AF_INET:
+            level = SOL_IP;
+            type = IP_RECVERR;
+            break;
+        case AF_INET6:
+            level = SOL_IPV6;
+            type = IPV6_RECVERR;
+            break;
+        case AF_PACKET:
+            level = SOL_PACKET;
+            type = PACKET_TX_TIMESTAMP;
+            break;
+        default:
+            return retErr(EAGAIN);
+    }
+    size_t used = 0;
+    timespec ts[3] = { { 13, 148 }, { 0, 0 }, { 20, 352 } };
+    sock_extended_err err = { 0 };
+    err.ee_errno = ENOMSG;
+    err.ee_origin = SO_EE_ORIGIN_TIMESTAMPING;
+    err.ee_data = 3;
+    if(!addCmsg(msg, used, SOL_SOCKET, SCM_TIMESTAMPING, ts, sizeof ts) ||
+        !addCmsg(msg, used, level, type, &err, sizeof err))
+        return retErr(EINVAL);
+    msg->msg_controllen = used;
+    fdesc[fd].txTsDone = true;
+    return 0;
+}
+// Send through eth1 using the packet information
+static inline ssize_t sendPktInfo(int fd, const msghdr *msg, int flags)
+{
+    if(flags != 0)
+        return retErr(ECONNRESET);
+    bool ip4 = fdesc[fd].domain == AF_INET;
+    const void *addr = ip4 ? (const void *)ip_addr_s : (const void *)ip6_addr_s;
+    size_t addrlen = ip4 ? sizeof ip_addr_s : sizeof ip6_addr_s;
+    if(msg->msg_name == nullptr || msg->msg_namelen != addrlen ||
+        memcmp(msg->msg_name, addr, addrlen) != 0)
+        return retErr(EINVAL);
+    cmsghdr *cm = CMSG_FIRSTHDR(msg);
+    if(cm == nullptr || CMSG_NXTHDR((msghdr *)msg, cm) != nullptr)
+        return retErr(EINVAL);
+    int ifIndex = -1;
+    if(ip4 && cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_PKTINFO &&
+        cm->cmsg_len == CMSG_LEN(sizeof(in_pktinfo)))
+        ifIndex = ((in_pktinfo *)CMSG_DATA(cm))->ipi_ifindex;
+    else if(!ip4 && cm->cmsg_level == IPPROTO_IPV6 &&
+        cm->cmsg_type == IPV6_PKTINFO &&
+        cm->cmsg_len == CMSG_LEN(sizeof(in6_pktinfo)))
+        ifIndex = ((in6_pktinfo *)CMSG_DATA(cm))->ipi6_ifindex;
+    if(ifIndex != 8)
+        return retErr(ENODEV);
+    if(msg->msg_iovlen != 1 || msg->msg_iov[0].iov_len != 5 ||
+        msg->msg_iov[0].iov_base == nullptr ||
+        memcmp(msg->msg_iov[0].iov_base, "\x1\x2\x3\x4\x5", 5) != 0)
+        return retErr(ECONNRESET);
+    return 5;
+}
 /*****************************************************************************/
 int socket(int domain, int type, int protocol) throw()
 {
@@ -353,6 +571,7 @@ int socket(int domain, int type, int protocol) throw()
     if(fd >= 0) {
         fdesc[fd].domain = domain;
         fdesc[fd].clkID = 0;
+        fdesc[fd].txTsDone = false;
     }
     return fd;
 }
@@ -433,11 +652,28 @@ int setsockopt(int fd, int level, int optname, const void *optval,
                 case SO_ATTACH_FILTER:
                     if(optlen == sizeof(sock_fprog)) {
                         sock_fprog *bpf = (sock_fprog *)optval;
-                        if(bpf->len == 4 && bpf->filter != nullptr &&
-                            memcmp(bpf->filter, bpf_filter, 4) == 0)
-                            break;
+                        if(bpf->len < 4 || bpf->filter == nullptr ||
+                            (bpf->len == 4 &&
+                                memcmp(bpf->filter, bpf_filter, 4) != 0))
+                            return retErr(EINVAL);
+                        lastFilter.assign(bpf->filter, bpf->filter + bpf->len);
+                        break;
                     }
                     return retErr(EINVAL);
+                case SO_DETACH_FILTER:
+                    lastFilter.clear();
+                    break;
+                case SO_TIMESTAMPING:
+                    if(optlen != sizeof(int) ||
+                        (*ival != ts_sw_flags && *ival != ts_hw_flags))
+                        return retErr(EINVAL);
+                    break;
+                case SO_TIMESTAMPNS:
+                    cmp_int(1);
+                case SO_BUSY_POLL:
+                    cmp_int(30);
+                case SO_PREFER_BUSY_POLL:
+                    cmp_int(1);
                 case SO_BINDTODEVICE:
                     cmp_opt(so_bindtodevice);
                 default:
@@ -451,9 +687,16 @@ int setsockopt(int fd, int level, int optname, const void *optval,
                 case IP_MULTICAST_LOOP:
                     cmp_int(0);
                 case IP_ADD_MEMBERSHIP:
+                    if(optlen == sizeof ip_add_membership8 &&
+                        memcmp(optval, ip_add_membership8, optlen) == 0)
+                        break;
                     cmp_opt(ip_add_membership);
                 case IP_MULTICAST_IF:
                     cmp_opt(ip_multicast_if);
+                case IP_MULTICAST_ALL:
+                    cmp_int(0);
+                case IP_PKTINFO:
+                    cmp_int(1);
                 default:
                     return retErr(ENOPROTOOPT);
             }
@@ -465,9 +708,16 @@ int setsockopt(int fd, int level, int optname, const void *optval,
                 case IPV6_MULTICAST_LOOP:
                     cmp_int(0);
                 case IPV6_ADD_MEMBERSHIP:
+                    if(optlen == sizeof ipv6_add_membership8 &&
+                        memcmp(optval, ipv6_add_membership8, optlen) == 0)
+                        break;
                     cmp_opt(ipv6_add_membership);
                 case IPV6_MULTICAST_IF:
                     cmp_opt(ipv6_multicast_if);
+                case IPV6_MULTICAST_ALL:
+                    cmp_int(0);
+                case IPV6_RECVPKTINFO:
+                    cmp_int(1);
                 default:
                     return retErr(ENOPROTOOPT);
             }
@@ -476,6 +726,19 @@ int setsockopt(int fd, int level, int optname, const void *optval,
             switch(optname) {
                 case PACKET_ADD_MEMBERSHIP:
                     cmp_opt(packet_add_membership);
+                case PACKET_VERSION:
+                    cmp_int(TPACKET_V3);
+                case PACKET_TIMESTAMP:
+                    cmp_int(SOF_TIMESTAMPING_RAW_HARDWARE);
+                case PACKET_RX_RING:
+                    if(optlen == sizeof(tpacket_req3)) {
+                        tpacket_req3 *req = (tpacket_req3 *)optval;
+                        if(req->tp_block_size == 4096 && req->tp_block_nr == 2 &&
+                            req->tp_frame_size == 2048 && req->tp_frame_nr == 4 &&
+                            req->tp_retire_blk_tov == 7)
+                            break;
+                    }
+                    return retErr(EINVAL);
                 default:
                     return retErr(ENOPROTOOPT);
             }
@@ -485,6 +748,59 @@ int setsockopt(int fd, int level, int optname, const void *optval,
     }
     return 0;
 }
+int getsockopt(int fd, int level, int optname, void *optval,
+    socklen_t *optlen) throw()
+{
+    retSock(getsockopt, level, optname, optval, optlen);
+    if(optval == nullptr || optlen == nullptr)
+        return retErr(EINVAL);
+    if(fdesc[fd].domain != AF_PACKET || level != SOL_PACKET ||
+        optname != PACKET_STATISTICS)
+        return retErr(ENOPROTOOPT);
+    if(*optlen != sizeof(tpacket_stats_v3))
+        return retErr(EINVAL);
+    // The kernel reset the counters on each read
+    tpacket_stats_v3 *st = (tpacket_stats_v3 *)optval;
+    st->tp_packets = 5;
+    st->tp_drops = 2;
+    st->tp_freeze_q_cnt = 0;
+    return 0;
+}
+// Receive ring with 2 frames in the first block
+void *mmap(void *addr, size_t length, int prot, int flags, int fd,
+    off_t offset) throw()
+{
+    if(!testMode || fdesc.count(fd) == 0)
+        return _mmap(addr, length, prot, flags, fd, offset);
+    if(fdesc[fd].domain != AF_PACKET || addr != nullptr || length != 8192 ||
+        prot != (PROT_READ | PROT_WRITE) ||
+        flags != MAP_SHARED || offset != 0) {
+        errno = EINVAL;
+        return MAP_FAILED;
+    }
+    uint8_t *ring = (uint8_t *)_mmap(nullptr, length, prot,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(ring == MAP_FAILED)
+        return MAP_FAILED;
+    tpacket_block_desc *bd = (tpacket_block_desc *)ring;
+    bd->hdr.bh1.block_status = TP_STATUS_USER;
+    bd->hdr.bh1.num_pkts = 2;
+    bd->hdr.bh1.offset_to_first_pkt = 64;
+    for(int i = 0; i < 2; i++) {
+        uint8_t *frame = ring + 64 + i * 128;
+        tpacket3_hdr *hdr = (tpacket3_hdr *)frame;
+        hdr->tp_next_offset = 128;
+        hdr->tp_sec = 12;
+        hdr->tp_nsec = 147 + i;
+        hdr->tp_mac = 66;
+        hdr->tp_snaplen = sizeof msg_iov_0 + 5;
+        hdr->tp_len = hdr->tp_snaplen;
+        memcpy(frame + 66, msg_iov_0, sizeof msg_iov_0);
+        memcpy(frame + 66 + sizeof msg_iov_0, "\x3\x4\x5\x6\x7", 5);
+        frame[66 + sizeof msg_iov_0] += i;
+    }
+    return ring;
+}
 ssize_t recv(int fd, void *buf, size_t len, int flags)
 {
     retSock(recv, buf, len, flags);
@@ -495,10 +811,14 @@ ssize_t recv(int fd, void *buf, size_t len, int flags)
         case AF_INET6:
             break;
         case AF_UNIX:
-        case AF_PACKET:
             return retErr(EINVAL);
+        case AF_PACKET:
+            // Busy poll peeks
+            if((flags & MSG_PEEK) == 0)
+                return retErr(EINVAL);
+            break;
     }
-    if(flags & ~MSG_DONTWAIT)
+    if(flags & ~(MSG_DONTWAIT | MSG_PEEK))
         return retErr(ECONNRESET);
     return recvFill(buf, len, flags);
 }
@@ -558,8 +878,12 @@ ssize_t sendto(int fd, const void *buf, size_t len, int flags,
 ssize_t recvmsg(int fd, msghdr *msg, int flags)
 {
     retSock(recvmsg, msg, flags);
+    if(msg != nullptr && (flags & MSG_ERRQUEUE) != 0)
+        return recvErrQueue(fd, msg, flags);
     if(msg == nullptr || msg->msg_iov == nullptr || msg->msg_iovlen == 0)
         return retErr(ENOMEM);
+    if(msg->msg_control != nullptr)
+        return recvTs(fd, msg, flags);
     if(fdesc[fd].domain != AF_PACKET)
         return retErr(EINVAL);
     if(flags & ~MSG_DONTWAIT)
@@ -580,8 +904,15 @@ ssize_t sendmsg(int fd, const msghdr *msg, int flags)
     retSock(sendmsg, msg, flags);
     if(msg == nullptr || msg->msg_iov == nullptr || msg->msg_iovlen == 0)
         return retErr(ENOMEM);
-    if(fdesc[fd].domain != AF_PACKET)
-        return retErr(EINVAL);
+    switch(fdesc[fd].domain) {
+        case AF_INET:
+        case AF_INET6:
+            return sendPktInfo(fd, msg, flags);
+        case AF_PACKET:
+            break;
+        default:
+            return retErr(EINVAL);
+    }
     if(flags != 0)
         return retErr(ECONNRESET);
     if(msg == nullptr || msg->msg_control != nullptr || msg->msg_controllen != 0 ||
@@ -599,6 +930,120 @@ ssize_t sendmsg(int fd, const msghdr *msg, int flags)
         return retErr(ECONNRESET);
     return 5 + sizeof msg_iov_0;
 }
+// Receive 2 messages from a peer
+int recvmmsg(int fd, mmsghdr *msgvec, unsigned int vlen, int flags,
+    timespec *timeout)
+{
+    retSock(recvmmsg, msgvec, vlen, flags, timeout);
+    if(msgvec == nullptr || vlen == 0)
+        return retErr(ENOMEM);
+    if(flags & ~(MSG_DONTWAIT | MSG_WAITFORONE) || timeout != nullptr)
+        return retErr(ECONNRESET);
+    int domain = fdesc[fd].domain;
+    unsigned int cnt = std::min(vlen, 2U);
+    for(unsigned int i = 0; i < cnt; i++) {
+        msghdr &msg = msgvec[i].msg_hdr;
+        if(msg.msg_iov == nullptr || msg.msg_control != nullptr ||
+            msg.msg_controllen != 0 || msg.msg_flags != 0)
+            return retErr(EINVAL);
+        switch(domain) {
+            case AF_INET:
+                if(msg.msg_iovlen != 1 || msg.msg_name == nullptr ||
+                    msg.msg_namelen < sizeof(sockaddr_in))
+                    return retErr(EINVAL);
+                {
+                    sockaddr_in *a = (sockaddr_in *)msg.msg_name;
+                    a->sin_family = AF_INET;
+                    a->sin_port = htons(320);
+                    a->sin_addr.s_addr = htonl(0xc0000201 + i);
+                    msg.msg_namelen = sizeof(sockaddr_in);
+                }
+                break;
+            case AF_INET6:
+                if(msg.msg_iovlen != 1 || msg.msg_name == nullptr ||
+                    msg.msg_namelen < sizeof(sockaddr_in6))
+                    return retErr(EINVAL);
+                {
+                    sockaddr_in6 *a = (sockaddr_in6 *)msg.msg_name;
+                    memset(a, 0, sizeof(sockaddr_in6));
+                    a->sin6_family = AF_INET6;
+                    a->sin6_port = htons(320);
+                    a->sin6_addr.s6_addr[0] = 0xfe;
+                    a->sin6_addr.s6_addr[1] = 0x80;
+                    a->sin6_addr.s6_addr[15] = 1 + i;
+                    msg.msg_namelen = sizeof(sockaddr_in6);
+                }
+                break;
+            case AF_PACKET:
+                if(msg.msg_iovlen != 2 || msg.msg_name != nullptr ||
+                    msg.msg_namelen != 0)
+                    return retErr(EINVAL);
+                if(msg.msg_iov[0].iov_len != 14 ||
+                    msg.msg_iov[0].iov_base == nullptr)
+                    return retErr(EINVAL);
+                memcpy(msg.msg_iov[0].iov_base, msg_iov_0, sizeof msg_iov_0);
+                break;
+            default:
+                return retErr(EINVAL);
+        }
+        iovec &iov = msg.msg_iov[msg.msg_iovlen - 1];
+        if(iov.iov_len == 0 || iov.iov_base == nullptr)
+            return retErr(EINVAL);
+        msgvec[i].msg_len = recvFill(iov.iov_base, iov.iov_len,
+                flags & MSG_DONTWAIT);
+        if(iov.iov_len < 5)
+            msg.msg_flags |= MSG_TRUNC;
+        if(domain == AF_PACKET)
+            msgvec[i].msg_len += 14;
+    }
+    return cnt;
+}
+int sendmmsg(int fd, mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    retSock(sendmmsg, msgvec, vlen, flags);
+    if(msgvec == nullptr || vlen == 0)
+        return retErr(ENOMEM);
+    if(flags != 0)
+        return retErr(ECONNRESET);
+    for(unsigned int i = 0; i < vlen; i++) {
+        msghdr &msg = msgvec[i].msg_hdr;
+        if(msg.msg_iov == nullptr || msg.msg_control != nullptr ||
+            msg.msg_controllen != 0 || msg.msg_flags != 0)
+            return retErr(EINVAL);
+        const void *addr = msg.msg_name;
+        socklen_t addrlen = msg.msg_namelen;
+        switch(fdesc[fd].domain) {
+            case AF_INET:
+                cmp_addr(ip_addr_s)
+                return retErr(EINVAL);
+            case AF_INET6:
+                cmp_addr(ip6_addr_s)
+                return retErr(EINVAL);
+            case AF_PACKET:
+                cmp_addr(msg_name)
+                return retErr(EINVAL);
+            default:
+                return retErr(EINVAL);
+        }
+        size_t len = 0;
+        if(msg.msg_iovlen == 2) {
+            if(fdesc[fd].domain != AF_PACKET ||
+                msg.msg_iov[0].iov_len != sizeof msg_iov_0 ||
+                msg.msg_iov[0].iov_base == nullptr ||
+                memcmp(msg.msg_iov[0].iov_base, msg_iov_0, sizeof msg_iov_0) != 0)
+                return retErr(ECONNRESET);
+            len = sizeof msg_iov_0;
+        } else if(msg.msg_iovlen != 1 || fdesc[fd].domain == AF_PACKET)
+            return retErr(EINVAL);
+        iovec &iov = msg.msg_iov[msg.msg_iovlen - 1];
+        if(iov.iov_len < 4 || iov.iov_len > 5 || iov.iov_base == nullptr ||
+            memcmp(iov.iov_base, "\x1\x2\x3\x4\x5", iov.iov_len) != 0)
+            return retErr(ECONNRESET);
+        // Short send of a 4 bytes message
+        msgvec[i].msg_len = len + (iov.iov_len == 5 ? 5 : 3);
+    }
+    return vlen;
+}
 uid_t getuid(void) throw()
 {
     retTest0(getuid);
@@ -816,12 +1261,16 @@ int ioctl(int fd, unsigned long request, ...) throw()
     ifreq *ifr = (ifreq *)arg;
     switch(request) {
         case SIOCGIFHWADDR:
-            if(strcmp("eth0", ifr->ifr_name) != 0)
+            if(strcmp("eth0", ifr->ifr_name) == 0)
+                memcpy(ifr->ifr_hwaddr.sa_data, "\x1\x2\x3\x4\x5\x6", 6);
+            else if(strcmp("eth1", ifr->ifr_name) == 0)
+                memcpy(ifr->ifr_hwaddr.sa_data, "\x1\x2\x3\x4\x5\x7", 6);
+            else
                 return retErr(EINVAL);
-            memcpy(ifr->ifr_hwaddr.sa_data, "\x1\x2\x3\x4\x5\x6", 6);
             break;
         case SIOCETHTOOL:
-            if(strcmp("eth0", ifr->ifr_name) != 0)
+            if(strcmp("eth0", ifr->ifr_name) != 0 &&
+                strcmp("eth1", ifr->ifr_name) != 0)
                 return retErr(EINVAL);
             {
                 ethtool_ts_info *info = (ethtool_ts_info *)ifr->ifr_data;
@@ -831,14 +1280,20 @@ int ioctl(int fd, unsigned long request, ...) throw()
             }
             break;
         case SIOCGIFINDEX:
-            if(strcmp("eth0", ifr->ifr_name) != 0)
+            if(strcmp("eth0", ifr->ifr_name) == 0)
+                ifr->ifr_ifindex = 7;
+            else if(strcmp("eth1", ifr->ifr_name) == 0)
+                ifr->ifr_ifindex = 8;
+            else
                 return retErr(EINVAL);
-            ifr->ifr_ifindex = 7;
             break;
         case SIOCGIFNAME:
-            if(ifr->ifr_ifindex != 7)
+            if(ifr->ifr_ifindex == 7)
+                strcpy(ifr->ifr_name, "eth0");
+            else if(ifr->ifr_ifindex == 8)
+                strcpy(ifr->ifr_name, "eth1");
+            else
                 return retErr(EINVAL);
-            strcpy(ifr->ifr_name, "eth0");
             break;
         case PTP_CLOCK_GETCAPS: {
             ptp_clock_caps *cps = (ptp_clock_caps *)arg;
@@ -9,12 +9,15 @@
  *
  */
 
+#include <stddef.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
 extern void initLibSys(void);
 extern void useTestMode(bool);
 extern void useRoot(bool);
+/* Run the last attached socket filter on a packet, return 0 to drop */
+extern unsigned int runFilter(const void *pkt, size_t len);
 #ifdef __cplusplus
 }
 #endif
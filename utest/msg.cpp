@@ -10,6 +10,7 @@
  */
 
 #include "msg.h"
+#include "mngViews.h"
 #include "comp.h"
 
 __PTPMGMT_NAMESPACE_USE;
@@ -67,6 +68,7 @@ TEST(MessageTest, MethodGetParams)
     EXPECT_EQ(p.rcvSMPTEOrg, p1.rcvSMPTEOrg);
     EXPECT_EQ(p.sendAuth, p1.sendAuth);
     EXPECT_EQ(p.rcvAuth, p1.rcvAuth);
+    EXPECT_EQ(p.reuseTlvs, p1.reuseTlvs);
 }
 
 // Tests set parameters method
@@ -96,6 +98,7 @@ TEST(MessageTest, MethodUpdateParams)
     EXPECT_EQ(p.rcvSMPTEOrg, p1.rcvSMPTEOrg);
     EXPECT_EQ(p.sendAuth, p1.sendAuth);
     EXPECT_EQ(p.rcvAuth, p1.rcvAuth);
+    EXPECT_EQ(p.reuseTlvs, p1.reuseTlvs);
 }
 
 // Tests get parsed TLV ID method
@@ -383,6 +386,26 @@ TEST(MessageTest, MethodFindMngID)
     EXPECT_EQ(m, NULL_PTP_MANAGEMENT);
     EXPECT_TRUE(Message::findMngID("UTC_PROPERTIES", m));
     EXPECT_EQ(m, UTC_PROPERTIES);
+    // Whole word match, though other IDs contain it
+    EXPECT_TRUE(Message::findMngID("fault_log", m, false));
+    EXPECT_EQ(m, FAULT_LOG);
+    EXPECT_FALSE(Message::findMngID("fault_log", m));
+    // Single partial match
+    EXPECT_TRUE(Message::findMngID("time_status", m, false));
+    EXPECT_EQ(m, TIME_STATUS_NP);
+    EXPECT_TRUE(Message::findMngID("user_desc", m, false));
+    EXPECT_EQ(m, USER_DESCRIPTION);
+    EXPECT_FALSE(Message::findMngID("TIME_STATUS", m));
+    // Multiple partial matches
+    EXPECT_FALSE(Message::findMngID("fault", m, false));
+    EXPECT_FALSE(Message::findMngID("DESCRIPTION", m, false));
+    EXPECT_FALSE(Message::findMngID("_DATA_SET", m, false));
+    EXPECT_FALSE(Message::findMngID("NO_SUCH_ID", m, false));
+    for(int i = FIRST_MNG_ID; i < LAST_MNG_ID; i++) {
+        mng_vals_e id = (mng_vals_e)i;
+        EXPECT_TRUE(Message::findMngID(Message::mng2str_c(id), m, true));
+        EXPECT_EQ(m, id);
+    }
 }
 
 // tests convert management error to string
@@ -1027,6 +1050,170 @@ TEST(MessageTest, MethodParseObj)
     EXPECT_EQ(m.parse(buf, 56), MNG_PARSE_ERROR_OK);
 }
 
+// Test parse into user TLV object
+// MNG_PARSE_ERROR_e parse(const void *buf, ssize_t msgSize, BaseMngTlv &tlv)
+TEST(MessageTest, MethodParseIntoTlv)
+{
+    Message m;
+    PRIORITY1_t p;
+    p.priority1 = 0x7f;
+    EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+    uint8_t buf[70];
+    EXPECT_EQ(m.build(buf, sizeof buf, 137), MNG_PARSE_ERROR_OK);
+    // actionField location IEEE "PTP management message"
+    // Change to response action of get/set message
+    buf[46] = RESPONSE;
+    PRIORITY1_t p1;
+    p1.priority1 = 0;
+    EXPECT_EQ(m.parse(buf, 56, p1), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(m.getTlvId(), PRIORITY1);
+    EXPECT_EQ(p1.priority1, 0x7f);
+    EXPECT_EQ(m.getData(), nullptr);
+    PRIORITY2_t p2;
+    EXPECT_EQ(m.parse(buf, 56, p2), MNG_PARSE_ERROR_MISMATCH_TLV);
+}
+
+// Test parse into user TLV object using buffer object
+// MNG_PARSE_ERROR_e parse(const Buf &buf, ssize_t msgSize, BaseMngTlv &tlv)
+TEST(MessageTest, MethodParseIntoTlvObj)
+{
+    Message m;
+    PRIORITY1_t p;
+    p.priority1 = 17;
+    EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+    Buf buf;
+    EXPECT_TRUE(buf.alloc(70));
+    EXPECT_EQ(m.build(buf, 1), MNG_PARSE_ERROR_OK);
+    // actionField location IEEE "PTP management message"
+    // Change to response action of get/set message
+    ((uint8_t *)buf())[46] = RESPONSE;
+    PRIORITY1_t p1;
+    EXPECT_EQ(m.parse(buf, 56, p1), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(p1.priority1, 17);
+}
+
+// Test parse reuse TLVs objects
+// bool MsgParams::reuseTlvs
+TEST(MessageTest, MethodParseReuseTlvs)
+{
+    MsgParams mp;
+    mp.reuseTlvs = true;
+    mp.rcvSignaling = true;
+    mp.filterSignaling = false;
+    Message m(mp);
+    PRIORITY1_t p;
+    p.priority1 = 1;
+    EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+    uint8_t buf[70];
+    EXPECT_EQ(m.build(buf, sizeof buf, 1), MNG_PARSE_ERROR_OK);
+    // actionField location IEEE "PTP management message"
+    // Change to response action of get/set message
+    buf[46] = RESPONSE;
+    EXPECT_EQ(m.parse(buf, 56), MNG_PARSE_ERROR_OK);
+    const BaseMngTlv *tlv = m.getData();
+    ASSERT_NE(tlv, nullptr);
+    p.priority1 = 2;
+    EXPECT_EQ(m.build(buf, sizeof buf, 2), MNG_PARSE_ERROR_OK);
+    buf[46] = RESPONSE;
+    EXPECT_EQ(m.parse(buf, 56), MNG_PARSE_ERROR_OK);
+    // Same object is used
+    EXPECT_EQ(m.getData(), tlv);
+    const PRIORITY1_t *p1 = dynamic_cast<const PRIORITY1_t *>(tlv);
+    ASSERT_NE(p1, nullptr);
+    EXPECT_EQ(p1->priority1, 2);
+    // Signaling message with the same management TLV
+    buf[0] = (buf[0] & 0xf0) | Signaling; // messageType
+    buf[3] = 52; // header.messageLength
+    buf[32] = 5; // controlField
+    // Move the 8 bytes of Mng TLV
+    for(int i = 0; i < 8; i++)
+        buf[44 + i] = buf[48 + i];
+    EXPECT_EQ(m.parse(buf, 52), MNG_PARSE_ERROR_SIG);
+    const BaseSigTlv *sig = m.getSigTlv(0);
+    ASSERT_NE(sig, nullptr);
+    tlv = m.getSigMngTlv(0);
+    ASSERT_NE(tlv, nullptr);
+    buf[50] = 3; // priority1
+    EXPECT_EQ(m.parse(buf, 52), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(m.getSigTlv(0), sig);
+    EXPECT_EQ(m.getSigMngTlv(0), tlv);
+    p1 = dynamic_cast<const PRIORITY1_t *>(tlv);
+    ASSERT_NE(p1, nullptr);
+    EXPECT_EQ(p1->priority1, 3);
+}
+
+// Test parse without decoding the management TLV
+// MNG_PARSE_ERROR_e parseView(const void *buf, ssize_t msgSize)
+// template <typename T> T view() const
+TEST(MessageTest, MethodParseView)
+{
+    Message m;
+    EXPECT_TRUE(m.setAction(GET, DEFAULT_DATA_SET));
+    uint8_t buf[80];
+    EXPECT_EQ(m.build(buf, sizeof buf, 1), MNG_PARSE_ERROR_OK);
+    // actionField location IEEE "PTP management message"
+    buf[46] = RESPONSE;
+    buf[3] = 74; // header.messageLength
+    buf[51] = 22; // lengthField
+    uint8_t data[20] = { 0x3, 0, 1, 2, 153, 255, 0xfe, 0xff, 0xff, 248,
+            196, 125, 70, 255, 254, 32, 172, 174, 7, 0
+        };
+    memcpy(buf + 54, data, sizeof data);
+    EXPECT_EQ(m.parseView(buf, 74), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(m.getTlvId(), DEFAULT_DATA_SET);
+    EXPECT_EQ(m.getData(), nullptr);
+    DEFAULT_DATA_SET_v v = m.view<DEFAULT_DATA_SET_v>();
+    ASSERT_TRUE(v.isValid());
+    EXPECT_FALSE(m.view<CURRENT_DATA_SET_v>().isValid());
+    // Compare with full parse
+    EXPECT_EQ(m.parse(buf, 74), MNG_PARSE_ERROR_OK);
+    const DEFAULT_DATA_SET_t *d =
+        dynamic_cast<const DEFAULT_DATA_SET_t *>(m.getData());
+    ASSERT_NE(d, nullptr);
+    v = m.view<DEFAULT_DATA_SET_v>();
+    ASSERT_TRUE(v.isValid());
+    EXPECT_EQ(v.flags(), d->flags);
+    EXPECT_EQ(v.numberPorts(), d->numberPorts);
+    EXPECT_EQ(v.numberPorts(), 0x102);
+    EXPECT_EQ(v.priority1(), d->priority1);
+    EXPECT_EQ(v.clockQuality().clockClass, d->clockQuality.clockClass);
+    EXPECT_EQ(v.clockQuality().clockAccuracy, d->clockQuality.clockAccuracy);
+    EXPECT_EQ(v.clockQuality().offsetScaledLogVariance,
+        d->clockQuality.offsetScaledLogVariance);
+    EXPECT_EQ(v.priority2(), d->priority2);
+    EXPECT_EQ(v.clockIdentity(), d->clockIdentity);
+    EXPECT_EQ(v.domainNumber(), d->domainNumber);
+    EXPECT_EQ(v.domainNumber(), 7);
+    // Too small dataField
+    buf[3] = 72; // header.messageLength
+    buf[51] = 20; // lengthField
+    EXPECT_EQ(m.parseView(buf, 72), MNG_PARSE_ERROR_OK);
+    EXPECT_FALSE(m.view<DEFAULT_DATA_SET_v>().isValid());
+}
+
+// Test read only view over a dataField
+// PORT_STATS_NP_v(const void *data, size_t size)
+TEST(MessageTest, MethodViewPortStats)
+{
+    uint8_t data[266] = { 196, 125, 70, 255, 254, 32, 172, 174, 0, 2 };
+    // linuxptp statistics use little endian order
+    data[10 + 8 * STAT_SYNC] = 0x34;
+    data[10 + 8 * STAT_SYNC + 1] = 0x12;
+    data[138 + 8 * MAX_MESSAGE_TYPES - 1] = 0x80;
+    PORT_STATS_NP_v v(data, sizeof data);
+    ASSERT_TRUE(v.isValid());
+    PortIdentity_t port = v.portIdentity();
+    EXPECT_EQ(port.portNumber, 2);
+    EXPECT_STREQ(port.clockIdentity.string().c_str(), "c47d46.fffe.20acae");
+    EXPECT_EQ(v.rxMsgType(STAT_SYNC), 0x1234);
+    EXPECT_EQ(v.rxMsgType(STAT_DELAY_REQ), 0);
+    EXPECT_EQ(v.txMsgType(MAX_MESSAGE_TYPES - 1), 0x8000000000000000);
+    EXPECT_EQ(v.txMsgType(MAX_MESSAGE_TYPES), 0);
+    EXPECT_FALSE(PORT_STATS_NP_v(data, sizeof data - 1).isValid());
+    EXPECT_FALSE(PORT_STATS_NP_v(PORT_DATA_SET, data, sizeof data).isValid());
+    EXPECT_TRUE(PORT_STATS_NP_v(PORT_STATS_NP, data, sizeof data).isValid());
+}
+
 // Test parse using buffer object
 // actionField_e getReplyAction() const
 TEST(MessageTest, MethodGetReplyAction)
@@ -1464,6 +1651,64 @@ TEST(MessageTest, MethodTraversSigTlvs)
     EXPECT_TRUE(m.traversSigTlvsCl(cb));
 }
 
+// Test visit signaling message TLVs while parsing
+// MNG_PARSE_ERROR_e parseVisit(const void *buf, ssize_t msgSize,
+//     const std::function<bool (const Message &msg, tlvType_e tlvType,
+//         const BaseSigTlv *tlv)> &callback)
+// MNG_PARSE_ERROR_e parseVisitCl(const void *buf, ssize_t msgSize,
+//     MessageSigTlvCallback &callback)
+TEST(MessageTest, MethodParseVisit)
+{
+    Message m;
+    PRIORITY1_t p;
+    p.priority1 = 137;
+    EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+    uint8_t buf[70];
+    EXPECT_EQ(m.build(buf, sizeof buf, 1), MNG_PARSE_ERROR_OK);
+    buf[46] = RESPONSE;
+    // signaling with two Mng TLVs = 44 + 8 + 8 = 60
+    buf[0] = (buf[0] & 0xf0) | Signaling; // messageType
+    buf[3] = 60; // header.messageLength
+    buf[32] = 5; // controlField
+    for(int i = 0; i < 8; i++)
+        buf[44 + i] = buf[48 + i];
+    for(int i = 0; i < 8; i++)
+        buf[52 + i] = buf[44 + i];
+    MsgParams mp = m.getParams();
+    mp.rcvSignaling = true;
+    mp.filterSignaling = false;
+    EXPECT_TRUE(m.updateParams(mp));
+    int cnt = 0;
+    const BaseSigTlv *last = nullptr;
+    EXPECT_EQ(m.parseVisit(buf, 60, [&cnt, &last](const Message & msg,
+    tlvType_e tlvType, const BaseSigTlv * tlv) {
+        EXPECT_TRUE(verifyPr1(msg, tlvType, tlv));
+        if(cnt++ > 0) {
+            EXPECT_EQ(tlv, last); // TLV object is reused
+        }
+        last = tlv;
+        return false;
+    }), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(cnt, 2);
+    // TLVs are not stored
+    EXPECT_TRUE(m.isLastMsgSig());
+    EXPECT_EQ(m.getSigTlvsCount(), 0);
+    // Stop on first TLV
+    verifyPr1Cl cb;
+    EXPECT_EQ(m.parseVisitCl(buf, 60, cb), MNG_PARSE_ERROR_SIG);
+    // Parse as usual after visiting
+    EXPECT_EQ(m.parse(buf, 60), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(m.getSigTlvsCount(), 2);
+    EXPECT_TRUE(m.traversSigTlvs(verifyPr1));
+    // Filter the management TLVs
+    mp.filterSignaling = true;
+    EXPECT_TRUE(m.updateParams(mp));
+    cnt = 0;
+    EXPECT_EQ(m.parseVisit(buf, 60, [&cnt](const Message &, tlvType_e,
+    const BaseSigTlv *) { return ++cnt > 0; }), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(cnt, 0);
+}
+
 // Test get number of TLVs in a PTP signaling message
 // size_t getSigTlvsCount() const
 TEST(MessageTest, MethodGetSigTlvsCount)
@@ -1576,3 +1821,139 @@ TEST(MessageTest, MethodGetSigMngTlvType)
     ASSERT_NE(p1, nullptr);
     EXPECT_EQ(p1->priority1, 137);
 }
+
+// Test batch parse of many messages
+// MessageBatch()
+// size_t parse(const void *const *bufs, const ssize_t *sizes, size_t count)
+// size_t size() const
+// MNG_PARSE_ERROR_e getErr(size_t position) const
+// msgType_e getType(size_t position) const
+// const PortIdentity_t &getPeer(size_t position) const
+// uint16_t getSequence(size_t position) const
+// actionField_e getReplyAction(size_t position) const
+// mng_vals_e getTlvId(size_t position) const
+// const BaseMngTlv *getData(size_t position) const
+TEST(MessageBatchTest, MethodParse)
+{
+    Message m;
+    PRIORITY1_t p;
+    uint8_t buf[3][70];
+    for(int i = 0; i < 3; i++) {
+        p.priority1 = 10 + i;
+        EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+        EXPECT_EQ(m.build(buf[i], sizeof buf[i], 20 + i), MNG_PARSE_ERROR_OK);
+        // actionField location IEEE "PTP management message"
+        // Change to response action of get/set message
+        buf[i][46] = RESPONSE;
+    }
+    // Wrong header
+    buf[1][1] = 0;
+    const void *bufs[3] = { buf[0], buf[1], buf[2] };
+    ssize_t sizes[3] = { 56, 56, 56 };
+    MessageBatch b;
+    EXPECT_EQ(b.parse(bufs, sizes, 3), 2);
+    EXPECT_EQ(b.size(), 3);
+    EXPECT_EQ(b.getErr(0), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(b.getErr(1), MNG_PARSE_ERROR_HEADER);
+    EXPECT_EQ(b.getErr(2), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(b.getErr(3), MNG_PARSE_ERROR_UNSUPPORT);
+    EXPECT_EQ(b.getType(0), Management);
+    EXPECT_EQ(b.getSequence(0), 20);
+    EXPECT_EQ(b.getSequence(2), 22);
+    EXPECT_EQ(b.getReplyAction(2), RESPONSE);
+    EXPECT_EQ(b.getTlvId(2), PRIORITY1);
+    EXPECT_EQ(b.getPeer(2), m.getParams().self_id);
+    EXPECT_EQ(b.getData(1), nullptr);
+    EXPECT_EQ(b.getData(3), nullptr);
+    // Failed header does not keep the previous message fields
+    EXPECT_EQ(b.getSequence(1), 0);
+    EXPECT_EQ(b.getTlvId(1), NULL_PTP_MANAGEMENT);
+    const PRIORITY1_t *p0 = dynamic_cast<const PRIORITY1_t *>(b.getData(0));
+    ASSERT_NE(p0, nullptr);
+    EXPECT_EQ(p0->priority1, 10);
+    const PRIORITY1_t *p2 = dynamic_cast<const PRIORITY1_t *>(b.getData(2));
+    ASSERT_NE(p2, nullptr);
+    EXPECT_EQ(p2->priority1, 12);
+    // Next batch reuse the TLV objects
+    buf[0][54] = 30; // priority1
+    EXPECT_EQ(b.parse(bufs, sizes, 1), 1);
+    EXPECT_EQ(b.size(), 1);
+    EXPECT_EQ(b.getData(0), p0);
+    EXPECT_EQ(p0->priority1, 30);
+    EXPECT_EQ(b.getData(2), nullptr);
+    // Wrong management ID after a valid message, keep the header fields
+    buf[1][1] = buf[0][1];
+    buf[1][52] = 0xff; // managementId
+    buf[1][53] = 0xff;
+    EXPECT_EQ(b.parse(bufs, sizes, 3), 2);
+    EXPECT_EQ(b.getErr(1), MNG_PARSE_ERROR_INVALID_ID);
+    EXPECT_EQ(b.getSequence(1), 21);
+    EXPECT_EQ(b.getTlvId(1), NULL_PTP_MANAGEMENT);
+    EXPECT_EQ(b.getTlvId(2), PRIORITY1);
+}
+
+// Test batch append a message
+// MessageBatch(const MsgParams &prms)
+// MNG_PARSE_ERROR_e append(const Buf &buf, ssize_t msgSize)
+// void clear()
+// Message &getMessage()
+TEST(MessageBatchTest, MethodAppend)
+{
+    MsgParams prms;
+    prms.domainNumber = 7;
+    MessageBatch b(prms);
+    EXPECT_EQ(b.getMessage().getParams().domainNumber, 7);
+    EXPECT_TRUE(b.getMessage().getParams().reuseTlvs);
+    Message m;
+    PRIORITY1_t p;
+    p.priority1 = 99;
+    EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+    Buf buf;
+    EXPECT_TRUE(buf.alloc(70));
+    EXPECT_EQ(m.build(buf, 5), MNG_PARSE_ERROR_OK);
+    ((uint8_t *)buf())[46] = RESPONSE;
+    EXPECT_EQ(b.append(buf, 56), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(b.append(buf, 100), MNG_PARSE_ERROR_TOO_SMALL);
+    EXPECT_EQ(b.size(), 2);
+    EXPECT_EQ(b.getSequence(0), 5);
+    EXPECT_EQ(b.getTlvId(1), NULL_PTP_MANAGEMENT);
+    const PRIORITY1_t *p1 = dynamic_cast<const PRIORITY1_t *>(b.getData(0));
+    ASSERT_NE(p1, nullptr);
+    EXPECT_EQ(p1->priority1, 99);
+    b.clear();
+    EXPECT_EQ(b.size(), 0);
+    EXPECT_EQ(b.getData(0), nullptr);
+}
+
+// Test prepared request
+// PreparedRequest(Message &msg)
+// bool isReady() const
+// MNG_PARSE_ERROR_e setSequence(uint16_t sequence)
+// uint16_t getSequence() const
+// const Buf &getBuf() const
+// size_t getMsgLen() const
+TEST(PreparedRequestTest, MethodSetSequence)
+{
+    PreparedRequest e;
+    EXPECT_FALSE(e.isReady());
+    EXPECT_EQ(e.setSequence(1), MNG_PARSE_ERROR_TOO_SMALL);
+    Message m;
+    PRIORITY1_t p;
+    p.priority1 = 0x7f;
+    EXPECT_TRUE(m.setAction(SET, PRIORITY1, &p));
+    uint8_t buf[70];
+    EXPECT_EQ(m.build(buf, sizeof buf, 137), MNG_PARSE_ERROR_OK);
+    PreparedRequest r(m);
+    EXPECT_TRUE(r.isReady());
+    EXPECT_EQ(r.getMsgLen(), 56);
+    EXPECT_EQ(r.getSequence(), 0);
+    EXPECT_EQ(r.setSequence(137), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(r.getSequence(), 137);
+    EXPECT_EQ(memcmp(r.getBuf().get(), buf, 56), 0);
+    // Changing the message does not change the request
+    p.priority1 = 0x10;
+    EXPECT_EQ(m.build(buf, sizeof buf, 137), MNG_PARSE_ERROR_OK);
+    EXPECT_NE(memcmp(r.getBuf().get(), buf, 56), 0);
+    EXPECT_EQ(r.prepare(m, 137), MNG_PARSE_ERROR_OK);
+    EXPECT_EQ(memcmp(r.getBuf().get(), buf, 56), 0);
+}
@@ -518,6 +518,81 @@ TEST(Msg2JsonTest, Signaling)
         "}");
 }
 
+// Test compact JSON into a string sink
+// bool msg2json(const Message &message, JsonSink &sink, bool compact,
+//     int indent)
+TEST(Msg2JsonTest, Compact)
+{
+    uint8_t buf[70];
+    Message m;
+    USER_DESCRIPTION_t t;
+    t.userDescription.textField = "test123";
+    EXPECT_TRUE(m.setAction(SET, USER_DESCRIPTION, &t));
+    EXPECT_EQ(m.build(buf, sizeof buf, 1), MNG_PARSE_ERROR_OK);
+    buf[46] = RESPONSE;
+    ASSERT_EQ(m.parse(buf, 62), MNG_PARSE_ERROR_OK);
+    std::string json;
+    JsonStrSink sink(json);
+    EXPECT_TRUE(msg2json(m, sink, true, 3));
+    EXPECT_STREQ(json.c_str(),
+        "{\"sequenceId\":1,\"sdoId\":0,\"domainNumber\":0,\"versionPTP\":2,"
+        "\"minorVersionPTP\":0,\"unicastFlag\":true,\"PTPProfileSpecific\":0,"
+        "\"messageType\":\"Management\",\"sourcePortIdentity\":"
+        "{\"clockIdentity\":\"000000.0000.000000\",\"portNumber\":0},"
+        "\"targetPortIdentity\":"
+        "{\"clockIdentity\":\"ffffff.ffff.ffffff\",\"portNumber\":65535},"
+        "\"actionField\":\"RESPONSE\",\"tlvType\":\"MANAGEMENT\","
+        "\"managementId\":\"USER_DESCRIPTION\","
+        "\"dataField\":{\"userDescription\":\"test123\"}}");
+    // The sink appends
+    std::string compact = json;
+    EXPECT_TRUE(msg2json(m, sink));
+    EXPECT_EQ(json, compact + msg2json(m));
+}
+
+// Test JSON into a caller buffer
+// JsonBufSink(char *buf, size_t size)
+// size_t len() const
+// void clear()
+TEST(Msg2JsonTest, BufSink)
+{
+    uint8_t buf[70];
+    Message m;
+    EXPECT_TRUE(m.setAction(GET, PRIORITY1));
+    EXPECT_EQ(m.build(buf, sizeof buf, 1), MNG_PARSE_ERROR_OK);
+    buf[46] = RESPONSE;
+    ASSERT_EQ(m.parse(buf, 54), MNG_PARSE_ERROR_OK);
+    std::string json = msg2json(m);
+    char out[1000];
+    JsonBufSink sink(out, sizeof out);
+    EXPECT_TRUE(msg2json(m, sink));
+    EXPECT_EQ(sink.len(), json.size());
+    EXPECT_STREQ(out, json.c_str());
+    sink.clear();
+    EXPECT_EQ(sink.len(), 0);
+    EXPECT_STREQ(out, "");
+    // Buffer too small for the JSON
+    JsonBufSink small(out, 100);
+    EXPECT_FALSE(msg2json(m, small));
+    EXPECT_LT(small.len(), 100);
+}
+
+// Test escaping of JSON strings
+TEST(Tlv2JsonTest, Escape)
+{
+    USER_DESCRIPTION_t t;
+    t.userDescription.textField = "a\"b\\c\nd\te\x01";
+    EXPECT_STREQ(tlv2json(USER_DESCRIPTION, &t).c_str(),
+        "{\n"
+        "  \"userDescription\" : \"a\\\"b\\\\c\\nd\\te\\u0001\"\n"
+        "}");
+    std::string json;
+    JsonStrSink sink(json);
+    EXPECT_TRUE(tlv2json(USER_DESCRIPTION, &t, sink, true));
+    EXPECT_STREQ(json.c_str(),
+        "{\"userDescription\":\"a\\\"b\\\\c\\nd\\te\\u0001\"}");
+}
+
 // Tests CLOCK_DESCRIPTION structure
 TEST(Tlv2JsonTest, CLOCK_DESCRIPTION)
 {
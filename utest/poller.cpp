@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Poller class unit tests
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <unistd.h>
+#include "poller.h"
+
+using namespace ptpmgmt;
+
+class PollerTest : public ::testing::Test
+{
+  protected:
+    SockPoller p;
+    int fds[2] = { -1, -1 };
+    void SetUp() override {
+        ASSERT_GE(p.getFd(), 0);
+        ASSERT_EQ(pipe(fds), 0);
+    }
+    void TearDown() override {
+        close(fds[0]);
+        close(fds[1]);
+    }
+};
+
+// Tests add file description
+// bool add(int fd, const PollerCallback &callback)
+// bool remove(int fd)
+// ssize_t dispatch(uint64_t timeout_ms = 0)
+TEST_F(PollerTest, MethodAdd)
+{
+    int ready = -1;
+    EXPECT_LT(p.dispatch(1), 0);
+    EXPECT_TRUE(p.add(fds[0], [&ready](int fd) {
+        char c;
+        ready = fd;
+        EXPECT_EQ(read(fd, &c, 1), 1);
+    }));
+    EXPECT_FALSE(p.add(fds[0], [](int) {}));
+    EXPECT_FALSE(p.add(-1, [](int) {}));
+    EXPECT_FALSE(p.add(fds[1], nullptr));
+    EXPECT_EQ(p.dispatch(1), 0);
+    EXPECT_EQ(write(fds[1], "x", 1), 1);
+    EXPECT_EQ(p.dispatch(1000), 1);
+    EXPECT_EQ(ready, fds[0]);
+    EXPECT_TRUE(p.remove(fds[0]));
+    EXPECT_FALSE(p.remove(fds[0]));
+}
+
+// Tests one-shot timer
+// int addTimer(uint64_t timeout_ms, const PollerTimerCallback &callback,
+//     bool periodic = false)
+// bool cancelTimer(int timerId)
+TEST_F(PollerTest, MethodAddTimer)
+{
+    int fired = 0;
+    int id = p.addTimer(1, [&fired](int) { fired++; });
+    ASSERT_GE(id, 0);
+    EXPECT_FALSE(p.remove(id));
+    EXPECT_LT(p.addTimer(0, [](int) {}), 0);
+    EXPECT_EQ(p.dispatch(), 1);
+    EXPECT_EQ(fired, 1);
+    // The timer is done
+    EXPECT_FALSE(p.cancelTimer(id));
+    id = p.addTimer(1000, [&fired](int) { fired++; });
+    ASSERT_GE(id, 0);
+    EXPECT_TRUE(p.cancelTimer(id));
+    EXPECT_FALSE(p.cancelTimer(fds[0]));
+}
+
+// Tests periodic timer
+// int addTimer(uint64_t timeout_ms, const PollerTimerCallback &callback,
+//     bool periodic = false)
+// bool run()
+// void stop()
+TEST_F(PollerTest, MethodRun)
+{
+    int fired = 0;
+    int id = p.addTimer(1, [&](int timerId) {
+        EXPECT_EQ(timerId, id);
+        if(++fired == 3)
+            p.stop();
+    }, true);
+    ASSERT_GE(id, 0);
+    EXPECT_TRUE(p.run());
+    EXPECT_EQ(fired, 3);
+    EXPECT_TRUE(p.cancelTimer(id));
+}
@@ -0,0 +1,366 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Management session class unit tests
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "poller.h"
+
+using namespace ptpmgmt;
+
+// Socket pair, the test replies from the other end
+class SockPair : public SockBase
+{
+  protected:
+    bool initBase() override {
+        int fds[2];
+        if(socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) != 0)
+            return false;
+        m_fd = fds[0];
+        m_peer = fds[1];
+        m_isInit = true;
+        return true;
+    }
+    void closeChild() override {
+        if(m_peer >= 0) {
+            ::close(m_peer);
+            m_peer = -1;
+        }
+    }
+    bool sendBase(const void *msg, size_t len) const override {
+        return sendReply(::send(m_fd, msg, len, 0), len);
+    }
+    ssize_t rcvBase(void *buf, size_t bufSize, bool block) const override {
+        return recv(m_fd, buf, bufSize, block ? 0 : MSG_DONTWAIT);
+    }
+  public:
+    int m_peer = -1;
+    ~SockPair() { closeChild(); }
+    // Receive a request and send back a reply
+    // Reply from the request target port, with priority1 of port number
+    bool reply(uint8_t *buf, ssize_t &size) {
+        size = recv(m_peer, buf, 100, MSG_DONTWAIT);
+        if(size < 56)
+            return false;
+        // sourcePortIdentity = targetPortIdentity
+        memcpy(buf + 20, buf + 34, 10);
+        // actionField location IEEE "PTP management message"
+        buf[46] = RESPONSE;
+        buf[54] = buf[43]; // priority1 = low byte of port number
+        return true;
+    }
+    bool sendPeer(const uint8_t *buf, ssize_t size) {
+        return ::send(m_peer, buf, size, 0) == size;
+    }
+};
+
+// UDP socket pair on the loop back, with kernel timestamps
+class SockUdpPair : public SockPair
+{
+  protected:
+    bool initBase() override {
+        m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        m_peer = socket(AF_INET, SOCK_DGRAM, 0);
+        if(m_fd < 0 || m_peer < 0)
+            return false;
+        sockaddr_in a = {}, b;
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        b = a;
+        socklen_t len = sizeof a;
+        if(bind(m_fd, (sockaddr *)&a, len) != 0 ||
+            bind(m_peer, (sockaddr *)&b, len) != 0 ||
+            getsockname(m_fd, (sockaddr *)&a, &len) != 0 ||
+            getsockname(m_peer, (sockaddr *)&b, &len) != 0 ||
+            connect(m_fd, (sockaddr *)&b, len) != 0 ||
+            connect(m_peer, (sockaddr *)&a, len) != 0)
+            return false;
+        m_isInit = true;
+        return true;
+    }
+    ssize_t rcvTsBase(void *buf, size_t bufSize, bool block,
+        Timestamp_t &ts) const override {
+        iovec iov = { buf, bufSize };
+        uint8_t control[256];
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof control;
+        ssize_t cnt = recvmsg(m_fd, &msg, block ? 0 : MSG_DONTWAIT);
+        ts = Timestamp_t();
+        for(cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+            cm = CMSG_NXTHDR(&msg, cm)) {
+            if(cm->cmsg_level == SOL_SOCKET &&
+                cm->cmsg_type == SCM_TIMESTAMPING)
+                ts = *(timespec *)CMSG_DATA(cm);
+        }
+        return cnt;
+    }
+};
+
+class SessionTest : public ::testing::Test
+{
+  protected:
+    SockPair sk;
+    PortIdentity_t target;
+    MsgParams prms;
+    void SetUp() override {
+        prms.useZeroGet = false; // Reply with dataField
+        ASSERT_TRUE(sk.init());
+        target.clockIdentity = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    }
+};
+
+// Test many requests in flight, replies in reverse order
+// std::future<SessionReply> requestFuture(const PortIdentity_t &target,
+//     actionField_e action, mng_vals_e tlv_id, uint64_t timeout_ms,
+//     const BaseMngTlv *data = nullptr)
+// size_t process(uint64_t timeout_ms = 0)
+// size_t pending() const
+TEST_F(SessionTest, MethodRequestFuture)
+{
+    ManagementSession s(sk, prms);
+    std::future<SessionReply> f[8];
+    for(uint16_t i = 0; i < 8; i++) {
+        target.portNumber = i + 1;
+        f[i] = s.requestFuture(target, GET, PRIORITY1, 1000);
+    }
+    EXPECT_EQ(s.pending(), 8);
+    uint8_t bufs[8][100];
+    ssize_t sizes[8];
+    for(int i = 0; i < 8; i++)
+        ASSERT_TRUE(sk.reply(bufs[i], sizes[i]));
+    // Reply from a wrong port is ignored
+    uint8_t wrong[100];
+    memcpy(wrong, bufs[0], sizes[0]);
+    wrong[29] = 9;
+    EXPECT_TRUE(sk.sendPeer(wrong, sizes[0]));
+    for(int i = 7; i >= 0; i--)
+        EXPECT_TRUE(sk.sendPeer(bufs[i], sizes[i]));
+    EXPECT_EQ(s.process(1000), 8);
+    EXPECT_EQ(s.pending(), 0);
+    for(uint16_t i = 0; i < 8; i++) {
+        ASSERT_EQ(f[i].wait_for(std::chrono::seconds(0)),
+            std::future_status::ready);
+        SessionReply r = f[i].get();
+        EXPECT_EQ(r.state, SESSION_REPLY);
+        EXPECT_EQ(r.err, MNG_PARSE_ERROR_OK);
+        EXPECT_EQ(r.sequence, i);
+        EXPECT_EQ(r.peer.portNumber, i + 1);
+        EXPECT_EQ(r.peer.clockIdentity, target.clockIdentity);
+        EXPECT_EQ(r.tlvId, PRIORITY1);
+        EXPECT_EQ(r.replyAction, RESPONSE);
+        // The socket does not use kernel timestamps
+        EXPECT_EQ(r.wireRtt, 0);
+        ASSERT_NE(r.data, nullptr);
+        EXPECT_EQ(((PRIORITY1_t *)r.data.get())->priority1, i + 1);
+    }
+}
+
+// Test round trip time statistics
+// SessionStats getStats() const
+// void resetStats()
+TEST_F(SessionTest, MethodStats)
+{
+    ManagementSession s(sk, prms);
+    SessionStats st = s.getStats();
+    EXPECT_EQ(st.rtt.count, 0);
+    EXPECT_EQ(st.rtt.mean(), 0);
+    std::future<SessionReply> f[3];
+    for(uint16_t i = 0; i < 3; i++) {
+        target.portNumber = i + 1;
+        f[i] = s.requestFuture(target, GET, PRIORITY1, 1000);
+    }
+    uint8_t bufs[3][100];
+    ssize_t sizes[3];
+    for(int i = 0; i < 3; i++) {
+        ASSERT_TRUE(sk.reply(bufs[i], sizes[i]));
+        EXPECT_TRUE(sk.sendPeer(bufs[i], sizes[i]));
+    }
+    EXPECT_EQ(s.process(1000), 3);
+    uint64_t lo = UINT64_MAX, hi = 0, sum = 0;
+    for(int i = 0; i < 3; i++) {
+        uint64_t rtt = f[i].get().rtt;
+        lo = std::min(lo, rtt);
+        hi = std::max(hi, rtt);
+        sum += rtt;
+    }
+    st = s.getStats();
+    EXPECT_EQ(st.rtt.count, 3);
+    EXPECT_EQ(st.rtt.min, lo);
+    EXPECT_EQ(st.rtt.max, hi);
+    EXPECT_EQ(st.rtt.sum, sum);
+    EXPECT_EQ(st.rtt.mean(), sum / 3);
+    // The socket does not use kernel timestamps
+    EXPECT_EQ(st.wireRtt.count, 0);
+    s.resetStats();
+    EXPECT_EQ(s.getStats().rtt.count, 0);
+}
+
+// Test round trip time with the kernel timestamps
+// bool SockBase::setTimestamping(bool enable, bool hardware = false)
+TEST_F(SessionTest, MethodWireRtt)
+{
+    SockUdpPair usk;
+    ASSERT_TRUE(usk.setTimestamping(true));
+    ASSERT_TRUE(usk.init());
+    ManagementSession s(usk, prms);
+    target.portNumber = 1;
+    std::future<SessionReply> f = s.requestFuture(target, GET, PRIORITY1,
+            1000);
+    uint8_t buf[100];
+    ssize_t size;
+    ASSERT_TRUE(usk.reply(buf, size));
+    EXPECT_TRUE(usk.sendPeer(buf, size));
+    EXPECT_EQ(s.process(1000), 1);
+    ASSERT_EQ(f.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    SessionReply r = f.get();
+    EXPECT_EQ(r.state, SESSION_REPLY);
+    EXPECT_GT(r.wireRtt, 0);
+    SessionStats st = s.getStats();
+    EXPECT_EQ(st.wireRtt.count, 1);
+    EXPECT_EQ(st.wireRtt.min, r.wireRtt);
+    EXPECT_EQ(st.wireRtt.max, r.wireRtt);
+}
+
+// Test request with callback and timeout
+// bool request(const PortIdentity_t &target, actionField_e action,
+//     mng_vals_e tlv_id, uint64_t timeout_ms, const SessionCallback &callback,
+//     const BaseMngTlv *data = nullptr)
+// size_t expire()
+TEST_F(SessionTest, MethodRequestTimeout)
+{
+    ManagementSession s(sk, prms);
+    target.portNumber = 1;
+    std::vector<SessionReply> res;
+    auto cb = [&res](const SessionReply & r) { res.push_back(r); };
+    EXPECT_TRUE(s.request(target, GET, PRIORITY1, 5, cb));
+    EXPECT_TRUE(s.request(target, GET, PRIORITY1, 1000, cb));
+    uint8_t buf[100];
+    ssize_t size;
+    ASSERT_TRUE(sk.reply(buf, size));
+    ASSERT_TRUE(sk.reply(buf, size));
+    // Reply only to the second request
+    EXPECT_TRUE(sk.sendPeer(buf, size));
+    EXPECT_EQ(s.process(1000), 2);
+    ASSERT_EQ(res.size(), 2);
+    EXPECT_EQ(res[0].state, SESSION_REPLY);
+    EXPECT_EQ(res[0].sequence, 1);
+    EXPECT_EQ(res[1].state, SESSION_TIMEOUT);
+    EXPECT_EQ(res[1].sequence, 0);
+    EXPECT_EQ(s.pending(), 0);
+    EXPECT_EQ(s.expire(), 0);
+}
+
+// Test handle a received message
+// bool handle(const void *buf, ssize_t msgSize)
+TEST_F(SessionTest, MethodHandle)
+{
+    ManagementSession s(sk, prms);
+    SessionReply res;
+    auto cb = [&res](const SessionReply & r) { res = r; };
+    // All ports match any peer port
+    target.portNumber = UINT16_MAX;
+    EXPECT_TRUE(s.request(target, GET, PRIORITY1, 1000, cb));
+    uint8_t buf[100];
+    ssize_t size;
+    ASSERT_TRUE(sk.reply(buf, size));
+    buf[28] = 0; // Reply from port 3
+    buf[29] = 3;
+    EXPECT_TRUE(s.handle(buf, size));
+    EXPECT_EQ(res.state, SESSION_REPLY);
+    EXPECT_EQ(res.peer.portNumber, 3);
+    // The request is completed
+    EXPECT_FALSE(s.handle(buf, size));
+    EXPECT_EQ(s.pending(), 0);
+}
+
+// Test cancel requests in flight
+// size_t cancel()
+// ~ManagementSession()
+TEST_F(SessionTest, MethodCancel)
+{
+    std::future<SessionReply> f;
+    {
+        ManagementSession s(sk, prms);
+        target.portNumber = 1;
+        EXPECT_TRUE(s.requestFuture(target, GET, PRIORITY1, 1000).valid());
+        EXPECT_EQ(s.cancel(), 1);
+        f = s.requestFuture(target, GET, PRIORITY1, 1000);
+    }
+    EXPECT_EQ(f.get().state, SESSION_CANCEL);
+}
+
+// Test request that fails to build
+TEST_F(SessionTest, MethodSendFail)
+{
+    ManagementSession s(sk, prms);
+    target.portNumber = 1;
+    // SET must have data
+    SessionReply r = s.requestFuture(target, SET, PRIORITY1, 1000).get();
+    EXPECT_EQ(r.state, SESSION_SEND_FAIL);
+    EXPECT_EQ(s.pending(), 0);
+    bool called = false;
+    EXPECT_FALSE(s.request(target, SET, PRIORITY1, 1000,
+    [&called](const SessionReply &) { called = true; }));
+    EXPECT_FALSE(called);
+}
+
+// Test time till the first request timeout
+// bool nextTimeout(uint64_t &timeout_ms) const
+// const SockBase &getSocket() const
+TEST_F(SessionTest, MethodNextTimeout)
+{
+    ManagementSession s(sk, prms);
+    EXPECT_EQ(&s.getSocket(), &sk);
+    uint64_t to;
+    EXPECT_FALSE(s.nextTimeout(to));
+    target.portNumber = 1;
+    EXPECT_TRUE(s.request(target, GET, PRIORITY1, 1000, nullptr));
+    EXPECT_TRUE(s.request(target, GET, PRIORITY1, 500, nullptr));
+    EXPECT_TRUE(s.nextTimeout(to));
+    EXPECT_LE(to, 500);
+    EXPECT_GT(to, 400);
+}
+
+// Test session with a poller
+// bool SockPoller::add(ManagementSession &session)
+// bool SockPoller::remove(ManagementSession &session)
+TEST_F(SessionTest, MethodPoller)
+{
+    ManagementSession s(sk, prms);
+    SockPoller p;
+    ASSERT_TRUE(p.add(s));
+    EXPECT_FALSE(p.add(sk, [](int) {}));
+    std::vector<SessionReply> res;
+    auto cb = [&res](const SessionReply & r) { res.push_back(r); };
+    target.portNumber = 1;
+    EXPECT_TRUE(s.request(target, GET, PRIORITY1, 100, cb));
+    EXPECT_TRUE(s.request(target, GET, PRIORITY1, 1000, cb));
+    uint8_t buf[100];
+    ssize_t size;
+    ASSERT_TRUE(sk.reply(buf, size));
+    ASSERT_TRUE(sk.reply(buf, size));
+    // Reply only to the second request
+    EXPECT_TRUE(sk.sendPeer(buf, size));
+    EXPECT_EQ(p.dispatch(1000), 1);
+    ASSERT_EQ(res.size(), 1);
+    EXPECT_EQ(res[0].state, SESSION_REPLY);
+    EXPECT_EQ(res[0].sequence, 1);
+    // The poller waits for the first request timeout
+    EXPECT_EQ(p.dispatch(), 1);
+    ASSERT_EQ(res.size(), 2);
+    EXPECT_EQ(res[1].state, SESSION_TIMEOUT);
+    EXPECT_EQ(res[1].sequence, 0);
+    EXPECT_TRUE(p.remove(s));
+    EXPECT_FALSE(p.remove(s));
+}
@@ -0,0 +1,247 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief Signalling TLV records in columns unit tests
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include "sigCols.h"
+#include "comp.h"
+
+__PTPMGMT_NAMESPACE_USE;
+
+class SigColsTest : public ::testing::Test, public Message
+{
+  protected:
+    const ClockIdentity_t clockId = { 196, 125, 70, 255, 254, 32, 172, 174 };
+    const PortIdentity_t portId = { clockId, 1 };
+    uint8_t buf[1500];
+    size_t curLen;
+    MsgParams a;
+    SigColumns cols;
+    void SetUp() override {
+        // signaling = 36 header + 10 targetPortIdentity = 44
+        curLen = 44;
+        build(buf, sizeof buf, 1);
+        buf[0] = (buf[0] & 0xf0) | Signaling; // messageType
+        buf[32] = 5; // controlField
+        a = getParams();
+        a.rcvSignaling = true;
+        a.filterSignaling = false;
+    }
+    void addTlv(tlvType_e type, uint8_t *msg, size_t len) {
+        uint16_t *cur = (uint16_t *)(buf + curLen);
+        *cur++ = cpu_to_net16(type);
+        *cur++ = cpu_to_net16(len);
+        memcpy(cur, msg, len);
+        curLen += len + 4;
+    }
+    MNG_PARSE_ERROR_e doParse() {
+        // header.messageLength
+        buf[2] = curLen >> 8;
+        buf[3] = curLen & 0xff;
+        return parseColumns(buf, curLen, cols);
+    }
+};
+
+// Tests decode records into columns
+// MNG_PARSE_ERROR_e parseColumns(const void *buf, ssize_t msgSize,
+//     SigColumns &cols)
+// size_t size(tlvType_e tlvType) const
+TEST_F(SigColsTest, MethodParseColumns)
+{
+    uint8_t m0[16] = {196, 125, 70, 255, 254, 32, 172, 174, 5, 7, 9, 1,
+            172, 201, 3, 45
+        };
+    addTlv(PATH_TRACE, m0, sizeof m0);
+    uint8_t m1[78] = {196, 125, 70, 255, 254, 32, 172, 174, 0, 1,
+            4, 0, 0, 0x90, 8, 0x20, 0x11, 0, 0x36, 0xf9, 0xdf, 0xb8,
+            0x45, 0x38, 0xaf, 0xb7, 0x17, 0x94, 0xd2, 0xa1, 0x99, 0x1a, 0x11,
+            0xbd, 0, 0x98, 0x41, 0, 2, 0x4e, 0x38, 0xd0, 0, 0,
+            11, 0xc7, 0, 0x81, 4, 8, 0x22, 8, 0, 0, 0, 0,
+            0x12, 0x43, 0x5b, 0x4a, 0xf4, 0xd4, 0x1e, 0x48, 0xbd, 0xde,
+            0xfa, 0x5c, 0, 0x81, 0x90, 0x58, 0x24, 0x20, 0x38, 0x1a, 0, 0
+        };
+    addTlv(SLAVE_RX_SYNC_TIMING_DATA, m1, sizeof m1);
+    uint8_t m2[56] = {196, 125, 70, 255, 254, 32, 172, 174, 0, 1, 7, 0,
+            11, 0xe6, 0x81, 1, 0x14, 0, 2, 0x24, 4, 0, 0x81, 0x12, 0x14, 0, 2,
+            0x20, 4, 0, 0xbe, 0xbd, 0xe0, 0,
+            7, 3, 0x81, 0x12, 0x14, 0x50, 0xb0, 0x20, 4, 0, 0x98, 0x42, 0x14,
+            0x50, 0xb0, 0x20, 4, 0, 0xbe, 0x95, 0x4e, 0xf0
+        };
+    addTlv(SLAVE_RX_SYNC_COMPUTED_DATA, m2, sizeof m2);
+    uint8_t m3[36] = {196, 125, 70, 255, 254, 32, 172, 174, 0, 1, 9, 0,
+            2, 0xf1, 0, 2, 9, 8, 2, 0x20,
+            0x36, 0x61, 0x20, 0x10,
+            9, 0xf3, 0, 0x20, 0, 0x90, 8, 0x40,
+            0x36, 0x61, 0x6d, 0x7c
+        };
+    addTlv(SLAVE_TX_EVENT_TIMESTAMPS, m3, sizeof m3);
+    EXPECT_TRUE(updateParams(a));
+    ASSERT_EQ(doParse(), MNG_PARSE_ERROR_SIG);
+    EXPECT_TRUE(isLastMsgSig());
+    // Only the TLV without records is stored
+    EXPECT_EQ(getSigTlvsCount(), 1);
+    EXPECT_EQ(getSigTlvType(0), PATH_TRACE);
+    const SLAVE_RX_SYNC_TIMING_DATA_cols_t &c1 = cols.rxSyncTiming;
+    EXPECT_EQ(cols.size(SLAVE_RX_SYNC_TIMING_DATA), 2);
+    EXPECT_EQ(c1.syncSourcePortIdentity, portId);
+    EXPECT_EQ(c1.sequenceId, std::vector<UInteger16_t>({1024, 3015}));
+    EXPECT_EQ(c1.syncOriginTimestamp.secondsField,
+        std::vector<UInteger48_t>({618611609856, 554118423048}));
+    EXPECT_EQ(c1.syncOriginTimestamp.nanosecondsField,
+        std::vector<UInteger32_t>({922345400, 0}));
+    EXPECT_EQ(c1.totalCorrectionField,
+        std::vector<Integer64_t>({0x4538afb71794d2a1, 0x12435b4af4d41e48}));
+    EXPECT_EQ(c1.scaledCumulativeRateOffset,
+        std::vector<Integer32_t>({-1726344771, -1109460388}));
+    EXPECT_EQ(c1.syncEventIngressTimestamp.secondsField,
+        std::vector<UInteger48_t>({653925548622, 556472476704}));
+    EXPECT_EQ(c1.syncEventIngressTimestamp.nanosecondsField,
+        std::vector<UInteger32_t>({953155584, 941228032}));
+    const SLAVE_RX_SYNC_COMPUTED_DATA_cols_t &c2 = cols.rxSyncComputed;
+    EXPECT_EQ(cols.size(SLAVE_RX_SYNC_COMPUTED_DATA), 2);
+    EXPECT_EQ(c2.sourcePortIdentity, portId);
+    EXPECT_EQ(c2.computedFlags, 7);
+    EXPECT_EQ(c2.sequenceId, std::vector<UInteger16_t>({3046, 1795}));
+    EXPECT_EQ(c2.offsetFromMaster, std::vector<Integer64_t>(
+    {(Integer64_t)0x8101140002240400, (Integer64_t)0x81121450b0200400}));
+    EXPECT_EQ(c2.meanPathDelay, std::vector<Integer64_t>(
+    {(Integer64_t)0x8112140002200400, (Integer64_t)0x98421450b0200400}));
+    EXPECT_EQ(c2.scaledNeighborRateRatio,
+        std::vector<Integer32_t>({-1094852608, -1097511184}));
+    const SLAVE_TX_EVENT_TIMESTAMPS_cols_t &c3 = cols.txEventTimestamps;
+    EXPECT_EQ(cols.size(SLAVE_TX_EVENT_TIMESTAMPS), 2);
+    EXPECT_EQ(c3.sourcePortIdentity, portId);
+    EXPECT_EQ(c3.eventMessageType, Delay_Resp);
+    EXPECT_EQ(c3.sequenceId, std::vector<UInteger16_t>({753, 2547}));
+    EXPECT_EQ(c3.eventEgressTimestamp.secondsField,
+        std::vector<UInteger48_t>({8741454368, 137448392768}));
+    EXPECT_EQ(c3.eventEgressTimestamp.nanosecondsField,
+        std::vector<UInteger32_t>({912334864, 912354684}));
+    EXPECT_EQ(cols.size(SLAVE_DELAY_TIMING_DATA_NP), 0);
+    // Append the records of the next message
+    ASSERT_EQ(doParse(), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(cols.size(SLAVE_RX_SYNC_TIMING_DATA), 4);
+    EXPECT_EQ(c1.sequenceId,
+        std::vector<UInteger16_t>({1024, 3015, 1024, 3015}));
+    EXPECT_EQ(c1.syncEventIngressTimestamp.nanosecondsField.size(), 4);
+    EXPECT_EQ(cols.size(SLAVE_RX_SYNC_COMPUTED_DATA), 4);
+    EXPECT_EQ(cols.size(SLAVE_TX_EVENT_TIMESTAMPS), 4);
+}
+
+// Tests keep a window of records
+// void trim(size_t maxRecords)
+// void clear()
+TEST_F(SigColsTest, MethodTrim)
+{
+    uint8_t m[36] = {196, 125, 70, 255, 254, 32, 172, 174, 0, 1, 9, 0,
+            2, 0xf1, 0, 2, 9, 8, 2, 0x20,
+            0x36, 0x61, 0x20, 0x10,
+            9, 0xf3, 0, 0x20, 0, 0x90, 8, 0x40,
+            0x36, 0x61, 0x6d, 0x7c
+        };
+    addTlv(SLAVE_TX_EVENT_TIMESTAMPS, m, sizeof m);
+    EXPECT_TRUE(updateParams(a));
+    ASSERT_EQ(doParse(), MNG_PARSE_ERROR_SIG);
+    ASSERT_EQ(doParse(), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(cols.size(SLAVE_TX_EVENT_TIMESTAMPS), 4);
+    cols.trim(3);
+    const SLAVE_TX_EVENT_TIMESTAMPS_cols_t &c = cols.txEventTimestamps;
+    EXPECT_EQ(c.sequenceId, std::vector<UInteger16_t>({2547, 753, 2547}));
+    EXPECT_EQ(c.eventEgressTimestamp.secondsField,
+        std::vector<UInteger48_t>({137448392768, 8741454368, 137448392768}));
+    EXPECT_EQ(c.eventEgressTimestamp.nanosecondsField,
+        std::vector<UInteger32_t>({912354684, 912334864, 912354684}));
+    cols.trim(5);
+    EXPECT_EQ(cols.size(SLAVE_TX_EVENT_TIMESTAMPS), 3);
+    cols.clear();
+    EXPECT_EQ(cols.size(SLAVE_TX_EVENT_TIMESTAMPS), 0);
+    EXPECT_EQ(c.eventEgressTimestamp.secondsField.size(), 0);
+}
+
+// Tests Linuxptp TLV records
+// static bool isColumnsTlv(tlvType_e tlvType, implementSpecific_e spec)
+TEST_F(SigColsTest, MethodLinuxptpColumns)
+{
+    uint8_t m[70] = {196, 125, 70, 255, 254, 32, 172, 174, 0, 1,
+            8, 0x6e, 0x84, 0x10, 9, 0x42, 8, 0xa4, 0x39, 0x50, 0x44,
+            0xd3, 0x48, 1, 0x20, 0x40, 0x10, 0x10, 0, 0, 0, 0x40, 8,
+            0x42, 8, 0x80, 0x36, 0xa0, 0xf5, 2,
+            0xc, 0x49, 0x80, 0x41, 0x21, 0x12, 8, 0xa4, 0x38, 0xde,
+            0xa5, 0x3a, 0x8c, 0x42, 0xa2, 0x40, 0x10, 2, 0, 0, 0xc5,
+            0, 8, 0x42, 8, 0xa4, 0x37, 6, 0x2c, 0xe2
+        };
+    addTlv(SLAVE_DELAY_TIMING_DATA_NP, m, sizeof m);
+    EXPECT_FALSE(SigColumns::isColumnsTlv(SLAVE_DELAY_TIMING_DATA_NP,
+            noImplementSpecific));
+    EXPECT_TRUE(SigColumns::isColumnsTlv(SLAVE_DELAY_TIMING_DATA_NP,
+            linuxptp));
+    EXPECT_TRUE(SigColumns::isColumnsTlv(SLAVE_TX_EVENT_TIMESTAMPS,
+            noImplementSpecific));
+    EXPECT_FALSE(SigColumns::isColumnsTlv(PATH_TRACE, linuxptp));
+    a.implementSpecific = noImplementSpecific;
+    EXPECT_TRUE(updateParams(a));
+    ASSERT_EQ(doParse(), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(cols.size(SLAVE_DELAY_TIMING_DATA_NP), 0);
+    a.implementSpecific = linuxptp;
+    EXPECT_TRUE(updateParams(a));
+    ASSERT_EQ(doParse(), MNG_PARSE_ERROR_SIG);
+    EXPECT_EQ(getSigTlvsCount(), 0);
+    const SLAVE_DELAY_TIMING_DATA_NP_cols_t &c = cols.delayTiming;
+    EXPECT_EQ(cols.size(SLAVE_DELAY_TIMING_DATA_NP), 2);
+    EXPECT_EQ(c.sourcePortIdentity, portId);
+    EXPECT_EQ(c.sequenceId, std::vector<UInteger16_t>({2158, 3145}));
+    EXPECT_EQ(c.delayOriginTimestamp.secondsField,
+        std::vector<UInteger48_t>({145204409665700, 141017216059556}));
+    EXPECT_EQ(c.delayOriginTimestamp.nanosecondsField,
+        std::vector<UInteger32_t>({961561811, 954115386}));
+    EXPECT_EQ(c.totalCorrectionField, std::vector<Integer64_t>(
+    {5188463705227001856l, (Integer64_t)10106818909802987520ul}));
+    EXPECT_EQ(c.delayResponseTimestamp.secondsField,
+        std::vector<UInteger48_t>({275016452224, 216603929217188}));
+    EXPECT_EQ(c.delayResponseTimestamp.nanosecondsField,
+        std::vector<UInteger32_t>({916518146, 923151586}));
+}
+
+// Tests columns of many records match the records parse
+TEST_F(SigColsTest, ManyRecords)
+{
+    const size_t recs = 41;
+    uint8_t m[10 + recs * 34];
+    memcpy(m, clockId.v, 8);
+    m[8] = 0;
+    m[9] = 1;
+    for(size_t i = 10; i < sizeof m; i++)
+        m[i] = (i * 37 + 11) & 0xff;
+    addTlv(SLAVE_RX_SYNC_TIMING_DATA, m, sizeof m);
+    EXPECT_TRUE(updateParams(a));
+    ASSERT_EQ(doParse(), MNG_PARSE_ERROR_SIG);
+    ASSERT_EQ(parse(buf, curLen), MNG_PARSE_ERROR_SIG);
+    ASSERT_EQ(getSigTlvsCount(), 1);
+    const SLAVE_RX_SYNC_TIMING_DATA_t *p =
+        dynamic_cast<const SLAVE_RX_SYNC_TIMING_DATA_t *>(getSigTlv(0));
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(p->list.size(), recs);
+    const SLAVE_RX_SYNC_TIMING_DATA_cols_t &c = cols.rxSyncTiming;
+    ASSERT_EQ(cols.size(SLAVE_RX_SYNC_TIMING_DATA), recs);
+    for(size_t i = 0; i < recs; i++) {
+        const SLAVE_RX_SYNC_TIMING_DATA_rec_t &r = p->list[i];
+        EXPECT_EQ(c.sequenceId[i], r.sequenceId);
+        EXPECT_EQ(c.syncOriginTimestamp.secondsField[i],
+            r.syncOriginTimestamp.secondsField);
+        EXPECT_EQ(c.syncOriginTimestamp.nanosecondsField[i],
+            r.syncOriginTimestamp.nanosecondsField);
+        EXPECT_EQ(c.totalCorrectionField[i],
+            r.totalCorrectionField.scaledNanoseconds);
+        EXPECT_EQ(c.scaledCumulativeRateOffset[i], r.scaledCumulativeRateOffset);
+        EXPECT_EQ(c.syncEventIngressTimestamp.secondsField[i],
+            r.syncEventIngressTimestamp.secondsField);
+        EXPECT_EQ(c.syncEventIngressTimestamp.nanosecondsField[i],
+            r.syncEventIngressTimestamp.nanosecondsField);
+    }
+}
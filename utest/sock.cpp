@@ -24,6 +24,42 @@ class SockUnixTest : public ::testing::Test, public SockUnix
     }
 };
 
+// Tests resolved Unix socket address
+// UnixPeer(const std::string &addr, bool useAbstract = false)
+// bool set(const std::string &addr, bool useAbstract = false)
+// void clear()
+// bool empty() const
+// bool isAbstract() const
+// std::string str() const
+// size_t hash() const
+// bool operator==(const UnixPeer &other) const
+// bool operator<(const UnixPeer &other) const
+TEST(UnixPeerTest, MethodSet)
+{
+    UnixPeer a, b("/peer"), c("peer", true), d(std::string(1, '\0') + "peer");
+    EXPECT_TRUE(a.empty());
+    EXPECT_STREQ(a.str().c_str(), "");
+    EXPECT_FALSE(b.empty());
+    EXPECT_FALSE(b.isAbstract());
+    EXPECT_STREQ(b.str().c_str(), "/peer");
+    EXPECT_TRUE(c.isAbstract());
+    EXPECT_EQ(c.str(), std::string(1, '\0') + "peer");
+    // Abstract address as a string with a leading zero
+    EXPECT_TRUE(c == d);
+    EXPECT_EQ(c.hash(), d.hash());
+    EXPECT_TRUE(b != c);
+    EXPECT_TRUE(b < c || c < b);
+    EXPECT_FALSE(b < b);
+    EXPECT_FALSE(a.set(""));
+    EXPECT_TRUE(a.empty());
+    EXPECT_TRUE(a.set("/peer"));
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_EQ(UnixPeer::Hash()(a), b.hash());
+    a.clear();
+    EXPECT_TRUE(a.empty());
+}
+
 // Tests getHomeDir method
 // const std::string &getHomeDir()
 // const char *getHomeDir_c()
@@ -240,6 +276,38 @@ TEST_F(SockUnixTest, MethodRcv)
     EXPECT_EQ(memcmp(buf, "\x1\x4\x5\x6\x7", 5), 0);
 }
 
+// Tests rcvTs method
+// bool setTimestamping(bool enable, bool hardware = false)
+// bool isTimestamping() const
+// ssize_t rcvTs(void *buf, size_t bufSize, Timestamp_t &ts,
+//     bool block = false) const
+// bool getTxTs(Timestamp_t &ts, uint32_t &id, bool block = false) const
+TEST_F(SockUnixTest, MethodRcvTs)
+{
+    EXPECT_TRUE(setSelfAddress("/me"));
+    EXPECT_TRUE(setPeerAddress("/peer"));
+    EXPECT_FALSE(isTimestamping());
+    EXPECT_TRUE(setTimestamping(true));
+    EXPECT_TRUE(isTimestamping());
+    EXPECT_TRUE(init());
+    EXPECT_FALSE(setTimestamping(false));
+    uint8_t buf[10];
+    Timestamp_t ts;
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts), 5);
+    EXPECT_EQ(memcmp(buf, "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ts, Timestamp_t(12, 147));
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts, true), 5);
+    EXPECT_EQ(memcmp(buf, "\x1\x4\x5\x6\x7", 5), 0);
+    // Unix socket does not support transmit timestamps
+    uint32_t id;
+    EXPECT_FALSE(getTxTs(ts, id));
+    // Nor hardware timestamps
+    SockUnix hw;
+    EXPECT_TRUE(hw.setSelfAddress("/me"));
+    EXPECT_TRUE(hw.setTimestamping(true, true));
+    EXPECT_FALSE(hw.init());
+}
+
 // Tests rcv method
 // ssize_t rcv(Buf &buf, bool block = false)
 // ssize_t rcvBuf(Buf &buf, bool block = false)
@@ -290,6 +358,28 @@ TEST_F(SockUnixTest, MethodRcvFrom)
     EXPECT_STREQ(from.c_str(), "/peer");
 }
 
+// Tests sendTo and rcvFrom with resolved address
+// bool sendTo(const void *msg, size_t len, const UnixPeer &peer) const
+// ssize_t rcvFrom(void *buf, size_t bufSize, UnixPeer &from,
+//     bool block = false) const
+TEST_F(SockUnixTest, MethodSendToRcvFromPeer)
+{
+    EXPECT_TRUE(setSelfAddress("/me"));
+    EXPECT_TRUE(init());
+    UnixPeer peer("/peer"), from;
+    EXPECT_TRUE(sendTo("\x1\x2\x3\x4\x5", 5, peer));
+    EXPECT_TRUE(sendTo("\x1\x2\x3\x4\x5", 5, UnixPeer("peer", true)));
+    EXPECT_FALSE(sendTo("\x1\x2\x3\x4\x5", 5, from));
+    uint8_t buf[10];
+    EXPECT_EQ(rcvFrom(buf, sizeof buf, from), 5);
+    EXPECT_EQ(memcmp(buf, "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_TRUE(from == peer);
+    EXPECT_STREQ(from.str().c_str(), "/peer");
+    EXPECT_EQ(rcvFrom(buf, sizeof buf, from, true), 5);
+    EXPECT_EQ(memcmp(buf, "\x1\x4\x5\x6\x7", 5), 0);
+    EXPECT_TRUE(from == peer);
+}
+
 // Tests rcvFrom with Buf method
 
 // ssize_t rcvFrom(Buf &buf, std::string &from, bool block = false) const
@@ -409,6 +499,21 @@ TEST_F(SockIp4Test, MethodSetAllInit)
     EXPECT_TRUE(setAllInit(i, f, "dumm"));
 }
 
+// Tests busy poll
+// bool setBusyPoll(uint32_t busy_poll, bool prefer_busy_poll = false,
+//     uint32_t busy_poll_spin = 0)
+TEST_F(SockIp4Test, MethodBusyPoll)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_FALSE(setBusyPoll(UINT32_MAX));
+    EXPECT_TRUE(setBusyPoll(30, true, 10));
+    EXPECT_TRUE(init());
+    EXPECT_FALSE(setBusyPoll(30));
+    // The spin finds the message before poll()
+    EXPECT_TRUE(poll(1));
+}
+
 // Tests poll method
 // bool poll(uint64_t timeout_ms = 0) const
 TEST_F(SockIp4Test, MethodPoll)
@@ -473,6 +578,60 @@ TEST_F(SockIp4Test, MethodRcv)
     EXPECT_EQ(memcmp(buf, "\x2\x4\x5\x6\x7", 5), 0);
     EXPECT_EQ(rcv(buf, sizeof buf, true), 5);
     EXPECT_EQ(memcmp(buf, "\x1\x4\x5\x6\x7", 5), 0);
+    // Socket does not use timestamps
+    Timestamp_t ts;
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts), -1);
+}
+
+// Tests rcvTs method
+// bool setTimestamping(bool enable, bool hardware = false)
+// bool isHwTimestamping() const
+// ssize_t rcvTs(void *buf, size_t bufSize, Timestamp_t &ts,
+//     bool block = false) const
+// ssize_t rcvTs(Buf &buf, Timestamp_t &ts, bool block = false) const
+TEST_F(SockIp4Test, MethodRcvTs)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_TRUE(setTimestamping(true));
+    EXPECT_FALSE(isHwTimestamping());
+    EXPECT_TRUE(init());
+    uint8_t buf[10];
+    Timestamp_t ts;
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts), 5);
+    EXPECT_EQ(memcmp(buf, "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ts, Timestamp_t(12, 147));
+    Buf b(10);
+    EXPECT_EQ(rcvTs(b, ts, true), 5);
+    EXPECT_EQ(memcmp(b.get(), "\x1\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ts, Timestamp_t(12, 147));
+}
+
+// Tests getTxTs method
+// uint32_t getTxId() const
+// bool getTxTs(Timestamp_t &ts, uint32_t &id, bool block = false) const
+TEST_F(SockIp4Test, MethodGetTxTs)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_TRUE(setTimestamping(true));
+    EXPECT_TRUE(init());
+    EXPECT_EQ(getTxId(), 0);
+    EXPECT_TRUE(send("\x1\x2\x3\x4\x5", 5));
+    EXPECT_EQ(getTxId(), 1);
+    SockMsg msgs[2];
+    for(auto &m : msgs) {
+        m.buf = (void *)"\x1\x2\x3\x4\x5";
+        m.len = 5;
+    }
+    EXPECT_EQ(sendBatch(msgs, 2), 2);
+    EXPECT_EQ(getTxId(), 3);
+    Timestamp_t ts;
+    uint32_t id;
+    EXPECT_TRUE(getTxTs(ts, id));
+    EXPECT_EQ(id, 3);
+    EXPECT_EQ(ts, Timestamp_t(13, 148));
+    EXPECT_FALSE(getTxTs(ts, id));
 }
 
 // Tests rcv method
@@ -494,6 +653,144 @@ TEST_F(SockIp4Test, MethodRcvBuf)
     EXPECT_EQ(memcmp(b.get(), "\x1\x4\x5\x6\x7", 5), 0);
 }
 
+// Tests sendBatch method
+// ssize_t sendBatch(const SockMsg *msgs, size_t count) const
+TEST_F(SockIp4Test, MethodSendBatch)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_TRUE(init());
+    uint8_t buf[5];
+    memcpy(buf, "\x1\x2\x3\x4\x5", 5);
+    SockMsg msgs[3];
+    for(auto &m : msgs) {
+        m.buf = buf;
+        m.len = sizeof buf;
+    }
+    EXPECT_EQ(sendBatch(msgs, 3), 3);
+    EXPECT_EQ(sendBatch(msgs, 0), -1);
+    // Stop at a short send
+    msgs[2].len = 4;
+    EXPECT_EQ(sendBatch(msgs, 3), 2);
+    msgs[0].len = 4;
+    EXPECT_EQ(sendBatch(msgs, 3), -1);
+}
+
+// Tests rcvBatch method
+// ssize_t rcvBatch(SockMsg *msgs, size_t count, bool block = false) const
+TEST_F(SockIp4Test, MethodRcvBatch)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_TRUE(init());
+    uint8_t bufs[3][10];
+    SockMsg msgs[3];
+    for(size_t i = 0; i < 3; i++) {
+        msgs[i].buf = bufs[i];
+        msgs[i].bufSize = sizeof bufs[i];
+    }
+    EXPECT_EQ(rcvBatch(msgs, 3), 2);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(memcmp(bufs[0], "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(msgs[1].len, 5);
+    EXPECT_EQ(memcmp(bufs[1], "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(msgs[0].fromLen, 4);
+    EXPECT_EQ(memcmp(msgs[0].from, "\xc0\x0\x2\x1", 4), 0);
+    EXPECT_EQ(rcvBatch(msgs, 1, true), 1);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(memcmp(bufs[0], "\x1\x4\x5\x6\x7", 5), 0);
+    // Drop a truncated message
+    msgs[1].bufSize = 3;
+    EXPECT_EQ(rcvBatch(msgs, 3), 1);
+    EXPECT_EQ(msgs[0].len, 5);
+}
+
+// Tests setFilter method
+// bool setFilter(const MsgParams &prms, bool useSelfId = false)
+// bool removeFilter()
+TEST_F(SockIp4Test, MethodSetFilter)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    MsgParams prms;
+    prms.transportSpecific = 2;
+    prms.domainNumber = 3;
+    EXPECT_TRUE(setFilter(prms));
+    EXPECT_TRUE(init());
+    // UDP header and Management message header
+    uint8_t pkt[8 + 54] = { 0 };
+    uint8_t *msg = pkt + 8;
+    msg[0] = 0x2d;
+    msg[4] = 3;
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    msg[4] = 4; // domain
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    msg[4] = 3;
+    msg[0] = 0x1d; // transport specific
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    msg[0] = 0x2c; // signalling
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    prms.rcvSignaling = true;
+    EXPECT_TRUE(setFilter(prms));
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    msg[0] = 0x2d;
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    msg[0] = 0x2b;
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    EXPECT_TRUE(removeFilter());
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    prms.transportSpecific = 0x10;
+    EXPECT_FALSE(setFilter(prms));
+}
+
+// Tests multiple interfaces
+// bool addIfUsingName(const std::string &ifName)
+// bool addIfUsingIndex(int ifIndex)
+// bool addIf(const IfInfo &ifObj)
+// bool clearIfs()
+// size_t ifsCount() const
+// bool sendIf(const void *msg, size_t len, int ifIndex) const
+// ssize_t rcvIf(void *buf, size_t bufSize, int &ifIndex,
+//     bool block = false) const
+TEST_F(SockIp4Test, MethodMultiIf)
+{
+    EXPECT_EQ(ifsCount(), 0);
+    // Set the interface first
+    EXPECT_FALSE(addIfUsingName("eth1"));
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_FALSE(addIfUsingName("eth0"));
+    EXPECT_TRUE(addIfUsingName("eth1"));
+    EXPECT_FALSE(addIfUsingIndex(8));
+    EXPECT_EQ(ifsCount(), 2);
+    EXPECT_TRUE(clearIfs());
+    EXPECT_EQ(ifsCount(), 1);
+    IfInfo i;
+    EXPECT_TRUE(i.initUsingName("eth1"));
+    EXPECT_TRUE(addIf(i));
+    EXPECT_TRUE(init());
+    EXPECT_FALSE(addIfUsingIndex(8));
+    EXPECT_FALSE(clearIfs());
+    EXPECT_EQ(getTxId(), 0);
+    EXPECT_TRUE(sendIf("\x1\x2\x3\x4\x5", 5, 8));
+    EXPECT_EQ(getTxId(), 1);
+    EXPECT_FALSE(sendIf("\x1\x2\x3\x4\x5", 5, 9));
+    EXPECT_EQ(getTxId(), 1);
+    // Sent messages are counted the same with any send method
+    EXPECT_TRUE(send("\x1\x2\x3\x4\x5", 5));
+    EXPECT_EQ(getTxId(), 2);
+    EXPECT_TRUE(sendIf("\x1\x2\x3\x4\x5", 5, 8));
+    EXPECT_EQ(getTxId(), 3);
+    uint8_t buf[10];
+    int ifIndex = 0;
+    EXPECT_EQ(rcvIf(buf, sizeof buf, ifIndex), 5);
+    EXPECT_EQ(memcmp(buf, "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ifIndex, 8);
+    EXPECT_EQ(rcvIf(buf, sizeof buf, ifIndex, true), 5);
+    EXPECT_EQ(memcmp(buf, "\x1\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ifIndex, 8);
+}
+
 class SockIp6Test : public ::testing::Test, public SockIp6
 {
   protected:
@@ -678,6 +975,71 @@ TEST_F(SockIp6Test, MethodRcvBuf)
     EXPECT_EQ(memcmp(b.get(), "\x1\x4\x5\x6\x7", 5), 0);
 }
 
+// Tests sendBatch method
+// ssize_t sendBatch(const SockMsg *msgs, size_t count) const
+TEST_F(SockIp6Test, MethodSendBatch)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_TRUE(setScope(15));
+    EXPECT_TRUE(init());
+    uint8_t buf[5];
+    memcpy(buf, "\x1\x2\x3\x4\x5", 5);
+    SockMsg msgs[3];
+    for(auto &m : msgs) {
+        m.buf = buf;
+        m.len = sizeof buf;
+    }
+    EXPECT_EQ(sendBatch(msgs, 3), 3);
+    EXPECT_EQ(sendBatch(msgs, 0), -1);
+}
+
+// Tests rcvBatch method
+// ssize_t rcvBatch(SockMsg *msgs, size_t count, bool block = false) const
+TEST_F(SockIp6Test, MethodRcvBatch)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_TRUE(setScope(15));
+    EXPECT_TRUE(init());
+    uint8_t bufs[3][10];
+    SockMsg msgs[3];
+    for(size_t i = 0; i < 3; i++) {
+        msgs[i].buf = bufs[i];
+        msgs[i].bufSize = sizeof bufs[i];
+    }
+    EXPECT_EQ(rcvBatch(msgs, 3), 2);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(memcmp(bufs[0], "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(msgs[1].len, 5);
+    EXPECT_EQ(memcmp(bufs[1], "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(msgs[0].fromLen, 16);
+    EXPECT_EQ(memcmp(msgs[0].from, "\xfe\x80\x0\x0\x0\x0\x0\x0\x0\x0\x0\x0\x0\x0\x0\x1", 16), 0);
+    EXPECT_EQ(rcvBatch(msgs, 1, true), 1);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(memcmp(bufs[0], "\x1\x4\x5\x6\x7", 5), 0);
+}
+
+// Tests multiple interfaces
+// bool addIfUsingIndex(int ifIndex)
+// bool sendIf(const void *msg, size_t len, int ifIndex) const
+// ssize_t rcvIf(void *buf, size_t bufSize, int &ifIndex,
+//     bool block = false) const
+TEST_F(SockIp6Test, MethodMultiIf)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setUdpTtl(7));
+    EXPECT_TRUE(setScope(15));
+    EXPECT_TRUE(addIfUsingIndex(8));
+    EXPECT_TRUE(init());
+    EXPECT_TRUE(sendIf("\x1\x2\x3\x4\x5", 5, 8));
+    uint8_t buf[10];
+    int ifIndex = 0;
+    EXPECT_EQ(rcvIf(buf, sizeof buf, ifIndex), 5);
+    EXPECT_EQ(memcmp(buf, "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ifIndex, 8);
+}
+
 class SockRawTest : public ::testing::Test, public SockRaw
 {
   protected:
@@ -781,6 +1143,40 @@ TEST_F(SockRawTest, MethodSetAllInit)
     EXPECT_TRUE(setAllInit(i, f, "dumm"));
 }
 
+// Tests busy poll
+// bool setBusyPoll(const ConfigFile &cfg, const std::string &section = "")
+TEST_F(SockRawTest, MethodBusyPoll)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    ConfigFile f;
+    EXPECT_TRUE(f.read_cfg("utest/testing.cfg"));
+    EXPECT_TRUE(setBusyPoll(f, "dumm"));
+    EXPECT_TRUE(init());
+    // The spin finds the message before poll()
+    EXPECT_TRUE(poll(1));
+}
+
+// Tests busy poll with receive ring
+TEST_F(SockRawTest, MethodBusyPollRing)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(setRxRing(4096, 2, 7));
+    EXPECT_TRUE(setBusyPoll(30, true, 10));
+    EXPECT_TRUE(init());
+    // The first block is ready
+    EXPECT_TRUE(poll(1));
+    size_t cnt = 0;
+    auto cb = [&cnt](const SockMsg &) { cnt++; };
+    EXPECT_EQ(rcvRing(cb), 2);
+    EXPECT_EQ(cnt, 2);
+    // Second block is not ready, spin and fall back to poll()
+    EXPECT_FALSE(poll(1));
+}
+
 // Tests poll method
 // bool poll(uint64_t timeout_ms = 0) const
 TEST_F(SockRawTest, MethodPoll)
@@ -871,3 +1267,258 @@ TEST_F(SockRawTest, MethodRcvBuf)
     EXPECT_EQ(rcvBuf(b, true), 5);
     EXPECT_EQ(memcmp(b.get(), "\x1\x4\x5\x6\x7", 5), 0);
 }
+
+// Tests sendBatch method
+// ssize_t sendBatch(const SockMsg *msgs, size_t count) const
+TEST_F(SockRawTest, MethodSendBatch)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(init());
+    uint8_t buf[5];
+    memcpy(buf, "\x1\x2\x3\x4\x5", 5);
+    SockMsg msgs[3];
+    for(auto &m : msgs) {
+        m.buf = buf;
+        m.len = sizeof buf;
+    }
+    EXPECT_EQ(sendBatch(msgs, 3), 3);
+    EXPECT_EQ(sendBatch(msgs, 0), -1);
+    // Stop at a short send
+    msgs[2].len = 4;
+    EXPECT_EQ(sendBatch(msgs, 3), 2);
+    msgs[0].len = 4;
+    EXPECT_EQ(sendBatch(msgs, 3), -1);
+}
+
+// Tests rcvBatch method
+// ssize_t rcvBatch(SockMsg *msgs, size_t count, bool block = false) const
+TEST_F(SockRawTest, MethodRcvBatch)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(init());
+    uint8_t bufs[3][10];
+    SockMsg msgs[3];
+    for(size_t i = 0; i < 3; i++) {
+        msgs[i].buf = bufs[i];
+        msgs[i].bufSize = sizeof bufs[i];
+    }
+    EXPECT_EQ(rcvBatch(msgs, 3), 2);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(memcmp(bufs[0], "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(msgs[1].len, 5);
+    EXPECT_EQ(memcmp(bufs[1], "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(msgs[0].fromLen, 6);
+    EXPECT_EQ(memcmp(msgs[0].from, "\x1\x2\x3\x4\x5\x6", 6), 0);
+    EXPECT_EQ(rcvBatch(msgs, 1, true), 1);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(memcmp(bufs[0], "\x1\x4\x5\x6\x7", 5), 0);
+    // Drop a truncated message
+    msgs[1].bufSize = 3;
+    EXPECT_EQ(rcvBatch(msgs, 3), 1);
+    EXPECT_EQ(msgs[0].len, 5);
+}
+
+// Tests rcvRing method
+// bool setRxRing(size_t blockSize, size_t blocksNum, uint32_t timeout_ms = 0)
+// bool isRxRing() const
+// ssize_t rcvRing(const SockMsgCallback &callback, bool block = false) const
+TEST_F(SockRawTest, MethodRcvRing)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_FALSE(setRxRing(1000, 2));
+    EXPECT_TRUE(setRxRing(4096, 2, 7));
+    EXPECT_FALSE(isRxRing());
+    EXPECT_TRUE(init());
+    EXPECT_TRUE(isRxRing());
+    size_t cnt = 0;
+    auto cb = [&cnt](const SockMsg & msg) {
+        EXPECT_EQ(msg.len, 5);
+        uint8_t b[5] = { (uint8_t)(3 + cnt), 4, 5, 6, 7 };
+        EXPECT_EQ(memcmp(msg.buf, b, 5), 0);
+        EXPECT_EQ(msg.fromLen, 6);
+        EXPECT_EQ(memcmp(msg.from, "\x1\x2\x3\x4\x5\x6", 6), 0);
+        cnt++;
+    };
+    EXPECT_EQ(rcvRing(cb), 2);
+    EXPECT_EQ(cnt, 2);
+    // Second block is not ready
+    EXPECT_EQ(rcvRing(cb), 0);
+    EXPECT_EQ(cnt, 2);
+    uint8_t buf[10];
+    EXPECT_EQ(rcv(buf, sizeof buf), -1);
+}
+
+// Tests rcv method with a receive ring
+// ssize_t rcv(void *buf, size_t bufSize, bool block = false)
+// ssize_t rcvBatch(SockMsg *msgs, size_t count, bool block = false) const
+TEST_F(SockRawTest, MethodRcvRingCopy)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(setRxRing(4096, 2, 7));
+    EXPECT_TRUE(init());
+    uint8_t buf[10];
+    EXPECT_EQ(rcv(buf, sizeof buf), 5);
+    EXPECT_EQ(memcmp(buf, "\x3\x4\x5\x6\x7", 5), 0);
+    SockMsg msgs[2];
+    msgs[0].buf = buf;
+    msgs[0].bufSize = sizeof buf;
+    EXPECT_EQ(rcvBatch(msgs, 2), 1);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(memcmp(buf, "\x4\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(msgs[0].fromLen, 6);
+    EXPECT_EQ(rcvBatch(msgs, 2), -1);
+}
+
+// Tests getRxStats method
+// bool getRxStats(uint64_t &packets, uint64_t &drops) const
+TEST_F(SockRawTest, MethodGetRxStats)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    uint64_t packets, drops;
+    EXPECT_FALSE(getRxStats(packets, drops));
+    EXPECT_TRUE(init());
+    EXPECT_TRUE(getRxStats(packets, drops));
+    EXPECT_EQ(packets, 5);
+    EXPECT_EQ(drops, 2);
+    EXPECT_TRUE(getRxStats(packets, drops));
+    EXPECT_EQ(packets, 10);
+    EXPECT_EQ(drops, 4);
+}
+
+// Tests rcvTs method
+// bool setTimestamping(bool enable, bool hardware = false)
+// ssize_t rcvTs(void *buf, size_t bufSize, Timestamp_t &ts,
+//     bool block = false) const
+TEST_F(SockRawTest, MethodRcvTs)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(setTimestamping(true, true));
+    EXPECT_TRUE(init());
+    uint8_t buf[10];
+    Timestamp_t ts;
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts), 5);
+    EXPECT_EQ(memcmp(buf, "\x2\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ts, Timestamp_t(19, 351));
+}
+
+// Tests rcvTs method with a receive ring
+// ssize_t rcvTs(void *buf, size_t bufSize, Timestamp_t &ts,
+//     bool block = false) const
+TEST_F(SockRawTest, MethodRcvRingTs)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(setTimestamping(true));
+    EXPECT_TRUE(setRxRing(4096, 2, 7));
+    EXPECT_TRUE(init());
+    uint8_t buf[10];
+    Timestamp_t ts;
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts), 5);
+    EXPECT_EQ(memcmp(buf, "\x3\x4\x5\x6\x7", 5), 0);
+    EXPECT_EQ(ts, Timestamp_t(12, 147));
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts), 5);
+    EXPECT_EQ(ts, Timestamp_t(12, 148));
+}
+
+// Tests rcvTs method with a receive ring and hardware timestamps
+// ssize_t rcvTs(void *buf, size_t bufSize, Timestamp_t &ts,
+//     bool block = false) const
+TEST_F(SockRawTest, MethodRcvRingHwTs)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(setTimestamping(true, true));
+    EXPECT_TRUE(setRxRing(4096, 2, 7));
+    EXPECT_TRUE(init());
+    uint8_t buf[10];
+    Timestamp_t ts;
+    // The frames do not carry hardware timestamps
+    EXPECT_EQ(rcvTs(buf, sizeof buf, ts), 5);
+    EXPECT_TRUE(ts.isZero());
+}
+
+// Tests getTxTs method
+// bool getTxTs(Timestamp_t &ts, uint32_t &id, bool block = false) const
+TEST_F(SockRawTest, MethodGetTxTs)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(setTimestamping(true, true));
+    EXPECT_TRUE(init());
+    EXPECT_TRUE(send("\x1\x2\x3\x4\x5", 5));
+    Timestamp_t ts;
+    uint32_t id;
+    EXPECT_TRUE(getTxTs(ts, id));
+    EXPECT_EQ(id, 3);
+    EXPECT_EQ(ts, Timestamp_t(20, 352));
+}
+
+// Tests setFilter method
+// bool setFilter(const MsgParams &prms, bool useSelfId = false)
+// bool removeFilter()
+TEST_F(SockRawTest, MethodSetFilter)
+{
+    EXPECT_TRUE(setIfUsingIndex(7));
+    EXPECT_TRUE(setPtpDstMacStr("1:1b:17:f:c:0"));
+    EXPECT_TRUE(setSocketPriority(7));
+    EXPECT_TRUE(init());
+    // Ethernet header and Management message header
+    uint8_t pkt[14 + 54] = { 0 };
+    pkt[12] = 0x88;
+    pkt[13] = 0xf7;
+    uint8_t *msg = pkt + 14;
+    msg[0] = 0xd;
+    msg[4] = 5;
+    uint8_t *target = msg + 34;
+    const uint8_t clk[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    memcpy(target, clk, 8);
+    target[9] = 9;
+    // Default filter pass PTP frames
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    MsgParams prms;
+    prms.domainNumber = 5;
+    memcpy(prms.self_id.clockIdentity.v, clk, 8);
+    prms.self_id.portNumber = 9;
+    EXPECT_TRUE(setFilter(prms, true));
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    target[9] = 8; // Other port
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    target[8] = 0xff; // All ports
+    target[9] = 0xff;
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    target[7] = 9; // Other clock
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    memset(target, 0xff, 8); // All clocks
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    target[3] = 0; // Other clock
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    memcpy(target, clk, 8);
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    msg[4] = 4; // domain
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    msg[4] = 5;
+    pkt[13] = 0xf8; // Ethernet protocol
+    EXPECT_EQ(runFilter(pkt, sizeof pkt), 0);
+    pkt[13] = 0xf7;
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+    // Too short for the target port
+    EXPECT_EQ(runFilter(pkt, 14 + 40), 0);
+    EXPECT_TRUE(removeFilter());
+    msg[4] = 4;
+    EXPECT_NE(runFilter(pkt, sizeof pkt), 0);
+}
@@ -694,6 +694,34 @@ TEST(MsgParamsTest, MethodIsSigTlv)
     EXPECT_FALSE(t.isSigTlv(REQUEST_UNICAST_TRANSMISSION));
 }
 
+// Tests query signal TLVs outside the common TLV types ranges
+// bool isSigTlv(tlvType_e type) const
+TEST(MsgParamsTest, MethodIsSigTlvRanges)
+{
+    MsgParams t;
+    t.allowSigTlv(SLAVE_DELAY_TIMING_DATA_NP);
+    t.allowSigTlv(ENHANCED_ACCURACY_METRICS);
+    t.allowSigTlv((tlvType_e)0x1234);
+    EXPECT_TRUE(t.isSigTlv(SLAVE_DELAY_TIMING_DATA_NP));
+    EXPECT_TRUE(t.isSigTlv(ENHANCED_ACCURACY_METRICS));
+    EXPECT_TRUE(t.isSigTlv((tlvType_e)0x1234));
+    EXPECT_FALSE(t.isSigTlv(ORGANIZATION_EXTENSION_PROPAGATE));
+    EXPECT_FALSE(t.isSigTlv(L1_SYNC));
+    EXPECT_FALSE(t.isSigTlv((tlvType_e)0x1235));
+    EXPECT_FALSE(t.isSigTlv((tlvType_e)0x7f40));
+    EXPECT_EQ(t.countSigTlvs(), 3);
+    // Allow twice
+    t.allowSigTlv((tlvType_e)0x1234);
+    EXPECT_EQ(t.countSigTlvs(), 3);
+    t.removeSigTlv((tlvType_e)0x1234);
+    t.removeSigTlv((tlvType_e)0x1234);
+    EXPECT_FALSE(t.isSigTlv((tlvType_e)0x1234));
+    t.removeSigTlv(SLAVE_DELAY_TIMING_DATA_NP);
+    EXPECT_FALSE(t.isSigTlv(SLAVE_DELAY_TIMING_DATA_NP));
+    EXPECT_TRUE(t.isSigTlv(ENHANCED_ACCURACY_METRICS));
+    EXPECT_EQ(t.countSigTlvs(), 1);
+}
+
 // Tests count of signal TLVs method
 // size_t countSigTlvs() const
 TEST(MsgParamsTest, MethodCountSigTlv)
@@ -0,0 +1,264 @@
+/* SPDX-License-Identifier: GPL-3.0-or-later
+   SPDX-FileCopyrightText: Copyright © 2024 Erez Geva <ErezGeva2@gmail.com> */
+
+/** @file
+ * @brief io_uring socket class unit tests
+ *
+ * @author Erez Geva <ErezGeva2@@gmail.com>
+ * @copyright © 2024 Erez Geva
+ *
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include "comp.h"
+#include "uring.h"
+
+using namespace ptpmgmt;
+
+// Socket class without io_uring support
+class SockFallback : public SockBase
+{
+  protected:
+    bool initBase() override {
+        int fds[2];
+        if(socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) != 0)
+            return false;
+        m_fd = fds[0];
+        m_peer = fds[1];
+        m_isInit = true;
+        return true;
+    }
+    void closeChild() override {
+        if(m_peer >= 0) {
+            ::close(m_peer);
+            m_peer = -1;
+        }
+    }
+    bool sendBase(const void *msg, size_t len) const override {
+        return sendReply(::send(m_fd, msg, len, 0), len);
+    }
+    ssize_t rcvBase(void *buf, size_t bufSize, bool block) const override {
+        ssize_t cnt = recv(m_fd, buf, bufSize, block ? 0 : MSG_DONTWAIT);
+        if(cnt < 0)
+            PTPMGMT_ERROR_P("recv");
+        return cnt;
+    }
+  public:
+    int m_peer = -1;
+    ~SockFallback() { closeChild(); }
+};
+
+// UDP socket on the loop back, send unicast to the peer socket
+class SockIp4Loop : public SockIp4
+{
+  public:
+    sockaddr_in m_self = {};
+    sockaddr_in m_peer = {};
+    bool initLoop() {
+        m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if(m_fd < 0)
+            return false;
+        m_self.sin_family = AF_INET;
+        m_self.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof m_self;
+        if(bind(m_fd, (sockaddr *)&m_self, len) != 0 ||
+            getsockname(m_fd, (sockaddr *)&m_self, &len) != 0)
+            return false;
+        m_isInit = true;
+        return true;
+    }
+    void setPeer(const SockIp4Loop &peer) {
+        m_peer = peer.m_self;
+        m_addr = (sockaddr *)&m_peer;
+        m_addr_len = sizeof m_peer;
+    }
+};
+
+class UringTest : public ::testing::Test
+{
+  protected:
+    SockUnix client, server;
+    std::string base;
+    void SetUp() override {
+        base = "/tmp/ptpmgmt_utest." + std::to_string(getpid());
+        ASSERT_TRUE(client.setSelfAddress(base + ".client"));
+        ASSERT_TRUE(client.setPeerAddress(base + ".server"));
+        ASSERT_TRUE(server.setSelfAddress(base + ".server"));
+        ASSERT_TRUE(server.setPeerAddress(base + ".client"));
+        ASSERT_TRUE(client.init());
+        ASSERT_TRUE(server.init());
+    }
+    void TearDown() override {
+        client.close();
+        server.close();
+    }
+};
+
+// Tests receive with Unix socket
+// bool init(size_t bufCount = 64, size_t bufSize = 2000)
+// ssize_t rcv(SockMsg *msgs, size_t count, bool block = false)
+// void release(const SockMsg *msgs, size_t count)
+TEST_F(UringTest, MethodRcv)
+{
+    SockUring u(server);
+    ASSERT_TRUE(u.init(4, 100));
+    EXPECT_FALSE(u.init());
+    EXPECT_GE(u.getFd(), 0);
+    SockMsg msgs[8];
+    EXPECT_EQ(u.rcv(msgs, 8), 0);
+    for(uint8_t i = 0; i < 6; i++) {
+        uint8_t buf[5] = { i, 1, 2, 3, 4 };
+        EXPECT_TRUE(client.send(buf, sizeof buf));
+    }
+    EXPECT_EQ(u.rcv(msgs, 1, true), 1);
+    EXPECT_EQ(msgs[0].len, 5);
+    EXPECT_EQ(msgs[0].bufSize, 100);
+    EXPECT_EQ(memcmp(msgs[0].buf, "\x0\x1\x2\x3\x4", 5), 0);
+    // Only 4 buffers
+    ssize_t cnt = u.rcv(msgs + 1, 7);
+    EXPECT_EQ(cnt, 3);
+    for(ssize_t i = 0; i < cnt; i++) {
+        EXPECT_EQ(msgs[i + 1].len, 5);
+        EXPECT_EQ(((uint8_t *)msgs[i + 1].buf)[0], i + 1);
+    }
+    u.release(msgs, cnt + 1);
+    cnt = u.rcv(msgs, 8, true);
+    EXPECT_EQ(cnt, 2);
+    EXPECT_EQ(((uint8_t *)msgs[0].buf)[0], 4);
+    EXPECT_EQ(((uint8_t *)msgs[1].buf)[0], 5);
+    u.release(msgs, cnt);
+    // Message from another peer is dropped
+    SockUnix other;
+    ASSERT_TRUE(other.setSelfAddress(base + ".other"));
+    ASSERT_TRUE(other.setPeerAddress(base + ".server"));
+    ASSERT_TRUE(other.init());
+    EXPECT_TRUE(other.send("\x9", 1));
+    other.close();
+    EXPECT_TRUE(client.send("\x7", 1));
+    EXPECT_EQ(u.rcv(msgs, 8, true), 1);
+    EXPECT_EQ(((uint8_t *)msgs[0].buf)[0], 7);
+    u.release(msgs, 1);
+}
+
+// Tests send with Unix socket
+// bool send(const void *msg, size_t len)
+// ssize_t submit()
+// size_t sendPending() const
+// size_t sendErrors()
+TEST_F(UringTest, MethodSend)
+{
+    SockUring u(server);
+    ASSERT_TRUE(u.init(4, 100));
+    for(uint8_t i = 0; i < 4; i++) {
+        uint8_t buf[5] = { i, 1, 2, 3, 4 };
+        EXPECT_TRUE(u.send(buf, sizeof buf));
+    }
+    EXPECT_FALSE(u.send("\x1", 1));
+    EXPECT_FALSE(u.send(nullptr, 1));
+    EXPECT_EQ(u.sendPending(), 4);
+    EXPECT_EQ(u.submit(), 4);
+    uint8_t buf[10];
+    for(uint8_t i = 0; i < 4; i++) {
+        EXPECT_EQ(client.rcv(buf, sizeof buf, true), 5);
+        EXPECT_EQ(buf[0], i);
+    }
+    EXPECT_EQ(u.sendErrors(), 0);
+    EXPECT_EQ(u.sendPending(), 0);
+    EXPECT_EQ(u.submit(), 0);
+    // Sent messages advance the transmit timestamp ID
+    EXPECT_EQ(server.getTxId(), 4);
+}
+
+// Tests send and receive with UDP socket on the loop back
+TEST(UringUdpTest, MethodSendRcv)
+{
+    SockIp4Loop a, b;
+    ASSERT_TRUE(a.initLoop());
+    ASSERT_TRUE(b.initLoop());
+    a.setPeer(b);
+    b.setPeer(a);
+    SockUring ua(a), ub(b);
+    ASSERT_TRUE(ua.init(4, 100));
+    ASSERT_TRUE(ub.init(4, 100));
+    for(uint8_t i = 0; i < 3; i++) {
+        uint8_t buf[5] = { i, 1, 2, 3, 4 };
+        EXPECT_TRUE(ua.send(buf, sizeof buf));
+    }
+    EXPECT_EQ(ua.submit(), 3);
+    SockMsg msgs[4];
+    ssize_t got = 0;
+    while(got < 3) {
+        ssize_t cnt = ub.rcv(msgs + got, 4 - got, true);
+        ASSERT_GT(cnt, 0);
+        got += cnt;
+    }
+    EXPECT_EQ(got, 3);
+    for(uint8_t i = 0; i < 3; i++) {
+        EXPECT_EQ(msgs[i].len, 5);
+        EXPECT_EQ(((uint8_t *)msgs[i].buf)[0], i);
+        EXPECT_EQ(msgs[i].fromLen, 4);
+        EXPECT_EQ(memcmp(msgs[i].from, "\x7f\x0\x0\x1", 4), 0);
+    }
+    ub.release(msgs, 3);
+    EXPECT_EQ(ua.sendErrors(), 0);
+    EXPECT_EQ(ua.sendPending(), 0);
+    EXPECT_EQ(a.getTxId(), 3);
+    // Reply to the sender
+    EXPECT_TRUE(ub.send("\x9", 1));
+    EXPECT_EQ(ub.submit(), 1);
+    EXPECT_EQ(ua.rcv(msgs, 4, true), 1);
+    EXPECT_EQ(msgs[0].len, 1);
+    EXPECT_EQ(((uint8_t *)msgs[0].buf)[0], 9);
+    ua.release(msgs, 1);
+}
+
+// Tests socket class without io_uring
+// bool isUring() const
+// void close()
+TEST(UringFallbackTest, MethodIsUring)
+{
+    SockFallback sk;
+    SockUring u(sk);
+    EXPECT_FALSE(u.init());
+    ASSERT_TRUE(sk.init());
+    ASSERT_TRUE(u.init(2, 100));
+    EXPECT_FALSE(u.isUring());
+    EXPECT_EQ(u.getFd(), sk.getFd());
+    SockMsg msgs[4];
+    EXPECT_EQ(u.rcv(msgs, 4), 0);
+    EXPECT_EQ(send(sk.m_peer, "\x1\x2\x3", 3, 0), 3);
+    EXPECT_EQ(send(sk.m_peer, "\x4\x5", 2, 0), 2);
+    EXPECT_EQ(send(sk.m_peer, "\x6", 1, 0), 1);
+    EXPECT_EQ(u.rcv(msgs, 4, true), 2);
+    EXPECT_EQ(msgs[0].len, 3);
+    EXPECT_EQ(memcmp(msgs[0].buf, "\x1\x2\x3", 3), 0);
+    EXPECT_EQ(msgs[1].len, 2);
+    EXPECT_EQ(memcmp(msgs[1].buf, "\x4\x5", 2), 0);
+    // All buffers are in use
+    EXPECT_LT(u.rcv(msgs + 2, 2), 0);
+    u.release(msgs, 2);
+    EXPECT_EQ(u.rcv(msgs, 4), 1);
+    EXPECT_EQ(msgs[0].len, 1);
+    u.release(msgs, 1);
+    // Buffer released twice is ignored
+    u.release(msgs, 1);
+    for(int i = 0; i < 3; i++)
+        EXPECT_EQ(send(sk.m_peer, "\x1", 1, 0), 1);
+    EXPECT_EQ(u.rcv(msgs, 4, true), 2);
+    EXPECT_NE(msgs[0].buf, msgs[1].buf);
+    u.release(msgs, 2);
+    EXPECT_EQ(u.rcv(msgs, 4), 1);
+    u.release(msgs, 1);
+    EXPECT_TRUE(u.send("\x7\x8", 2));
+    EXPECT_TRUE(u.send("\x9", 1));
+    EXPECT_EQ(u.submit(), 2);
+    EXPECT_EQ(u.sendPending(), 0);
+    uint8_t buf[10];
+    EXPECT_EQ(recv(sk.m_peer, buf, sizeof buf, 0), 2);
+    EXPECT_EQ(recv(sk.m_peer, buf, sizeof buf, 0), 1);
+    EXPECT_EQ(sk.getTxId(), 2);
+    u.close();
+    EXPECT_FALSE(u.send("\x9", 1));
+}